@@ -0,0 +1,203 @@
+#include <benchmark/benchmark.h>
+#include "GameGenerator.h"
+#include "GomokuLib/Board.h"
+#include "GomokuLib/CpuDispatch.h"
+#include "GomokuLib/TrainingData.h"
+#include "GomokuLib/TranspositionTable.h"
+
+using namespace GomokuLib;
+
+namespace
+{
+    // ランダム対局の手をそのまま盤面に置いた局面
+    Board boardFromGame(int boardSize, int length)
+    {
+        Board board(boardSize);
+        Stone stone = Stone::BLACK;
+        for (const auto &move : GomokuBench::randomGame(boardSize, length))
+        {
+            board.placeStone(move.first, move.second, stone);
+            stone = (stone == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
+        }
+        return board;
+    }
+
+    // 盤面サイズ × 手数の組み合わせ
+    void boardArguments(benchmark::internal::Benchmark *bench)
+    {
+        bench->ArgNames({"size", "moves"});
+        bench->ArgsProduct({{15, 19, 25, 50}, {16, 64, 256}});
+    }
+}
+
+// 対局の手を全て置いてから取り除く
+static void BM_PlaceStone(benchmark::State &state)
+{
+    int boardSize = static_cast<int>(state.range(0));
+    auto moves = GomokuBench::randomGame(boardSize, GomokuBench::clampLength(boardSize, static_cast<int>(state.range(1))));
+    Board board(boardSize);
+
+    for (auto _ : state)
+    {
+        Stone stone = Stone::BLACK;
+        for (const auto &move : moves)
+        {
+            benchmark::DoNotOptimize(board.placeStone(move.first, move.second, stone));
+            stone = (stone == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
+        }
+        for (const auto &move : moves)
+        {
+            board.placeStone(move.first, move.second, Stone::EMPTY);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(moves.size()) * 2);
+}
+BENCHMARK(BM_PlaceStone)->Apply(boardArguments);
+
+// 盤面全体の勝敗判定
+static void BM_CheckWinner(benchmark::State &state)
+{
+    int boardSize = static_cast<int>(state.range(0));
+    Board board = boardFromGame(boardSize, GomokuBench::clampLength(boardSize, static_cast<int>(state.range(1))));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(board.checkWinner());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CheckWinner)->Apply(boardArguments);
+
+// 盤面全体の形の特徴の数え上げ
+static void BM_CountLineFeatures(benchmark::State &state)
+{
+    int boardSize = static_cast<int>(state.range(0));
+    Board board = boardFromGame(boardSize, GomokuBench::clampLength(boardSize, static_cast<int>(state.range(1))));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(board.countLineFeatures());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CountLineFeatures)->Apply(boardArguments);
+
+// 命令セットごとの盤面全体の走査（勝敗判定と形の特徴）
+static void BM_BoardScanLevel(benchmark::State &state)
+{
+    SimdLevel level = static_cast<SimdLevel>(state.range(0));
+    int boardSize = static_cast<int>(state.range(1));
+    if (!BoardScan::isSupported(level))
+    {
+        state.SkipWithError("not supported on this CPU");
+        return;
+    }
+    Board board = boardFromGame(boardSize, GomokuBench::clampLength(boardSize, 64));
+
+    SimdLevel previous = BoardScan::getLevel();
+    BoardScan::setLevel(level);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(board.checkWinner());
+        benchmark::DoNotOptimize(board.countLineFeatures());
+    }
+    BoardScan::setLevel(previous);
+    state.SetLabel(BoardScan::levelToString(level));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoardScanLevel)->ArgNames({"level", "size"})->ArgsProduct({{0, 1, 2, 3}, {15, 50}});
+
+// 命令セットごとの盤面の対称変換（自己対局の学習データの8通りの水増し）
+static void BM_ApplySymmetry(benchmark::State &state)
+{
+    SimdLevel level = static_cast<SimdLevel>(state.range(0));
+    int boardSize = static_cast<int>(state.range(1));
+    if (!CpuDispatch::isSupported(level))
+    {
+        state.SkipWithError("not supported on this CPU");
+        return;
+    }
+    Board board = boardFromGame(boardSize, GomokuBench::clampLength(boardSize, 64));
+    TrainingSample sample;
+    for (int r = 0; r < boardSize; r++)
+    {
+        for (int c = 0; c < boardSize; c++)
+        {
+            sample.cells.push_back(board.getStone(r, c));
+        }
+    }
+    TrainingSample out;
+
+    SimdLevel previous = CpuDispatch::getLevel();
+    CpuDispatch::setLevel(level);
+    for (auto _ : state)
+    {
+        for (int symmetry = 0; symmetry < TrainingData::SYMMETRY_COUNT; symmetry++)
+        {
+            TrainingData::applySymmetry(sample, boardSize, symmetry, out);
+            benchmark::DoNotOptimize(out.cells.data());
+        }
+    }
+    CpuDispatch::setLevel(previous);
+    state.SetLabel(CpuDispatch::levelToString(level));
+    state.SetItemsProcessed(state.iterations() * TrainingData::SYMMETRY_COUNT);
+}
+BENCHMARK(BM_ApplySymmetry)->ArgNames({"level", "size"})->ArgsProduct({{0, 2}, {15, 50}});
+
+// 命令セットごとの盤面全体の Zobrist ハッシュ（探索の開始局面）
+static void BM_HashBoard(benchmark::State &state)
+{
+    SimdLevel level = static_cast<SimdLevel>(state.range(0));
+    int boardSize = static_cast<int>(state.range(1));
+    if (!CpuDispatch::isSupported(level))
+    {
+        state.SkipWithError("not supported on this CPU");
+        return;
+    }
+    Board board = boardFromGame(boardSize, GomokuBench::clampLength(boardSize, 64));
+    TranspositionTable table(boardSize, 16);
+
+    SimdLevel previous = CpuDispatch::getLevel();
+    CpuDispatch::setLevel(level);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(table.hash(board, Stone::BLACK));
+    }
+    CpuDispatch::setLevel(previous);
+    state.SetLabel(CpuDispatch::levelToString(level));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HashBoard)->ArgNames({"level", "size"})->ArgsProduct({{0, 2}, {15, 50}});
+
+// 最後の着手だけを調べる勝敗判定
+static void BM_CheckWinAt(benchmark::State &state)
+{
+    int boardSize = static_cast<int>(state.range(0));
+    int length = GomokuBench::clampLength(boardSize, static_cast<int>(state.range(1)));
+    auto moves = GomokuBench::randomGame(boardSize, length);
+    Board board = boardFromGame(boardSize, length);
+
+    for (auto _ : state)
+    {
+        for (const auto &move : moves)
+        {
+            benchmark::DoNotOptimize(board.checkWinAt(move.first, move.second));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(moves.size()));
+}
+BENCHMARK(BM_CheckWinAt)->Apply(boardArguments);
+
+// 盤面が埋まっているかの判定
+static void BM_IsFull(benchmark::State &state)
+{
+    int boardSize = static_cast<int>(state.range(0));
+    Board board = boardFromGame(boardSize, GomokuBench::clampLength(boardSize, static_cast<int>(state.range(1))));
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(board.isFull());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_IsFull)->Apply(boardArguments);
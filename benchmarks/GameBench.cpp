@@ -0,0 +1,276 @@
+#include <benchmark/benchmark.h>
+#include "GameGenerator.h"
+#include "GomokuLib/Game.h"
+#include "GomokuLib/GameJournal.h"
+#include "GomokuLib/GameSnapshot.h"
+#include "GomokuLib/Perft.h"
+#include "GomokuLib/Search.h"
+#include "GomokuLib/ThreadArena.h"
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace GomokuLib;
+
+namespace
+{
+    // ランダム対局を最後まで打った対局
+    Game playedGame(int boardSize, const std::vector<std::pair<int, int>> &moves)
+    {
+        Game game(boardSize);
+        for (const auto &move : moves)
+        {
+            game.playTurn(move.first, move.second);
+        }
+        return game;
+    }
+
+    // ベンチマークごとの一時ファイル
+    std::string tempRecordPath(const benchmark::State &state)
+    {
+        auto name = "gomoku_bench_" + std::to_string(state.range(0)) + "_" + std::to_string(state.range(1)) + ".txt";
+        return (std::filesystem::temp_directory_path() / name).string();
+    }
+
+    // 盤面サイズ × 手数の組み合わせ
+    void gameArguments(benchmark::internal::Benchmark *bench)
+    {
+        bench->ArgNames({"size", "moves"});
+        bench->ArgsProduct({{15, 19, 25, 50}, {16, 64, 256}});
+    }
+
+    std::vector<std::pair<int, int>> benchGame(const benchmark::State &state)
+    {
+        int boardSize = static_cast<int>(state.range(0));
+        return GomokuBench::randomGame(boardSize, GomokuBench::clampLength(boardSize, static_cast<int>(state.range(1))));
+    }
+}
+
+// 新しい対局に全ての手を打つ
+static void BM_PlayTurn(benchmark::State &state)
+{
+    int boardSize = static_cast<int>(state.range(0));
+    auto moves = benchGame(state);
+
+    for (auto _ : state)
+    {
+        Game game(boardSize);
+        for (const auto &move : moves)
+        {
+            benchmark::DoNotOptimize(game.playTurn(move.first, move.second));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(moves.size()));
+}
+BENCHMARK(BM_PlayTurn)->Apply(gameArguments);
+
+// 打ち終えた対局を初期局面まで一手ずつ戻す（打つ時間は計測しない）
+static void BM_UndoMove(benchmark::State &state)
+{
+    int boardSize = static_cast<int>(state.range(0));
+    auto moves = benchGame(state);
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Game game = playedGame(boardSize, moves);
+        state.ResumeTiming();
+
+        while (game.undoMove())
+        {
+        }
+        benchmark::DoNotOptimize(game);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(moves.size()));
+}
+BENCHMARK(BM_UndoMove)->Apply(gameArguments);
+
+// 対局のコピー
+static void BM_CopyGame(benchmark::State &state)
+{
+    Game game = playedGame(static_cast<int>(state.range(0)), benchGame(state));
+
+    for (auto _ : state)
+    {
+        Game copy(game);
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CopyGame)->Apply(gameArguments);
+
+// スレッドの領域への対局のコピー（2回目からはヒープから確保しない）
+static void BM_CopyGameArena(benchmark::State &state)
+{
+    Game game = playedGame(static_cast<int>(state.range(0)), benchGame(state));
+
+    for (auto _ : state)
+    {
+        Game copy(game, ThreadArena::get());
+        benchmark::DoNotOptimize(copy);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CopyGameArena)->Apply(gameArguments);
+
+// 確保済みの対局への代入（領域を使い回す）
+static void BM_AssignGame(benchmark::State &state)
+{
+    Game game = playedGame(static_cast<int>(state.range(0)), benchGame(state));
+    Game target(game);
+
+    for (auto _ : state)
+    {
+        target = game;
+        benchmark::DoNotOptimize(target);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AssignGame)->Apply(gameArguments);
+
+// 棋譜の保存
+static void BM_SaveGame(benchmark::State &state)
+{
+    Game game = playedGame(static_cast<int>(state.range(0)), benchGame(state));
+    std::string path = tempRecordPath(state);
+
+    for (auto _ : state)
+    {
+        game.saveGame(path);
+    }
+    state.SetItemsProcessed(state.iterations());
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_SaveGame)->Apply(gameArguments);
+
+// 棋譜の読み込み
+static void BM_LoadGame(benchmark::State &state)
+{
+    std::string path = tempRecordPath(state);
+    playedGame(static_cast<int>(state.range(0)), benchGame(state)).saveGame(path);
+
+    for (auto _ : state)
+    {
+        Game game = Game::loadGame(path);
+        benchmark::DoNotOptimize(game);
+    }
+    state.SetItemsProcessed(state.iterations());
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_LoadGame)->Apply(gameArguments);
+
+// 記録を付けた対局での着手と一手戻し（1回ごとに saveGame で書き直す代わりに、8 バイトずつ追記する）
+static void BM_JournalMove(benchmark::State &state)
+{
+    std::string path = tempRecordPath(state);
+    std::remove(path.c_str());
+    std::remove((path + ".journal").c_str());
+    {
+        GameJournal journal(path);
+        Game game = journal.open(playedGame(static_cast<int>(state.range(0)), benchGame(state)));
+        game.jumpTo(game.getPly() / 2);
+        auto move = game.getLineView()[game.getPly()];
+        game.setJournal(&journal);
+
+        for (auto _ : state)
+        {
+            game.playTurn(move.first, move.second);
+            game.undoMove();
+        }
+        state.SetItemsProcessed(state.iterations() * 2);
+        game.setJournal(nullptr);
+    }
+    std::remove(path.c_str());
+    std::remove((path + ".journal").c_str());
+}
+BENCHMARK(BM_JournalMove)->Apply(gameArguments);
+
+// 着手と一手戻しのたびに観戦者向けの状態を公開する（観戦スレッドが読み続けていても公開する側は待たない）
+static void BM_PublishSnapshot(benchmark::State &state)
+{
+    Game game(19);
+    for (const auto &move : GomokuBench::randomGame(19, 64))
+    {
+        game.playTurn(move.first, move.second);
+    }
+    game.jumpTo(game.getPly() / 2);
+    auto move = game.getLineView()[game.getPly()];
+
+    SnapshotPublisher publisher(game);
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int64_t r = 0; r < state.range(0); r++)
+    {
+        readers.emplace_back([&publisher, &done]()
+                             {
+            SnapshotReader reader(publisher);
+            while (!done.load(std::memory_order_relaxed))
+            {
+                auto snapshot = reader.read();
+                benchmark::DoNotOptimize(snapshot->moves.size());
+                std::this_thread::yield();
+            } });
+    }
+
+    for (auto _ : state)
+    {
+        game.playTurn(move.first, move.second);
+        publisher.publish(game);
+        game.undoMove();
+        publisher.publish(game);
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+
+    done = true;
+    for (auto &thread : readers)
+    {
+        thread.join();
+    }
+}
+BENCHMARK(BM_PublishSnapshot)->ArgName("readers")->Arg(0)->Arg(64);
+
+// 小さな盤面の全ての着手の並びを playTurn と takeBackMove でたどる
+static void BM_Perft(benchmark::State &state)
+{
+    Game game(static_cast<int>(state.range(0)));
+    int depth = static_cast<int>(state.range(1));
+    uint64_t nodes = 0;
+
+    for (auto _ : state)
+    {
+        nodes += Perft::count(game, depth).nodes;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(nodes));
+}
+BENCHMARK(BM_Perft)->ArgNames({"size", "depth"})->Args({5, 3})->Args({7, 3})->Unit(benchmark::kMillisecond);
+
+// 固定の深さの探索（timed:1 は使い切らない時間の制限を付け、探索中の時計の確認の負荷を測る）
+static void BM_Search(benchmark::State &state)
+{
+    Game game(15);
+    for (const auto &move : GomokuBench::randomGame(15, 16))
+    {
+        game.playTurn(move.first, move.second);
+    }
+
+    SearchLimits limits;
+    limits.maxDepth = 3;
+    if (state.range(0) != 0)
+    {
+        limits.time.softMs = 3600000;
+        limits.time.hardMs = 3600000;
+    }
+
+    uint64_t nodes = 0;
+    for (auto _ : state)
+    {
+        SearchResult result = Search::run(game.getBoard(), game.getCurrentPlayer(), limits);
+        nodes += result.nodes;
+        benchmark::DoNotOptimize(result.bestMove);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(nodes));
+}
+BENCHMARK(BM_Search)->ArgName("timed")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "GomokuLib/Board.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace GomokuBench
+{
+
+    // 再現可能なランダム対局を作る
+    // 同じサイズ・手数・シードからは常に同じ棋譜ができる（途中で五連ができる手は選ばないので、最後まで打てる）
+    inline std::vector<std::pair<int, int>> randomGame(int boardSize, int length, uint64_t seed = 1)
+    {
+        std::mt19937_64 rng(seed * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(boardSize));
+        GomokuLib::Board board(boardSize);
+        std::vector<std::pair<int, int>> moves;
+
+        // 空きマスの一覧から選び、選んだマスは末尾と入れ替えて取り除く
+        std::vector<std::pair<int, int>> empty;
+        for (int r = 0; r < boardSize; r++)
+        {
+            for (int c = 0; c < boardSize; c++)
+            {
+                empty.emplace_back(r, c);
+            }
+        }
+
+        GomokuLib::Stone stone = GomokuLib::Stone::BLACK;
+        size_t remaining = empty.size();
+        while (static_cast<int>(moves.size()) < length && remaining > 0)
+        {
+            size_t index = static_cast<size_t>(rng() % remaining);
+            auto move = empty[index];
+            std::swap(empty[index], empty[--remaining]);
+
+            board.placeStone(move.first, move.second, stone);
+            if (board.checkWinAt(move.first, move.second))
+            {
+                // 五連になる手は使わない（このマスはもう選ばない）
+                board.placeStone(move.first, move.second, GomokuLib::Stone::EMPTY);
+                continue;
+            }
+            moves.push_back(move);
+            stone = (stone == GomokuLib::Stone::BLACK) ? GomokuLib::Stone::WHITE : GomokuLib::Stone::BLACK;
+        }
+        return moves;
+    }
+
+    // 対局の手数を盤面に収まる数に切り詰める（手数の引数を全ての盤面サイズで共通にするため）
+    inline int clampLength(int boardSize, int length)
+    {
+        return std::min(length, boardSize * boardSize / 2);
+    }
+
+} // namespace GomokuBench
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+#include "GameGenerator.h"
+#include "GomokuLib/BatchEvaluator.h"
+#include "GomokuLib/NeuralNetwork.h"
+#include <memory>
+
+using namespace GomokuLib;
+
+namespace
+{
+    // ランダム対局の手をそのまま盤面に置いた局面
+    Board boardFromGame(int boardSize, int length)
+    {
+        Board board(boardSize);
+        Stone stone = Stone::BLACK;
+        for (const auto &move : GomokuBench::randomGame(boardSize, length))
+        {
+            board.placeStone(move.first, move.second, stone);
+            stone = (stone == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
+        }
+        return board;
+    }
+}
+
+// アキュムレータからの評価（命令セットごと）
+static void BM_NeuralEvaluate(benchmark::State &state)
+{
+    SimdLevel level = static_cast<SimdLevel>(state.range(0));
+    if (!BoardScan::isSupported(level))
+    {
+        state.SkipWithError("not supported on this CPU");
+        return;
+    }
+    NeuralNetwork network = NeuralNetwork::random(15, 1);
+    Board board = boardFromGame(15, 40);
+    NeuralAccumulator accumulator(network, board);
+
+    SimdLevel previous = NeuralNetwork::getLevel();
+    NeuralNetwork::setLevel(level);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(accumulator.evaluate(Stone::BLACK));
+    }
+    NeuralNetwork::setLevel(previous);
+    state.SetLabel(BoardScan::levelToString(level));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NeuralEvaluate)->ArgName("level")->Arg(static_cast<int>(SimdLevel::SCALAR))->Arg(static_cast<int>(SimdLevel::AVX2));
+
+// 探索と同じく、石を置いて評価し、取り除く
+static void BM_NeuralIncremental(benchmark::State &state)
+{
+    NeuralNetwork network = NeuralNetwork::random(15, 1);
+    Board board = boardFromGame(15, 40);
+    NeuralAccumulator accumulator(network, board);
+
+    for (auto _ : state)
+    {
+        for (int col = 0; col < 15; col++)
+        {
+            if (board.getStone(0, col) != Stone::EMPTY)
+                continue;
+            accumulator.addStone(0, col, Stone::BLACK);
+            benchmark::DoNotOptimize(accumulator.evaluate(Stone::WHITE));
+            accumulator.removeStone(0, col, Stone::BLACK);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 15);
+}
+BENCHMARK(BM_NeuralIncremental);
+
+// 盤面全体からアキュムレータを作り直す
+static void BM_NeuralRefresh(benchmark::State &state)
+{
+    NeuralNetwork network = NeuralNetwork::random(15, 1);
+    Board board = boardFromGame(15, 40);
+    NeuralAccumulator accumulator(network, board);
+
+    for (auto _ : state)
+    {
+        accumulator.refresh(board);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NeuralRefresh);
+
+// 複数のスレッドから BatchEvaluator に1局面ずつ渡す（バッチの大きさはスレッド数）
+static void BM_NeuralBatchEvaluate(benchmark::State &state)
+{
+    static std::unique_ptr<BatchEvaluator> evaluator;
+    if (state.thread_index() == 0)
+    {
+        auto network = std::make_shared<const NeuralNetwork>(NeuralNetwork::random(15, 1));
+        evaluator = std::make_unique<BatchEvaluator>(15, BatchEvaluator::networkEvaluator(network),
+                                                     static_cast<size_t>(state.threads()), 200);
+    }
+    Board board = boardFromGame(15, 40);
+
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(evaluator->evaluate(board, Stone::BLACK));
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0)
+    {
+        BatchEvaluatorStats stats = evaluator->getStats();
+        state.counters["fill"] = stats.fillRate();
+        state.counters["delay_us"] = stats.meanDelayMicroseconds;
+        evaluator.reset();
+    }
+}
+BENCHMARK(BM_NeuralBatchEvaluate)->Threads(1)->Threads(4)->UseRealTime();
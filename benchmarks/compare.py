@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""gomoku_bench の JSON 出力を保存済みのベースラインと比べ、遅くなったベンチマークを報告する。
+
+使い方:
+    gomoku_bench --benchmark_out=current.json --benchmark_out_format=json
+    benchmarks/compare.py benchmarks/baseline.json current.json [--threshold 0.10] [--metric cpu_time]
+    benchmarks/compare.py --update benchmarks/baseline.json current.json   # ベースラインを更新
+
+閾値を超えて遅くなったベンチマークがあれば終了コード 1 を返す。
+"""
+
+import argparse
+import json
+import sys
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_results(path):
+    """Google Benchmark の JSON（またはベースライン）から {名前: {real_time, cpu_time}}（ns）を読む。"""
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+
+    # ベースラインの形式
+    if isinstance(data.get("benchmarks"), dict):
+        return data["benchmarks"]
+
+    results = {}
+    medians = {}
+    for bench in data.get("benchmarks", []):
+        scale = TIME_UNITS.get(bench.get("time_unit", "ns"), 1.0)
+        entry = {
+            "real_time": bench["real_time"] * scale,
+            "cpu_time": bench["cpu_time"] * scale,
+        }
+        # 繰り返し実行した場合は中央値を使う
+        if bench.get("run_type") == "aggregate":
+            if bench.get("aggregate_name") == "median":
+                medians[bench["run_name"]] = entry
+            continue
+        results.setdefault(bench.get("run_name", bench["name"]), entry)
+    results.update(medians)
+    return results
+
+
+def write_baseline(path, results):
+    baseline = {
+        "time_unit": "ns",
+        "benchmarks": {name: {k: round(v, 3) for k, v in entry.items()} for name, entry in sorted(results.items())},
+    }
+    with open(path, "w", encoding="utf-8") as f:
+        json.dump(baseline, f, indent=1, sort_keys=True)
+        f.write("\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare gomoku_bench results against a stored baseline.")
+    parser.add_argument("baseline", help="baseline JSON file")
+    parser.add_argument("current", help="JSON output of gomoku_bench (--benchmark_out_format=json)")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown reported as a regression (default: 0.10 = 10%%)")
+    parser.add_argument("--metric", choices=["cpu_time", "real_time"], default="cpu_time",
+                        help="time to compare (default: cpu_time)")
+    parser.add_argument("--update", action="store_true", help="overwrite the baseline with the current results")
+    args = parser.parse_args()
+
+    current = load_results(args.current)
+    if args.update:
+        write_baseline(args.baseline, current)
+        print(f"Baseline written to {args.baseline} ({len(current)} benchmarks)")
+        return 0
+
+    baseline = load_results(args.baseline)
+    regressions = []
+    print(f"{'Benchmark':<44} {'Baseline':>12} {'Current':>12} {'Change':>8}")
+    for name in sorted(baseline):
+        if name not in current:
+            print(f"{name:<44} {'':>12} {'missing':>12}")
+            continue
+        before = baseline[name][args.metric]
+        after = current[name][args.metric]
+        change = (after - before) / before if before > 0 else 0.0
+        mark = ""
+        if change > args.threshold:
+            regressions.append(name)
+            mark = "  REGRESSION"
+        print(f"{name:<44} {before:>10.0f}ns {after:>10.0f}ns {change:>+7.1%}{mark}")
+
+    for name in sorted(set(current) - set(baseline)):
+        print(f"{name:<44} {'new':>12} {current[name][args.metric]:>10.0f}ns")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than the baseline by more than {args.threshold:.0%}")
+        return 1
+    print(f"\nNo regressions above {args.threshold:.0%}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
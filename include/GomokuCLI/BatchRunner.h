@@ -0,0 +1,112 @@
+#pragma once
+
+#include "GomokuCLI/CommandTable.h"
+#include "GomokuLib/Game.h"
+#include "GomokuLib/GameJournal.h"
+#include "GomokuLib/MoveSpan.h"
+#include "GomokuLib/NeuralNetwork.h"
+#include "GomokuLib/Search.h"
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// バッチ実行の出力形式
+enum class BatchFormat
+{
+    TEXT, // 1コマンド1行のテキスト
+    JSON  // 1コマンド1行の JSON (JSON Lines)
+};
+
+// 非対話のバッチ実行（スクリプトファイルまたは標準入力のコマンドを順に処理する）
+// 画面のクリアや盤面の再描画は行わず、結果を1行ずつの記録として大きなバッファに書き溜める
+class BatchRunner : private CommandHandler
+{
+private:
+    std::unique_ptr<GomokuLib::GameJournal> journal;         // 操作を追記している記録（ゲームより後に破棄する）
+    std::unique_ptr<GomokuLib::Game> game;                   // ゲームインスタンス
+    std::shared_ptr<const GomokuLib::NeuralNetwork> network; // 探索の評価に使うネットワーク（なければ手書きの評価）
+    std::optional<GomokuLib::SearchResult> analysis;         // 直前の analyze の結果
+    BatchFormat format;                                      // 出力形式
+    int outputFd;                                            // 出力先
+    std::string output;                                      // 出力バッファ
+    CommandArgs tokens;                                      // 処理中の行のトークン（行ごとの確保を避けるため使い回す）
+    bool isRunning;                                          // exit/quit を受け取るまで true
+    size_t lineNumber;                                       // 処理中の行番号
+    size_t errorCount;                                       // 失敗したコマンドの数
+
+    // 1行のコマンドを処理
+    void executeLine(std::string_view line);
+
+    // 各コマンドの実装（コマンド表は対話モードと共有する）
+    void handleStart(const CommandArgs &args) override;
+    void handlePlace(const CommandArgs &args) override;
+    void handleShow(const CommandArgs &args) override;
+    void handleMoves(const CommandArgs &args) override;
+    void handleSave(const CommandArgs &args) override;
+    void handleLoad(const CommandArgs &args) override;
+    void handleJournal(const CommandArgs &args) override;
+    void handleUndo(const CommandArgs &args) override;
+    void handleRedo(const CommandArgs &args) override;
+    void handleGoto(const CommandArgs &args) override;
+    void handleVariations(const CommandArgs &args) override;
+    void handleVariation(const CommandArgs &args) override;
+    void handlePrune(const CommandArgs &args) override;
+    void handleGo(const CommandArgs &args) override;
+    void handleAnalyze(const CommandArgs &args) override;
+    void handleAnalyzeGame(const CommandArgs &args);
+    void handleAnalysis(const CommandArgs &args) override;
+    void handleStop(const CommandArgs &args) override;
+    void handlePerft(const CommandArgs &args) override;
+    void handleStats(const CommandArgs &args) override;
+    void handleTrace(const CommandArgs &args) override;
+    void handleExit(const CommandArgs &args) override;
+    void handleHelp(const CommandArgs &args) override;
+
+    // variation <n> / prune <n> の共通部分
+    void switchVariation(const CommandArgs &args, bool prune);
+
+    // [depth] の引数を読む（不正なら記録して false）
+    bool parseDepth(std::string_view command, const CommandArgs &args, size_t index, int &depth);
+
+    // 記録を閉じる（追記した操作を同期してから閉じる）
+    void closeJournal();
+
+    // 結果の記録
+    void beginRecord(std::string_view command, bool ok);
+    void endRecord();
+    void appendField(std::string_view key, long long value);
+    void appendField(std::string_view key, std::string_view value);
+    void appendMoves(std::string_view key, GomokuLib::MoveSpan moves);
+    void recordAnalysis(std::string_view command);
+    void appendJsonString(std::string_view value);
+    void recordError(std::string_view command, std::string_view error);
+    bool requireGame(std::string_view command);
+
+    // バッファが大きくなったら書き出す
+    void flushIfNeeded();
+    void flush();
+
+    // 受信済みのデータから完全な行を処理し、処理したバイト数を返す
+    size_t processBuffer(std::string_view data);
+
+public:
+    // コンストラクタ
+    BatchRunner(BatchFormat format, int outputFd);
+
+    // デストラクタ（残りの出力を書き出す）
+    ~BatchRunner();
+
+    // スクリプトファイルのコマンドを実行
+    void runFile(const std::string &filepath);
+
+    // 探索に使うニューラルネットワークを設定する
+    void setNetwork(std::shared_ptr<const GomokuLib::NeuralNetwork> value);
+
+    // ファイルディスクリプタから読み込んだコマンドを実行（標準入力など）
+    void runStream(int inputFd);
+
+    // 失敗したコマンドの数
+    size_t getErrorCount() const;
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "GomokuLib/GameClock.h"
+#include <string_view>
+#include <vector>
+
+// コマンドの引数（先頭はコマンド名。入力の行を指すので、その行を処理し終えるまで有効）
+using CommandArgs = std::vector<std::string_view>;
+
+// コマンドの実装（対話モードとバッチ実行）
+// 両方が全てのコマンドを実装し、違うのは出力の形式だけにする
+// （コマンド表にコマンドを追加すると、両方で実装するまでコンパイルできない）
+class CommandHandler
+{
+public:
+    virtual ~CommandHandler() = default;
+
+    virtual void handleStart(const CommandArgs &args) = 0;
+    virtual void handlePlace(const CommandArgs &args) = 0;
+    virtual void handleShow(const CommandArgs &args) = 0;
+    virtual void handleMoves(const CommandArgs &args) = 0;
+    virtual void handleSave(const CommandArgs &args) = 0;
+    virtual void handleLoad(const CommandArgs &args) = 0;
+    virtual void handleJournal(const CommandArgs &args) = 0;
+    virtual void handleUndo(const CommandArgs &args) = 0;
+    virtual void handleRedo(const CommandArgs &args) = 0;
+    virtual void handleGoto(const CommandArgs &args) = 0;
+    virtual void handleVariations(const CommandArgs &args) = 0;
+    virtual void handleVariation(const CommandArgs &args) = 0;
+    virtual void handlePrune(const CommandArgs &args) = 0;
+    virtual void handleGo(const CommandArgs &args) = 0;
+    virtual void handleAnalyze(const CommandArgs &args) = 0;
+    virtual void handleAnalysis(const CommandArgs &args) = 0;
+    virtual void handleStop(const CommandArgs &args) = 0;
+    virtual void handlePerft(const CommandArgs &args) = 0;
+    virtual void handleStats(const CommandArgs &args) = 0;
+    virtual void handleTrace(const CommandArgs &args) = 0;
+    virtual void handleExit(const CommandArgs &args) = 0;
+    virtual void handleHelp(const CommandArgs &args) = 0;
+};
+
+// コマンドの定義
+struct CommandSpec
+{
+    std::string_view name;                                   // コマンド名（小文字）
+    std::string_view usage;                                  // help に表示する使い方（空なら help に表示しない別名）
+    std::string_view description;                            // help に表示する説明
+    void (CommandHandler::*handler)(const CommandArgs &args); // 実装
+};
+
+// 対話モードとバッチ実行で共有するコマンド表と、引数の解釈
+class CommandTable
+{
+public:
+    // 入力から着手までの遅れに備えて、エンジンが1手ごとに残しておく時間（ミリ秒）
+    static constexpr int64_t MOVE_OVERHEAD_MS = 20;
+
+    // 全てのコマンド（help に表示する順。使い方が複数あるコマンドは同じ名前で続けて並べ、実装は先頭のものを使う）
+    static const std::vector<CommandSpec> &getCommands();
+
+    // コマンド名から定義を探す（大文字小文字を区別しない。なければ nullptr）
+    static const CommandSpec *find(std::string_view name);
+
+    // 空白区切りで分割する（tokens は呼び出しごとの確保を避けるため使い回す）
+    static void tokenize(std::string_view line, CommandArgs &tokens);
+
+    // 大文字小文字を区別せずに比較（keyword は小文字）
+    static bool equalsIgnoreCase(std::string_view token, std::string_view keyword);
+
+    // 整数に変換（全体が数字でなければ false）
+    static bool parseInt(std::string_view text, int &value);
+
+    // "<秒>[+<増分の秒>]" 形式の持ち時間を読む（小数も可）
+    static bool parseTimeControl(std::string_view text, GomokuLib::TimeControl &control);
+};
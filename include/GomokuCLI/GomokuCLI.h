@@ -1,52 +1,90 @@
 #pragma once
 
+#include "GomokuCLI/CommandTable.h"
+#include "GomokuCLI/TerminalRenderer.h"
+#include "GomokuLib/Analyzer.h"
+#include "GomokuLib/GameAnalyzer.h"
 #include "GomokuLib/Game.h"
+#include "GomokuLib/GameJournal.h"
+#include "GomokuLib/NeuralNetwork.h"
 #include <string>
 #include <vector>
 #include <memory>
-#include <functional>
-#include <map>
 
-class GomokuCLI
+class GomokuCLI : private CommandHandler
 {
 private:
-    std::unique_ptr<GomokuLib::Game> game; // ゲームインスタンス
-    bool isRunning;                        // アプリケーションの実行状態
-    bool gameLoaded;                       // ゲームがロードされているか
+    std::unique_ptr<GomokuLib::GameJournal> journal; // 操作を追記している記録（ゲームより後に破棄する）
+    std::unique_ptr<GomokuLib::Game> game;           // ゲームインスタンス
+    bool isRunning;                                  // アプリケーションの実行状態
+    bool gameLoaded;                                 // ゲームがロードされているか
+    TerminalRenderer renderer;                       // 盤面の描画
 
-    // コマンドハンドラーの型定義
-    using CommandHandler = std::function<void(const std::vector<std::string> &)>;
+    GomokuLib::Analyzer analyzer;                        // バックグラウンドの解析
+    GomokuLib::AnalysisHandle analysis;                  // 実行中または直前の解析
+    std::vector<std::pair<int, int>> analysisMoves;      // 解析を始めた局面の棋譜
+    bool analysisReported;                               // 解析の完了を表示済みか
+    std::shared_ptr<const GomokuLib::NeuralNetwork> network; // 解析の評価に使うネットワーク（なければ手書きの評価）
 
-    // コマンドとハンドラーのマッピング
-    std::map<std::string, CommandHandler> commandHandlers;
-
-    // コマンド実行のヘルパーメソッド
-    void registerCommands();
-    std::vector<std::string> parseCommand(const std::string &input);
-    bool executeCommand(const std::vector<std::string> &tokens);
+    // コマンド実行のヘルパーメソッド（コマンド表はバッチ実行と共有する）
+    bool executeCommand(const CommandArgs &tokens);
 
     // 各コマンドの実装
-    void handleStart(const std::vector<std::string> &args);
-    void handlePlace(const std::vector<std::string> &args);
-    void handleShow(const std::vector<std::string> &args);
-    void handleMoves(const std::vector<std::string> &args);
-    void handleSave(const std::vector<std::string> &args);
-    void handleLoad(const std::vector<std::string> &args);
-    void handleUndo(const std::vector<std::string> &args);
-    void handleExit(const std::vector<std::string> &args);
-    void handleHelp(const std::vector<std::string> &args);
+    void handleStart(const CommandArgs &args) override;
+    void handlePlace(const CommandArgs &args) override;
+    void handleShow(const CommandArgs &args) override;
+    void handleMoves(const CommandArgs &args) override;
+    void handleSave(const CommandArgs &args) override;
+    void handleLoad(const CommandArgs &args) override;
+    void handleJournal(const CommandArgs &args) override;
+    void handleUndo(const CommandArgs &args) override;
+    void handleRedo(const CommandArgs &args) override;
+    void handleGoto(const CommandArgs &args) override;
+    void handleVariations(const CommandArgs &args) override;
+    void handleVariation(const CommandArgs &args) override;
+    void handlePrune(const CommandArgs &args) override;
+    void handleGo(const CommandArgs &args) override;
+    void handleAnalyze(const CommandArgs &args) override;
+    void handleAnalyzeGame(const CommandArgs &args);
+    void handleAnalysis(const CommandArgs &args) override;
+    void handleStop(const CommandArgs &args) override;
+    void handlePerft(const CommandArgs &args) override;
+    void handleStats(const CommandArgs &args) override;
+    void handleTrace(const CommandArgs &args) override;
+    void handleExit(const CommandArgs &args) override;
+    void handleHelp(const CommandArgs &args) override;
 
     // ユーティリティメソッド
-    void displayBoard() const;
+    void closeJournal();
+    void displayBoard();
     void displayGameStatus() const;
+    void displayMoveResult(GomokuLib::MoveResult result, const std::string &message);
     void displayMoves() const;
     void clearScreen() const;
+    std::string statusText() const;
+    std::string clockText() const;
     std::string stoneToString(GomokuLib::Stone stone) const;
 
+    // 解析の状態を確認し、完了していればプロンプトの前に結果を表示する
+    // 局面が変わった場合は解析をキャンセルする
+    void pollAnalysis();
+    bool isAnalyzedPosition() const;
+    std::string formatAnalysis(const GomokuLib::SearchResult &result) const;
+
+    // 対局全体の解析結果の表示
+    void printGameReport(const GomokuLib::GameAnalysis &analysis, double seconds) const;
+    void printGameReportJson(const GomokuLib::GameAnalysis &analysis, double seconds) const;
+
 public:
     // コンストラクタ
     GomokuCLI();
 
+    // デストラクタ（実行中の解析をキャンセルする）
+    ~GomokuCLI();
+
+    // 解析に使うニューラルネットワークを設定する
+    void setNetwork(std::shared_ptr<const GomokuLib::NeuralNetwork> value);
+
     // メインループ
     void run();
 
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "GomokuLib/Game.h"
+#include "GomokuLib/TimeManager.h"
+#include <chrono>
+#include <istream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Gomocup / Piskvork のエンジンプロトコル
+// 標準入力からコマンドを読み、標準出力に応答だけを書き出す（画面のクリアや盤面表示はしない）
+class PiskvorkProtocol
+{
+private:
+    std::unique_ptr<GomokuLib::Game> game; // 対局（START で作成）
+    std::istream &input;                   // コマンドの入力元
+    int outputFd;                          // 応答の出力先
+    std::string output;                    // 送信前の応答
+    bool isRunning;                        // END を受け取るまで true
+
+    // 時間設定（ミリ秒、INFO で更新される）
+    long long timeoutTurn;  // 1手の制限時間（0 なら即答）
+    long long timeoutMatch; // 対局全体の制限時間（0 なら無制限）
+    long long timeLeft;     // 対局の残り時間
+    std::chrono::steady_clock::time_point turnStart; // コマンドを受け取った時刻
+
+    // BOARD コマンドの受信中か、その間に受け取った石
+    bool readingBoard;
+    std::vector<std::pair<int, int>> boardOwn;
+    std::vector<std::pair<int, int>> boardOpponent;
+
+    // コマンドの処理
+    void handleLine(const std::string &line);
+    void handleStart(const std::string &args);
+    void handleTurn(const std::string &args);
+    void handleBegin();
+    void handleBoardLine(const std::string &line);
+    void handleInfo(const std::string &args);
+    void handleTakeback(const std::string &args);
+    void handleRestart();
+    void handleAbout();
+
+    // 自分の手を決めて応答する
+    void playOwnMove();
+
+    // 黒番と白番の石から対局を組み立て直す（黒から交互に並べる）
+    bool rebuildGame(const std::vector<std::pair<int, int>> &black, const std::vector<std::pair<int, int>> &white);
+
+    // この手番で使える時間（timeout_turn を1手の上限、timeout_match を持ち時間、time_left を残り時間として決める）
+    GomokuLib::TimeBudget turnBudget() const;
+
+    // "x,y" 形式の座標を (行, 列) に変換
+    static bool parseCoordinate(const std::string &text, int &row, int &col);
+
+    // 応答の追加と送信
+    void respond(const std::string &line);
+    void flush();
+
+public:
+    // コンストラクタ
+    PiskvorkProtocol(std::istream &input, int outputFd);
+
+    // END を受け取るか入力が終わるまでコマンドを処理する
+    void run();
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "GomokuLib/Board.h"
+#include <string>
+#include <vector>
+
+// 端末への盤面描画
+// 端末（TTY）では盤面を画面上部に固定し、前回の描画との差分だけを ANSI エスケープシーケンスで書き換える
+// それ以外（パイプやファイル）では従来通り盤面全体を出力する
+class TerminalRenderer
+{
+private:
+    int outputFd;             // 出力先
+    bool interactive;         // 出力先が ANSI に対応した端末か
+    bool layoutReady;         // 盤面を固定した画面レイアウトを描画済みか
+    int terminalRows;         // 端末の行数
+    int terminalCols;         // 端末の桁数
+    int frameSize;            // 前回描画した盤面のサイズ
+    std::vector<char> frame;  // 前回描画した各マスの文字
+    std::string frameStatus;  // 前回描画した状態行
+    std::string buffer;       // 1フレーム分の出力
+
+    // 端末の大きさを取得し、変わっていれば true を返す
+    bool updateTerminalSize();
+
+    // 盤面が端末に収まるか
+    bool fitsTerminal(int size) const;
+
+    // 画面を消して盤面と状態行を描き、その下をスクロール領域にする
+    void drawLayout(const GomokuLib::Board &board, const std::string &status);
+
+    // 変化したマスと状態行だけを書き換える
+    void drawDiff(const GomokuLib::Board &board, const std::string &status);
+
+    // 盤面全体をテキストとして出力する（TTY でない場合）
+    void drawPlain(const GomokuLib::Board &board);
+
+    // カーソルを画面上の位置（1始まり）に移動するシーケンスを追加
+    void appendCursorMove(int line, int column);
+
+    // バッファを1回の write で書き出す
+    void writeFrame();
+
+public:
+    // コンストラクタ
+    explicit TerminalRenderer(int outputFd);
+
+    // デストラクタ（スクロール領域を元に戻す）
+    ~TerminalRenderer();
+
+    TerminalRenderer(const TerminalRenderer &) = delete;
+    TerminalRenderer &operator=(const TerminalRenderer &) = delete;
+
+    // 差分描画を使うか
+    bool isInteractive() const;
+
+    // 盤面と状態行を描画する（TTY でない場合、状態行は呼び出し側が出力する）
+    void render(const GomokuLib::Board &board, const std::string &status);
+
+    // 次の描画で画面全体を描き直す
+    void invalidate();
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QObject>
+#include <QMetaType>
+#include "GomokuLib/Analyzer.h"
+#include "GomokuLib/GameAnalyzer.h"
+#include <utility>
+#include <vector>
+
+Q_DECLARE_METATYPE(GomokuLib::SearchResult)
+Q_DECLARE_METATYPE(GomokuLib::GameAnalysis)
+
+// GomokuLib::Analyzer の結果を Qt のイベントループに届ける
+// 解析はワーカースレッドで行い、途中経過と完了はキュー接続でこのオブジェクトのスレッドに移してから通知する
+class AnalysisBridge : public QObject
+{
+    Q_OBJECT
+public:
+    explicit AnalysisBridge(QObject *parent = nullptr);
+
+    // デストラクタ（実行中の解析をキャンセルし、ワーカーが終わるのを待つ）
+    ~AnalysisBridge() override;
+
+    // 盤面をコピーして解析を開始する（実行中の解析はキャンセルする）
+    void start(const GomokuLib::Board &board, GomokuLib::Stone player,
+               const GomokuLib::SearchLimits &limits = GomokuLib::SearchLimits());
+
+    // 実行中の解析をキャンセルする（キャンセルした解析の通知は届かない）
+    void cancel();
+
+    // 解析中か
+    bool isRunning() const;
+
+    // 対局全体の解析を開始する（実行中の対局の解析はキャンセルする）
+    void startGame(int boardSize, std::vector<std::pair<int, int>> moves,
+                   const GomokuLib::GameAnalysisOptions &options = GomokuLib::GameAnalysisOptions());
+
+    // 実行中の対局の解析をキャンセルする（キャンセルした解析の通知は届かない）
+    void cancelGame();
+
+signals:
+    // 深さを1つ読み終えるたびに通知
+    void progress(const GomokuLib::SearchResult &partial);
+
+    // 解析が完了したときに通知（cancel で打ち切った場合は通知しない）
+    void finished(const GomokuLib::SearchResult &result);
+
+    // 対局の解析で局面を1つ解析し終えるたびに通知
+    void gameProgress(int done, int total);
+
+    // 対局の解析が完了したときに通知（cancelGame で打ち切った場合や、棋譜が不正な場合は通知しない）
+    void gameFinished(const GomokuLib::GameAnalysis &analysis);
+
+private:
+    GomokuLib::Analyzer analyzer;
+    GomokuLib::AnalysisHandle handle;
+    quint64 generation; // 開始するたびに増やし、古い解析からの通知を捨てる
+
+    // 対局の解析（GameAnalyzer は完了まで戻らないので、専用のスレッドで呼ぶ）
+    GomokuLib::ThreadPool gameWorker;
+    GomokuLib::CancellationToken gameToken;
+    quint64 gameGeneration;
+};
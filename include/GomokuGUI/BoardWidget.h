@@ -1,6 +1,10 @@
 #pragma once
 
 #include <QWidget>
+#include <QPixmap>
+#include <QPointF>
+#include <QRect>
+#include <vector>
 #include "GomokuLib/Board.h"
 
 class BoardWidget : public QWidget
@@ -10,13 +14,54 @@ public:
     explicit BoardWidget(QWidget *parent = nullptr);
     void setBoard(const GomokuLib::Board *board);
 
+    // 指定したマスの石が変わったときに、そのマスだけを描き直す
+    void stoneChanged(int row, int col);
+
+    // 盤面全体を前回の描画と比べ、変わったマスだけを描き直す（棋譜の読み込みや巻き戻しの後）
+    void syncStones();
+
+    // 直近の描画にかかった時間（ミリ秒）
+    double getLastFrameTime() const;
+
 signals:
     void moveSelected(int row, int col);
 
+    // 1回の描画が終わるたびに、かかった時間（ミリ秒）を通知する
+    void frameRendered(double milliseconds);
+
 protected:
     void paintEvent(QPaintEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
 
 private:
     const GomokuLib::Board *board;
-};
\ No newline at end of file
+
+    // 盤面の背景とグリッド線（サイズ変更時だけ作り直す）
+    QPixmap gridLayer;
+
+    // 石だけを描いた透過レイヤー（変わったマスだけ描き直す）
+    QPixmap stoneLayer;
+
+    // 石のレイヤーに描かれている石
+    std::vector<GomokuLib::Stone> drawnStones;
+
+    // ウィジェットの大きさから求めた盤面の配置
+    QPointF origin;   // 左上の交点の位置
+    double cellPitch; // 交点の間隔
+
+    double lastFrameTime;
+
+    // 配置を計算し、両方のレイヤーを作り直す
+    void rebuildLayers();
+
+    // グリッドのレイヤーを描く
+    void paintGridLayer();
+
+    // 石のレイヤーの1マスを描き直し、画面上で描き直す範囲を返す
+    QRect paintStone(int row, int col);
+
+    // マスの中心の位置と、石が占める範囲
+    QPointF cellCenter(int row, int col) const;
+    QRect cellRect(int row, int col) const;
+};
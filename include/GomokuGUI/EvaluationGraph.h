@@ -0,0 +1,39 @@
+#pragma once
+
+#include <QWidget>
+#include "GomokuLib/GameAnalyzer.h"
+
+// 対局の解析結果を、手数ごとの評価値（黒が上）の折れ線で表示する
+// 悪手と勝ちの見逃しには印を付け、クリックした手数を plySelected で通知する
+class EvaluationGraph : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit EvaluationGraph(QWidget *parent = nullptr);
+
+    // 表示する解析結果を設定する
+    void setAnalysis(const GomokuLib::GameAnalysis &analysis);
+
+    // 解析結果を消す
+    void clear();
+
+    // 現在の局面の手数（縦線で示す）
+    void setCurrentPly(int ply);
+
+    QSize sizeHint() const override;
+
+signals:
+    void plySelected(int ply);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+
+private:
+    GomokuLib::GameAnalysis analysis;
+    int currentPly;
+
+    // 手数と評価値を描画位置に変換する
+    double plyToX(int ply) const;
+    double scoreToY(int score) const;
+};
@@ -1,10 +1,15 @@
 #pragma once
 
 #include <QMainWindow>
-#include <QListWidget>
+#include <QListView>
+#include <QLabel>
+#include <QSlider>
 
 #include "GomokuLib/Game.h"
+#include "GomokuGUI/AnalysisBridge.h"
 #include "GomokuGUI/BoardWidget.h"
+#include "GomokuGUI/EvaluationGraph.h"
+#include "GomokuGUI/MoveHistoryModel.h"
 
 class MainWindow : public QMainWindow
 {
@@ -19,12 +24,25 @@ private slots:
     void openGame();
     void saveGame();
     void undoMove();
+    void redoMove();
     void onMovePlayed(int row, int col);
+    void onTimelineMoved(int ply);
+    void requestHint();
+    void onAnalysisProgress(const GomokuLib::SearchResult &partial);
+    void onAnalysisFinished(const GomokuLib::SearchResult &result);
+    void analyzeGame();
+    void onGameAnalysisFinished(const GomokuLib::GameAnalysis &analysis);
 
 private:
     GomokuLib::Game *game;
     BoardWidget *boardWidget;
-    QListWidget *moveHistoryList;
+    QListView *moveHistoryList;
+    MoveHistoryModel *moveHistoryModel;
+    QLabel *frameTimeLabel;
+    QSlider *timelineSlider;
+    QLabel *timelineLabel;
+    AnalysisBridge *analysisBridge;
+    EvaluationGraph *evaluationGraph;
 
     void resetGame(int boardSize = 15);
     void updateUI();
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include "GomokuLib/Game.h"
+
+// 棋譜の一覧を表示するためのモデル
+// 対局の棋譜を直接参照し、表示する文字列は表示されるときにだけ作る
+class MoveHistoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+public:
+    explicit MoveHistoryModel(QObject *parent = nullptr);
+
+    // 表示する対局を設定する（一覧全体を作り直す）
+    void setGame(const GomokuLib::Game *game);
+
+    // 着手や一手戻しの後に呼び、増減した行だけを追加・削除する
+    void sync();
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    const GomokuLib::Game *game;
+    int rows; // ビューに通知済みの行数
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Search.h"
+#include "ThreadPool.h"
+#include <future>
+#include <memory>
+#include <mutex>
+
+namespace GomokuLib
+{
+
+    // 非同期の解析の進み具合を参照・操作するためのハンドル（コピーしても同じ解析を指す）
+    class AnalysisHandle
+    {
+    private:
+        // 解析の共有状態（ワーカーと呼び出し元の両方から参照される）
+        struct State
+        {
+            CancellationToken token;
+            mutable std::mutex mutex;
+            SearchResult latest; // 最後に読み終えた深さの結果
+        };
+
+        std::shared_ptr<State> state;
+        std::shared_future<SearchResult> result;
+
+        friend class Analyzer;
+
+    public:
+        // 空のハンドル（isValid が false）
+        AnalysisHandle() = default;
+
+        // 解析を指しているか
+        bool isValid() const;
+
+        // キャンセルを要求（読み終えた深さまでの結果で完了する）
+        void cancel() const;
+
+        // キャンセルが要求されているか
+        bool isCancelled() const;
+
+        // 解析が完了しているか（待たずに確認する）
+        bool isFinished() const;
+
+        // 完了を待って結果を取得
+        SearchResult wait() const;
+
+        // 途中経過（最後に読み終えた深さの最善手順）
+        SearchResult getLatest() const;
+    };
+
+    // 探索をスレッドプール上で非同期に実行する
+    // コールバックはワーカースレッドから呼ばれるので、UI への反映は呼び出し側でスレッドを移す
+    class Analyzer
+    {
+    public:
+        using ProgressCallback = Search::ProgressCallback;
+        using CompletionCallback = std::function<void(const SearchResult &)>;
+
+    private:
+        ThreadPool pool;
+
+    public:
+        // コンストラクタ（同時に実行する解析の数）
+        explicit Analyzer(size_t threadCount = 1);
+
+        // 盤面をコピーして解析を開始する
+        // onProgress は深さを1つ読み終えるたび、onComplete は完了時（キャンセルされた場合も）に呼ばれる
+        AnalysisHandle analyze(const Board &board, Stone player, const SearchLimits &limits,
+                               ProgressCallback onProgress = nullptr, CompletionCallback onComplete = nullptr);
+
+        // 実行中・待機中の解析が全て完了するまで待つ
+        void waitIdle();
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Board.h"
+#include "LatencyHistogram.h"
+#include "NeuralNetwork.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // まとめて評価する局面（項目ごとに配列を分けた SoA 形式）
+    // 局面 i の黒と白の行のビット列は、それぞれの配列の i * サイズ から並ぶ
+    class EvaluationBatch
+    {
+    private:
+        int boardSize;
+        size_t capacity;
+        size_t count;
+        std::vector<uint64_t> blackRows;
+        std::vector<uint64_t> whiteRows;
+        std::vector<Stone> sidesToMove;
+        std::vector<int> scores;
+
+    public:
+        // コンストラクタ（サイズが BoardScan::MAX_PACKED_SIZE を超える盤面は std::runtime_error）
+        EvaluationBatch(int boardSize, size_t capacity);
+
+        // 空にする・局面を追加する（満杯の場合は追加せずに false）
+        void clear();
+        bool add(const Board &board, Stone sideToMove);
+
+        size_t size() const { return count; }
+        size_t getCapacity() const { return capacity; }
+        int getBoardSize() const { return boardSize; }
+
+        // index 番目の局面
+        const uint64_t *getBlackRows(size_t index) const { return blackRows.data() + index * boardSize; }
+        const uint64_t *getWhiteRows(size_t index) const { return whiteRows.data() + index * boardSize; }
+        Stone getSideToMove(size_t index) const { return sidesToMove[index]; }
+        Stone getStone(size_t index, int row, int col) const;
+
+        // 評価値（手番側から見た値。評価器が書き込む）
+        void setScore(size_t index, int score) { scores[index] = score; }
+        int getScore(size_t index) const { return scores[index]; }
+    };
+
+    // まとめて評価した結果の統計
+    struct BatchEvaluatorStats
+    {
+        size_t batchSize = 0;               // 1回にまとめる局面の上限
+        uint64_t batches = 0;               // 評価器を呼んだ回数
+        uint64_t positions = 0;             // 評価した局面の数
+        uint64_t fullBatches = 0;           // 満杯で評価したバッチの数（残りは期限切れで評価した）
+        double meanDelayMicroseconds = 0.0; // 局面を渡してから評価器が呼ばれるまでの平均
+        double p50DelayMicroseconds = 0.0;
+        double p99DelayMicroseconds = 0.0;
+
+        // バッチの埋まり具合（0〜1）
+        double fillRate() const { return batches > 0 ? static_cast<double>(positions) / (batches * batchSize) : 0.0; }
+    };
+
+    // 探索スレッドから末端の局面を受け取り、まとめて評価器に渡す
+    // 受け取った局面はロックのないキューに積み、専用のスレッドが batchSize 個たまるか、最初の局面から
+    // maxDelayMicroseconds たつまで集めて評価器を1回呼ぶ。待っているスレッドは futex で起こす
+    class BatchEvaluator
+    {
+    public:
+        // バッチの全ての局面に評価値を書き込む（例外を投げると、そのバッチの局面を渡した全てのスレッドに伝わる）
+        using Evaluator = std::function<void(EvaluationBatch &batch)>;
+
+    private:
+        // 評価を待っている局面（渡したスレッドのスタックに置く）
+        struct Request
+        {
+            const Board *board = nullptr;
+            Stone sideToMove = Stone::EMPTY;
+            int score = 0;
+            uint64_t submitted = 0;         // 受け取った時刻（ナノ秒）
+            std::exception_ptr error;
+            std::atomic<uint32_t> state{0}; // 評価待ち・完了・futex で待機中
+            std::atomic<Request *> next{nullptr};
+        };
+
+        int boardSize;
+        size_t batchSize;
+        long long maxDelayMicroseconds;
+        Evaluator evaluator;
+
+        // 複数の生産者と1つの消費者のキュー（生産者は head を交換するだけで積める）
+        std::atomic<Request *> head;
+        Request *tail;
+        Request stub;
+
+        std::atomic<uint32_t> submitted;      // 積んだ数（評価用のスレッドが futex で待つ）
+        std::atomic<bool> dispatcherSleeping; // 評価用のスレッドが待機中か（起こす必要があるか）
+        std::atomic<bool> stopping;
+
+        std::atomic<uint64_t> batchCount;
+        std::atomic<uint64_t> positionCount;
+        std::atomic<uint64_t> fullBatchCount;
+        LatencyHistogram delay; // 受け取ってから評価器が呼ばれるまで（ナノ秒）
+
+        std::thread dispatcher;
+
+        void push(Request *request);
+        Request *pop();
+
+        // 評価用のスレッドのメインループ
+        void dispatchLoop();
+
+        // 次の局面を待つ（deadline は steady_clock のナノ秒、0 なら期限なし）
+        Request *waitForRequest(uint64_t deadline);
+
+        // 結果を書き込んで、待っているスレッドを起こす
+        static void complete(Request *request);
+
+    public:
+        // コンストラクタ（評価用のスレッドを開始する）
+        BatchEvaluator(int boardSize, Evaluator evaluator, size_t batchSize = 64, long long maxDelayMicroseconds = 200);
+
+        // デストラクタ（積まれた局面を評価し終えてからスレッドを止める）
+        ~BatchEvaluator();
+
+        BatchEvaluator(const BatchEvaluator &) = delete;
+        BatchEvaluator &operator=(const BatchEvaluator &) = delete;
+
+        // 局面を渡して、評価されるまで待つ（手番側から見た評価値）
+        int evaluate(const Board &board, Stone sideToMove);
+
+        int getBoardSize() const;
+
+        // 統計の取得と消去
+        BatchEvaluatorStats getStats() const;
+        void resetStats();
+
+        // ニューラルネットワークで評価する評価器
+        static Evaluator networkEvaluator(std::shared_ptr<const NeuralNetwork> network);
+    };
+
+} // namespace GomokuLib
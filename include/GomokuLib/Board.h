@@ -1,17 +1,37 @@
 #pragma once
 
+#include "BoardScan.h"
 #include "Common.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 #include <vector>
 
 namespace GomokuLib
 {
 
+    // 盤面の圧縮表現（1マス2ビット）
+    using BoardSnapshot = std::vector<uint8_t>;
+
     // 盤面を表現するクラス
     class Board
     {
     private:
-        int size;                             // 盤面のサイズ（一辺のマス数）
-        std::vector<std::vector<Stone>> grid; // 盤面の状態
+        int size;                      // 盤面のサイズ（一辺のマス数）
+        int stoneCount;                // 置かれている石の数
+        std::pmr::vector<Stone> cells; // 盤面の状態（行優先で1列に並べる）
+
+        // 盤面全体の走査用に、黒と白の石を1行 64 ビットのビット列で持つ
+        // （黒の行、白の行の順。サイズが BoardScan::MAX_PACKED_SIZE を超える盤面では空）
+        std::pmr::vector<uint64_t> packed;
+
+        // マスの状態
+        Stone &cell(int row, int col) { return cells[static_cast<size_t>(row) * size + col]; }
+        Stone cell(int row, int col) const { return cells[static_cast<size_t>(row) * size + col]; }
+
+        // 石の種類ごとの行のビット列の先頭
+        uint64_t *packedRows(Stone stone);
+        const uint64_t *packedRows(Stone stone) const;
 
         // 指定された位置が盤面内かチェック
         bool isValidPosition(int row, int col) const;
@@ -19,9 +39,30 @@ namespace GomokuLib
         // 勝利判定のためのヘルパーメソッド
         bool checkLine(int row, int col, int dRow, int dCol, Stone stone) const;
 
+        // 5連を探す（ビット列の行をまとめて調べる方法と、マス目を順に調べる方法。見つからなければ EMPTY）
+        Stone findFiveInRows() const;
+        Stone findFiveInGrid() const;
+
     public:
+        // 盤面の領域を確保するアロケータ（std::pmr のコンテナに入れると、コンテナと同じ領域から確保する）
+        using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
         // コンストラクタ
-        Board(int size);
+        Board(int size, const allocator_type &allocator = allocator_type());
+
+        // コピー・ムーブ（アロケータを指定しないコピーは既定の領域から確保する。代入は確保済みの領域を使い回す）
+        Board(const Board &other) = default;
+        Board(const Board &other, const allocator_type &allocator);
+        Board(Board &&other) noexcept = default;
+        Board(Board &&other, const allocator_type &allocator);
+        Board &operator=(const Board &other) = default;
+        Board &operator=(Board &&other) = default;
+
+        allocator_type getAllocator() const;
+
+        // 全ての石を取り除く（サイズを指定すると変える。確保済みの領域は使い回す）
+        void reset();
+        void reset(int newSize);
 
         // 石を配置
         bool placeStone(int row, int col, Stone stone);
@@ -29,14 +70,32 @@ namespace GomokuLib
         // 指定位置の石を取得
         Stone getStone(int row, int col) const;
 
-        // 勝者の判定
+        // 勝者の判定（盤面全体を調べる。複数の5連がある場合は行優先で最初に始まるものの色）
         Stone checkWinner() const;
 
+        // 盤面全体の形の特徴を数える
+        LineFeatures countLineFeatures() const;
+
+        // 指定位置の石を含む5連があるか（最後の着手のみを調べる高速判定）
+        bool checkWinAt(int row, int col) const;
+
         // 盤面が全て埋まっているか
         bool isFull() const;
 
         // 盤面サイズの取得
         int getSize() const;
+
+        // 石の種類ごとの行のビット列（第 c ビットが c 列目。サイズが BoardScan::MAX_PACKED_SIZE を超える盤面では nullptr）
+        const uint64_t *getPackedRows(Stone stone) const;
+
+        // 盤面を圧縮して保存（destination には snapshotSize(getSize()) バイト書き込む）
+        static size_t snapshotSize(int size);
+        BoardSnapshot saveSnapshot() const;
+        void saveSnapshot(uint8_t *destination) const;
+
+        // 保存した盤面に戻す（同じサイズの盤面から保存したものに限る）
+        void restoreSnapshot(const BoardSnapshot &snapshot);
+        void restoreSnapshot(const uint8_t *source);
     };
 
 } // namespace GomokuLib
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CpuDispatch.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // 盤面全体の形の特徴
+    // 縦・横・斜めの全ての5マスの窓のうち、相手の石を含まないものを自分の石の数で分けて数える
+    // black[5] / white[5] は5連（6連以上は含まれる窓の数だけ数える）
+    struct LineFeatures
+    {
+        std::array<uint64_t, 6> black{};
+        std::array<uint64_t, 6> white{};
+    };
+
+    // 1行を 64 ビットのビット列（列 c がビット c）で表した盤面を走査するカーネル
+    // 実装は CpuDispatch の表から選ぶ（命令セットの関数は CpuDispatch と同じもの）
+    class BoardScan
+    {
+    public:
+        // ビット列で表せる盤面の最大サイズ
+        static constexpr int MAX_PACKED_SIZE = 64;
+
+        // 行の配列の末尾に置く 0 の行の数（ベクトルで行をまとめて読んでも範囲外を読まないように）
+        static constexpr int ROW_PADDING = 16;
+
+        // この CPU とビルドで使える最も速い命令セット
+        static SimdLevel detectLevel();
+
+        // この CPU とビルドで使えるか
+        static bool isSupported(SimdLevel level);
+
+        // 使える命令セットの一覧（SCALAR から順に）
+        static std::vector<SimdLevel> supportedLevels();
+
+        // 現在使っている命令セットと、その固定（全てのカーネルを切り替える。使えない命令セットを指定すると std::runtime_error）
+        static SimdLevel getLevel();
+        static void setLevel(SimdLevel level);
+
+        static const char *levelToString(SimdLevel level);
+
+        // 5連の始点の列のビットを行ごとに out に書き出す
+        // own と out は size + ROW_PADDING 行分の領域があり、own の size 行目以降は 0
+        static void findFiveStarts(const uint64_t *own, int size, uint64_t *out);
+
+        // 5マスの窓を自分の石の数ごとに数えて counts[0..5] に加える（own と other は findFiveStarts と同じ形）
+        static void countWindows(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts);
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace GomokuLib
+{
+
+    // 協調的なキャンセルの合図
+    // コピーしたトークンは同じ状態を共有し、どれか1つで cancel すると全てに伝わる
+    class CancellationToken
+    {
+    private:
+        std::shared_ptr<std::atomic<bool>> cancelled;
+
+    public:
+        // コンストラクタ
+        CancellationToken() : cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+        // キャンセルを要求
+        void cancel() const { cancelled->store(true, std::memory_order_relaxed); }
+
+        // キャンセルが要求されているか（処理側が定期的に確認する）
+        bool isCancelled() const { return cancelled->load(std::memory_order_relaxed); }
+    };
+
+} // namespace GomokuLib
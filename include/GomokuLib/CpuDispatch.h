@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // カーネルに使う命令セット
+    enum class SimdLevel
+    {
+        SCALAR, // 64 ビット整数（どの CPU でも動く）
+        SSE2,   // 2行ずつ
+        AVX2,   // 4行ずつ
+        AVX512  // 8行ずつ
+    };
+
+    // 起動後に一度だけ調べた CPU の機能（x86 以外やカーネルを作らないビルドでは全て false）
+    struct CpuFeatures
+    {
+        bool sse2 = false;
+        bool popcnt = false;
+        bool bmi = false;
+        bool avx2 = false;
+        bool avx512f = false;
+    };
+
+    // 命令セットごとのカーネルの切り替え
+    // 盤面の走査・ニューラルネットワークの評価・盤面の対称変換・Zobrist ハッシュの実装を1つの表にまとめて選ぶ
+    // 初めて使うときに CPU を調べて表を決める。環境変数 GOMOKU_SIMD（scalar / sse2 / avx2 / avx512）で上限を指定できる
+    // 指定した命令セットの実装がない種類のカーネルは、それより下の命令セットで最も速い実装を使う
+    class CpuDispatch
+    {
+    public:
+        // 命令セットの上限を指定する環境変数
+        static constexpr const char *ENVIRONMENT_VARIABLE = "GOMOKU_SIMD";
+
+        static const CpuFeatures &getFeatures();
+
+        // この CPU とビルドで使えるか
+        static bool isSupported(SimdLevel level);
+
+        // この CPU とビルドで使える最も速い命令セット
+        static SimdLevel detectLevel();
+
+        // 使える命令セットの一覧（SCALAR から順に）
+        static std::vector<SimdLevel> supportedLevels();
+
+        // 環境変数で指定した命令セット（使えなければそれより下で使える最も速いもの。指定がなければ detectLevel）
+        static SimdLevel defaultLevel();
+
+        // 現在の表の命令セットと、その固定（使えない命令セットを指定すると std::runtime_error）
+        static SimdLevel getLevel();
+        static void setLevel(SimdLevel level);
+
+        // defaultLevel に戻す
+        static void resetLevel();
+
+        // 命令セットの名前と、名前からの変換（知らない名前なら false）
+        static const char *levelToString(SimdLevel level);
+        static bool parseLevel(const std::string &name, SimdLevel &level);
+    };
+
+} // namespace GomokuLib
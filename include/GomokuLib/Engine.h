@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Board.h"
+#include <utility>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // 探索を使わない即答用の着手選択
+    // 各候補点について、自分が置いた場合（攻め）と相手が置いた場合（守り）の形を評価する
+    class Engine
+    {
+    public:
+        // 形の評価値
+        static constexpr int SCORE_FIVE = 1000000;     // 五連
+        static constexpr int SCORE_OPEN_FOUR = 100000; // 両端が空いた四
+        static constexpr int SCORE_FOUR = 10000;       // 片端が空いた四
+        static constexpr int SCORE_OPEN_THREE = 5000;  // 両端が空いた三
+        static constexpr int SCORE_THREE = 500;        // 片端が空いた三
+        static constexpr int SCORE_OPEN_TWO = 200;     // 両端が空いた二
+        static constexpr int SCORE_TWO = 50;           // 片端が空いた二
+        static constexpr int SCORE_ONE = 10;           // 両端が空いた一
+
+        // 指定位置に石を置いた場合にできる形の評価値（4方向の合計）
+        static int scoreMove(const Board &board, int row, int col, Stone stone);
+
+        // 着手候補（既存の石から distance マス以内の空きマス。盤面が空なら中央）
+        static std::vector<std::pair<int, int>> candidateMoves(const Board &board, int distance = 2);
+
+        // 最善と思われる手を選ぶ（打てる場所がなければ (-1, -1)）
+        static std::pair<int, int> chooseMove(const Board &board, Stone player);
+    };
+
+} // namespace GomokuLib
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "Board.h"
+#include "GameClock.h"
+#include "MoveSpan.h"
+#include <cstdint>
+#include <iosfwd>
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <utility>
@@ -8,44 +13,191 @@
 namespace GomokuLib
 {
 
+    class GameJournal;
+    enum class JournalOperation : uint8_t;
+
     // ゲーム全体の進行を管理するクラス
+    // 棋譜は変化（分岐）を含む木として持ち、そのうち1本の手順を現在の棋譜として扱う
     class Game
     {
     private:
-        Board board;                            // 盤面
-        Stone currentPlayer;                    // 現在のプレイヤー
-        std::vector<std::pair<int, int>> moves; // 棋譜 (行, 列)
+        // 変化の木の節点（nodes の添字で互いを指す）
+        struct VariationNode
+        {
+            std::pair<int, int> move; // この節点に至る着手 (行, 列)（根では未使用）
+            uint32_t parent;          // 親（根では NO_NODE）
+            uint32_t firstChild;      // 最初の子（次の手の候補）
+            uint32_t nextSibling;     // 次の兄弟（同じ局面からの別の手）
+            uint32_t selectedChild;   // 現在の棋譜で選ばれている子
+            uint32_t snapshot;        // CHECKPOINT_INTERVAL 手ごとの盤面の snapshots での番号（それ以外は NO_SNAPSHOT）
+        };
+
+        // 操作の記録先（コピーした対局には引き継がない）
+        struct JournalLink
+        {
+            GameJournal *target = nullptr;
+
+            JournalLink() = default;
+            JournalLink(const JournalLink &) {}
+            JournalLink &operator=(const JournalLink &) { return *this; }
+        };
+
+        static constexpr uint32_t NO_NODE = UINT32_MAX;
+        static constexpr uint32_t ROOT_NODE = 0;
+        static constexpr uint32_t NO_SNAPSHOT = UINT32_MAX;
+
+        // 全てのコンテナは同じアロケータから確保する（コピーやムーブでは中身だけを移す）
+        Board board;                                 // 盤面
+        Stone currentPlayer;                         // 現在のプレイヤー
+        Stone winner;                                // 勝者（最後の着手で更新する）
+        std::pmr::vector<VariationNode> nodes;       // 変化の木の節点（解放した節点は freeNodes から再利用する）
+        std::pmr::vector<uint32_t> freeNodes;        // 再利用できる節点
+        std::pmr::vector<uint8_t> snapshots;         // 保存した盤面（Board::snapshotSize バイトずつ並べる）
+        std::pmr::vector<uint32_t> freeSnapshots;    // 再利用できる盤面の番号
+        std::pmr::vector<uint32_t> path;             // 現在の棋譜の節点（path[0] は根）
+        std::pmr::vector<std::pair<int, int>> moves; // 現在の棋譜 (行, 列)（path[1..] の着手、戻した手も含む）
+        size_t ply;                                  // 盤面に置かれている手数（moves の先頭から）
+        JournalLink journal;                         // 操作を追記する記録（なければ記録しない）
+        GameClock clock;                             // 対局時計（持ち時間を設定しなければ動かない）
+
+        // 記録が設定されていれば操作を追記する
+        void record(JournalOperation operation, int first = 0, int second = 0);
+
+        // undoMove と jumpTo の本体（他の操作の途中で呼んでも記録しない）
+        bool stepBack();
+        bool moveTo(size_t targetPly);
+
+        // 手数 index の着手の石（黒から交互）
+        static Stone stoneForPly(size_t index);
+
+        // 盤面上の石の並びから勝者と手番を求め直す
+        void updateStateAfterJump();
+
+        // 根の節点と初期局面を作る
+        void initializeRoot();
+
+        // 現在の盤面を保存して番号を返す
+        uint32_t storeSnapshot();
+
+        // 節点の確保と、部分木の解放
+        uint32_t allocateNode(uint32_t parent, int row, int col);
+        void releaseSubtree(uint32_t node);
+
+        // 現在の局面の子を、その先の手順ごと木から取り除く
+        void removeChild(uint32_t child);
+
+        // 節点の子のうち、指定した着手の子・指定した順番の子を探す（なければ NO_NODE）
+        uint32_t findChild(uint32_t node, int row, int col) const;
+        uint32_t childAt(uint32_t node, size_t index) const;
+
+        // 現在の局面より先の棋譜を、子を選び直した手順に置き換える
+        void rebuildLineFrom(uint32_t child);
+
+        // 棋譜の末尾から、選ばれている子をたどって棋譜を伸ばす
+        void extendLine();
 
     public:
+        // 盤面を保存する間隔（任意の手数への移動は最大でこの手数の再生で済む）
+        static constexpr size_t CHECKPOINT_INTERVAL = 16;
+
+        // 棋譜と盤面の領域を確保するアロケータ（std::pmr のコンテナに入れると、コンテナと同じ領域から確保する）
+        using allocator_type = Board::allocator_type;
+
         // コンストラクタ
-        Game(int boardSize);
+        Game(int boardSize, const allocator_type &allocator = allocator_type());
+
+        // コピー・ムーブ（アロケータを指定しないコピーは既定の領域から確保する。代入は確保済みの領域を使い回す）
+        Game(const Game &other) = default;
+        Game(const Game &other, const allocator_type &allocator);
+        Game(Game &&other) = default;
+        Game(Game &&other, const allocator_type &allocator);
+        Game &operator=(const Game &other) = default;
+        Game &operator=(Game &&other) = default;
+
+        allocator_type getAllocator() const;
+
+        // 初期局面に戻し、棋譜も変化も消す（サイズを指定すると変える。確保済みの領域は使い回す）
+        void reset();
+        void reset(int boardSize);
 
         // 現在のプレイヤーが指定位置に石を置く
+        // 途中の局面で棋譜と違う手を打つと新しい変化になり、元の手順は別の変化として残る
         MoveResult playTurn(int row, int col);
 
+        // 持ち時間を設定する（両者の時計を初期値に戻して止める。時間制限のない TimeControl で外す）
+        void setTimeControl(const TimeControl &control);
+
+        // 対局時計（startClock を呼ぶか、最初に着手したときから動く。着手のたびに相手の時計に切り替わる）
+        const GameClock &getClock() const;
+        GameClock &getClock();
+
+        // 手番側の時計を動かす
+        void startClock();
+
+        // 手番側の時間が尽きていれば時間切れとして終局にする（時間切れで終局していれば true）
+        // 時間切れは一手戻しても取り消さない（setTimeControl か reset で消える）
+        bool checkTime();
+
         // 現在のプレイヤーを取得
         Stone getCurrentPlayer() const;
 
         // 盤面を取得
         const Board &getBoard() const;
 
-        // ゲームが終了しているか
+        // ゲームが終了しているか（時間切れを含む）
         bool isGameOver() const;
 
-        // 勝者を取得
+        // 勝者を取得（時間切れなら相手の勝ち）
         Stone getWinner() const;
 
-        // 棋譜を取得
+        // 棋譜を取得（盤面に置かれている手のみ）
         std::vector<std::pair<int, int>> getMoves() const;
 
-        // 一手戻す
+        // 棋譜をコピーせずに参照する（次の着手または一手戻しまで有効）
+        MoveSpan getMoveView() const;
+
+        // 戻した手も含む現在の棋譜全体を参照する
+        MoveSpan getLineView() const;
+
+        // 盤面に置かれている手数
+        size_t getPly() const;
+
+        // 一手戻す（戻した手は棋譜に残り、redoMove や jumpTo で再び進められる）
         bool undoMove();
 
+        // 一手戻し、戻した手をその先の手順ごと棋譜から消す（以前の一手戻しと同じ動作）
+        bool takeBackMove();
+
+        // 戻した手を一手進める
+        bool redoMove();
+
+        // 現在の棋譜の指定した手数の局面に移動する（0 は初期局面、棋譜の長さを超える場合は false）
+        bool jumpTo(size_t targetPly);
+
+        // 現在の局面から打たれたことのある次の手（変化）の一覧
+        std::vector<std::pair<int, int>> getVariations() const;
+
+        // 次の手として index 番目の変化を選び、それ以降の棋譜をその変化の手順に切り替える（盤面は変わらない）
+        bool selectVariation(size_t index);
+
+        // 現在の局面からの index 番目の変化を、その先の手順ごと削除する
+        bool pruneVariation(size_t index);
+
+        // 変化の木に含まれる着手の数
+        size_t getVariationNodeCount() const;
+
+        // 棋譜を変える操作を追記する記録を設定する（nullptr で外す。記録は対局より後まで残すこと）
+        void setJournal(GameJournal *value);
+        GameJournal *getJournal() const;
+
         // 棋譜からゲームを復元
         static Game loadGame(const std::string &filepath);
+        static Game loadGame(std::istream &in);
 
-        // 現在の棋譜を保存
+        // 現在の棋譜を保存（変化がある場合は VARIATIONS: 以降に木全体も書き出す）
+        // ファイルには一時ファイルに書いてから置き換えるので、途中で落ちても元のファイルは壊れない
         void saveGame(const std::string &filepath) const;
+        void saveGame(std::ostream &out) const;
     };
 
 } // namespace GomokuLib
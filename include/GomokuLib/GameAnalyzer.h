@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Engine.h"
+#include "Game.h"
+#include "MoveSpan.h"
+#include "Search.h"
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // 着手の判定
+    enum class MoveJudgement
+    {
+        NONE,       // 問題なし
+        BLUNDER,    // 評価値を大きく下げた
+        MISSED_WIN  // 勝ちを読み切れる局面で、勝ちにならない手を打った
+    };
+
+    // 1手ごとの解析結果（評価値は着手した側から見た値）
+    struct MoveAnalysis
+    {
+        int ply = 0;                          // 何手目か（1始まり）
+        Stone player = Stone::EMPTY;          // 着手した側
+        std::pair<int, int> move{-1, -1};     // 打った手
+        std::pair<int, int> bestMove{-1, -1}; // 探索で最善とされた手
+        int scoreBefore = 0;                  // 着手前の局面の評価値（depth 手読んだ値）
+        int scoreAfter = 0;                   // 着手後の局面の評価値（depth - 1 手読んだ値）
+        long long loss = 0;                   // 評価値の下がり幅（0 以上）
+        MoveJudgement judgement = MoveJudgement::NONE;
+    };
+
+    // 対局全体の解析結果
+    struct GameAnalysis
+    {
+        int boardSize = 0;
+        std::vector<int> evaluations;    // 各局面（0 は初期局面）の黒から見た評価値（最後の2つの深さの平均）
+        std::vector<int> depths;         // 各局面を読み終えた深さ（終局した局面と、予算内に1手も読めなかった局面では 0）
+        std::vector<MoveAnalysis> moves; // 各着手の解析結果
+        uint64_t nodes = 0;              // 調べた局面の合計
+        bool completed = false;          // 全ての局面を解析し終えたか（キャンセルされると false）
+    };
+
+    // 対局解析の条件
+    struct GameAnalysisOptions
+    {
+        SearchLimits limits;                               // 1局面あたりの探索の予算（maxDepth は 2 以上に切り上げる）
+        long long blunderThreshold = Engine::SCORE_OPEN_FOUR; // この値以上評価値を下げた手を悪手とする
+        size_t threadCount = 0;                            // 同時に解析する局面の数（0 はハードウェアスレッド数）
+        size_t tableEntries = size_t(1) << 20;             // 共有する置換表のエントリ数
+
+        // コンストラクタ（既定の予算は深さ 4、候補手 12、1局面 20 万局面まで）
+        GameAnalysisOptions()
+        {
+            limits.maxDepth = 4;
+            limits.maxCandidates = 12;
+            limits.maxNodes = 200000;
+        }
+    };
+
+    // 対局の全ての局面を並列に評価し、悪手と勝ちの見逃しを検出する
+    // 局面ごとに独立したタスクとしてスレッドプールで探索し、置換表を共有して隣り合う局面で読みを再利用する
+    class GameAnalyzer
+    {
+    public:
+        // 局面を1つ解析し終えるたびに（ワーカースレッドから）呼ばれる
+        using ProgressCallback = std::function<void(size_t done, size_t total)>;
+
+        // 初期局面から moves の順に打った対局を解析する
+        static GameAnalysis analyze(int boardSize, MoveSpan moves, const GameAnalysisOptions &options = GameAnalysisOptions(),
+                                    const CancellationToken &token = CancellationToken(),
+                                    const ProgressCallback &onProgress = nullptr);
+
+        // 対局の現在の棋譜を解析する
+        static GameAnalysis analyze(const Game &game, const GameAnalysisOptions &options = GameAnalysisOptions(),
+                                    const CancellationToken &token = CancellationToken(),
+                                    const ProgressCallback &onProgress = nullptr);
+
+        // 判定を文字列に変換
+        static const char *judgementToString(MoveJudgement judgement);
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Common.h"
+#include <chrono>
+#include <cstdint>
+
+namespace GomokuLib
+{
+
+    // 持ち時間の設定（ミリ秒）
+    struct TimeControl
+    {
+        int64_t initialMs = 0;   // 対局開始時の持ち時間（0 は時間制限なし）
+        int64_t incrementMs = 0; // 1手指すごとに加える時間（フィッシャー方式）
+        int64_t maxMoveMs = 0;   // 1手に使える時間の上限（0 は上限なし）
+        int64_t overheadMs = 0;  // 通信や描画の遅れに備えて、1手ごとに残しておく時間
+
+        bool isTimed() const { return initialMs > 0; }
+    };
+
+    // 対局時計（黒と白の残り時間。時刻は全て steady_clock で測る）
+    // 動いているのは手番側の時計だけで、press で止めると増分を加えて相手の時計を動かす
+    class GameClock
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+
+    private:
+        TimeControl control;
+        int64_t remaining[2]; // 黒・白の残り（最後に時計を止めた時点、ミリ秒）
+        Stone running;        // 時計が動いている側（止まっていれば EMPTY）
+        TimePoint turnStart;  // running の時計を動かした時刻
+        Stone flagged;        // 時間切れになった側（なければ EMPTY）
+
+        static int indexOf(Stone player) { return player == Stone::WHITE ? 1 : 0; }
+
+        // running の時計を止めて使った時間を差し引く
+        void chargeRunning(TimePoint now);
+
+    public:
+        // コンストラクタ（時間制限なし）
+        GameClock();
+
+        // コンストラクタ（両者に持ち時間を設定して止めておく）
+        explicit GameClock(const TimeControl &control);
+
+        const TimeControl &getControl() const;
+        bool isTimed() const;
+
+        // 両者の残り時間を初期値に戻して止める
+        void reset();
+
+        // player の時計を動かす（動いている時計があれば、その側の使った時間を差し引いてから切り替える）
+        void start(Stone player, TimePoint now = Clock::now());
+
+        // 時計を止める（動いていた側の使った時間を差し引く）
+        void stop(TimePoint now = Clock::now());
+
+        // player が指し終えたときに呼ぶ（使った時間を差し引き、増分を加えて相手の時計を動かす）
+        // 時間が足りなければ時間切れとして記録し false を返す
+        bool press(Stone player, TimePoint now = Clock::now());
+
+        // player の残り時間（動いている時計は now までの経過を差し引く。負になることもある）
+        int64_t getRemaining(Stone player, TimePoint now = Clock::now()) const;
+
+        // 動いている時計が now までに使った時間（止まっていれば 0）
+        int64_t getElapsed(TimePoint now = Clock::now()) const;
+
+        // 動いている時計の残りが尽きていれば時間切れとして記録する（時間切れになっている側を返す）
+        Stone checkFlag(TimePoint now = Clock::now());
+
+        // player の残り時間を外から合わせる（対局サーバーが知らせてくる残り時間など。動いている時計は now から測り直す）
+        void setRemaining(Stone player, int64_t milliseconds, TimePoint now = Clock::now());
+
+        bool isRunning() const;
+        Stone getRunning() const;
+
+        // 時間切れになった側（なければ EMPTY）
+        Stone getFlagged() const;
+    };
+
+} // namespace GomokuLib
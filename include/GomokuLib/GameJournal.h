@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Game.h"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace GomokuLib
+{
+
+    // 記録する操作（Game の棋譜を変える公開メソッドに1つずつ対応する）
+    enum class JournalOperation : uint8_t
+    {
+        PLAY = 1,             // playTurn(行, 列)
+        UNDO = 2,             // undoMove()
+        TAKE_BACK = 3,        // takeBackMove()
+        REDO = 4,             // redoMove()
+        JUMP = 5,             // jumpTo(手数)
+        SELECT_VARIATION = 6, // selectVariation(番号)
+        PRUNE_VARIATION = 7,  // pruneVariation(番号)
+        RESET = 8,            // reset(盤面のサイズ)
+    };
+
+    // 記録の設定
+    struct GameJournalOptions
+    {
+        int syncIntervalMs = 10;         // まとめて fdatasync する間隔（この間に追記した操作は1回の同期で済む）
+        size_t compactionRecords = 1024; // この数の操作を追記したら棋譜全体を書き出して記録を空にする（0 はしない）
+    };
+
+    // 記録の状態
+    struct GameJournalStats
+    {
+        uint64_t generation = 0;         // 書き出した棋譜の世代（書き出すたびに増える）
+        uint64_t appended = 0;           // 追記した操作の数
+        uint64_t durable = 0;            // そのうちディスクへの書き込みを確認した数
+        uint64_t syncs = 0;              // fdatasync の回数
+        uint64_t compactions = 0;        // 棋譜全体を書き出した回数
+        size_t recordsSinceSnapshot = 0; // 最後に書き出してから追記した操作の数
+        uint64_t replayed = 0;           // 復元のときに再生した操作の数
+        uint64_t discardedBytes = 0;     // 復元のときに捨てた書きかけの記録の大きさ
+    };
+
+    // 対局を少しずつ追記して保存する記録
+    // 棋譜全体（filepath、saveGame 形式）と、その後の操作の記録（filepath + ".journal"）の2つのファイルを使う
+    // 操作は 8 バイトずつ追記し、専用のスレッドが一定間隔でまとめて fdatasync する
+    // 操作が compactionRecords 個たまると、棋譜全体を一時ファイルに書いて置き換えてから記録を空にする
+    // 途中で落ちても、棋譜全体を読み込んで記録の壊れていない部分を再生すれば直前の状態に戻る
+    class GameJournal
+    {
+    private:
+        std::string snapshotPath;
+        std::string journalPath;
+        GameJournalOptions options;
+        int fd;
+
+        mutable std::mutex mutex;
+        std::condition_variable wake;   // 同期用のスレッドを起こす
+        std::condition_variable synced; // 同期を待っているスレッドを起こす
+        uint64_t waiters;               // sync() で待っているスレッドの数
+        bool stopping;
+        int syncError;                  // 最後に失敗した fdatasync の errno（0 は成功）
+        GameJournalStats stats;
+
+        std::thread syncer;
+
+        // 同期用のスレッドのメインループ
+        void syncLoop();
+
+        // 記録を空にして、世代を書いたヘッダだけにする
+        void resetJournal(uint64_t generation);
+
+        // 棋譜全体を書き出す（一時ファイルに書いて同期してから置き換える）
+        void writeSnapshot(const Game &game, uint64_t generation) const;
+
+    public:
+        // 記録の大きさ（ヘッダと1つの操作）
+        static constexpr size_t HEADER_SIZE = 16;
+        static constexpr size_t RECORD_SIZE = 8;
+
+        // コンストラクタ（ファイルは open で開く）
+        explicit GameJournal(const std::string &filepath, const GameJournalOptions &options = GameJournalOptions());
+
+        // デストラクタ（追記した操作を同期してからスレッドを止める）
+        ~GameJournal();
+
+        GameJournal(const GameJournal &) = delete;
+        GameJournal &operator=(const GameJournal &) = delete;
+
+        // 記録から対局を復元し、続きを追記できるようにする
+        // 棋譜全体のファイルがなければ initial から始める（壊れている場合は std::runtime_error）
+        // 返した対局に Game::setJournal(this) を設定すると、以降の操作が記録される
+        Game open(const Game &initial);
+
+        // 操作を追記する（Game から呼ばれる。compactionRecords に達すると game 全体を書き出す）
+        void append(const Game &game, JournalOperation operation, int first = 0, int second = 0);
+
+        // 棋譜全体を書き出して、記録を空にする
+        void compact(const Game &game);
+
+        // ここまでに追記した操作がディスクに書き込まれるまで待つ（同時に呼んだスレッドは1回の同期で済む）
+        void sync();
+
+        GameJournalStats getStats() const;
+
+        // 操作の記録を変換する・記録から戻す（チェックサムが合わなければ false）
+        static void encode(JournalOperation operation, int first, int second, uint8_t *record);
+        static bool decode(const uint8_t *record, JournalOperation &operation, int &first, int &second);
+
+        // 記録された操作を対局に適用する（適用できなければ false）
+        static bool apply(Game &game, JournalOperation operation, int first, int second);
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Game.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // 観戦者に見せる対局の状態（公開した後は変更しない）
+    struct GameSnapshot
+    {
+        uint64_t version = 0;                  // 公開した順の番号（1 から）
+        int boardSize = 0;
+        Stone currentPlayer = Stone::BLACK;
+        Stone winner = Stone::EMPTY;           // 対局中は EMPTY
+        std::vector<Stone> cells;              // 盤面（行優先）
+        std::vector<std::pair<int, int>> moves; // 盤面に置かれている手
+
+        Stone getStone(int row, int col) const { return cells[static_cast<size_t>(row) * boardSize + col]; }
+    };
+
+    // 対局を進めるスレッドが状態を公開し、多くの観戦スレッドが待たずに読むための仕組み（RCU）
+    // 公開のたびに新しい GameSnapshot を作ってポインタを差し替え、古いものはエポックで回収する
+    // 読む側は自分の枠にエポックを書いてからポインタを読むだけなので、書く側を待たせず、書く側にも待たされない
+    // 公開した側は、古い状態を読んでいる観戦者がいなくなった（全員の枠のエポックが進んだ）ものから再利用する
+    class SnapshotPublisher
+    {
+    private:
+        // 観戦者ごとの枠（別々のキャッシュラインに置く）
+        struct alignas(64) ReaderSlot
+        {
+            std::atomic<uint64_t> epoch{IDLE}; // 読んでいる間は読み始めたときのエポック、それ以外は IDLE
+            std::atomic<bool> claimed{false};  // SnapshotReader が使っているか
+        };
+
+        // 差し替えた古い状態（差し替えたときのエポックより後から読み始めた観戦者しかいなければ再利用できる）
+        struct Retired
+        {
+            GameSnapshot *snapshot;
+            uint64_t epoch;
+        };
+
+        std::unique_ptr<ReaderSlot[]> slots;
+        size_t slotCount;
+        alignas(64) std::atomic<uint64_t> globalEpoch;
+        alignas(64) std::atomic<const GameSnapshot *> current;
+        std::atomic<uint64_t> publishedVersion; // current の版の番号（current は回収されうるので、枠を持たずに読む側はこちらを読む）
+
+        // 以下は公開するスレッドだけが触る
+        std::vector<Retired> retired;
+        std::vector<GameSnapshot *> pool; // 再利用できる状態
+        uint64_t nextVersion;
+
+        // 誰も読んでいない古い状態を pool に戻す
+        void reclaim();
+
+        friend class SnapshotReader;
+
+    public:
+        static constexpr uint64_t IDLE = UINT64_MAX;
+
+        // コンストラクタ（game の状態を最初の版として公開する）
+        explicit SnapshotPublisher(const Game &game, size_t maxReaders = 128);
+
+        // デストラクタ（SnapshotReader は全て先に破棄しておくこと）
+        ~SnapshotPublisher();
+
+        SnapshotPublisher(const SnapshotPublisher &) = delete;
+        SnapshotPublisher &operator=(const SnapshotPublisher &) = delete;
+
+        // 対局の現在の状態を公開する（常に同じ1つのスレッドから呼ぶ）
+        void publish(const Game &game);
+
+        // 最後に公開した版の番号（どのスレッドからでも呼べる）
+        uint64_t getVersion() const;
+
+        // まだ回収していない古い状態の数（公開するスレッドから呼ぶ）
+        size_t getRetiredCount() const;
+
+        size_t getMaxReaders() const;
+    };
+
+    // 観戦者1人分の読み取り口（観戦するスレッドごとに1つ作る）
+    class SnapshotReader
+    {
+    private:
+        SnapshotPublisher *publisher;
+        SnapshotPublisher::ReaderSlot *slot;
+
+    public:
+        // 読んでいる間の状態（破棄するまで snapshot は回収されない。同じ読み取り口では1つずつ使う）
+        class Guard
+        {
+        private:
+            SnapshotPublisher::ReaderSlot *slot;
+            const GameSnapshot *snapshot;
+
+        public:
+            Guard(SnapshotPublisher::ReaderSlot *slot, const GameSnapshot *snapshot) : slot(slot), snapshot(snapshot) {}
+            ~Guard();
+
+            Guard(const Guard &) = delete;
+            Guard &operator=(const Guard &) = delete;
+
+            const GameSnapshot &operator*() const { return *snapshot; }
+            const GameSnapshot *operator->() const { return snapshot; }
+        };
+
+        // コンストラクタ（空いている枠がなければ std::runtime_error）
+        explicit SnapshotReader(SnapshotPublisher &publisher);
+
+        // デストラクタ（枠を返す）
+        ~SnapshotReader();
+
+        SnapshotReader(const SnapshotReader &) = delete;
+        SnapshotReader &operator=(const SnapshotReader &) = delete;
+
+        // 最新の状態を読み始める（待たずに終わる）
+        Guard read();
+    };
+
+} // namespace GomokuLib
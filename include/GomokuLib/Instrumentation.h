@@ -0,0 +1,156 @@
+#pragma once
+
+#include "LatencyHistogram.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 計測の有効・無効（CMake の GOMOKU_INSTRUMENTATION で切り替える）
+// 無効にするとカウンタとタイマーのマクロは空になり、計測のコードは一切残らない
+#ifndef GOMOKU_INSTRUMENTATION
+#define GOMOKU_INSTRUMENTATION 0
+#endif
+
+namespace GomokuLib
+{
+
+    // 処理の回数・量を数えるカウンタ
+    enum class Counter
+    {
+        MOVES_APPLIED, // Game::playTurn で打たれた手
+        WIN_CHECKS,    // 勝敗判定の呼び出し
+        CELLS_SCANNED, // 勝敗判定で調べたマス
+        BYTES_PARSED,  // 読み込んだ棋譜・スクリプトのバイト数
+        COUNT
+    };
+
+    // 計測結果のスナップショット
+    struct InstrumentationSnapshot
+    {
+        // タイマー1つ分の集計（時間はナノ秒）
+        struct TimerStats
+        {
+            std::string name;
+            uint64_t count = 0;
+            double mean = 0.0;
+            uint64_t p50 = 0;
+            uint64_t p90 = 0;
+            uint64_t p99 = 0;
+            uint64_t max = 0;
+            uint64_t total = 0;
+        };
+
+        std::array<uint64_t, static_cast<size_t>(Counter::COUNT)> counters{}; // カウンタの値（Counter の順）
+        std::vector<TimerStats> timers;                                        // タイマー（名前順）
+    };
+
+    // カウンタとタイマーの計測
+    // カウンタはスレッドごとに持ち、自分のスレッドの値だけを書き換えるのでアトミック加算も共有メモリへの書き込みもない
+    // タイマーは名前ごとの LatencyHistogram に記録する
+    class Instrumentation
+    {
+    public:
+        static constexpr bool ENABLED = GOMOKU_INSTRUMENTATION != 0;
+        static constexpr size_t COUNTER_COUNT = static_cast<size_t>(Counter::COUNT);
+
+        // スレッドごとのカウンタ（書き込むのは持ち主のスレッドだけ、集計時に他のスレッドから読む）
+        class ThreadCounters
+        {
+        private:
+            std::array<std::atomic<uint64_t>, COUNTER_COUNT> values;
+
+        public:
+            ThreadCounters();
+            ~ThreadCounters();
+
+            ThreadCounters(const ThreadCounters &) = delete;
+            ThreadCounters &operator=(const ThreadCounters &) = delete;
+
+            void add(Counter counter, uint64_t amount)
+            {
+                auto &value = values[static_cast<size_t>(counter)];
+                value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+            }
+
+            uint64_t get(size_t index) const
+            {
+                return values[index].load(std::memory_order_relaxed);
+            }
+        };
+
+        // 呼び出し元スレッドのカウンタ
+        // 定数で初期化されるポインタだけを毎回見るので、初期化済みかの確認や関数呼び出しが入らない
+        static ThreadCounters &local()
+        {
+            ThreadCounters *counters = current;
+            return counters ? *counters : registerThread();
+        }
+
+    private:
+        // 呼び出し元スレッドのカウンタ（そのスレッドで初めて数えるときに作って登録する）
+        static inline thread_local ThreadCounters *current = nullptr;
+        static ThreadCounters &registerThread();
+
+    public:
+        // 名前付きのタイマーのヒストグラム（初めて使う名前なら作る。参照はプログラムの終了まで有効）
+        static LatencyHistogram &timer(const std::string &name);
+
+        // 全スレッドのカウンタと全てのタイマーを集計する
+        static InstrumentationSnapshot snapshot();
+
+        // カウンタとタイマーを 0 に戻す
+        static void reset();
+
+        // カウンタの名前（Prometheus の名前にも使う）
+        static const char *counterName(Counter counter);
+
+        // JSON と Prometheus のテキスト形式への書き出し
+        static std::string toJson(const InstrumentationSnapshot &snapshot);
+        static std::string toPrometheus(const InstrumentationSnapshot &snapshot);
+    };
+
+    // スコープを抜けるまでの時間をヒストグラムに記録する
+    class ScopedTimer
+    {
+    private:
+        LatencyHistogram &histogram;
+        std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit ScopedTimer(LatencyHistogram &histogram)
+            : histogram(histogram), start(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~ScopedTimer()
+        {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+    };
+
+} // namespace GomokuLib
+
+#define GOMOKU_INSTRUMENTATION_CONCAT_INNER(a, b) a##b
+#define GOMOKU_INSTRUMENTATION_CONCAT(a, b) GOMOKU_INSTRUMENTATION_CONCAT_INNER(a, b)
+
+#if GOMOKU_INSTRUMENTATION
+// カウンタに加える
+#define GOMOKU_COUNT(counter, amount) ::GomokuLib::Instrumentation::local().add(::GomokuLib::Counter::counter, (amount))
+// 固定の名前のタイマーでスコープの時間を計る（ヒストグラムは初回に一度だけ引く）
+#define GOMOKU_TIMED_SCOPE(name)                                                                                         \
+    static ::GomokuLib::LatencyHistogram &GOMOKU_INSTRUMENTATION_CONCAT(gomokuHistogram, __LINE__) =                    \
+        ::GomokuLib::Instrumentation::timer(name);                                                                       \
+    ::GomokuLib::ScopedTimer GOMOKU_INSTRUMENTATION_CONCAT(gomokuTimer, __LINE__)(GOMOKU_INSTRUMENTATION_CONCAT(gomokuHistogram, __LINE__))
+#else
+// 加える量の式は評価しない（使われない変数の警告を出さないように sizeof で参照だけする）
+#define GOMOKU_COUNT(counter, amount) ((void)sizeof(amount))
+#define GOMOKU_TIMED_SCOPE(name) ((void)0)
+#endif
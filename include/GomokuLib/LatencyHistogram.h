@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace GomokuLib
+{
+
+    // 対数・線形バケットのレイテンシヒストグラム（HDR ヒストグラム方式）
+    // 2のべき乗ごとの区間を SUB_BUCKETS 個に等分するので、相対誤差は約 1/SUB_BUCKETS
+    // 記録は relaxed なアトミック加算のみで、他スレッドから集計しながら記録できる
+    class LatencyHistogram
+    {
+    public:
+        static constexpr int SUB_BUCKET_BITS = 4;
+        static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static constexpr int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    private:
+        std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets; // バケットごとの件数
+        std::atomic<uint64_t> total;                             // 記録した値の合計
+        std::atomic<uint64_t> maxValue;                          // 記録した値の最大値
+
+        // 値に対応するバケット番号
+        static int bucketIndex(uint64_t value);
+
+        // バケットに含まれる値の上限
+        static uint64_t bucketUpperBound(int index);
+
+    public:
+        // コンストラクタ
+        LatencyHistogram();
+
+        LatencyHistogram(const LatencyHistogram &) = delete;
+        LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+        // 値を記録（単位は呼び出し側で統一する。通常はナノ秒）
+        void record(uint64_t value)
+        {
+            buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+            total.fetch_add(value, std::memory_order_relaxed);
+            uint64_t current = maxValue.load(std::memory_order_relaxed);
+            while (value > current && !maxValue.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        // 別のヒストグラムの内容を加える
+        void merge(const LatencyHistogram &other);
+
+        // 全て消去
+        void reset();
+
+        // 記録した件数
+        uint64_t getCount() const;
+
+        // 平均値
+        double getMean() const;
+
+        // 最大値
+        uint64_t getMax() const;
+
+        // パーセンタイル値（percentile は 0〜100）
+        uint64_t getPercentile(double percentile) const;
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace GomokuLib
+{
+
+    // 読み込み専用でメモリマップしたファイル
+    class MappedFile
+    {
+    private:
+        const char *data; // マップした先頭アドレス（空ファイルの場合は nullptr）
+        size_t size;      // ファイルサイズ（バイト）
+
+        // マッピングを解放
+        void release();
+
+    public:
+        // 指定したファイルをマップ（失敗した場合は std::runtime_error）
+        explicit MappedFile(const std::string &filepath);
+
+        // デストラクタ
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        // ファイル内容を取得
+        std::string_view getContents() const;
+
+        // ファイルサイズを取得
+        size_t getSize() const;
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+namespace GomokuLib
+{
+
+    // 棋譜 (行, 列) の読み取り専用ビュー（所有しない）
+    // 元の棋譜に着手や一手戻しが行われると無効になる
+    class MoveSpan
+    {
+    public:
+        using value_type = std::pair<int, int>;
+        using const_iterator = const value_type *;
+
+    private:
+        const value_type *first; // 先頭の着手
+        size_t count;            // 着手数
+
+    public:
+        // コンストラクタ
+        constexpr MoveSpan() noexcept : first(nullptr), count(0) {}
+        constexpr MoveSpan(const value_type *data, size_t size) noexcept : first(data), count(size) {}
+
+        // 着手数
+        constexpr size_t size() const noexcept { return count; }
+        constexpr bool empty() const noexcept { return count == 0; }
+
+        // 要素へのアクセス（範囲外の確認は行わない）
+        constexpr const value_type &operator[](size_t index) const noexcept { return first[index]; }
+        constexpr const value_type &front() const noexcept { return first[0]; }
+        constexpr const value_type &back() const noexcept { return first[count - 1]; }
+        constexpr const value_type *data() const noexcept { return first; }
+
+        // 範囲 for 用
+        constexpr const_iterator begin() const noexcept { return first; }
+        constexpr const_iterator end() const noexcept { return first + count; }
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Board.h"
+#include "BoardScan.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // 量子化したニューラルネットワークによる局面の評価（NNUE 形式）
+    //
+    // 入力は (手番側から見た石の色, マス) ごとの特徴で、第1層は特徴ごとの重み (int16) の和を
+    // 黒から見た分と白から見た分の2つのアキュムレータに持つ。石を1つ置く・取り除くたびに
+    // その石の重みを足し引きするだけで更新でき、評価のたびに盤面全体を読み直す必要がない。
+    // 評価は [手番側, 相手側] のアキュムレータを 0〜127 に切り詰めた 512 バイトを入力に
+    // int8 の全結合層 512→32→1 を計算する（AVX2 が使える CPU ではベクトル命令で計算する）。
+    //
+    // 重みのファイル（リトルエンディアン）:
+    //   "GMKNNUE1" | 盤面サイズ u32 | HIDDEN u32 | OUTPUT_HIDDEN u32 | outputScale i32
+    //   | 特徴の重み i16[2 * サイズ^2][HIDDEN] | 特徴のバイアス i16[HIDDEN]
+    //   | 第2層の重み i8[OUTPUT_HIDDEN][2 * HIDDEN] | 第2層のバイアス i32[OUTPUT_HIDDEN]
+    //   | 出力層の重み i8[OUTPUT_HIDDEN] | 出力層のバイアス i32
+    class NeuralNetwork
+    {
+    public:
+        static constexpr int HIDDEN = 256;       // アキュムレータの幅（1視点あたり）
+        static constexpr int OUTPUT_HIDDEN = 32; // 第2層の幅
+        static constexpr int L1_SHIFT = 6;       // 第2層の出力の右シフト
+        static constexpr int OUTPUT_DIVISOR = 1024;
+
+        // ファイルの先頭の識別子
+        static constexpr char MAGIC[8] = {'G', 'M', 'K', 'N', 'N', 'U', 'E', '1'};
+
+        // 重みをメモリマップして読み込む（形式が違う場合は std::runtime_error）
+        static NeuralNetwork load(const std::string &filepath);
+
+        // 乱数の重みのネットワーク（動作確認とベンチマーク用）
+        static NeuralNetwork random(int boardSize, uint64_t seed);
+
+        // 重みをファイルに書き出す
+        void save(const std::string &filepath) const;
+
+        int getBoardSize() const;
+
+        // 評価の計算に使う命令セット（SCALAR か AVX2。setLevel は CpuDispatch::setLevel と同じく全てのカーネルを切り替える
+        // 使えない命令セットを指定すると std::runtime_error）
+        static SimdLevel getLevel();
+        static void setLevel(SimdLevel level);
+
+        // 第1層より後の計算（手番側と相手側のアキュムレータから Engine と同じ尺度の評価値を求める）
+        int forward(const int16_t *own, const int16_t *other) const;
+
+        // 特徴の重みとバイアス
+        const int16_t *featureWeights(int feature) const;
+        const int16_t *featureBias() const;
+
+        // 手番側から見た特徴の番号（自分の石は 0〜サイズ^2-1、相手の石はその後ろ）
+        int featureIndex(Stone perspective, int row, int col, Stone stone) const;
+
+    private:
+        NeuralNetwork(int boardSize, int outputScale);
+
+        int boardSize;
+        int outputScale; // 出力を Engine の評価値の尺度に直す係数（OUTPUT_DIVISOR 分の）
+        std::vector<int16_t> features;     // [2 * サイズ^2][HIDDEN]
+        std::vector<int16_t> bias;         // [HIDDEN]
+        std::vector<int8_t> hiddenWeights; // [OUTPUT_HIDDEN][2 * HIDDEN]
+        std::vector<int32_t> hiddenBias;   // [OUTPUT_HIDDEN]
+        std::vector<int8_t> outputWeights; // [OUTPUT_HIDDEN]
+        int32_t outputBias;
+    };
+
+    // 盤面の石に合わせて差分で更新するアキュムレータ
+    // 1つの探索（スレッド）ごとに持ち、石を置く・取り除くたびに addStone / removeStone を呼ぶ
+    class NeuralAccumulator
+    {
+    public:
+        NeuralAccumulator(const NeuralNetwork &network, const Board &board);
+
+        // 空の盤面のアキュムレータ
+        explicit NeuralAccumulator(const NeuralNetwork &network);
+
+        // 盤面から作り直す
+        void refresh(const Board &board);
+
+        // 黒と白の行のビット列から作り直す（Board::getPackedRows と同じ形式）
+        void refresh(const uint64_t *blackRows, const uint64_t *whiteRows);
+
+        // 石を1つ置いた・取り除いた分だけ更新する
+        void addStone(int row, int col, Stone stone);
+        void removeStone(int row, int col, Stone stone);
+
+        // sideToMove の手番から見た評価値
+        int evaluate(Stone sideToMove) const;
+
+    private:
+        const NeuralNetwork &network;
+        alignas(32) std::array<int16_t, NeuralNetwork::HIDDEN> black; // 黒から見たアキュムレータ
+        alignas(32) std::array<int16_t, NeuralNetwork::HIDDEN> white; // 白から見たアキュムレータ
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Game.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // perft の結果
+    struct PerftResult
+    {
+        uint64_t sequences = 0; // 指定した手数ちょうどの着手の並びの数
+        uint64_t nodes = 0;     // 打った手の総数（途中の局面を含む）
+        uint64_t terminals = 0; // 途中で終局した並びの数（終局後は打てないので sequences には含まれない）
+        double seconds = 0.0;   // かかった時間
+
+        // 1秒あたりに打った手の数
+        double nodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+    };
+
+    // 局面から打てる全ての着手の並びを数える（チェスの perft と同じ考え方）
+    // Game::playTurn と Game::takeBackMove だけで盤面を進め・戻すので、盤面や対局の実装を変えたときの
+    // 正しさ（数が一致するか）と速さの確認に使える
+    // 数えるのは現在の局面までの手だけを打ち直した対局なので、渡した対局（変化や戻した手、持ち時間を含む）は変わらない
+    class Perft
+    {
+    public:
+        // depth 手の並びを数える
+        static PerftResult count(const Game &game, int depth);
+
+        // 初手ごとに分けて数える（初手ごとの並びの数を返す。数の食い違いを探すときに使う）
+        static std::vector<std::pair<std::pair<int, int>, uint64_t>> divide(const Game &game, int depth);
+
+        // 初手ごとに対局をコピーして、threadCount 個のスレッドで並列に数える（0 はハードウェアスレッド数）
+        static PerftResult countParallel(const Game &game, int depth, size_t threadCount = 0);
+    };
+
+} // namespace GomokuLib
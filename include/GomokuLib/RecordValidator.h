@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Common.h"
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // 棋譜検証で見つかった問題の種類
+    enum class RecordIssueType
+    {
+        PARSE_ERROR,          // 書式の誤り
+        INVALID_SIZE,         // 盤面サイズが不正
+        ILLEGAL_MOVE,         // 盤面外または既に石がある位置への着手
+        MOVE_AFTER_GAME_OVER, // 終局後の着手
+        WRONG_COLOR_ORDER     // 手番の色が交互になっていない
+    };
+
+    // 棋譜検証で見つかった問題
+    struct RecordIssue
+    {
+        RecordIssueType type; // 問題の種類
+        int line;             // 行番号（1始まり）
+        int moveIndex;        // 何手目か（1始まり、着手以外の行では 0）
+        std::string message;  // 説明
+    };
+
+    // 棋譜の検証結果
+    struct RecordSummary
+    {
+        int boardSize;                          // 盤面サイズ
+        std::vector<std::pair<int, int>> moves; // 有効だった着手 (行, 列)
+        Stone winner;                           // 勝者（未終局なら EMPTY）
+        std::vector<RecordIssue> issues;        // 見つかった問題
+
+        // 問題がなかったか
+        bool isValid() const { return issues.empty(); }
+    };
+
+    // saveGame 形式の棋譜を厳密に検証するクラス
+    // loadGame は不正な行を読み飛ばすが、こちらは全ての問題を報告する
+    class RecordValidator
+    {
+    public:
+        // 受け付ける盤面サイズの範囲
+        static constexpr int MIN_BOARD_SIZE = 5;
+        static constexpr int MAX_BOARD_SIZE = 1024;
+
+        // メモリ上の棋譜を検証
+        static RecordSummary validate(std::string_view contents);
+
+        // ファイルの棋譜を検証（メモリマップして読み込む）
+        static RecordSummary validateFile(const std::string &filepath);
+
+        // 問題の種類を文字列に変換
+        static const char *issueTypeToString(RecordIssueType type);
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "BatchEvaluator.h"
+#include "Board.h"
+#include "CancellationToken.h"
+#include "NeuralNetwork.h"
+#include "TimeManager.h"
+#include "TranspositionTable.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // 探索の条件
+    struct SearchLimits
+    {
+        int maxDepth = 4;       // 読みの深さ（手数）
+        int maxCandidates = 12; // 各局面で読む候補手の数（Engine の評価順に上位から）
+        uint64_t maxNodes = 0;  // 調べる局面の上限（0 は無制限、超えると読み終えた深さまでの結果を返す）
+
+        // 1手に使う時間（TimeManager::allocate で持ち時間から決める。既定では時間で止めない）
+        // 上限を過ぎると読み終えた深さまでの結果を返し、目安を過ぎるか強制手と読めたら次の深さに進まない
+        TimeBudget time;
+
+        // 末端の評価に使うニューラルネットワーク（nullptr か盤面の大きさが違えば Engine の形の評価を使う）
+        std::shared_ptr<const NeuralNetwork> network;
+
+        // 末端の局面をまとめて評価する評価器（複数の探索で共有する。設定されていれば network より優先）
+        std::shared_ptr<BatchEvaluator> evaluator;
+    };
+
+    // 探索の結果（途中経過として通知される場合もある）
+    struct SearchResult
+    {
+        std::pair<int, int> bestMove{-1, -1};                  // 最善手（打てる場所がなければ (-1, -1)）
+        int score = 0;                                         // 手番側から見た評価値
+        int depth = 0;                                         // 読み終えた深さ
+        std::vector<std::pair<int, int>> principalVariation;   // 最善の手順（bestMove から始まる）
+        uint64_t nodes = 0;                                    // 調べた局面の数
+        bool completed = false;                                // 途中で打ち切らずに読み終えたか（キャンセルや maxNodes、時間の上限で打ち切ると false）
+        bool forced = false;                                   // 他の手が全て負けと読めたか（打てる手が1つしかない場合も含む）
+    };
+
+    // 反復深化のアルファベータ探索
+    // 候補手は Engine の評価で並べ替えて上位だけを読み、末端は双方の最も良い手の評価の差で評価する
+    // （limits.evaluator か limits.network があれば、末端はそれで評価する）
+    class Search
+    {
+    public:
+        // 勝ちの評価値（勝ちまでの手数が短いほど大きい）
+        static constexpr int SCORE_WIN = 100000000;
+
+        // 深さを1つ読み終えるたびに呼ばれる
+        using ProgressCallback = std::function<void(const SearchResult &)>;
+
+        // player の手番として探索する（token がキャンセルされると、読み終えた深さまでの結果を返す）
+        // table を渡すとそれを使って同じ局面の読み直しを省く（複数の探索で同時に共有できる）
+        static SearchResult run(const Board &board, Stone player, const SearchLimits &limits,
+                                const CancellationToken &token = CancellationToken(),
+                                const ProgressCallback &onProgress = nullptr,
+                                TranspositionTable *table = nullptr);
+
+        // 評価値が勝ち・負けを表すか
+        static bool isWinScore(int score);
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CancellationToken.h"
+#include "Search.h"
+#include "TrainingData.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // 自己対局の条件
+    struct SelfPlayOptions
+    {
+        std::string outputDirectory = "selfplay"; // シャードの出力先
+        int boardSize = 15;
+        uint64_t games = 1000;                    // 対局の総数（全シャードの合計）
+        uint64_t seed = 1;                        // 乱数の種（同じ種とシャード数なら同じデータになる）
+        size_t shardCount = 0;                    // シャード数 = ワーカー数（0 はハードウェアスレッド数）
+        int openingPlies = 4;                     // 序盤に乱数で打つ手数（この局面は記録しない）
+        SearchLimits limits;                      // 1手あたりの探索の予算（maxNodes で打ち切っても同じ種なら同じ結果になる）
+        bool augment = true;                      // 各局面を8通りの対称変換で記録する
+        bool resume = false;                      // 既存のシャードの続きから作る
+
+        // コンストラクタ（既定の予算は深さ 3、候補手 10、1手 2 万局面まで）
+        SelfPlayOptions()
+        {
+            limits.maxDepth = 3;
+            limits.maxCandidates = 10;
+            limits.maxNodes = 20000;
+        }
+    };
+
+    // 自己対局の進み具合（この実行で作った分）
+    struct SelfPlayStats
+    {
+        uint64_t games = 0;          // 終えた対局の数
+        uint64_t samples = 0;        // 書き出した局面の数（対称変換したものを含む）
+        uint64_t resumedSamples = 0; // 再開したシャードに既にあった局面の数
+        double seconds = 0.0;        // 経過時間
+
+        double samplesPerSecond() const { return seconds > 0.0 ? samples / seconds : 0.0; }
+    };
+
+    // 学習データを作る自己対局
+    // シャードごとに1つのワーカーが対局 shardIndex, shardIndex + shardCount, ... を順に打ち、自分のシャードだけに書く
+    // 各対局の乱数は種と対局の番号だけで決まるので、途中で止まっても同じ対局から作り直せる
+    class SelfPlay
+    {
+    public:
+        // reportInterval ごとに（呼び出し元のスレッドから）呼ばれる
+        using ProgressCallback = std::function<void(const SelfPlayStats &)>;
+
+        // 全ての対局を打つか token がキャンセルされるまで実行する（打ちかけの対局は書き出さない）
+        static SelfPlayStats run(const SelfPlayOptions &options, const CancellationToken &token = CancellationToken(),
+                                 const ProgressCallback &onProgress = nullptr, double reportInterval = 1.0);
+
+        // 対局を1つ打ち、探索した局面を samples に入れる（キャンセルされた場合は false）
+        static bool playGame(const SelfPlayOptions &options, uint32_t game, std::vector<TrainingSample> &samples,
+                             const CancellationToken &token = CancellationToken());
+
+        // シャードのファイル名（outputDirectory/shard-0003.bin）
+        static std::string shardPath(const std::string &directory, size_t shardIndex);
+
+        // 対局ごとの乱数の種
+        static uint64_t gameSeed(uint64_t seed, uint32_t game);
+    };
+
+} // namespace GomokuLib
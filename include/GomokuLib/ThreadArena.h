@@ -0,0 +1,19 @@
+#pragma once
+
+#include <memory_resource>
+
+namespace GomokuLib
+{
+
+    // スレッドごとに使い回すメモリ領域
+    // タスクや探索の中だけで使う盤面・対局のコピーをここから確保する。解放した領域はそのスレッドの中で
+    // 再利用するので、同じ大きさのコピーを繰り返すとヒープからは確保しなくなる
+    // 確保したオブジェクトは、確保したスレッドの中で破棄すること（他のスレッドに渡したり、スレッドより長く残したりしない）
+    class ThreadArena
+    {
+    public:
+        // 呼び出したスレッドの領域
+        static std::pmr::memory_resource *get();
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // ワークスティーリング方式のスレッドプール
+    // 各ワーカーが自分のキューを持ち、空になると他のワーカーのキューからタスクを盗む
+    class ThreadPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+    private:
+        // ワーカーごとのタスクキュー（ロックはキュー単位で、全体ロックは持たない）
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkQueue>> queues; // ワーカーごとのキュー
+        std::vector<std::thread> workers;               // ワーカースレッド
+        std::atomic<size_t> nextQueue;                  // 外部から投入する際のラウンドロビン位置
+        std::atomic<size_t> pendingTasks;               // 未完了のタスク数
+        std::atomic<bool> stopping;                     // 終了要求
+
+        std::mutex sleepMutex;              // 待機用のミューテックス
+        std::condition_variable wakeUp;     // タスク投入の通知
+        std::condition_variable allDone;    // 全タスク完了の通知
+
+        // ワーカーのメインループ
+        void workerLoop(size_t index);
+
+        // タスクを1つ取り出す（自分のキューの末尾、なければ他のキューの先頭から盗む）
+        bool popTask(size_t index, Task &task);
+
+    public:
+        // コンストラクタ（threadCount が 0 ならハードウェアスレッド数）
+        explicit ThreadPool(size_t threadCount = 0);
+
+        // デストラクタ（残っているタスクを全て実行してから終了）
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        // タスクを投入
+        void post(Task task);
+
+        // 戻り値を future で受け取るタスクを投入
+        template <typename F>
+        std::future<std::invoke_result_t<F>> submit(F &&func)
+        {
+            using Result = std::invoke_result_t<F>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+            std::future<Result> future = task->get_future();
+            post([task]()
+                 { (*task)(); });
+            return future;
+        }
+
+        // 投入済みのタスクが全て完了するまで待つ
+        void waitIdle();
+
+        // ワーカースレッド数を取得
+        size_t getThreadCount() const;
+
+        // 呼び出し元スレッドがこのプールのワーカーならそのインデックス、そうでなければ -1
+        int currentWorkerIndex() const;
+    };
+
+} // namespace GomokuLib
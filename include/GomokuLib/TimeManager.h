@@ -0,0 +1,90 @@
+#pragma once
+
+#include "GameClock.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace GomokuLib
+{
+
+    class Game;
+
+    // 1手に使う時間（ミリ秒。hardMs が 0 なら時間では止めない）
+    struct TimeBudget
+    {
+        int64_t softMs = 0; // 目安（深さを1つ読み終えたとき、これを過ぎていれば次の深さに進まない）
+        int64_t hardMs = 0; // 上限（読んでいる途中でも、これを過ぎたら打ち切る）
+
+        bool isLimited() const { return hardMs > 0; }
+    };
+
+    // 残りの持ち時間から1手の時間を決め、探索をいつ止めるかを判断する
+    // 目安の時間は最善手の安定度で伸び縮みし、最善手が変わり続けるうちは上限まで延ばし、
+    // 変わらなければ早めに止める。他に手がない（強制手）と読めたらすぐに止める
+    class TimeManager
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using TimePoint = Clock::time_point;
+
+    private:
+        TimeBudget budget;
+        TimePoint startTime;
+        TimePoint hardDeadline;
+        std::pair<int, int> previousBest; // 前の深さの最善手
+        double scale;                     // 目安の時間に掛ける倍率（最善手が変わると増え、変わらないと減る）
+        int64_t lastIterationEnd;         // 前の深さを読み終えた時刻（開始からのミリ秒）
+
+    public:
+        // 残りの手数の見込みの下限（残り時間をこの手数より細かく分けない）
+        static constexpr int64_t MIN_MOVES_TO_GO = 8;
+
+        // 序盤の残り手数の見込み（手数が進むにつれて MIN_MOVES_TO_GO まで減らす）
+        static constexpr int64_t OPENING_MOVES_TO_GO = 30;
+
+        // 定石で決まりやすい序盤の手数（この手数までは目安を半分にする）
+        static constexpr size_t OPENING_PLIES = 4;
+
+        // 上限は目安のこの倍数まで（ただし残り時間の 1/HARD_SHARE を超えない）
+        static constexpr int64_t HARD_RATIO = 4;
+        static constexpr int64_t HARD_SHARE = 3;
+
+        // 持ち時間の設定と残り時間から、1手の目安と上限を決める
+        static TimeBudget allocate(const TimeControl &control, int64_t remainingMs, int boardSize, size_t ply);
+
+        // 対局の手番側の時計から、1手の目安と上限を決める（時間制限がなければ無制限の TimeBudget）
+        static TimeBudget allocate(const Game &game, TimePoint now = Clock::now());
+
+        // コンストラクタ（start から時間を測る）
+        explicit TimeManager(const TimeBudget &budget, TimePoint start = Clock::now());
+
+        const TimeBudget &getBudget() const;
+
+        // 時間の制限があるか
+        bool isLimited() const;
+
+        // 上限を過ぎたか（時刻の比較だけなので探索の途中で呼べる。時間の制限がなければ時計も読まない）
+        bool isHardExpired() const
+        {
+            return budget.hardMs > 0 && Clock::now() >= hardDeadline;
+        }
+
+        bool isHardExpired(TimePoint now) const
+        {
+            return budget.hardMs > 0 && now >= hardDeadline;
+        }
+
+        // 深さを1つ読み終えるたびに呼び、次の深さに進むかを返す
+        // forced は他の手が全て負けと読めたこと（それ以上読んでも手は変わらない）
+        bool shouldContinue(const std::pair<int, int> &bestMove, bool forced, TimePoint now = Clock::now());
+
+        // 最善手の安定度で伸び縮みした現在の目安（ミリ秒）
+        int64_t getSoftLimit() const;
+
+        // 探索を始めてからの時間（ミリ秒）
+        int64_t getElapsed(TimePoint now = Clock::now()) const;
+    };
+
+} // namespace GomokuLib
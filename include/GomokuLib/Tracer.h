@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Instrumentation.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace GomokuLib
+{
+
+    // 1つの区間（Chrome のトレース形式の "ph":"X" のイベント）
+    // 名前・分類・引数名は文字列リテラルなど、プログラムの終了まで有効な文字列を指す
+    struct TraceEvent
+    {
+        const char *name = nullptr;
+        const char *category = nullptr;
+        const char *argName = nullptr; // 引数がなければ nullptr
+        int64_t argValue = 0;
+        int64_t start = 0;    // トレース開始からの時間（ナノ秒）
+        int64_t duration = 0; // ナノ秒
+    };
+
+    // Chrome のトレース形式（Perfetto や chrome://tracing で開ける JSON）で区間を記録する
+    // 実行中に start / stop で切り替えられ、止めている間は区間ごとにフラグを1回読むだけで済む
+    // 各スレッドは自分のリングバッファに書き込み、書き出しは専用のスレッドがまとめて行う
+    class Tracer
+    {
+    public:
+        // スレッドごとのリングバッファの大きさ（溢れた区間は捨てて数える）
+        static constexpr size_t BUFFER_CAPACITY = 8192;
+
+        // スレッドごとのリングバッファ（書き込むのは持ち主のスレッドだけ、読み出すのは書き出し側だけ）
+        class ThreadBuffer
+        {
+        private:
+            std::array<TraceEvent, BUFFER_CAPACITY> events;
+            std::atomic<size_t> head; // 次に書き込む位置（持ち主のスレッドが進める）
+            std::atomic<size_t> tail; // 次に読み出す位置（書き出し側が進める）
+            std::atomic<uint64_t> dropped;
+            uint32_t threadId;
+
+        public:
+            explicit ThreadBuffer(uint32_t threadId);
+
+            ThreadBuffer(const ThreadBuffer &) = delete;
+            ThreadBuffer &operator=(const ThreadBuffer &) = delete;
+
+            void push(const TraceEvent &event)
+            {
+                size_t h = head.load(std::memory_order_relaxed);
+                if (h - tail.load(std::memory_order_acquire) >= BUFFER_CAPACITY)
+                {
+                    dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return;
+                }
+                events[h % BUFFER_CAPACITY] = event;
+                head.store(h + 1, std::memory_order_release);
+            }
+
+            // 溜まっている区間を取り出して callback に渡す（書き出し側だけが呼ぶ）
+            template <typename Callback>
+            size_t drain(Callback &&callback)
+            {
+                size_t t = tail.load(std::memory_order_relaxed);
+                size_t h = head.load(std::memory_order_acquire);
+                for (size_t i = t; i != h; i++)
+                {
+                    callback(events[i % BUFFER_CAPACITY]);
+                }
+                tail.store(h, std::memory_order_release);
+                return h - t;
+            }
+
+            uint32_t getThreadId() const { return threadId; }
+            uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+        };
+
+        // トレースを始める（書き出しはバックグラウンドで行う。既に記録中なら先に止める）
+        // ファイルを開けない場合は std::runtime_error
+        static void start(const std::string &filepath);
+
+        // 溜まっている区間を書き出してファイルを閉じる（記録中でなければ何もしない）
+        static void stop();
+
+        static bool isEnabled()
+        {
+            return enabled.load(std::memory_order_relaxed);
+        }
+
+        // 現在の記録で書き出した区間と、バッファが溢れて捨てた区間の数
+        static uint64_t getWrittenCount();
+        static uint64_t getDroppedCount();
+
+        // トレース開始からの時間（ナノ秒）
+        static int64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                       .count() -
+                   epoch.load(std::memory_order_relaxed);
+        }
+
+        // 呼び出し元スレッドのバッファに区間を追加する
+        static void record(const TraceEvent &event)
+        {
+            ThreadBuffer *buffer = current;
+            (buffer ? *buffer : registerThread()).push(event);
+        }
+
+    private:
+        static std::atomic<bool> enabled;
+        static std::atomic<int64_t> epoch;
+        static inline thread_local ThreadBuffer *current = nullptr;
+
+        // スレッドの終了時にバッファを手放す
+        struct BufferOwner;
+
+        static ThreadBuffer &registerThread();
+    };
+
+    // スコープの区間を記録する（作った時点でトレースが止まっていれば何もしない）
+    class TraceScope
+    {
+    private:
+        TraceEvent event;
+        bool active;
+
+    public:
+        TraceScope(const char *category, const char *name, const char *argName = nullptr, int64_t argValue = 0)
+            : active(Tracer::isEnabled())
+        {
+            if (active)
+            {
+                event.name = name;
+                event.category = category;
+                event.argName = argName;
+                event.argValue = argValue;
+                event.start = Tracer::now();
+            }
+        }
+
+        ~TraceScope()
+        {
+            if (active)
+            {
+                event.duration = Tracer::now() - event.start;
+                Tracer::record(event);
+            }
+        }
+
+        TraceScope(const TraceScope &) = delete;
+        TraceScope &operator=(const TraceScope &) = delete;
+    };
+
+} // namespace GomokuLib
+
+#if GOMOKU_INSTRUMENTATION
+// スコープの区間を記録する（GOMOKU_TRACE_SCOPE("game", "Game::playTurn")、引数を1つ付ける場合は名前と値を続ける）
+#define GOMOKU_TRACE_SCOPE(category, ...) \
+    ::GomokuLib::TraceScope GOMOKU_INSTRUMENTATION_CONCAT(gomokuTrace, __LINE__)(category, __VA_ARGS__)
+#else
+#define GOMOKU_TRACE_SCOPE(category, ...) ((void)0)
+#endif
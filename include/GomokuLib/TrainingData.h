@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Common.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // 学習データの1局面（自己対局の着手前の局面と、その探索結果・対局の結果）
+    struct TrainingSample
+    {
+        uint32_t game = 0;                    // 対局の番号
+        int ply = 0;                          // 何手目の局面か（0 は初期局面）
+        int symmetry = 0;                     // 元の局面に施した対称変換（0 は恒等変換）
+        Stone sideToMove = Stone::BLACK;      // 手番
+        int outcome = 0;                      // 手番側から見た対局の結果（1 勝ち、0 引き分け、-1 負け）
+        std::pair<int, int> bestMove{-1, -1}; // 探索の最善手
+        int score = 0;                        // 手番側から見た探索の評価値
+        std::vector<Stone> cells;             // 盤面（行優先、サイズ × サイズ）
+    };
+
+    // シャードの作成条件（ファイルの先頭に書き、再開時に一致するか確かめる）
+    struct TrainingShardInfo
+    {
+        int boardSize = 15;
+        uint64_t seed = 0;        // 自己対局の乱数の種
+        uint32_t shardIndex = 0;  // このシャードの番号
+        uint32_t shardCount = 1;  // シャードの総数
+    };
+
+    // 学習データの固定長レコードの形式と、盤面の対称変換
+    // シャードはヘッダーの後に、1局面 recordSize(boardSize) バイトのレコードを並べたファイル
+    class TrainingData
+    {
+    public:
+        // ファイルの先頭の識別子とヘッダーの大きさ
+        static constexpr char MAGIC[8] = {'G', 'M', 'K', 'T', 'R', 'A', 'I', 'N'};
+        static constexpr size_t HEADER_SIZE = 40;
+
+        // 盤面の対称変換の数（回転4通り × 裏返しの有無）
+        static constexpr int SYMMETRY_COUNT = 8;
+
+        // 1レコードのバイト数（局面は黒と白それぞれ1マス1ビット）
+        static size_t recordSize(int boardSize);
+
+        // 対称変換した座標
+        static std::pair<int, int> transform(int row, int col, int boardSize, int symmetry);
+
+        // 局面を対称変換する（out の盤面の領域は使い回す）
+        static void applySymmetry(const TrainingSample &sample, int boardSize, int symmetry, TrainingSample &out);
+
+        // レコードへの変換とレコードからの復元
+        static void encode(const TrainingSample &sample, int boardSize, uint8_t *record);
+        static void decode(const uint8_t *record, int boardSize, TrainingSample &out);
+
+        // ヘッダーの読み書き（形式が違う場合は std::runtime_error）
+        static void encodeHeader(const TrainingShardInfo &info, uint8_t *header);
+        static TrainingShardInfo decodeHeader(const uint8_t *header, size_t size);
+    };
+
+    // シャードの書き出し（1スレッドから使う。レコードはバッファに貯めて、flush でまとめて書く）
+    class TrainingShardWriter
+    {
+    private:
+        int fd;                       // 書き込み先
+        TrainingShardInfo info;       // ヘッダーの内容
+        size_t recordBytes;           // 1レコードのバイト数
+        std::vector<uint8_t> buffer;  // 書き出し前のレコード
+        size_t buffered;              // buffer の使用中のバイト数
+        uint64_t recordCount;         // ファイルとバッファのレコードの合計
+        int64_t lastGame;             // 最後のレコードの対局の番号（レコードがなければ -1）
+        std::string filepath;
+
+        // 再開時に、途中で書きかけた最後の対局をファイルから取り除く
+        void truncateLastGame();
+
+    public:
+        // シャードを開く（resume なら既存のシャードの続きから、そうでなければ空にして書く）
+        // 再開する場合、最後の対局は書きかけの可能性があるので取り除く（同じ種から作り直せる）
+        TrainingShardWriter(const std::string &filepath, const TrainingShardInfo &info, bool resume,
+                            size_t bufferBytes = size_t(1) << 20);
+
+        // デストラクタ（残っているレコードを書き出す）
+        ~TrainingShardWriter();
+
+        TrainingShardWriter(const TrainingShardWriter &) = delete;
+        TrainingShardWriter &operator=(const TrainingShardWriter &) = delete;
+
+        // レコードを追加（バッファが一杯なら書き出す）
+        void append(const TrainingSample &sample);
+
+        // バッファのレコードを全て書き出す
+        void flush();
+
+        // 書き出したレコードをディスクまで届ける
+        void sync();
+
+        uint64_t getRecordCount() const;
+        int64_t getLastGame() const;
+        size_t getBufferedBytes() const;
+    };
+
+    // シャードの読み込み（メモリマップして、レコードを番号で読む。末尾の書きかけのレコードは無視する）
+    class TrainingShardReader
+    {
+    private:
+        MappedFile file;
+        TrainingShardInfo info;
+        size_t recordBytes;
+        uint64_t recordCount;
+
+    public:
+        // シャードを開く（形式が違う場合は std::runtime_error）
+        explicit TrainingShardReader(const std::string &filepath);
+
+        const TrainingShardInfo &getInfo() const;
+        uint64_t getRecordCount() const;
+
+        // index 番目のレコードを読む
+        void read(uint64_t index, TrainingSample &out) const;
+    };
+
+} // namespace GomokuLib
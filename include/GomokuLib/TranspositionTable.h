@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Board.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    // 置換表の評価値の種類
+    enum class BoundType : uint8_t
+    {
+        NONE = 0,  // 未登録
+        EXACT = 1, // 正確な値
+        LOWER = 2, // 下限（ベータカットした値）
+        UPPER = 3  // 上限（どの手もアルファを超えなかった値）
+    };
+
+    // 置換表から取り出した探索結果
+    struct TableEntry
+    {
+        int score = 0;                     // 評価値（勝ちの値は登録した局面からの手数）
+        int depth = 0;                     // 読んだ深さ
+        BoundType bound = BoundType::NONE; // 評価値の種類
+        std::pair<int, int> move{-1, -1};  // 最善手（なければ (-1, -1)）
+    };
+
+    // Zobrist ハッシュで局面を引く、複数スレッドで共有できる置換表
+    // 各エントリはキーとデータの排他的論理和を一緒に書き込み、読み出し時に照合してロックなしで破損を検出する
+    class TranspositionTable
+    {
+    private:
+        // ロックなしで読み書きするエントリ（check には key ^ data を入れる）
+        struct Slot
+        {
+            std::atomic<uint64_t> check{0};
+            std::atomic<uint64_t> data{0};
+        };
+
+        int boardSize;
+        std::vector<uint64_t> stoneKeys; // マスと石の色ごとの乱数（[マス * 2 + 色]）
+        uint64_t sideKey;                // 白番のときに加える乱数
+        std::unique_ptr<Slot[]> slots;
+        size_t mask;                     // エントリ数 - 1（エントリ数は2の累乗）
+
+    public:
+        // コンストラクタ（entryCount は2の累乗に切り上げる）
+        TranspositionTable(int boardSize, size_t entryCount = size_t(1) << 20);
+
+        TranspositionTable(const TranspositionTable &) = delete;
+        TranspositionTable &operator=(const TranspositionTable &) = delete;
+
+        // 盤面サイズ（ハッシュは同じサイズの盤面にのみ使える）
+        int getBoardSize() const;
+
+        // エントリ数
+        size_t getCapacity() const;
+
+        // 盤面と手番から局面のハッシュを計算する
+        uint64_t hash(const Board &board, Stone player) const;
+
+        // 石を置く・取り除くときにハッシュに加える値（同じ値をもう一度加えると元に戻る）
+        uint64_t stoneKey(int row, int col, Stone stone) const;
+
+        // 手番が変わるときにハッシュに加える値
+        uint64_t sideToMoveKey() const;
+
+        // 局面を引く（登録されていなければ false）
+        bool probe(uint64_t key, TableEntry &entry) const;
+
+        // 局面を登録する（同じ局面はより深く読んだ結果のみで上書きし、別の局面なら置き換える）
+        void store(uint64_t key, const TableEntry &entry);
+
+        // 全てのエントリを消す（他のスレッドが使っていないときに呼ぶ）
+        void clear();
+    };
+
+} // namespace GomokuLib
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "GomokuLib/LatencyHistogram.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// 負荷生成の設定
+struct LoadConfig
+{
+    std::string host = "127.0.0.1"; // 接続先ホスト（TCP）
+    int port = 7777;                // 接続先ポート（TCP）
+    std::string unixPath;           // Unix ソケットのパス（指定した場合はこちらを使う）
+    size_t connections = 1000;      // 同時接続数（= 同時セッション数）
+    size_t threads = 0;             // クライアントスレッド数（0 ならハードウェアスレッド数）
+    double durationSeconds = 10.0;  // 実行時間（秒）
+    int boardSize = 15;             // 盤面サイズ
+    int undoPercent = 5;            // place の代わりに undo を送る割合（%）
+    int movesPercent = 2;           // place の代わりに moves を送る割合（%）
+    size_t watchers = 0;            // 対局を観戦する接続の数（0 なら観戦しない）
+};
+
+// 負荷生成で送るコマンド（レイテンシの集計単位）
+enum class LoadCommand
+{
+    START,
+    PLACE,
+    UNDO,
+    MOVES,
+    COUNT
+};
+
+// GomokuServer にセッションを大量に張って対局させる負荷生成器
+// 各接続は応答を受け取ってから次のコマンドを送る（クローズドループ）
+// watchers を指定すると、各セッションを観戦する接続も張り、差分の配信の量とサーバーのメモリを測る
+// （観戦中のセッションを終わらせないよう、終局したら新しい対局を始める代わりに一手戻す）
+class LoadGenerator
+{
+private:
+    LoadConfig config; // 設定
+
+    // コマンドごとの往復レイテンシ
+    std::array<std::unique_ptr<GomokuLib::LatencyHistogram>, static_cast<size_t>(LoadCommand::COUNT)> latency;
+
+    // 1スレッド分のクライアントを動かす
+    void runWorker(size_t workerIndex, size_t connectionCount, uint64_t seed, uint64_t deadline);
+
+    // 1スレッド分の観戦者を動かす（firstWatcher 番目から順にセッションへ割り当てる）
+    void runWatchers(size_t firstWatcher, size_t watcherCount, uint64_t deadline);
+
+    // サーバーへ接続（失敗した場合は -1）
+    int connectToServer() const;
+
+    // 1行のコマンドを送って応答を待つ（失敗した場合は空文字列）
+    std::string queryServer(const std::string &line) const;
+
+public:
+    // コンストラクタ
+    explicit LoadGenerator(const LoadConfig &config);
+
+    // 負荷を生成して結果を出力（終了コードを返す）
+    int run();
+
+    // コマンド名を取得
+    static const char *commandName(LoadCommand command);
+};
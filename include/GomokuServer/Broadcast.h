@@ -0,0 +1,57 @@
+#pragma once
+
+#include "GomokuLib/Game.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 観戦者へ配る差分（1回の変更につき一度だけ作り、全ての観戦者の送信キューで参照を共有する）
+using BroadcastBuffer = std::shared_ptr<const std::string>;
+
+// 観戦者向けの差分の行（番号は対局ごとに 1 から増え、盤面全体はその時点の番号を持つ）
+//   EV <seq> PLACE <B/W> <row> <col>
+//   EV <seq> UNDO
+//   EV <seq> RESULT <WIN B / WIN W / DRAW>
+//   EV <seq> CLOSED
+//   SNAP <seq> <size> <勝者 -/B/W/DRAW> <n> <row>,<col> ...
+class Broadcast
+{
+public:
+    static void appendPlace(std::string &out, uint64_t sequence, GomokuLib::Stone player, int row, int col);
+    static void appendUndo(std::string &out, uint64_t sequence);
+    static void appendResult(std::string &out, uint64_t sequence, GomokuLib::Stone winner);
+    static void appendClosed(std::string &out, uint64_t sequence);
+    static void appendSnapshot(std::string &out, uint64_t sequence, const GomokuLib::Game &game);
+};
+
+// 接続ごとの送信キュー
+// バッファはコピーせずに参照で並べ、writev でまとめて送る
+class SendQueue
+{
+private:
+    struct Entry
+    {
+        BroadcastBuffer buffer;
+        bool droppable; // 観戦者が追いつけなくなったときに捨ててよい差分か（コマンドの応答は捨てない）
+    };
+
+    std::vector<Entry> entries; // 送信待ち（head より前は送信済み）
+    size_t head;                // 先頭の送信待ち
+    size_t offset;              // 先頭のバッファのうち送信済みの長さ
+    size_t bytes;               // 送信待ちのバイト数
+
+public:
+    SendQueue();
+
+    void push(BroadcastBuffer buffer, bool droppable);
+
+    // 送りかけの先頭を除いて、捨ててよい差分を全て捨てる
+    void dropPending();
+
+    // 送れるだけ送る（送信バッファが一杯なら途中で戻る。接続が切れていれば false）
+    bool send(int fd);
+
+    bool empty() const;
+    size_t getBytes() const;
+};
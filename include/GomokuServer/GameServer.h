@@ -0,0 +1,59 @@
+#pragma once
+
+#include "GomokuServer/Shard.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// サーバーの設定
+struct ServerConfig
+{
+    int tcpPort = 7777;     // TCP の待ち受けポート（負なら使わない）
+    std::string unixPath;   // Unix ソケットのパス（空なら使わない）
+    size_t threads = 0;     // シャード（スレッド）数（0 ならハードウェアスレッド数）
+    bool pinThreads = false; // シャードのスレッドを CPU コアに固定するか
+};
+
+// 複数の対局を同時に扱うヘッドレスのゲームサーバー
+class GameServer
+{
+private:
+    ServerConfig config;                       // 設定
+    std::vector<std::unique_ptr<Shard>> shards; // シャード
+    int unixListenFd;                          // 共有の Unix ソケット
+
+public:
+    // コンストラクタ（待ち受けソケットの作成に失敗した場合は std::runtime_error）
+    explicit GameServer(const ServerConfig &config);
+
+    // デストラクタ
+    ~GameServer();
+
+    GameServer(const GameServer &) = delete;
+    GameServer &operator=(const GameServer &) = delete;
+
+    // 全シャードのイベントループを実行（stop が呼ばれるまで戻らない）
+    void run();
+
+    // 停止を要求（任意のスレッドから呼べる）
+    void stop();
+
+    // セッションIDから担当シャードを取得
+    Shard &shardFor(uint64_t sessionId);
+
+    // シャード数を取得
+    size_t getShardCount() const;
+
+    // コマンドごとのレイテンシの集計（1行にまとめた文字列）
+    std::string latencySummary() const;
+
+    // コマンドごとのレイテンシの集計（表形式）
+    std::string latencyReport() const;
+
+    // 観戦者の数とプロセスのメモリ使用量（1行にまとめた文字列）
+    std::string resourceSummary() const;
+
+    // コマンド名を取得
+    static const char *commandName(ServerCommand command);
+};
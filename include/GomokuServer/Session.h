@@ -0,0 +1,46 @@
+#pragma once
+
+#include "GomokuLib/Game.h"
+#include "GomokuServer/Broadcast.h"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+struct Connection;
+
+// サーバー上の1対局
+struct Session
+{
+    uint64_t id;                         // セッションID（下位ビットで担当シャードが決まる）
+    std::optional<GomokuLib::Game> game; // 対局
+    int attachedConnections;             // 接続しているクライアント数
+    uint64_t sequence;                   // 最後の変更の番号（観戦者への差分の番号）
+    std::vector<Connection *> watchers;  // 観戦している接続（対局者の数には含めない）
+    BroadcastBuffer snapshot;            // 盤面全体の行（番号が snapshotSequence のままなら使い回す）
+    uint64_t snapshotSequence;           // snapshot を作ったときの番号
+};
+
+// シャード内で使い回すセッションのプール（シャードのスレッドからのみ使う）
+class SessionPool
+{
+private:
+    std::vector<std::unique_ptr<Session>> freeList; // 再利用待ちのセッション
+    size_t allocated;                               // これまでに確保したセッション数
+
+public:
+    // コンストラクタ
+    SessionPool();
+
+    // セッションを取得（空きがなければ新規に確保）
+    std::unique_ptr<Session> acquire(uint64_t id, int boardSize);
+
+    // セッションを返却
+    void release(std::unique_ptr<Session> session);
+
+    // 確保済みのセッション数
+    size_t getAllocatedCount() const;
+
+    // 再利用待ちのセッション数
+    size_t getFreeCount() const;
+};
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "GomokuLib/LatencyHistogram.h"
+#include "GomokuServer/Session.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class GameServer;
+
+// プロトコルのコマンド（レイテンシの集計単位）
+enum class ServerCommand
+{
+    START,  // start <size>
+    ATTACH, // attach <id>
+    PLACE,  // place <row> <col>
+    UNDO,   // undo
+    MOVES,  // moves
+    STATUS, // status
+    CLOSE,  // close
+    WATCH,  // watch <id>
+    RESYNC, // resync
+    STATS,  // stats
+    QUIT,   // quit
+    UNKNOWN,
+    COUNT
+};
+
+// クライアントとの接続
+struct Connection
+{
+    int fd;              // ソケット
+    std::string input;   // 未処理の受信データ
+    std::string output;  // 未送信の応答
+    Session *session;    // 接続中のセッション
+    bool waitingWrite;   // EPOLLOUT を待っているか
+    bool closing;        // 送信後に切断するか
+    uint64_t pendingId;  // 他のシャードへ移動した後に接続するセッションID
+    uint64_t pendingSince; // 移動を始めた時刻（attach のレイテンシ計測用、ナノ秒）
+    bool pendingWatch;   // 移動した後に attach ではなく watch する
+    SendQueue queue;     // 観戦中の差分と、その後ろに並んだ応答
+    Session *watching;   // 観戦中のセッション
+    size_t watchIndex;   // watching->watchers の中の位置
+    bool needsSnapshot;  // 差分が溜まりすぎたので、送信待ちが空いたら盤面全体を送る
+    bool flushQueued;    // pendingFlush に入っているか
+};
+
+// 1スレッド・1 epoll ループが担当するシャード
+// セッションは ID で各シャードに振り分けられ、シャード内のデータはそのスレッドだけが触る
+class Shard
+{
+private:
+    size_t index;        // シャード番号
+    GameServer &server;  // 所属するサーバー
+    int epollFd;         // epoll インスタンス
+    int wakeFd;          // 他スレッドからの通知用 eventfd
+    int tcpListenFd;     // このシャード専用の TCP 待ち受けソケット（SO_REUSEPORT）
+    int unixListenFd;    // 全シャードで共有する Unix ソケット（所有はサーバー）
+    std::atomic<bool> stopping;
+
+    std::unordered_map<uint64_t, std::unique_ptr<Session>> sessions;     // 担当するセッション
+    std::unordered_map<Connection *, std::unique_ptr<Connection>> connections; // 担当する接続
+    SessionPool sessionPool;                                             // セッションのプール
+    uint64_t nextSequence;                                               // 次に発行するセッション番号
+    std::vector<Connection *> pendingFlush;                              // 差分を積んだ観戦者（イベントを処理し終えてからまとめて送る）
+    std::atomic<size_t> watcherCount;                                    // 観戦している接続の数
+
+    std::mutex inboxMutex;              // 受け入れ待ち接続のロック（シャード単位）
+    std::vector<Connection *> inbox;    // 他のシャードから移ってくる接続
+
+    std::array<GomokuLib::LatencyHistogram, static_cast<size_t>(ServerCommand::COUNT)> latency; // コマンドごとのレイテンシ
+
+    // 1行のコマンドの処理結果
+    enum class LineResult
+    {
+        CONTINUE, // 続けて次の行を処理する
+        MIGRATE   // 接続を他のシャードへ移す
+    };
+
+    // イベント処理
+    void acceptConnections(int listenFd, bool tcp);
+    void handleEvents(Connection *conn, uint32_t events);
+    void drainInbox();
+
+    // 受信済みの行を順に処理する（接続が他のシャードへ移った場合は false）
+    bool processInput(Connection *conn);
+
+    // 1行のコマンドを処理する
+    LineResult executeLine(Connection *conn, std::string_view line);
+
+    // 各コマンドの実装
+    void handleStart(Connection *conn, const std::vector<std::string_view> &args);
+    LineResult handleAttach(Connection *conn, const std::vector<std::string_view> &args);
+    void handlePlace(Connection *conn, const std::vector<std::string_view> &args);
+    void handleUndo(Connection *conn);
+    void handleMoves(Connection *conn);
+    void handleStatus(Connection *conn);
+    void handleClose(Connection *conn);
+    LineResult handleWatch(Connection *conn, const std::vector<std::string_view> &args);
+    void handleResync(Connection *conn);
+
+    // 移ってきた接続の attach を完了する
+    void completeAttach(Connection *conn);
+
+    // セッションへの接続と切断
+    void attachSession(Connection *conn, Session *session);
+    void detachSession(Connection *conn);
+
+    // 観戦の開始と終了
+    void subscribe(Connection *conn, Session *session);
+    void unsubscribe(Connection *conn);
+
+    // 変更の差分を全ての観戦者の送信キューに積む（バッファは1つを共有する）
+    void publish(Session &session, std::string delta);
+
+    // 盤面全体の行（同じ番号の間は全員で使い回す）
+    BroadcastBuffer sessionSnapshot(Session &session);
+
+    // 応答の後ろにバッファを積み、イベントを処理し終えてから送る
+    void enqueue(Connection *conn, BroadcastBuffer buffer, bool droppable);
+    void flushPending();
+    void forgetPendingFlush(Connection *conn);
+
+    // 応答を送信する（接続を閉じた場合は false）
+    bool flush(Connection *conn);
+
+    // 接続の管理
+    void closeConnection(Connection *conn);
+    void registerConnection(std::unique_ptr<Connection> conn);
+    void migrateConnection(Connection *conn, Shard &target);
+
+public:
+    // コンストラクタ（tcpPort が負なら TCP は使わない）
+    Shard(size_t index, GameServer &server, int tcpPort, int unixListenFd);
+
+    // デストラクタ
+    ~Shard();
+
+    Shard(const Shard &) = delete;
+    Shard &operator=(const Shard &) = delete;
+
+    // イベントループ（stop が呼ばれるまで戻らない）
+    void run();
+
+    // イベントループの停止を要求（任意のスレッドから呼べる）
+    void stop();
+
+    // 他のシャードから接続を受け入れる（任意のスレッドから呼べる）
+    void adopt(Connection *conn);
+
+    // コマンドのレイテンシを取得（他のスレッドから読んでもよい）
+    const GomokuLib::LatencyHistogram &getLatency(ServerCommand command) const;
+
+    // シャード番号を取得
+    size_t getIndex() const;
+
+    // 観戦している接続の数（他のスレッドから読んでもよい）
+    size_t getWatcherCount() const;
+};
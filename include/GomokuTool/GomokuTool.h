@@ -0,0 +1,71 @@
+#pragma once
+
+#include "GomokuLib/RecordValidator.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+// 棋譜アーカイブの集計結果
+struct ArchiveStats
+{
+    size_t files = 0;        // 処理したファイル数
+    size_t validFiles = 0;   // 問題のなかったファイル数
+    size_t invalidFiles = 0; // 問題のあったファイル数
+    size_t unreadable = 0;   // 読み込めなかったファイル数
+    size_t bytes = 0;        // 読み込んだバイト数
+    size_t totalMoves = 0;   // 有効な着手の総数
+    size_t blackWins = 0;    // 黒の勝ち
+    size_t whiteWins = 0;    // 白の勝ち
+    size_t draws = 0;        // 引き分け
+    size_t unfinished = 0;   // 未終局
+
+    std::vector<size_t> lengthHistogram;                 // 手数のヒストグラム（LENGTH_BUCKET 手ごと）
+    std::map<int, std::vector<size_t>> firstMoveHeatmap; // 盤面サイズごとの初手の分布
+    std::map<GomokuLib::RecordIssueType, size_t> issues; // 問題の種類ごとの件数
+
+    static constexpr size_t LENGTH_BUCKET = 10;
+
+    // 1局分の結果を加える
+    void add(const GomokuLib::RecordSummary &summary, size_t fileBytes);
+
+    // 別の集計結果を足し合わせる
+    void merge(const ArchiveStats &other);
+};
+
+// 1ファイル分の問題の報告
+struct FileReport
+{
+    std::string path;                           // ファイルパス
+    std::string error;                          // 読み込みエラー（読めた場合は空）
+    std::vector<GomokuLib::RecordIssue> issues; // 検証で見つかった問題
+};
+
+// 棋譜アーカイブの検証・集計ツール
+class GomokuTool
+{
+private:
+    size_t threadCount;                  // ワーカースレッド数（0 なら全コア）
+    bool jsonOutput;                     // JSON で出力するか
+    bool quiet;                          // ファイルごとの問題を出力しないか
+    std::vector<std::string> extensions; // 対象とする拡張子（空なら全ファイル）
+    std::vector<std::string> inputPaths; // 入力パス（ファイルまたはディレクトリ）
+
+    // コマンドライン引数の解析（失敗した場合は false）
+    bool parseArguments(int argc, char **argv);
+
+    // 対象ファイルか判定
+    bool matchesExtension(const std::string &path) const;
+
+    // 結果の出力
+    void printText(const ArchiveStats &stats, const std::vector<FileReport> &reports) const;
+    void printJson(const ArchiveStats &stats, const std::vector<FileReport> &reports) const;
+    void printUsage() const;
+
+public:
+    // コンストラクタ
+    GomokuTool();
+
+    // ツールの実行（終了コードを返す）
+    int run(int argc, char **argv);
+};
@@ -0,0 +1,1063 @@
+#include "GomokuCLI/BatchRunner.h"
+#include "GomokuLib/GameAnalyzer.h"
+#include "GomokuLib/Instrumentation.h"
+#include "GomokuLib/MappedFile.h"
+#include "GomokuLib/Perft.h"
+#include "GomokuLib/TimeManager.h"
+#include "GomokuLib/Tracer.h"
+#include <cerrno>
+#include <charconv>
+#include <filesystem>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace
+{
+    // 出力バッファをこの大きさまで溜めてから書き出す
+    constexpr size_t OUTPUT_BUFFER_SIZE = 1 << 20;
+
+    // 標準入力から一度に読み込む大きさ
+    constexpr size_t INPUT_CHUNK_SIZE = 1 << 20;
+
+    // 持ち時間のある対局で、エンジンが1手に読む深さの上限（実際には時間で止まる）
+    constexpr int MAX_TIMED_DEPTH = 64;
+
+    // 石の1文字表現
+    const char *stoneToString(GomokuLib::Stone stone)
+    {
+        switch (stone)
+        {
+        case GomokuLib::Stone::BLACK:
+            return "B";
+        case GomokuLib::Stone::WHITE:
+            return "W";
+        case GomokuLib::Stone::DRAW:
+            return "draw";
+        default:
+            return "none";
+        }
+    }
+}
+
+BatchRunner::BatchRunner(BatchFormat format, int outputFd)
+    : format(format), outputFd(outputFd), isRunning(true), lineNumber(0), errorCount(0)
+{
+    output.reserve(OUTPUT_BUFFER_SIZE + 4096);
+}
+
+BatchRunner::~BatchRunner()
+{
+    flush();
+}
+
+void BatchRunner::setNetwork(std::shared_ptr<const GomokuLib::NeuralNetwork> value)
+{
+    network = std::move(value);
+}
+
+void BatchRunner::runFile(const std::string &filepath)
+{
+    GomokuLib::MappedFile file(filepath);
+    std::string_view contents = file.getContents();
+    GOMOKU_COUNT(BYTES_PARSED, contents.size());
+
+    size_t consumed = processBuffer(contents);
+
+    // 最後の行に改行がない場合
+    if (isRunning && consumed < contents.size())
+    {
+        lineNumber++;
+        executeLine(contents.substr(consumed));
+    }
+    flush();
+}
+
+void BatchRunner::runStream(int inputFd)
+{
+    std::string buffer;
+    buffer.reserve(INPUT_CHUNK_SIZE * 2);
+    std::vector<char> chunk(INPUT_CHUNK_SIZE);
+
+    while (isRunning)
+    {
+        ssize_t n = ::read(inputFd, chunk.data(), chunk.size());
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            break;
+        }
+        buffer.append(chunk.data(), static_cast<size_t>(n));
+        GOMOKU_COUNT(BYTES_PARSED, n);
+
+        size_t consumed = processBuffer(buffer);
+        buffer.erase(0, consumed);
+    }
+
+    if (isRunning && !buffer.empty())
+    {
+        lineNumber++;
+        executeLine(buffer);
+    }
+    flush();
+}
+
+size_t BatchRunner::getErrorCount() const
+{
+    return errorCount;
+}
+
+size_t BatchRunner::processBuffer(std::string_view data)
+{
+    size_t consumed = 0;
+    while (isRunning)
+    {
+        size_t end = data.find('\n', consumed);
+        if (end == std::string_view::npos)
+        {
+            break;
+        }
+        lineNumber++;
+        executeLine(data.substr(consumed, end - consumed));
+        consumed = end + 1;
+    }
+    return isRunning ? consumed : data.size();
+}
+
+void BatchRunner::executeLine(std::string_view line)
+{
+    CommandTable::tokenize(line, tokens);
+
+    // 空行とコメント行は読み飛ばす
+    if (tokens.empty() || tokens[0][0] == '#')
+    {
+        return;
+    }
+
+    const CommandSpec *command = CommandTable::find(tokens[0]);
+    if (command == nullptr)
+    {
+        recordError(tokens[0], "unknown-command");
+    }
+    else
+    {
+        (this->*command->handler)(tokens);
+    }
+
+    flushIfNeeded();
+}
+
+// コマンド実装: start <size> [time]
+void BatchRunner::handleStart(const CommandArgs &args)
+{
+    int size = 0;
+    if (args.size() < 2 || !CommandTable::parseInt(args[1], size))
+    {
+        recordError("start", "usage: start <size> [time]");
+        return;
+    }
+    if (size < 5)
+    {
+        recordError("start", "board-too-small");
+        return;
+    }
+
+    GomokuLib::TimeControl control;
+    if (args.size() >= 3 && !CommandTable::parseTimeControl(args[2], control))
+    {
+        recordError("start", "invalid-time-control");
+        return;
+    }
+
+    closeJournal();
+    game = std::make_unique<GomokuLib::Game>(size);
+    beginRecord("start", true);
+    appendField("size", size);
+    if (control.isTimed())
+    {
+        // 黒の時計は対局を始めた時点から動かす
+        game->setTimeControl(control);
+        game->startClock();
+        appendField("initialMs", static_cast<long long>(control.initialMs));
+        appendField("incrementMs", static_cast<long long>(control.incrementMs));
+    }
+    endRecord();
+}
+
+// コマンド実装: place <row> <col>
+void BatchRunner::handlePlace(const CommandArgs &args)
+{
+    if (!requireGame("place"))
+    {
+        return;
+    }
+
+    int row = 0;
+    int col = 0;
+    if (args.size() < 3 || !CommandTable::parseInt(args[1], row) || !CommandTable::parseInt(args[2], col))
+    {
+        recordError("place", "usage: place <row> <col>");
+        return;
+    }
+
+    GomokuLib::Stone stone = game->getCurrentPlayer();
+    switch (game->playTurn(row, col))
+    {
+    case GomokuLib::MoveResult::SUCCESS:
+        beginRecord("place", true);
+        appendField("row", row);
+        appendField("col", col);
+        appendField("stone", stoneToString(stone));
+        if (game->isGameOver())
+        {
+            appendField("winner", stoneToString(game->getWinner()));
+        }
+        endRecord();
+        break;
+    case GomokuLib::MoveResult::INVALID_MOVE:
+        recordError("place", "invalid-move");
+        break;
+    case GomokuLib::MoveResult::GAME_OVER:
+        recordError("place", game->getClock().getFlagged() != GomokuLib::Stone::EMPTY ? "time-over" : "game-over");
+        break;
+    }
+}
+
+// コマンド実装: show（明示的に指定された場合だけ盤面を出力する）
+void BatchRunner::handleShow(const CommandArgs &)
+{
+    if (!requireGame("show"))
+    {
+        return;
+    }
+
+    const auto &board = game->getBoard();
+    int size = board.getSize();
+
+    beginRecord("show", true);
+    appendField("size", size);
+    appendField("turn", stoneToString(game->getCurrentPlayer()));
+    appendField("winner", stoneToString(game->getWinner()));
+
+    // 盤面は1行ずつの文字列（テキスト形式では / 区切り）
+    output += (format == BatchFormat::JSON) ? ",\"board\":[" : " board=";
+    for (int row = 0; row < size; row++)
+    {
+        if (row > 0)
+        {
+            output += (format == BatchFormat::JSON) ? "," : "/";
+        }
+        if (format == BatchFormat::JSON)
+        {
+            output += '"';
+        }
+        for (int col = 0; col < size; col++)
+        {
+            auto stone = board.getStone(row, col);
+            output += (stone == GomokuLib::Stone::BLACK) ? 'B' : (stone == GomokuLib::Stone::WHITE) ? 'W' : '.';
+        }
+        if (format == BatchFormat::JSON)
+        {
+            output += '"';
+        }
+    }
+    if (format == BatchFormat::JSON)
+    {
+        output += ']';
+    }
+    endRecord();
+}
+
+// コマンド実装: moves
+void BatchRunner::handleMoves(const CommandArgs &)
+{
+    if (!requireGame("moves"))
+    {
+        return;
+    }
+
+    const auto moves = game->getMoveView();
+    beginRecord("moves", true);
+    appendField("count", static_cast<long long>(moves.size()));
+    appendMoves("moves", moves);
+    endRecord();
+}
+
+// コマンド実装: save <filename>
+void BatchRunner::handleSave(const CommandArgs &args)
+{
+    if (!requireGame("save"))
+    {
+        return;
+    }
+    if (args.size() < 2)
+    {
+        recordError("save", "usage: save <filename>");
+        return;
+    }
+
+    try
+    {
+        std::string filename(args[1]);
+        game->saveGame(filename);
+        beginRecord("save", true);
+        appendField("file", filename);
+        endRecord();
+    }
+    catch (const std::exception &e)
+    {
+        recordError("save", e.what());
+    }
+}
+
+// コマンド実装: load <filename>（--resume は対話モードとの互換のために受け付ける）
+void BatchRunner::handleLoad(const CommandArgs &args)
+{
+    std::string_view filename;
+    for (size_t i = 1; i < args.size(); i++)
+    {
+        if (args[i] != "--resume")
+        {
+            filename = args[i];
+        }
+    }
+    if (filename.empty())
+    {
+        recordError("load", "usage: load <filename>");
+        return;
+    }
+
+    try
+    {
+        auto loaded = std::make_unique<GomokuLib::Game>(GomokuLib::Game::loadGame(std::string(filename)));
+        closeJournal();
+        game = std::move(loaded);
+        beginRecord("load", true);
+        appendField("file", filename);
+        appendField("size", game->getBoard().getSize());
+        appendField("moves", static_cast<long long>(game->getMoveView().size()));
+        endRecord();
+    }
+    catch (const std::exception &e)
+    {
+        recordError("load", e.what());
+    }
+}
+
+// コマンド実装: journal <filename> / journal off
+void BatchRunner::handleJournal(const CommandArgs &args)
+{
+    if (args.size() < 2)
+    {
+        recordError("journal", "usage: journal <filename> | journal off");
+        return;
+    }
+
+    if (CommandTable::equalsIgnoreCase(args[1], "off"))
+    {
+        if (!journal)
+        {
+            recordError("journal", "no-journal");
+            return;
+        }
+        closeJournal();
+        beginRecord("journal", true);
+        appendField("closed", 1);
+        endRecord();
+        return;
+    }
+
+    // 記録があればそこから復元し、なければ現在の対局から記録を始める
+    std::string filename(args[1]);
+    if (!game && !std::filesystem::exists(filename))
+    {
+        recordError("journal", "no-game");
+        return;
+    }
+
+    try
+    {
+        closeJournal();
+        auto opened = std::make_unique<GomokuLib::GameJournal>(filename);
+        auto restored = std::make_unique<GomokuLib::Game>(opened->open(game ? *game : GomokuLib::Game(15)));
+        journal = std::move(opened);
+        game = std::move(restored);
+        game->setJournal(journal.get());
+
+        GomokuLib::GameJournalStats stats = journal->getStats();
+        beginRecord("journal", true);
+        appendField("file", filename);
+        appendField("replayed", static_cast<long long>(stats.replayed));
+        appendField("discardedBytes", static_cast<long long>(stats.discardedBytes));
+        endRecord();
+    }
+    catch (const std::exception &e)
+    {
+        recordError("journal", e.what());
+    }
+}
+
+// コマンド実装: undo
+void BatchRunner::handleUndo(const CommandArgs &)
+{
+    if (!requireGame("undo"))
+    {
+        return;
+    }
+
+    if (game->undoMove())
+    {
+        beginRecord("undo", true);
+        appendField("turn", stoneToString(game->getCurrentPlayer()));
+        endRecord();
+    }
+    else
+    {
+        recordError("undo", "nothing-to-undo");
+    }
+}
+
+// コマンド実装: redo
+void BatchRunner::handleRedo(const CommandArgs &)
+{
+    if (!requireGame("redo"))
+    {
+        return;
+    }
+
+    if (game->redoMove())
+    {
+        beginRecord("redo", true);
+        appendField("ply", static_cast<long long>(game->getPly()));
+        appendField("turn", stoneToString(game->getCurrentPlayer()));
+        endRecord();
+    }
+    else
+    {
+        recordError("redo", "nothing-to-redo");
+    }
+}
+
+// コマンド実装: goto <n>
+void BatchRunner::handleGoto(const CommandArgs &args)
+{
+    if (!requireGame("goto"))
+    {
+        return;
+    }
+
+    int target = 0;
+    if (args.size() < 2 || !CommandTable::parseInt(args[1], target))
+    {
+        recordError("goto", "usage: goto <n>");
+        return;
+    }
+    if (target < 0 || !game->jumpTo(static_cast<size_t>(target)))
+    {
+        recordError("goto", "out-of-range");
+        return;
+    }
+
+    beginRecord("goto", true);
+    appendField("ply", target);
+    appendField("length", static_cast<long long>(game->getLineView().size()));
+    appendField("turn", stoneToString(game->getCurrentPlayer()));
+    endRecord();
+}
+
+// コマンド実装: variations
+void BatchRunner::handleVariations(const CommandArgs &)
+{
+    if (!requireGame("variations"))
+    {
+        return;
+    }
+
+    const auto variations = game->getVariations();
+    beginRecord("variations", true);
+    appendField("ply", static_cast<long long>(game->getPly()));
+    appendField("count", static_cast<long long>(variations.size()));
+    appendMoves("variations", GomokuLib::MoveSpan(variations.data(), variations.size()));
+    endRecord();
+}
+
+// コマンド実装: variation <n>
+void BatchRunner::handleVariation(const CommandArgs &args)
+{
+    switchVariation(args, false);
+}
+
+// コマンド実装: prune <n>
+void BatchRunner::handlePrune(const CommandArgs &args)
+{
+    switchVariation(args, true);
+}
+
+void BatchRunner::switchVariation(const CommandArgs &args, bool prune)
+{
+    const char *command = prune ? "prune" : "variation";
+    if (!requireGame(command))
+    {
+        return;
+    }
+
+    int index = 0;
+    if (args.size() < 2 || !CommandTable::parseInt(args[1], index))
+    {
+        recordError(command, prune ? "usage: prune <n>" : "usage: variation <n>");
+        return;
+    }
+    bool done = index >= 0 && (prune ? game->pruneVariation(static_cast<size_t>(index))
+                                     : game->selectVariation(static_cast<size_t>(index)));
+    if (!done)
+    {
+        recordError(command, "no-such-variation");
+        return;
+    }
+
+    beginRecord(command, true);
+    appendField("index", index);
+    appendField("length", static_cast<long long>(game->getLineView().size()));
+    endRecord();
+}
+
+// コマンド実装: go [depth]（手番側の手をエンジンが決めて打つ）
+void BatchRunner::handleGo(const CommandArgs &args)
+{
+    if (!requireGame("go"))
+    {
+        return;
+    }
+
+    // 持ち時間のある対局では、残り時間から決めた時間だけ読む
+    GomokuLib::SearchLimits limits;
+    limits.network = network;
+    limits.time = GomokuLib::TimeManager::allocate(*game);
+    if (limits.time.isLimited())
+    {
+        limits.maxDepth = MAX_TIMED_DEPTH;
+    }
+    if (!parseDepth("go", args, 1, limits.maxDepth))
+    {
+        return;
+    }
+
+    // 考えている間に時間切れになっていれば指せない
+    game->checkTime();
+    if (game->isGameOver())
+    {
+        recordError("go", game->getClock().getFlagged() != GomokuLib::Stone::EMPTY ? "time-over" : "game-over");
+        return;
+    }
+
+    GomokuLib::Stone player = game->getCurrentPlayer();
+    GomokuLib::SearchResult result = GomokuLib::Search::run(game->getBoard(), player, limits);
+    if (result.bestMove.first < 0)
+    {
+        recordError("go", "no-move");
+        return;
+    }
+
+    int row = result.bestMove.first;
+    int col = result.bestMove.second;
+    if (game->playTurn(row, col) != GomokuLib::MoveResult::SUCCESS)
+    {
+        recordError("go", "time-over");
+        return;
+    }
+
+    beginRecord("go", true);
+    appendField("row", row);
+    appendField("col", col);
+    appendField("stone", stoneToString(player));
+    appendField("depth", result.depth);
+    appendField("nodes", static_cast<long long>(result.nodes));
+    if (result.forced)
+    {
+        appendField("forced", 1);
+    }
+    if (game->isGameOver())
+    {
+        appendField("winner", stoneToString(game->getWinner()));
+    }
+    endRecord();
+}
+
+// コマンド実装: analyze [depth] / analyze game [depth]
+// バッチ実行では結果を順に記録するため、バックグラウンドではなくその場で読み終える
+void BatchRunner::handleAnalyze(const CommandArgs &args)
+{
+    if (!requireGame("analyze"))
+    {
+        return;
+    }
+
+    if (args.size() >= 2 && CommandTable::equalsIgnoreCase(args[1], "game"))
+    {
+        handleAnalyzeGame(args);
+        return;
+    }
+
+    if (game->isGameOver())
+    {
+        recordError("analyze", "game-over");
+        return;
+    }
+
+    GomokuLib::SearchLimits limits;
+    limits.network = network;
+    if (!parseDepth("analyze", args, 1, limits.maxDepth))
+    {
+        return;
+    }
+
+    analysis = GomokuLib::Search::run(game->getBoard(), game->getCurrentPlayer(), limits);
+    recordAnalysis("analyze");
+}
+
+// コマンド実装: analyze game [depth] [--json]（--json は対話モードとの互換のために受け付ける）
+void BatchRunner::handleAnalyzeGame(const CommandArgs &args)
+{
+    GomokuLib::GameAnalysisOptions options;
+    options.limits.network = network;
+    for (size_t i = 2; i < args.size(); i++)
+    {
+        if (!CommandTable::equalsIgnoreCase(args[i], "--json") && !parseDepth("analyze", args, i, options.limits.maxDepth))
+        {
+            return;
+        }
+    }
+
+    if (game->getMoveView().empty())
+    {
+        recordError("analyze", "no-moves");
+        return;
+    }
+
+    try
+    {
+        auto result = GomokuLib::GameAnalyzer::analyze(*game, options);
+
+        long long blunders = 0;
+        long long missedWins = 0;
+        for (const auto &move : result.moves)
+        {
+            blunders += (move.judgement == GomokuLib::MoveJudgement::BLUNDER) ? 1 : 0;
+            missedWins += (move.judgement == GomokuLib::MoveJudgement::MISSED_WIN) ? 1 : 0;
+        }
+
+        beginRecord("analyze", true);
+        appendField("moves", static_cast<long long>(result.moves.size()));
+        appendField("nodes", static_cast<long long>(result.nodes));
+        appendField("blunders", blunders);
+        appendField("missedWins", missedWins);
+
+        // 各局面の黒から見た評価値（テキスト形式では ; 区切り）
+        output += (format == BatchFormat::JSON) ? ",\"evaluations\":[" : " evaluations=";
+        for (size_t i = 0; i < result.evaluations.size(); i++)
+        {
+            if (i > 0)
+            {
+                output += (format == BatchFormat::JSON) ? "," : ";";
+            }
+            output += std::to_string(result.evaluations[i]);
+        }
+        if (format == BatchFormat::JSON)
+        {
+            output += ']';
+        }
+        endRecord();
+    }
+    catch (const std::exception &e)
+    {
+        recordError("analyze", e.what());
+    }
+}
+
+// コマンド実装: analysis（直前の analyze の結果）
+void BatchRunner::handleAnalysis(const CommandArgs &)
+{
+    if (!analysis)
+    {
+        recordError("analysis", "no-analysis");
+        return;
+    }
+    recordAnalysis("analysis");
+}
+
+void BatchRunner::recordAnalysis(std::string_view command)
+{
+    const auto &pv = analysis->principalVariation;
+    beginRecord(command, true);
+    appendField("depth", analysis->depth);
+    appendField("row", analysis->bestMove.first);
+    appendField("col", analysis->bestMove.second);
+    appendField("score", analysis->score);
+    appendField("nodes", static_cast<long long>(analysis->nodes));
+    appendMoves("pv", GomokuLib::MoveSpan(pv.data(), pv.size()));
+    endRecord();
+}
+
+// コマンド実装: stop（バッチ実行の解析はその場で読み終えるので、止める解析はない）
+void BatchRunner::handleStop(const CommandArgs &)
+{
+    recordError("stop", "no-analysis-running");
+}
+
+// コマンド実装: perft <depth> [threads]
+void BatchRunner::handlePerft(const CommandArgs &args)
+{
+    if (!requireGame("perft"))
+    {
+        return;
+    }
+
+    int depth = 0;
+    int threads = 1;
+    if (args.size() < 2 || !CommandTable::parseInt(args[1], depth) ||
+        (args.size() >= 3 && !CommandTable::parseInt(args[2], threads)) || depth < 0 || threads < 0)
+    {
+        recordError("perft", "usage: perft <depth> [threads]");
+        return;
+    }
+
+    // Perft は対局のコピーで数えるので、記録や持ち時間には影響しない
+    GomokuLib::PerftResult result = (threads == 1) ? GomokuLib::Perft::count(*game, depth)
+                                                   : GomokuLib::Perft::countParallel(*game, depth, static_cast<size_t>(threads));
+    beginRecord("perft", true);
+    appendField("depth", depth);
+    appendField("sequences", static_cast<long long>(result.sequences));
+    appendField("nodes", static_cast<long long>(result.nodes));
+    appendField("terminals", static_cast<long long>(result.terminals));
+    appendField("ms", static_cast<long long>(result.seconds * 1000));
+    endRecord();
+}
+
+// コマンド実装: stats [json|prometheus|reset]
+// 記録の形式は --format で決まるので、json と prometheus は引数なしと同じに扱う
+void BatchRunner::handleStats(const CommandArgs &args)
+{
+    if (!GomokuLib::Instrumentation::ENABLED)
+    {
+        recordError("stats", "instrumentation-disabled");
+        return;
+    }
+
+    std::string_view option = (args.size() >= 2) ? args[1] : std::string_view();
+    if (CommandTable::equalsIgnoreCase(option, "reset"))
+    {
+        GomokuLib::Instrumentation::reset();
+        beginRecord("stats", true);
+        appendField("reset", 1);
+        endRecord();
+        return;
+    }
+    if (!option.empty() && !CommandTable::equalsIgnoreCase(option, "json") && !CommandTable::equalsIgnoreCase(option, "prometheus"))
+    {
+        recordError("stats", "usage: stats [json|prometheus|reset]");
+        return;
+    }
+
+    // カウンタは名前ごと、タイマーは <名前>.count / .p50 / .p99 / .max（ナノ秒）の項目にする
+    auto snapshot = GomokuLib::Instrumentation::snapshot();
+    beginRecord("stats", true);
+    for (size_t i = 0; i < GomokuLib::Instrumentation::COUNTER_COUNT; i++)
+    {
+        appendField(GomokuLib::Instrumentation::counterName(static_cast<GomokuLib::Counter>(i)),
+                    static_cast<long long>(snapshot.counters[i]));
+    }
+    for (const auto &timer : snapshot.timers)
+    {
+        appendField(timer.name + ".count", static_cast<long long>(timer.count));
+        appendField(timer.name + ".p50", static_cast<long long>(timer.p50));
+        appendField(timer.name + ".p99", static_cast<long long>(timer.p99));
+        appendField(timer.name + ".max", static_cast<long long>(timer.max));
+    }
+    endRecord();
+}
+
+// コマンド実装: trace start <file> / trace stop
+void BatchRunner::handleTrace(const CommandArgs &args)
+{
+    if (!GomokuLib::Instrumentation::ENABLED)
+    {
+        recordError("trace", "instrumentation-disabled");
+        return;
+    }
+
+    if (args.size() == 3 && CommandTable::equalsIgnoreCase(args[1], "start"))
+    {
+        try
+        {
+            GomokuLib::Tracer::start(std::string(args[2]));
+            beginRecord("trace", true);
+            appendField("file", args[2]);
+            endRecord();
+        }
+        catch (const std::exception &e)
+        {
+            recordError("trace", e.what());
+        }
+    }
+    else if (args.size() == 2 && CommandTable::equalsIgnoreCase(args[1], "stop"))
+    {
+        if (!GomokuLib::Tracer::isEnabled())
+        {
+            recordError("trace", "not-running");
+            return;
+        }
+        GomokuLib::Tracer::stop();
+        beginRecord("trace", true);
+        appendField("written", static_cast<long long>(GomokuLib::Tracer::getWrittenCount()));
+        appendField("dropped", static_cast<long long>(GomokuLib::Tracer::getDroppedCount()));
+        endRecord();
+    }
+    else
+    {
+        recordError("trace", "usage: trace start <file> | trace stop");
+    }
+}
+
+// コマンド実装: exit/quit
+void BatchRunner::handleExit(const CommandArgs &)
+{
+    beginRecord("exit", true);
+    endRecord();
+    isRunning = false;
+}
+
+// コマンド実装: help（コマンド名の一覧）
+void BatchRunner::handleHelp(const CommandArgs &)
+{
+    beginRecord("help", true);
+    output += (format == BatchFormat::JSON) ? ",\"commands\":[" : " commands=";
+    std::string_view previous;
+    for (const auto &command : CommandTable::getCommands())
+    {
+        if (command.name == previous)
+        {
+            continue;
+        }
+        if (!previous.empty())
+        {
+            output += (format == BatchFormat::JSON) ? "," : ";";
+        }
+        if (format == BatchFormat::JSON)
+        {
+            appendJsonString(command.name);
+        }
+        else
+        {
+            output += command.name;
+        }
+        previous = command.name;
+    }
+    if (format == BatchFormat::JSON)
+    {
+        output += ']';
+    }
+    endRecord();
+}
+
+bool BatchRunner::parseDepth(std::string_view command, const CommandArgs &args, size_t index, int &depth)
+{
+    if (index >= args.size())
+    {
+        return true;
+    }
+    if (!CommandTable::parseInt(args[index], depth) || depth < 1)
+    {
+        recordError(command, "invalid-depth");
+        return false;
+    }
+    return true;
+}
+
+void BatchRunner::closeJournal()
+{
+    if (!journal)
+    {
+        return;
+    }
+    if (game)
+    {
+        game->setJournal(nullptr);
+    }
+    journal.reset();
+}
+
+bool BatchRunner::requireGame(std::string_view command)
+{
+    if (!game)
+    {
+        recordError(command, "no-game");
+        return false;
+    }
+    return true;
+}
+
+void BatchRunner::beginRecord(std::string_view command, bool ok)
+{
+    if (format == BatchFormat::JSON)
+    {
+        output += "{\"cmd\":";
+        appendJsonString(command);
+        output += ok ? ",\"ok\":true" : ",\"ok\":false";
+    }
+    else
+    {
+        output += ok ? "ok " : "error ";
+        output += command;
+    }
+}
+
+void BatchRunner::endRecord()
+{
+    output += (format == BatchFormat::JSON) ? "}\n" : "\n";
+}
+
+void BatchRunner::appendField(std::string_view key, long long value)
+{
+    char digits[24];
+    auto result = std::to_chars(digits, digits + sizeof(digits), value);
+
+    if (format == BatchFormat::JSON)
+    {
+        output += ",\"";
+        output += key;
+        output += "\":";
+    }
+    else
+    {
+        output += ' ';
+        output += key;
+        output += '=';
+    }
+    output.append(digits, result.ptr);
+}
+
+void BatchRunner::appendField(std::string_view key, std::string_view value)
+{
+    if (format == BatchFormat::JSON)
+    {
+        output += ",\"";
+        output += key;
+        output += "\":";
+        appendJsonString(value);
+    }
+    else
+    {
+        output += ' ';
+        output += key;
+        output += '=';
+        // 値に空白を含む場合は引用符で囲む
+        if (value.find(' ') != std::string_view::npos)
+        {
+            output += '"';
+            output += value;
+            output += '"';
+        }
+        else
+        {
+            output += value;
+        }
+    }
+}
+
+void BatchRunner::appendMoves(std::string_view key, GomokuLib::MoveSpan moves)
+{
+    // 着手の一覧（テキスト形式では row,col を ; 区切り、JSON では [row,col] の配列）
+    if (format == BatchFormat::JSON)
+    {
+        output += ",\"";
+        output += key;
+        output += "\":[";
+    }
+    else
+    {
+        output += ' ';
+        output += key;
+        output += '=';
+    }
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        if (i > 0)
+        {
+            output += (format == BatchFormat::JSON) ? "," : ";";
+        }
+        output += (format == BatchFormat::JSON) ? "[" : "";
+        output += std::to_string(moves[i].first);
+        output += ',';
+        output += std::to_string(moves[i].second);
+        output += (format == BatchFormat::JSON) ? "]" : "";
+    }
+    if (format == BatchFormat::JSON)
+    {
+        output += ']';
+    }
+}
+
+void BatchRunner::appendJsonString(std::string_view value)
+{
+    // 引用符・バックスラッシュ・制御文字はエスケープする（コマンド名など入力をそのまま書く値もある）
+    static const char HEX[] = "0123456789abcdef";
+    output += '"';
+    for (char c : value)
+    {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\')
+        {
+            output += '\\';
+            output += c;
+        }
+        else if (byte < 0x20 || byte == 0x7f)
+        {
+            output += "\\u00";
+            output += HEX[byte >> 4];
+            output += HEX[byte & 0x0f];
+        }
+        else
+        {
+            output += c;
+        }
+    }
+    output += '"';
+}
+
+void BatchRunner::recordError(std::string_view command, std::string_view error)
+{
+    errorCount++;
+    beginRecord(command, false);
+    appendField("line", static_cast<long long>(lineNumber));
+    appendField("error", error);
+    endRecord();
+}
+
+void BatchRunner::flushIfNeeded()
+{
+    if (output.size() >= OUTPUT_BUFFER_SIZE)
+    {
+        flush();
+    }
+}
+
+void BatchRunner::flush()
+{
+    size_t written = 0;
+    while (written < output.size())
+    {
+        ssize_t n = ::write(outputFd, output.data() + written, output.size() - written);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    output.clear();
+}
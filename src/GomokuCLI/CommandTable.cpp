@@ -0,0 +1,126 @@
+#include "GomokuCLI/CommandTable.h"
+#include <charconv>
+#include <stdexcept>
+#include <string>
+
+const std::vector<CommandSpec> &CommandTable::getCommands()
+{
+    static const std::vector<CommandSpec> commands = {
+        {"start", "start <size> [time]", "Start a new game (time: <seconds>[+<increment>] per player, e.g. 300+5)", &CommandHandler::handleStart},
+        {"place", "place <row> <col>", "Place a stone at the specified position", &CommandHandler::handlePlace},
+        {"show", "show", "Display the current board", &CommandHandler::handleShow},
+        {"moves", "moves", "Display the move history", &CommandHandler::handleMoves},
+        {"save", "save <filename>", "Save the current game to a file", &CommandHandler::handleSave},
+        {"load", "load <filename>", "Load a game from a file for viewing", &CommandHandler::handleLoad},
+        {"load", "load --resume <filename>", "Load a game from a file and resume playing", &CommandHandler::handleLoad},
+        {"journal", "journal <filename> / off", "Record every move to a crash-safe journal (restores it if it exists)", &CommandHandler::handleJournal},
+        {"undo", "undo", "Undo the last move", &CommandHandler::handleUndo},
+        {"redo", "redo", "Redo an undone move", &CommandHandler::handleRedo},
+        {"goto", "goto <n>", "Jump to the position after move n (0 = empty board)", &CommandHandler::handleGoto},
+        {"variations", "variations", "List the moves played from this position", &CommandHandler::handleVariations},
+        {"variation", "variation <n>", "Continue the line with variation n", &CommandHandler::handleVariation},
+        {"prune", "prune <n>", "Delete variation n and everything after it", &CommandHandler::handlePrune},
+        {"go", "go [depth]", "Let the engine play for the side to move (uses the clock in timed games)", &CommandHandler::handleGo},
+        {"analyze", "analyze [depth]", "Search for the best move from this position (default depth 4)", &CommandHandler::handleAnalyze},
+        {"analyze", "analyze game [depth] [--json]", "Evaluate every move of the game and report mistakes", &CommandHandler::handleAnalyze},
+        {"analysis", "analysis", "Show the best line found so far", &CommandHandler::handleAnalysis},
+        {"stop", "stop", "Stop the running analysis", &CommandHandler::handleStop},
+        {"perft", "perft <depth> [threads]", "Count every legal move sequence of the given length", &CommandHandler::handlePerft},
+        {"stats", "stats [json|prometheus|reset]", "Show counters and timing histograms", &CommandHandler::handleStats},
+        {"trace", "trace start <file> / stop", "Record a Chrome trace of the following commands", &CommandHandler::handleTrace},
+        {"exit", "exit / quit", "Exit the application", &CommandHandler::handleExit},
+        {"quit", "", "", &CommandHandler::handleExit},
+        {"help", "help", "Display this help message", &CommandHandler::handleHelp},
+    };
+    return commands;
+}
+
+const CommandSpec *CommandTable::find(std::string_view name)
+{
+    for (const auto &command : getCommands())
+    {
+        if (equalsIgnoreCase(name, command.name))
+        {
+            return &command;
+        }
+    }
+    return nullptr;
+}
+
+void CommandTable::tokenize(std::string_view line, CommandArgs &tokens)
+{
+    tokens.clear();
+    size_t pos = 0;
+    while (pos < line.size())
+    {
+        while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r'))
+        {
+            pos++;
+        }
+        size_t start = pos;
+        while (pos < line.size() && line[pos] != ' ' && line[pos] != '\t' && line[pos] != '\r')
+        {
+            pos++;
+        }
+        if (pos > start)
+        {
+            tokens.push_back(line.substr(start, pos - start));
+        }
+    }
+}
+
+bool CommandTable::equalsIgnoreCase(std::string_view token, std::string_view keyword)
+{
+    if (token.size() != keyword.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < token.size(); i++)
+    {
+        char c = token[i];
+        if (c >= 'A' && c <= 'Z')
+        {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+        if (c != keyword[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CommandTable::parseInt(std::string_view text, int &value)
+{
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+bool CommandTable::parseTimeControl(std::string_view text, GomokuLib::TimeControl &control)
+{
+    try
+    {
+        size_t plus = text.find('+');
+        std::string baseText(text.substr(0, plus));
+        size_t used = 0;
+        double base = std::stod(baseText, &used);
+        if (used != baseText.size() || base <= 0)
+            return false;
+        double increment = 0;
+        if (plus != std::string_view::npos)
+        {
+            std::string incrementText(text.substr(plus + 1));
+            increment = std::stod(incrementText, &used);
+            if (used != incrementText.size() || increment < 0)
+                return false;
+        }
+        control.initialMs = static_cast<int64_t>(base * 1000);
+        control.incrementMs = static_cast<int64_t>(increment * 1000);
+        control.overheadMs = MOVE_OVERHEAD_MS;
+        return control.initialMs > 0;
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+}
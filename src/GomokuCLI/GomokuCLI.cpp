@@ -1,38 +1,47 @@
 #include "GomokuCLI/GomokuCLI.h"
+#include "GomokuLib/Instrumentation.h"
+#include "GomokuLib/Perft.h"
+#include "GomokuLib/Search.h"
+#include "GomokuLib/TimeManager.h"
+#include "GomokuLib/Tracer.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <cctype>
+#include <chrono>
+#include <filesystem>
 #include <iomanip>
+#include <unistd.h>
 
-GomokuCLI::GomokuCLI() : isRunning(true), gameLoaded(false)
+namespace
 {
-    registerCommands();
+    // 持ち時間のある対局で、エンジンが1手に読む深さの上限（実際には時間で止まる）
+    constexpr int MAX_TIMED_DEPTH = 64;
+
+    // 残り時間を m:ss.d 形式にする（尽きていれば 0:00.0）
+    std::string formatClock(int64_t milliseconds)
+    {
+        milliseconds = std::max<int64_t>(0, milliseconds);
+        std::ostringstream out;
+        out << milliseconds / 60000 << ":" << std::setw(2) << std::setfill('0') << milliseconds / 1000 % 60 << "."
+            << milliseconds / 100 % 10;
+        return out.str();
+    }
+}
+
+GomokuCLI::GomokuCLI() : isRunning(true), gameLoaded(false), renderer(STDOUT_FILENO), analysisReported(true)
+{
+}
+
+GomokuCLI::~GomokuCLI()
+{
+    // 読み終えるのを待たずに終了できるよう、探索を打ち切る
+    analysis.cancel();
 }
 
-void GomokuCLI::registerCommands()
+void GomokuCLI::setNetwork(std::shared_ptr<const GomokuLib::NeuralNetwork> value)
 {
-    // コマンドとハンドラーを登録
-    commandHandlers["start"] = [this](const auto &args)
-    { handleStart(args); };
-    commandHandlers["place"] = [this](const auto &args)
-    { handlePlace(args); };
-    commandHandlers["show"] = [this](const auto &args)
-    { handleShow(args); };
-    commandHandlers["moves"] = [this](const auto &args)
-    { handleMoves(args); };
-    commandHandlers["save"] = [this](const auto &args)
-    { handleSave(args); };
-    commandHandlers["load"] = [this](const auto &args)
-    { handleLoad(args); };
-    commandHandlers["undo"] = [this](const auto &args)
-    { handleUndo(args); };
-    commandHandlers["exit"] = [this](const auto &args)
-    { handleExit(args); };
-    commandHandlers["quit"] = [this](const auto &args)
-    { handleExit(args); };
-    commandHandlers["help"] = [this](const auto &args)
-    { handleHelp(args); };
+    network = std::move(value);
 }
 
 void GomokuCLI::run()
@@ -41,56 +50,41 @@ void GomokuCLI::run()
     std::cout << "Type 'help' for a list of available commands." << std::endl;
 
     std::string input;
+    CommandArgs tokens;
     while (isRunning)
     {
-        std::cout << "\nGomoku> ";
-        std::getline(std::cin, input);
-
-        if (input.empty())
-            continue;
+        // 解析はワーカースレッドで進むので、結果の表示はコマンドの合間に行う
+        pollAnalysis();
 
-        auto tokens = parseCommand(input);
-        if (!tokens.empty())
+        std::cout << "\nGomoku> ";
+        if (!std::getline(std::cin, input))
         {
-            if (!executeCommand(tokens))
-            {
-                std::cerr << "Unknown command: " << tokens[0] << std::endl;
-                std::cerr << "Type 'help' for a list of available commands." << std::endl;
-            }
+            break;
         }
-    }
-}
-
-std::vector<std::string> GomokuCLI::parseCommand(const std::string &input)
-{
-    std::vector<std::string> tokens;
-    std::istringstream iss(input);
-    std::string token;
 
-    while (iss >> token)
-    {
-        // コマンドは小文字に統一
-        std::transform(token.begin(), token.end(), token.begin(),
-                       [](unsigned char c)
-                       { return std::tolower(c); });
-        tokens.push_back(token);
+        CommandTable::tokenize(input, tokens);
+        if (!tokens.empty() && !executeCommand(tokens))
+        {
+            std::cerr << "Unknown command: " << tokens[0] << std::endl;
+            std::cerr << "Type 'help' for a list of available commands." << std::endl;
+        }
     }
-
-    return tokens;
 }
 
-bool GomokuCLI::executeCommand(const std::vector<std::string> &tokens)
+bool GomokuCLI::executeCommand(const CommandArgs &tokens)
 {
-    const std::string &command = tokens[0];
-
-    auto it = commandHandlers.find(command);
-    if (it != commandHandlers.end())
+    const CommandSpec *command = CommandTable::find(tokens[0]);
+    if (command == nullptr)
     {
-        it->second(tokens);
-        return true;
+        return false;
     }
 
-    return false;
+#if GOMOKU_INSTRUMENTATION
+    // コマンドごとの処理時間（名前は実行時に決まるので、マクロを使わずに記録する）
+    GomokuLib::ScopedTimer timer(GomokuLib::Instrumentation::timer("cli." + std::string(command->name)));
+#endif
+    (this->*command->handler)(tokens);
+    return true;
 }
 
 bool GomokuCLI::isGameStarted() const
@@ -99,38 +93,52 @@ bool GomokuCLI::isGameStarted() const
 }
 
 // コマンド実装: start
-void GomokuCLI::handleStart(const std::vector<std::string> &args)
+void GomokuCLI::handleStart(const CommandArgs &args)
 {
     if (args.size() < 2)
     {
-        std::cerr << "Error: Please specify board size. Usage: start <size>" << std::endl;
+        std::cerr << "Error: Please specify board size. Usage: start <size> [<seconds>[+<increment>]]" << std::endl;
         return;
     }
 
-    try
+    GomokuLib::TimeControl control;
+    if (args.size() >= 3 && !CommandTable::parseTimeControl(args[2], control))
     {
-        int size = std::stoi(args[1]);
-        if (size < 5)
-        {
-            std::cerr << "Error: Board size must be at least 5." << std::endl;
-            return;
-        }
-
-        game = std::make_unique<GomokuLib::Game>(size);
-        gameLoaded = true;
-        clearScreen();
-        std::cout << "New game started with board size " << size << "x" << size << std::endl;
-        displayBoard();
-        displayGameStatus();
+        std::cerr << "Error: Invalid time control. Use <seconds>[+<increment>], e.g. 300+5." << std::endl;
+        return;
     }
-    catch (const std::invalid_argument &)
+
+    int size = 0;
+    if (!CommandTable::parseInt(args[1], size))
     {
         std::cerr << "Error: Invalid board size. Please enter a valid number." << std::endl;
+        return;
+    }
+    if (size < 5)
+    {
+        std::cerr << "Error: Board size must be at least 5." << std::endl;
+        return;
     }
+
+    closeJournal();
+    game = std::make_unique<GomokuLib::Game>(size);
+    gameLoaded = true;
+    clearScreen();
+    std::cout << "New game started with board size " << size << "x" << size << std::endl;
+    if (control.isTimed())
+    {
+        // 黒の時計は対局を始めた時点から動かす
+        game->setTimeControl(control);
+        game->startClock();
+        std::cout << "Time control: " << control.initialMs / 1000.0 << "s + " << control.incrementMs / 1000.0
+                  << "s per move" << std::endl;
+    }
+    displayBoard();
+    displayGameStatus();
 }
 
 // コマンド実装: place
-void GomokuCLI::handlePlace(const std::vector<std::string> &args)
+void GomokuCLI::handlePlace(const CommandArgs &args)
 {
     if (!isGameStarted())
     {
@@ -144,63 +152,21 @@ void GomokuCLI::handlePlace(const std::vector<std::string> &args)
         return;
     }
 
-    try
-    {
-        int row = std::stoi(args[1]);
-        int col = std::stoi(args[2]);
-
-        auto result = game->playTurn(row, col);
-        clearScreen();
-
-        switch (result)
-        {
-        case GomokuLib::MoveResult::SUCCESS:
-            std::cout << "Stone placed at (" << row << "," << col << ")" << std::endl;
-            displayBoard();
-
-            if (game->isGameOver())
-            {
-                auto winner = game->getWinner();
-                if (winner == GomokuLib::Stone::BLACK)
-                {
-                    std::cout << "Black wins!" << std::endl;
-                }
-                else if (winner == GomokuLib::Stone::WHITE)
-                {
-                    std::cout << "White wins!" << std::endl;
-                }
-                else if (winner == GomokuLib::Stone::DRAW)
-                {
-                    std::cout << "The game ended in a draw!" << std::endl;
-                }
-            }
-            else
-            {
-                displayGameStatus();
-            }
-            break;
-
-        case GomokuLib::MoveResult::INVALID_MOVE:
-            std::cerr << "Error: Invalid move. The position is either occupied or out of bounds." << std::endl;
-            displayBoard();
-            displayGameStatus();
-            break;
-
-        case GomokuLib::MoveResult::GAME_OVER:
-            std::cerr << "Error: The game is already over." << std::endl;
-            displayBoard();
-            std::cout << "Game is over. Start a new game or load a saved one." << std::endl;
-            break;
-        }
-    }
-    catch (const std::invalid_argument &)
+    int row = 0;
+    int col = 0;
+    if (!CommandTable::parseInt(args[1], row) || !CommandTable::parseInt(args[2], col))
     {
         std::cerr << "Error: Invalid coordinates. Please enter valid numbers." << std::endl;
+        return;
     }
+
+    auto result = game->playTurn(row, col);
+    clearScreen();
+    displayMoveResult(result, "Stone placed at (" + std::to_string(row) + "," + std::to_string(col) + ")");
 }
 
 // コマンド実装: show
-void GomokuCLI::handleShow(const std::vector<std::string> &args)
+void GomokuCLI::handleShow(const CommandArgs &)
 {
     if (!isGameStarted())
     {
@@ -214,7 +180,7 @@ void GomokuCLI::handleShow(const std::vector<std::string> &args)
 }
 
 // コマンド実装: moves
-void GomokuCLI::handleMoves(const std::vector<std::string> &args)
+void GomokuCLI::handleMoves(const CommandArgs &)
 {
     if (!isGameStarted())
     {
@@ -229,7 +195,7 @@ void GomokuCLI::handleMoves(const std::vector<std::string> &args)
 }
 
 // コマンド実装: save
-void GomokuCLI::handleSave(const std::vector<std::string> &args)
+void GomokuCLI::handleSave(const CommandArgs &args)
 {
     if (!isGameStarted())
     {
@@ -245,7 +211,7 @@ void GomokuCLI::handleSave(const std::vector<std::string> &args)
 
     try
     {
-        std::string filename = args[1];
+        std::string filename(args[1]);
         game->saveGame(filename);
         std::cout << "Game saved to " << filename << std::endl;
     }
@@ -256,7 +222,7 @@ void GomokuCLI::handleSave(const std::vector<std::string> &args)
 }
 
 // コマンド実装: load
-void GomokuCLI::handleLoad(const std::vector<std::string> &args)
+void GomokuCLI::handleLoad(const CommandArgs &args)
 {
     if (args.size() < 2)
     {
@@ -270,7 +236,7 @@ void GomokuCLI::handleLoad(const std::vector<std::string> &args)
         bool resume = false;
 
         // --resume オプションの確認
-        if (args.size() >= 3 && args[1] == "--resume" && args.size() >= 3)
+        if (args.size() >= 3 && args[1] == "--resume")
         {
             filename = args[2];
             resume = true;
@@ -286,7 +252,9 @@ void GomokuCLI::handleLoad(const std::vector<std::string> &args)
         }
 
         // ゲームの読み込み
-        game = std::make_unique<GomokuLib::Game>(GomokuLib::Game::loadGame(filename));
+        auto loaded = std::make_unique<GomokuLib::Game>(GomokuLib::Game::loadGame(filename));
+        closeJournal();
+        game = std::move(loaded);
         gameLoaded = true;
         clearScreen();
 
@@ -308,8 +276,64 @@ void GomokuCLI::handleLoad(const std::vector<std::string> &args)
     }
 }
 
+// コマンド実装: journal
+void GomokuCLI::handleJournal(const CommandArgs &args)
+{
+    if (args.size() < 2)
+    {
+        std::cerr << "Error: Please specify a filename. Usage: journal <filename> | journal off" << std::endl;
+        return;
+    }
+
+    if (CommandTable::equalsIgnoreCase(args[1], "off"))
+    {
+        if (!journal)
+        {
+            std::cerr << "Error: No journal is open." << std::endl;
+            return;
+        }
+        closeJournal();
+        std::cout << "Journal closed." << std::endl;
+        return;
+    }
+
+    // 記録があればそこから復元し、なければ現在の対局から記録を始める
+    std::string filename(args[1]);
+    if (!isGameStarted() && !std::filesystem::exists(filename))
+    {
+        std::cerr << "Error: No game in progress. Use 'start <size>' to start a new game." << std::endl;
+        return;
+    }
+
+    try
+    {
+        closeJournal();
+        auto opened = std::make_unique<GomokuLib::GameJournal>(filename);
+        auto restored = std::make_unique<GomokuLib::Game>(opened->open(isGameStarted() ? *game : GomokuLib::Game(15)));
+        journal = std::move(opened);
+        game = std::move(restored);
+        game->setJournal(journal.get());
+        gameLoaded = true;
+        clearScreen();
+
+        GomokuLib::GameJournalStats stats = journal->getStats();
+        std::cout << "Journaling game to " << filename << " (replayed " << stats.replayed << " operations";
+        if (stats.discardedBytes > 0)
+        {
+            std::cout << ", discarded " << stats.discardedBytes << " bytes of a torn record";
+        }
+        std::cout << ")" << std::endl;
+        displayBoard();
+        displayGameStatus();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error opening journal: " << e.what() << std::endl;
+    }
+}
+
 // コマンド実装: undo
-void GomokuCLI::handleUndo(const std::vector<std::string> &args)
+void GomokuCLI::handleUndo(const CommandArgs &)
 {
     if (!isGameStarted())
     {
@@ -330,112 +354,688 @@ void GomokuCLI::handleUndo(const std::vector<std::string> &args)
     }
 }
 
-// コマンド実装: exit/quit
-void GomokuCLI::handleExit(const std::vector<std::string> &args)
+// コマンド実装: goto
+void GomokuCLI::handleGoto(const CommandArgs &args)
 {
-    isRunning = false;
-    std::cout << "Thank you for playing Gomoku. Goodbye!" << std::endl;
+    if (!isGameStarted())
+    {
+        std::cerr << "Error: No game in progress. Use 'start <size>' to start a new game." << std::endl;
+        return;
+    }
+
+    if (args.size() < 2)
+    {
+        std::cerr << "Error: Please specify a move number. Usage: goto <n>" << std::endl;
+        return;
+    }
+
+    int target = 0;
+    if (!CommandTable::parseInt(args[1], target))
+    {
+        std::cerr << "Error: Invalid move number. Please enter a valid number." << std::endl;
+        return;
+    }
+    size_t length = game->getLineView().size();
+    if (target < 0 || static_cast<size_t>(target) > length)
+    {
+        std::cerr << "Error: Move number must be between 0 and " << length << "." << std::endl;
+        return;
+    }
+
+    game->jumpTo(static_cast<size_t>(target));
+    clearScreen();
+    std::cout << "Moved to move " << target << " of " << length << std::endl;
+    displayBoard();
+    displayGameStatus();
 }
 
-// コマンド実装: help
-void GomokuCLI::handleHelp(const std::vector<std::string> &args)
+// コマンド実装: redo
+void GomokuCLI::handleRedo(const CommandArgs &)
 {
-    clearScreen();
-    std::cout << "Available commands:" << std::endl;
-    std::cout << "-----------------" << std::endl;
-    std::cout << "start <size>              - Start a new game with specified board size" << std::endl;
-    std::cout << "place <row> <col>         - Place a stone at the specified position" << std::endl;
-    std::cout << "show                      - Display the current board" << std::endl;
-    std::cout << "moves                     - Display the move history" << std::endl;
-    std::cout << "save <filename>           - Save the current game to a file" << std::endl;
-    std::cout << "load <filename>           - Load a game from a file for viewing" << std::endl;
-    std::cout << "load --resume <filename>  - Load a game from a file and resume playing" << std::endl;
-    std::cout << "undo                      - Undo the last move" << std::endl;
-    std::cout << "exit / quit               - Exit the application" << std::endl;
-    std::cout << "help                      - Display this help message" << std::endl;
+    if (!isGameStarted())
+    {
+        std::cerr << "Error: No game in progress. Use 'start <size>' to start a new game." << std::endl;
+        return;
+    }
+
+    if (game->redoMove())
+    {
+        clearScreen();
+        std::cout << "Move redone." << std::endl;
+        displayBoard();
+        displayGameStatus();
+    }
+    else
+    {
+        std::cerr << "Error: Cannot redo. No undone moves in the current line." << std::endl;
+    }
 }
 
-// ユーティリティメソッド: 盤面表示
-void GomokuCLI::displayBoard() const
+// コマンド実装: variations
+void GomokuCLI::handleVariations(const CommandArgs &)
 {
     if (!isGameStarted())
+    {
+        std::cerr << "Error: No game in progress. Use 'start <size>' to start a new game." << std::endl;
         return;
+    }
 
-    const auto &board = game->getBoard();
-    int size = board.getSize();
+    auto variations = game->getVariations();
+    if (variations.empty())
+    {
+        std::cout << "No variations from this position." << std::endl;
+        return;
+    }
 
-    // 列番号の表示
-    std::cout << "  ";
-    for (int col = 0; col < size; col++)
+    // 現在の棋譜で選ばれている変化に印を付ける
+    auto line = game->getLineView();
+    size_t ply = game->getPly();
+    std::cout << "Variations from move " << ply << ":" << std::endl;
+    for (size_t i = 0; i < variations.size(); i++)
     {
-        std::cout << " " << col;
+        bool selected = ply < line.size() && line[ply] == variations[i];
+        std::cout << (selected ? "* " : "  ") << i << ". (" << variations[i].first << "," << variations[i].second << ")" << std::endl;
     }
-    std::cout << std::endl;
+}
 
-    // 盤面の表示
-    for (int row = 0; row < size; row++)
+// コマンド実装: variation <n>
+void GomokuCLI::handleVariation(const CommandArgs &args)
+{
+    if (!isGameStarted())
     {
-        std::cout << std::setw(2) << row << " ";
-        for (int col = 0; col < size; col++)
-        {
-            auto stone = board.getStone(row, col);
-            char symbol = '.';
-            if (stone == GomokuLib::Stone::BLACK)
-                symbol = 'B';
-            else if (stone == GomokuLib::Stone::WHITE)
-                symbol = 'W';
-            std::cout << " " << symbol;
-        }
-        std::cout << std::endl;
+        std::cerr << "Error: No game in progress. Use 'start <size>' to start a new game." << std::endl;
+        return;
+    }
+
+    if (args.size() < 2)
+    {
+        std::cerr << "Error: Please specify a variation number. Usage: variation <n>" << std::endl;
+        return;
+    }
+
+    int index = 0;
+    if (!CommandTable::parseInt(args[1], index))
+    {
+        std::cerr << "Error: Invalid variation number. Please enter a valid number." << std::endl;
+        return;
+    }
+    if (index < 0 || !game->selectVariation(static_cast<size_t>(index)))
+    {
+        std::cerr << "Error: No such variation. Type 'variations' to list them." << std::endl;
+        return;
     }
+    std::cout << "Switched to variation " << index << " (" << game->getLineView().size() << " moves in line)." << std::endl;
 }
 
-// ユーティリティメソッド: ゲーム状態表示
-void GomokuCLI::displayGameStatus() const
+// コマンド実装: prune <n>
+void GomokuCLI::handlePrune(const CommandArgs &args)
 {
     if (!isGameStarted())
+    {
+        std::cerr << "Error: No game in progress. Use 'start <size>' to start a new game." << std::endl;
         return;
+    }
 
-    std::cout << std::endl;
-    std::cout << "Current Player: " << stoneToString(game->getCurrentPlayer()) << std::endl;
+    if (args.size() < 2)
+    {
+        std::cerr << "Error: Please specify a variation number. Usage: prune <n>" << std::endl;
+        return;
+    }
+
+    int index = 0;
+    if (!CommandTable::parseInt(args[1], index))
+    {
+        std::cerr << "Error: Invalid variation number. Please enter a valid number." << std::endl;
+        return;
+    }
+    if (index < 0 || !game->pruneVariation(static_cast<size_t>(index)))
+    {
+        std::cerr << "Error: No such variation. Type 'variations' to list them." << std::endl;
+        return;
+    }
+    std::cout << "Variation " << index << " removed." << std::endl;
 }
 
-// ユーティリティメソッド: 棋譜表示
-void GomokuCLI::displayMoves() const
+// コマンド実装: go [depth]（手番側の手をエンジンが決めて打つ）
+void GomokuCLI::handleGo(const CommandArgs &args)
 {
     if (!isGameStarted())
+    {
+        std::cerr << "Error: No game in progress. Use 'start <size>' to start a new game." << std::endl;
         return;
+    }
 
-    const auto &moves = game->getMoves();
-    if (moves.empty())
+    // 考えている間に時間切れになっていれば指せない
+    game->checkTime();
+    if (game->isGameOver())
     {
-        std::cout << "No moves have been made yet." << std::endl;
+        displayMoveResult(GomokuLib::MoveResult::GAME_OVER, "");
         return;
     }
 
-    std::cout << "Move history:" << std::endl;
-    std::cout << "------------" << std::endl;
+    // 持ち時間のある対局では、残り時間から決めた時間だけ読む
+    GomokuLib::SearchLimits limits;
+    limits.network = network;
+    limits.time = GomokuLib::TimeManager::allocate(*game);
+    if (limits.time.isLimited())
+    {
+        limits.maxDepth = MAX_TIMED_DEPTH;
+    }
+    if (args.size() >= 2)
+    {
+        if (!CommandTable::parseInt(args[1], limits.maxDepth))
+        {
+            std::cerr << "Error: Invalid depth. Please enter a valid number." << std::endl;
+            return;
+        }
+        if (limits.maxDepth < 1)
+        {
+            std::cerr << "Error: Depth must be at least 1." << std::endl;
+            return;
+        }
+    }
 
-    GomokuLib::Stone stone = GomokuLib::Stone::BLACK; // 最初の手は黒
-    for (size_t i = 0; i < moves.size(); i++)
+    // バックグラウンドの解析と CPU を取り合わないように止める
+    analysis.cancel();
+
+    GomokuLib::Stone player = game->getCurrentPlayer();
+    auto start = std::chrono::steady_clock::now();
+    GomokuLib::SearchResult result = GomokuLib::Search::run(game->getBoard(), player, limits);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    if (result.bestMove.first < 0)
     {
-        const auto &move = moves[i];
-        std::cout << i + 1 << ". " << stoneToString(stone) << " (" << move.first << "," << move.second << ")" << std::endl;
-        // プレイヤーの交代
-        stone = (stone == GomokuLib::Stone::BLACK) ? GomokuLib::Stone::WHITE : GomokuLib::Stone::BLACK;
+        std::cerr << "Error: No move available." << std::endl;
+        return;
     }
-    std::cout << std::endl;
+
+    int row = result.bestMove.first;
+    int col = result.bestMove.second;
+    auto moveResult = game->playTurn(row, col);
+    clearScreen();
+
+    std::ostringstream message;
+    message << stoneToString(player) << " plays (" << row << "," << col << ") - depth " << result.depth << ", "
+            << result.nodes << " nodes, " << elapsed << " ms";
+    if (limits.time.isLimited())
+    {
+        message << " (budget " << limits.time.softMs << "/" << limits.time.hardMs << " ms)";
+    }
+    if (result.forced)
+    {
+        message << ", forced";
+    }
+    displayMoveResult(moveResult, message.str());
 }
 
-// ユーティリティメソッド: 画面クリア
-void GomokuCLI::clearScreen() const
+// コマンド実装: analyze [depth] / analyze game [depth] [--json]
+void GomokuCLI::handleAnalyze(const CommandArgs &args)
 {
-    // クロスプラットフォーム対応のため、単純な方法でクリア
-    std::cout << std::string(50, '\n');
+    if (!isGameStarted())
+    {
+        std::cerr << "Error: No game in progress. Use 'start <size>' to start a new game." << std::endl;
+        return;
+    }
+
+    if (args.size() >= 2 && CommandTable::equalsIgnoreCase(args[1], "game"))
+    {
+        handleAnalyzeGame(args);
+        return;
+    }
+
+    if (game->isGameOver())
+    {
+        std::cerr << "Error: The game is already over." << std::endl;
+        return;
+    }
+
+    GomokuLib::SearchLimits limits;
+    limits.network = network;
+    if (args.size() >= 2)
+    {
+        if (!CommandTable::parseInt(args[1], limits.maxDepth))
+        {
+            std::cerr << "Error: Invalid depth. Please enter a valid number." << std::endl;
+            return;
+        }
+        if (limits.maxDepth < 1)
+        {
+            std::cerr << "Error: Depth must be at least 1." << std::endl;
+            return;
+        }
+    }
+
+    // 前の解析は結果を待たずに打ち切る
+    analysis.cancel();
+
+    const auto moves = game->getMoveView();
+    analysisMoves.assign(moves.begin(), moves.end());
+    analysisReported = false;
+    analysis = analyzer.analyze(game->getBoard(), game->getCurrentPlayer(), limits);
+    std::cout << "Analyzing " << stoneToString(game->getCurrentPlayer()) << " to depth " << limits.maxDepth
+              << " in the background. Type 'analysis' for progress or 'stop' to cancel." << std::endl;
 }
 
-// ユーティリティメソッド: 石の文字列表現
-std::string GomokuCLI::stoneToString(GomokuLib::Stone stone) const
+// コマンド実装: analyze game [depth] [--json]
+void GomokuCLI::handleAnalyzeGame(const CommandArgs &args)
+{
+    GomokuLib::GameAnalysisOptions options;
+    options.limits.network = network;
+    bool json = false;
+    for (size_t i = 2; i < args.size(); i++)
+    {
+        if (CommandTable::equalsIgnoreCase(args[i], "--json"))
+        {
+            json = true;
+            continue;
+        }
+        if (!CommandTable::parseInt(args[i], options.limits.maxDepth))
+        {
+            std::cerr << "Error: Invalid depth. Usage: analyze game [depth] [--json]" << std::endl;
+            return;
+        }
+        if (options.limits.maxDepth < 1)
+        {
+            std::cerr << "Error: Depth must be at least 1." << std::endl;
+            return;
+        }
+    }
+
+    const auto moves = game->getMoveView();
+    if (moves.empty())
+    {
+        std::cerr << "Error: No moves to analyze." << std::endl;
+        return;
+    }
+
+    try
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto analysis = GomokuLib::GameAnalyzer::analyze(*game, options);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (json)
+        {
+            printGameReportJson(analysis, seconds);
+        }
+        else
+        {
+            printGameReport(analysis, seconds);
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error analyzing game: " << e.what() << std::endl;
+    }
+}
+
+// コマンド実装: analysis
+void GomokuCLI::handleAnalysis(const CommandArgs &)
+{
+    if (!analysis.isValid())
+    {
+        std::cerr << "Error: No analysis has been started. Use 'analyze [depth]' to start one." << std::endl;
+        return;
+    }
+
+    if (analysis.isFinished())
+    {
+        pollAnalysis();
+        if (analysis.isFinished())
+        {
+            std::cout << formatAnalysis(analysis.wait()) << std::endl;
+        }
+        return;
+    }
+
+    auto latest = analysis.getLatest();
+    if (latest.depth == 0)
+    {
+        std::cout << "Analysis running (no depth completed yet)." << std::endl;
+        return;
+    }
+    std::cout << "Analysis running. " << formatAnalysis(latest) << std::endl;
+}
+
+// コマンド実装: stop
+void GomokuCLI::handleStop(const CommandArgs &)
+{
+    if (!analysis.isValid() || analysis.isFinished())
+    {
+        std::cerr << "Error: No analysis is running." << std::endl;
+        return;
+    }
+
+    // 読み終えた深さまでの結果で完了するので、待って表示する
+    analysis.cancel();
+    analysisReported = true;
+    std::cout << "Analysis stopped. " << formatAnalysis(analysis.wait()) << std::endl;
+}
+
+// コマンド実装: perft <depth> [threads]
+void GomokuCLI::handlePerft(const CommandArgs &args)
+{
+    if (!isGameStarted())
+    {
+        std::cerr << "Error: No game in progress. Use 'start <size>' to start a new game." << std::endl;
+        return;
+    }
+
+    if (args.size() < 2)
+    {
+        std::cerr << "Error: Please specify a depth. Usage: perft <depth> [threads]" << std::endl;
+        return;
+    }
+
+    int depth = 0;
+    int threads = 1;
+    if (!CommandTable::parseInt(args[1], depth) || (args.size() >= 3 && !CommandTable::parseInt(args[2], threads)))
+    {
+        std::cerr << "Error: Invalid number. Usage: perft <depth> [threads]" << std::endl;
+        return;
+    }
+    if (depth < 0 || threads < 0)
+    {
+        std::cerr << "Error: Depth and thread count must not be negative." << std::endl;
+        return;
+    }
+
+    // Perft は対局のコピーで数えるので、記録や持ち時間には影響しない
+    GomokuLib::PerftResult result = (threads == 1) ? GomokuLib::Perft::count(*game, depth)
+                                                   : GomokuLib::Perft::countParallel(*game, depth, static_cast<size_t>(threads));
+    std::cout << "perft(" << depth << ") = " << result.sequences
+              << " (" << result.nodes << " nodes, " << result.terminals << " terminal, "
+              << std::fixed << std::setprecision(3) << result.seconds << " s, "
+              << std::setprecision(0) << result.nodesPerSecond() << " nodes/s)" << std::defaultfloat << std::endl;
+}
+
+// コマンド実装: stats
+void GomokuCLI::handleStats(const CommandArgs &args)
+{
+    if (!GomokuLib::Instrumentation::ENABLED)
+    {
+        std::cout << "Instrumentation is disabled in this build (configure with -DGOMOKU_INSTRUMENTATION=ON)." << std::endl;
+        return;
+    }
+
+    std::string format;
+    for (char c : (args.size() >= 2) ? args[1] : std::string_view())
+    {
+        format += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    if (format == "reset")
+    {
+        GomokuLib::Instrumentation::reset();
+        std::cout << "Counters and timers have been reset." << std::endl;
+        return;
+    }
+
+    auto snapshot = GomokuLib::Instrumentation::snapshot();
+    if (format == "json")
+    {
+        std::cout << GomokuLib::Instrumentation::toJson(snapshot) << std::endl;
+        return;
+    }
+    if (format == "prometheus")
+    {
+        std::cout << GomokuLib::Instrumentation::toPrometheus(snapshot);
+        return;
+    }
+    if (!format.empty())
+    {
+        std::cout << "Usage: stats [json|prometheus|reset]" << std::endl;
+        return;
+    }
+
+    std::cout << "Counters:" << std::endl;
+    for (size_t i = 0; i < GomokuLib::Instrumentation::COUNTER_COUNT; i++)
+    {
+        std::cout << "  " << std::left << std::setw(16)
+                  << GomokuLib::Instrumentation::counterName(static_cast<GomokuLib::Counter>(i))
+                  << std::right << snapshot.counters[i] << std::endl;
+    }
+
+    std::cout << "Timers (microseconds):" << std::endl;
+    if (snapshot.timers.empty())
+    {
+        std::cout << "  (none recorded)" << std::endl;
+        return;
+    }
+    std::cout << "  " << std::left << std::setw(20) << "name" << std::right << std::setw(8) << "count"
+              << std::setw(12) << "mean" << std::setw(12) << "p50" << std::setw(12) << "p99"
+              << std::setw(12) << "max" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto &timer : snapshot.timers)
+    {
+        std::cout << "  " << std::left << std::setw(20) << timer.name << std::right << std::setw(8) << timer.count
+                  << std::setw(12) << timer.mean / 1000.0 << std::setw(12) << timer.p50 / 1000.0
+                  << std::setw(12) << timer.p99 / 1000.0 << std::setw(12) << timer.max / 1000.0 << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+}
+
+// コマンド実装: trace
+void GomokuCLI::handleTrace(const CommandArgs &args)
+{
+    if (!GomokuLib::Instrumentation::ENABLED)
+    {
+        std::cout << "Tracing is disabled in this build (configure with -DGOMOKU_INSTRUMENTATION=ON)." << std::endl;
+        return;
+    }
+
+    if (args.size() == 3 && CommandTable::equalsIgnoreCase(args[1], "start"))
+    {
+        try
+        {
+            GomokuLib::Tracer::start(std::string(args[2]));
+            std::cout << "Tracing to " << args[2] << std::endl;
+        }
+        catch (const std::exception &e)
+        {
+            std::cout << "Error: " << e.what() << std::endl;
+        }
+    }
+    else if (args.size() == 2 && CommandTable::equalsIgnoreCase(args[1], "stop"))
+    {
+        if (!GomokuLib::Tracer::isEnabled())
+        {
+            std::cout << "Tracing is not running." << std::endl;
+            return;
+        }
+        GomokuLib::Tracer::stop();
+        std::cout << "Trace written: " << GomokuLib::Tracer::getWrittenCount() << " events ("
+                  << GomokuLib::Tracer::getDroppedCount() << " dropped)." << std::endl;
+    }
+    else
+    {
+        std::cout << "Usage: trace start <file> | trace stop" << std::endl;
+    }
+}
+
+// コマンド実装: exit/quit
+void GomokuCLI::handleExit(const CommandArgs &)
+{
+    isRunning = false;
+    std::cout << "Thank you for playing Gomoku. Goodbye!" << std::endl;
+}
+
+// コマンド実装: help
+void GomokuCLI::handleHelp(const CommandArgs &)
+{
+    clearScreen();
+    std::cout << "Available commands:" << std::endl;
+    std::cout << "-----------------" << std::endl;
+    for (const auto &command : CommandTable::getCommands())
+    {
+        if (!command.usage.empty())
+        {
+            std::cout << std::left << std::setw(25) << command.usage << std::right << " - " << command.description << std::endl;
+        }
+    }
+}
+
+// ユーティリティメソッド: 記録を閉じる（追記した操作を同期してから閉じる）
+void GomokuCLI::closeJournal()
+{
+    if (!journal)
+        return;
+
+    if (game)
+    {
+        game->setJournal(nullptr);
+    }
+    journal.reset();
+}
+
+// ユーティリティメソッド: 盤面表示
+void GomokuCLI::displayBoard()
+{
+    if (!isGameStarted())
+        return;
+
+    // 端末では前回の描画との差分だけを書き換える
+    renderer.render(game->getBoard(), statusText());
+}
+
+// ユーティリティメソッド: ゲーム状態表示
+void GomokuCLI::displayGameStatus() const
+{
+    if (!isGameStarted())
+        return;
+
+    // 端末では状態行も盤面と一緒に描画される
+    if (renderer.isInteractive())
+        return;
+
+    std::cout << std::endl;
+    std::cout << "Current Player: " << stoneToString(game->getCurrentPlayer()) << std::endl;
+    if (game->getClock().isTimed())
+    {
+        std::cout << "Clock: " << clockText() << std::endl;
+    }
+}
+
+// ユーティリティメソッド: 着手の結果と盤面を表示する（成功した場合は message を表示する）
+void GomokuCLI::displayMoveResult(GomokuLib::MoveResult result, const std::string &message)
+{
+    switch (result)
+    {
+    case GomokuLib::MoveResult::SUCCESS:
+        std::cout << message << std::endl;
+        displayBoard();
+
+        if (game->isGameOver())
+        {
+            auto winner = game->getWinner();
+            if (winner == GomokuLib::Stone::BLACK)
+            {
+                std::cout << "Black wins!" << std::endl;
+            }
+            else if (winner == GomokuLib::Stone::WHITE)
+            {
+                std::cout << "White wins!" << std::endl;
+            }
+            else if (winner == GomokuLib::Stone::DRAW)
+            {
+                std::cout << "The game ended in a draw!" << std::endl;
+            }
+        }
+        else
+        {
+            displayGameStatus();
+        }
+        break;
+
+    case GomokuLib::MoveResult::INVALID_MOVE:
+        std::cerr << "Error: Invalid move. The position is either occupied or out of bounds." << std::endl;
+        displayBoard();
+        displayGameStatus();
+        break;
+
+    case GomokuLib::MoveResult::GAME_OVER:
+        if (game->getClock().getFlagged() != GomokuLib::Stone::EMPTY)
+        {
+            std::cout << stoneToString(game->getClock().getFlagged()) << " ran out of time. " << statusText() << std::endl;
+        }
+        else
+        {
+            std::cerr << "Error: The game is already over." << std::endl;
+        }
+        displayBoard();
+        std::cout << "Game is over. Start a new game or load a saved one." << std::endl;
+        break;
+    }
+}
+
+// ユーティリティメソッド: 盤面の下に固定表示する状態行
+std::string GomokuCLI::statusText() const
+{
+    bool onTime = game->getClock().getFlagged() != GomokuLib::Stone::EMPTY;
+    switch (game->getWinner())
+    {
+    case GomokuLib::Stone::BLACK:
+        return onTime ? "Black wins on time!" : "Black wins!";
+    case GomokuLib::Stone::WHITE:
+        return onTime ? "White wins on time!" : "White wins!";
+    case GomokuLib::Stone::DRAW:
+        return "The game ended in a draw!";
+    default:
+        if (game->getClock().isTimed())
+        {
+            return "Current Player: " + stoneToString(game->getCurrentPlayer()) + " | " + clockText();
+        }
+        return "Current Player: " + stoneToString(game->getCurrentPlayer());
+    }
+}
+
+// ユーティリティメソッド: 両者の残り時間
+std::string GomokuCLI::clockText() const
+{
+    const auto &clock = game->getClock();
+    return "Black " + formatClock(clock.getRemaining(GomokuLib::Stone::BLACK)) + "  White " +
+           formatClock(clock.getRemaining(GomokuLib::Stone::WHITE));
+}
+
+// ユーティリティメソッド: 棋譜表示
+void GomokuCLI::displayMoves() const
+{
+    if (!isGameStarted())
+        return;
+
+    const auto moves = game->getMoveView();
+    if (moves.empty())
+    {
+        std::cout << "No moves have been made yet." << std::endl;
+        return;
+    }
+
+    std::cout << "Move history:" << std::endl;
+    std::cout << "------------" << std::endl;
+
+    GomokuLib::Stone stone = GomokuLib::Stone::BLACK; // 最初の手は黒
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        const auto &move = moves[i];
+        std::cout << i + 1 << ". " << stoneToString(stone) << " (" << move.first << "," << move.second << ")" << std::endl;
+        // プレイヤーの交代
+        stone = (stone == GomokuLib::Stone::BLACK) ? GomokuLib::Stone::WHITE : GomokuLib::Stone::BLACK;
+    }
+    std::cout << std::endl;
+}
+
+// ユーティリティメソッド: 画面クリア
+void GomokuCLI::clearScreen() const
+{
+    // 端末では盤面を画面上部に固定しているので消さない
+    if (renderer.isInteractive())
+        return;
+
+    // クロスプラットフォーム対応のため、単純な方法でクリア
+    std::cout << std::string(50, '\n');
+}
+
+// ユーティリティメソッド: 石の文字列表現
+std::string GomokuCLI::stoneToString(GomokuLib::Stone stone) const
 {
     switch (stone)
     {
@@ -449,3 +1049,149 @@ std::string GomokuCLI::stoneToString(GomokuLib::Stone stone) const
         return "Empty";
     }
 }
+
+// ユーティリティメソッド: 解析の完了確認
+void GomokuCLI::pollAnalysis()
+{
+    if (!analysis.isValid() || analysisReported)
+        return;
+
+    // 解析した局面から動いた結果は役に立たないので捨てる
+    if (!isAnalyzedPosition())
+    {
+        analysis.cancel();
+        analysisReported = true;
+        std::cout << "Analysis cancelled because the position changed." << std::endl;
+        return;
+    }
+
+    if (analysis.isFinished())
+    {
+        analysisReported = true;
+        std::cout << "Analysis finished. " << formatAnalysis(analysis.wait()) << std::endl;
+    }
+}
+
+// ユーティリティメソッド: 現在の局面が解析を始めた局面と同じか
+bool GomokuCLI::isAnalyzedPosition() const
+{
+    if (!isGameStarted())
+        return false;
+
+    const auto moves = game->getMoveView();
+    return std::equal(moves.begin(), moves.end(), analysisMoves.begin(), analysisMoves.end());
+}
+
+// ユーティリティメソッド: 解析結果の文字列表現
+std::string GomokuCLI::formatAnalysis(const GomokuLib::SearchResult &result) const
+{
+    std::ostringstream oss;
+    oss << "Depth " << result.depth << ": best (" << result.bestMove.first << "," << result.bestMove.second << ")";
+
+    if (GomokuLib::Search::isWinScore(result.score))
+    {
+        int plies = (result.score > 0) ? GomokuLib::Search::SCORE_WIN - result.score
+                                       : GomokuLib::Search::SCORE_WIN + result.score;
+        oss << ", " << (result.score > 0 ? "wins" : "loses") << " in " << (plies / 2 + 1) << " move(s)";
+    }
+    else
+    {
+        oss << ", score " << result.score;
+    }
+
+    oss << ", line";
+    for (const auto &move : result.principalVariation)
+    {
+        oss << " (" << move.first << "," << move.second << ")";
+    }
+    oss << ", " << result.nodes << " nodes";
+    return oss.str();
+}
+
+namespace
+{
+    // 黒から見た評価値の表示（勝ち・負けを読み切った場合は手数を示す）
+    std::string formatScore(int score)
+    {
+        if (GomokuLib::Search::isWinScore(score))
+        {
+            int plies = GomokuLib::Search::SCORE_WIN - std::abs(score);
+            return std::string(score > 0 ? "B" : "W") + " wins in " + std::to_string(plies / 2 + 1);
+        }
+        return (score > 0 ? "+" : "") + std::to_string(score);
+    }
+
+    std::string formatMove(const std::pair<int, int> &move)
+    {
+        if (move.first < 0)
+            return "-";
+        return "(" + std::to_string(move.first) + "," + std::to_string(move.second) + ")";
+    }
+}
+
+// ユーティリティメソッド: 対局の解析結果をテキストで表示
+void GomokuCLI::printGameReport(const GomokuLib::GameAnalysis &analysis, double seconds) const
+{
+    size_t blunders = 0;
+    size_t missedWins = 0;
+
+    std::cout << "Game analysis: " << analysis.moves.size() << " moves, " << analysis.nodes << " nodes, "
+              << std::fixed << std::setprecision(2) << seconds << " s" << std::defaultfloat << std::endl;
+    std::cout << std::left << std::setw(6) << "Move" << std::setw(8) << "Player" << std::setw(10) << "Played"
+              << std::setw(10) << "Best" << std::setw(16) << "Eval (Black)" << "Note" << std::endl;
+
+    for (const auto &move : analysis.moves)
+    {
+        std::cout << std::setw(6) << move.ply
+                  << std::setw(8) << (move.player == GomokuLib::Stone::BLACK ? "Black" : "White")
+                  << std::setw(10) << formatMove(move.move)
+                  << std::setw(10) << formatMove(move.bestMove)
+                  << std::setw(16) << formatScore(analysis.evaluations[move.ply]);
+        if (move.judgement == GomokuLib::MoveJudgement::BLUNDER)
+        {
+            blunders++;
+            if (GomokuLib::Search::isWinScore(move.scoreAfter))
+                std::cout << "blunder (allows a forced win)";
+            else
+                std::cout << "blunder (-" << move.loss << ")";
+        }
+        else if (move.judgement == GomokuLib::MoveJudgement::MISSED_WIN)
+        {
+            missedWins++;
+            std::cout << "missed win";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::right;
+
+    std::cout << "Blunders: " << blunders << ", missed wins: " << missedWins << std::endl;
+}
+
+// ユーティリティメソッド: 対局の解析結果を JSON で表示
+void GomokuCLI::printGameReportJson(const GomokuLib::GameAnalysis &analysis, double seconds) const
+{
+    std::ostringstream out;
+    out << "{\"boardSize\": " << analysis.boardSize
+        << ", \"completed\": " << (analysis.completed ? "true" : "false")
+        << ", \"nodes\": " << analysis.nodes
+        << ", \"seconds\": " << seconds
+        << ", \"evaluations\": [";
+    for (size_t i = 0; i < analysis.evaluations.size(); i++)
+    {
+        out << (i ? ", " : "") << analysis.evaluations[i];
+    }
+    out << "], \"moves\": [";
+    for (size_t i = 0; i < analysis.moves.size(); i++)
+    {
+        const auto &move = analysis.moves[i];
+        out << (i ? "," : "") << "\n  {\"ply\": " << move.ply
+            << ", \"player\": \"" << (move.player == GomokuLib::Stone::BLACK ? "B" : "W") << "\""
+            << ", \"row\": " << move.move.first << ", \"col\": " << move.move.second
+            << ", \"bestRow\": " << move.bestMove.first << ", \"bestCol\": " << move.bestMove.second
+            << ", \"scoreBefore\": " << move.scoreBefore << ", \"scoreAfter\": " << move.scoreAfter
+            << ", \"loss\": " << move.loss
+            << ", \"judgement\": \"" << GomokuLib::GameAnalyzer::judgementToString(move.judgement) << "\"}";
+    }
+    out << "\n]}";
+    std::cout << out.str() << std::endl;
+}
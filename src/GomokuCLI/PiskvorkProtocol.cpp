@@ -0,0 +1,427 @@
+#include "GomokuCLI/PiskvorkProtocol.h"
+#include "GomokuCLI/CommandTable.h"
+#include "GomokuLib/Engine.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <unistd.h>
+
+namespace
+{
+    // 受け付ける盤面サイズの範囲
+    constexpr int MIN_BOARD_SIZE = 5;
+    constexpr int MAX_BOARD_SIZE = 100;
+
+    // 大文字に変換
+    std::string toUpper(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](unsigned char c)
+                       { return std::toupper(c); });
+        return text;
+    }
+
+    // 前後の空白を取り除く
+    std::string trim(const std::string &text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos)
+        {
+            return "";
+        }
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    // 整数に変換
+    bool parseInt(const std::string &text, long long &value)
+    {
+        std::string trimmed = trim(text);
+        auto result = std::from_chars(trimmed.data(), trimmed.data() + trimmed.size(), value);
+        return !trimmed.empty() && result.ec == std::errc() && result.ptr == trimmed.data() + trimmed.size();
+    }
+}
+
+PiskvorkProtocol::PiskvorkProtocol(std::istream &input, int outputFd)
+    : input(input), outputFd(outputFd), isRunning(true),
+      timeoutTurn(30000), timeoutMatch(0), timeLeft(0), readingBoard(false)
+{
+}
+
+void PiskvorkProtocol::run()
+{
+    std::string line;
+    while (isRunning && std::getline(input, line))
+    {
+        turnStart = std::chrono::steady_clock::now();
+        handleLine(trim(line));
+        flush();
+    }
+}
+
+void PiskvorkProtocol::handleLine(const std::string &line)
+{
+    if (line.empty())
+    {
+        return;
+    }
+
+    // BOARD の後は DONE まで石の行が続く
+    if (readingBoard)
+    {
+        handleBoardLine(line);
+        return;
+    }
+
+    size_t space = line.find(' ');
+    std::string command = toUpper(line.substr(0, space));
+    std::string args = (space == std::string::npos) ? "" : trim(line.substr(space + 1));
+
+    if (command == "TURN")
+        handleTurn(args);
+    else if (command == "INFO")
+        handleInfo(args);
+    else if (command == "START")
+        handleStart(args);
+    else if (command == "BEGIN")
+        handleBegin();
+    else if (command == "BOARD")
+    {
+        if (!game)
+        {
+            respond("ERROR no game started");
+            return;
+        }
+        readingBoard = true;
+        boardOwn.clear();
+        boardOpponent.clear();
+    }
+    else if (command == "TAKEBACK")
+        handleTakeback(args);
+    else if (command == "RESTART")
+        handleRestart();
+    else if (command == "ABOUT")
+        handleAbout();
+    else if (command == "END")
+        isRunning = false;
+    else
+        respond("UNKNOWN command " + command);
+}
+
+// コマンド実装: START <size>
+void PiskvorkProtocol::handleStart(const std::string &args)
+{
+    long long size = 0;
+    if (!parseInt(args, size) || size < MIN_BOARD_SIZE || size > MAX_BOARD_SIZE)
+    {
+        respond("ERROR unsupported board size");
+        return;
+    }
+
+    game = std::make_unique<GomokuLib::Game>(static_cast<int>(size));
+    timeLeft = timeoutMatch;
+    respond("OK");
+}
+
+// コマンド実装: TURN x,y（相手の着手に続けて自分の手を返す）
+void PiskvorkProtocol::handleTurn(const std::string &args)
+{
+    int row = 0;
+    int col = 0;
+    if (!game)
+    {
+        respond("ERROR no game started");
+        return;
+    }
+    if (!parseCoordinate(args, row, col))
+    {
+        respond("ERROR malformed coordinate");
+        return;
+    }
+    switch (game->playTurn(row, col))
+    {
+    case GomokuLib::MoveResult::SUCCESS:
+        playOwnMove();
+        break;
+    case GomokuLib::MoveResult::INVALID_MOVE:
+        respond("ERROR invalid move " + args);
+        break;
+    case GomokuLib::MoveResult::GAME_OVER:
+        respond("ERROR game is over");
+        break;
+    }
+}
+
+// コマンド実装: BEGIN（先手として最初の手を返す）
+void PiskvorkProtocol::handleBegin()
+{
+    if (!game)
+    {
+        respond("ERROR no game started");
+        return;
+    }
+
+    playOwnMove();
+}
+
+// コマンド実装: BOARD の石の行と DONE
+void PiskvorkProtocol::handleBoardLine(const std::string &line)
+{
+    if (toUpper(line) == "DONE")
+    {
+        readingBoard = false;
+
+        // 手番は自分なので、石の数が同じなら自分が黒、相手が1つ多ければ相手が黒
+        bool ownIsBlack = boardOwn.size() == boardOpponent.size();
+        if (!ownIsBlack && boardOpponent.size() != boardOwn.size() + 1)
+        {
+            respond("ERROR inconsistent stone counts");
+            return;
+        }
+
+        bool rebuilt = ownIsBlack ? rebuildGame(boardOwn, boardOpponent) : rebuildGame(boardOpponent, boardOwn);
+        if (!rebuilt)
+        {
+            respond("ERROR invalid board");
+            return;
+        }
+
+        playOwnMove();
+        return;
+    }
+
+    // x,y,field（field は 1 が自分、2 が相手、3 は連続対局用で無視する）
+    size_t lastComma = line.rfind(',');
+    int row = 0;
+    int col = 0;
+    long long field = 0;
+    if (lastComma == std::string::npos || !parseCoordinate(line.substr(0, lastComma), row, col) ||
+        !parseInt(line.substr(lastComma + 1), field))
+    {
+        respond("ERROR malformed board line");
+        return;
+    }
+
+    if (field == 1)
+    {
+        boardOwn.emplace_back(row, col);
+    }
+    else if (field == 2)
+    {
+        boardOpponent.emplace_back(row, col);
+    }
+}
+
+// コマンド実装: INFO <key> <value>（応答は返さない）
+void PiskvorkProtocol::handleInfo(const std::string &args)
+{
+    size_t space = args.find(' ');
+    std::string key = args.substr(0, space);
+    std::string valueText = (space == std::string::npos) ? "" : args.substr(space + 1);
+    long long value = 0;
+    bool isNumber = parseInt(valueText, value) && value >= 0;
+
+    if (key == "timeout_turn" && isNumber)
+    {
+        timeoutTurn = value;
+    }
+    else if (key == "timeout_match" && isNumber)
+    {
+        timeoutMatch = value;
+        if (!game || game->getMoveView().empty())
+        {
+            timeLeft = value;
+        }
+    }
+    else if (key == "time_left" && isNumber)
+    {
+        timeLeft = value;
+    }
+    else if (key == "timeout_turn" || key == "timeout_match" || key == "time_left")
+    {
+        respond("ERROR invalid value for " + key);
+    }
+    // max_memory, game_type, rule, evaluate, folder は使わない
+}
+
+// コマンド実装: TAKEBACK x,y
+void PiskvorkProtocol::handleTakeback(const std::string &args)
+{
+    int row = 0;
+    int col = 0;
+    if (!game || !parseCoordinate(args, row, col))
+    {
+        respond("ERROR invalid takeback");
+        return;
+    }
+
+    // 直前の手なら一手戻すだけで済む
+    auto moves = game->getMoves();
+    if (!moves.empty() && moves.back() == std::make_pair(row, col))
+    {
+        game->undoMove();
+        respond("OK");
+        return;
+    }
+
+    // それ以外は指定の石を除いて並べ直す
+    std::vector<std::pair<int, int>> black;
+    std::vector<std::pair<int, int>> white;
+    bool found = false;
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        if (moves[i] == std::make_pair(row, col))
+        {
+            found = true;
+            continue;
+        }
+        (i % 2 == 0 ? black : white).push_back(moves[i]);
+    }
+
+    if (!found || !(black.size() == white.size() || black.size() == white.size() + 1) || !rebuildGame(black, white))
+    {
+        respond("ERROR invalid takeback");
+        return;
+    }
+    respond("OK");
+}
+
+// コマンド実装: RESTART
+void PiskvorkProtocol::handleRestart()
+{
+    if (!game)
+    {
+        respond("ERROR no game started");
+        return;
+    }
+
+    game = std::make_unique<GomokuLib::Game>(game->getBoard().getSize());
+    timeLeft = timeoutMatch;
+    respond("OK");
+}
+
+// コマンド実装: ABOUT
+void PiskvorkProtocol::handleAbout()
+{
+    respond("name=\"GomokuLib\", version=\"0.1.0\", author=\"GomokuLib contributors\"");
+}
+
+void PiskvorkProtocol::playOwnMove()
+{
+    if (game->isGameOver())
+    {
+        respond("ERROR game is over");
+        return;
+    }
+
+    GomokuLib::TimeBudget budget = turnBudget();
+    auto move = GomokuLib::Engine::chooseMove(game->getBoard(), game->getCurrentPlayer());
+    if (move.first < 0 || game->playTurn(move.first, move.second) != GomokuLib::MoveResult::SUCCESS)
+    {
+        respond("ERROR no move available");
+        return;
+    }
+
+    // 持ち時間を自分で差し引いておく（time_left が届けばそちらで上書きされる）
+    long long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - turnStart)
+                            .count();
+    if (timeoutMatch > 0)
+    {
+        timeLeft = std::max(0LL, timeLeft - elapsed);
+    }
+    if (elapsed > budget.hardMs)
+    {
+        respond("DEBUG move took " + std::to_string(elapsed) + "ms, budget was " + std::to_string(budget.hardMs) + "ms");
+    }
+
+    // 座標は x（列）, y（行）の順
+    respond(std::to_string(move.second) + "," + std::to_string(move.first));
+}
+
+bool PiskvorkProtocol::rebuildGame(const std::vector<std::pair<int, int>> &black,
+                                   const std::vector<std::pair<int, int>> &white)
+{
+    auto rebuilt = std::make_unique<GomokuLib::Game>(game->getBoard().getSize());
+    for (size_t i = 0; i < black.size(); i++)
+    {
+        if (rebuilt->playTurn(black[i].first, black[i].second) != GomokuLib::MoveResult::SUCCESS)
+        {
+            return false;
+        }
+        if (i < white.size() && rebuilt->playTurn(white[i].first, white[i].second) != GomokuLib::MoveResult::SUCCESS)
+        {
+            return false;
+        }
+    }
+
+    game = std::move(rebuilt);
+    return true;
+}
+
+GomokuLib::TimeBudget PiskvorkProtocol::turnBudget() const
+{
+    GomokuLib::TimeBudget budget;
+
+    // timeout_turn が 0 なら即答が求められている
+    if (timeoutTurn == 0)
+    {
+        budget.softMs = 1;
+        budget.hardMs = 1;
+        return budget;
+    }
+
+    GomokuLib::TimeControl control;
+    control.initialMs = timeoutMatch;
+    control.maxMoveMs = timeoutTurn;
+    control.overheadMs = CommandTable::MOVE_OVERHEAD_MS;
+
+    // 対局全体の制限時間がなければ、1手の制限時間から遅れに備える分を除いた時間まで使える
+    if (!control.isTimed())
+    {
+        budget.hardMs = std::max<int64_t>(1, control.maxMoveMs - control.overheadMs);
+        budget.softMs = budget.hardMs;
+        return budget;
+    }
+
+    int size = game ? game->getBoard().getSize() : MAX_BOARD_SIZE;
+    size_t ply = game ? game->getPly() : 0;
+    return GomokuLib::TimeManager::allocate(control, timeLeft, size, ply);
+}
+
+bool PiskvorkProtocol::parseCoordinate(const std::string &text, int &row, int &col)
+{
+    size_t comma = text.find(',');
+    long long x = 0;
+    long long y = 0;
+    if (comma == std::string::npos || !parseInt(text.substr(0, comma), x) || !parseInt(text.substr(comma + 1), y))
+    {
+        return false;
+    }
+
+    col = static_cast<int>(x);
+    row = static_cast<int>(y);
+    return true;
+}
+
+void PiskvorkProtocol::respond(const std::string &line)
+{
+    output += line;
+    output += '\n';
+}
+
+void PiskvorkProtocol::flush()
+{
+    // 1回のコマンドに対する応答はまとめて1回で書き出す
+    size_t written = 0;
+    while (written < output.size())
+    {
+        ssize_t n = ::write(outputFd, output.data() + written, output.size() - written);
+        if (n <= 0)
+        {
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    output.clear();
+}
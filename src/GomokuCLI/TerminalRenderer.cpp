@@ -0,0 +1,311 @@
+#include "GomokuCLI/TerminalRenderer.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace
+{
+    // 盤面の下に残すスクロール領域の最小行数（メッセージとプロンプト用）
+    constexpr int MIN_SCROLL_LINES = 3;
+
+    // マスの表示文字
+    char stoneSymbol(GomokuLib::Stone stone)
+    {
+        if (stone == GomokuLib::Stone::BLACK)
+            return 'B';
+        if (stone == GomokuLib::Stone::WHITE)
+            return 'W';
+        return '.';
+    }
+
+    // 画面上の位置（1始まり）: 1行目が列番号、盤面の行はその下に続く
+    int cellLine(int row)
+    {
+        return row + 2;
+    }
+
+    // 行番号（2桁）と空白の後に、各マスが " X" の2桁で並ぶ
+    int cellColumn(int col)
+    {
+        return col * 2 + 5;
+    }
+
+    // 盤面の下に空行を1行挟んで状態行を置く
+    int statusLine(int size)
+    {
+        return size + 3;
+    }
+}
+
+TerminalRenderer::TerminalRenderer(int outputFd)
+    : outputFd(outputFd), interactive(false), layoutReady(false),
+      terminalRows(0), terminalCols(0), frameSize(0)
+{
+    const char *term = std::getenv("TERM");
+    interactive = ::isatty(outputFd) && term != nullptr && std::strcmp(term, "dumb") != 0;
+    if (interactive)
+    {
+        updateTerminalSize();
+    }
+}
+
+TerminalRenderer::~TerminalRenderer()
+{
+    if (layoutReady)
+    {
+        // スクロール領域を解除し、カーソルを画面の最下行に置く
+        std::cout.flush();
+        buffer = "\x1b[r";
+        appendCursorMove(terminalRows, 1);
+        buffer += '\n';
+        writeFrame();
+    }
+}
+
+bool TerminalRenderer::isInteractive() const
+{
+    return interactive;
+}
+
+void TerminalRenderer::invalidate()
+{
+    layoutReady = false;
+}
+
+void TerminalRenderer::render(const GomokuLib::Board &board, const std::string &status)
+{
+    // std::cout に溜まっているメッセージを先に出しておく
+    std::cout.flush();
+
+    if (!interactive)
+    {
+        drawPlain(board);
+        return;
+    }
+
+    if (updateTerminalSize())
+    {
+        layoutReady = false;
+    }
+
+    int size = board.getSize();
+    if (!fitsTerminal(size))
+    {
+        // 端末に収まらない盤面は従来通りスクロールさせて表示する
+        if (layoutReady)
+        {
+            buffer = "\x1b[r";
+            appendCursorMove(terminalRows, 1);
+            buffer += '\n';
+            writeFrame();
+            layoutReady = false;
+        }
+        drawPlain(board);
+        std::cout << std::endl
+                  << status << std::endl;
+        return;
+    }
+
+    if (!layoutReady || size != frameSize)
+    {
+        drawLayout(board, status);
+    }
+    else
+    {
+        drawDiff(board, status);
+    }
+}
+
+bool TerminalRenderer::updateTerminalSize()
+{
+    struct winsize ws;
+    if (::ioctl(outputFd, TIOCGWINSZ, &ws) != 0 || ws.ws_row == 0 || ws.ws_col == 0)
+    {
+        // 大きさが分からない端末では一般的な 80x24 とみなす
+        ws.ws_row = 24;
+        ws.ws_col = 80;
+    }
+
+    bool changed = ws.ws_row != terminalRows || ws.ws_col != terminalCols;
+    terminalRows = ws.ws_row;
+    terminalCols = ws.ws_col;
+    return changed;
+}
+
+bool TerminalRenderer::fitsTerminal(int size) const
+{
+    // 列番号の見出しは2桁以上の番号で盤面より広くなる
+    int headerWidth = 2;
+    for (int col = 0; col < size; col++)
+    {
+        headerWidth += 1 + static_cast<int>(std::to_string(col).size());
+    }
+    int width = std::max(cellColumn(size - 1), headerWidth);
+    return statusLine(size) + MIN_SCROLL_LINES <= terminalRows && width <= terminalCols;
+}
+
+void TerminalRenderer::drawLayout(const GomokuLib::Board &board, const std::string &status)
+{
+    int size = board.getSize();
+    buffer.clear();
+
+    // スクロール領域を解除して画面を消す
+    buffer += "\x1b[r\x1b[H\x1b[2J";
+
+    // 列番号の表示
+    buffer += "  ";
+    for (int col = 0; col < size; col++)
+    {
+        buffer += ' ';
+        buffer += std::to_string(col);
+    }
+    buffer += "\r\n";
+
+    // 盤面の表示
+    frame.assign(static_cast<size_t>(size) * size, '.');
+    for (int row = 0; row < size; row++)
+    {
+        if (row < 10)
+        {
+            buffer += ' ';
+        }
+        buffer += std::to_string(row);
+        buffer += ' ';
+        for (int col = 0; col < size; col++)
+        {
+            char symbol = stoneSymbol(board.getStone(row, col));
+            frame[static_cast<size_t>(row) * size + col] = symbol;
+            buffer += ' ';
+            buffer += symbol;
+        }
+        buffer += "\r\n";
+    }
+
+    buffer += "\r\n";
+    buffer += status;
+
+    // 盤面の下をメッセージとプロンプト用のスクロール領域にする（設定するとカーソルは左上に戻る）
+    int top = statusLine(size) + 1;
+    buffer += "\x1b[";
+    buffer += std::to_string(top);
+    buffer += ';';
+    buffer += std::to_string(terminalRows);
+    buffer += 'r';
+    appendCursorMove(top, 1);
+
+    writeFrame();
+
+    frameSize = size;
+    frameStatus = status;
+    layoutReady = true;
+}
+
+void TerminalRenderer::drawDiff(const GomokuLib::Board &board, const std::string &status)
+{
+    int size = board.getSize();
+    buffer.clear();
+
+    // スクロール領域内のカーソル位置を保存
+    buffer += "\x1b" "7";
+    size_t emptyLength = buffer.size();
+
+    for (int row = 0; row < size; row++)
+    {
+        for (int col = 0; col < size; col++)
+        {
+            char symbol = stoneSymbol(board.getStone(row, col));
+            char &drawn = frame[static_cast<size_t>(row) * size + col];
+            if (symbol != drawn)
+            {
+                appendCursorMove(cellLine(row), cellColumn(col));
+                buffer += symbol;
+                drawn = symbol;
+            }
+        }
+    }
+
+    if (status != frameStatus)
+    {
+        // 状態行を書き換え、行末の古い文字を消す
+        appendCursorMove(statusLine(size), 1);
+        buffer += status;
+        buffer += "\x1b[K";
+        frameStatus = status;
+    }
+
+    // 変化がなければ何も書き出さない
+    if (buffer.size() == emptyLength)
+    {
+        return;
+    }
+
+    buffer += "\x1b" "8";
+    writeFrame();
+}
+
+void TerminalRenderer::drawPlain(const GomokuLib::Board &board)
+{
+    int size = board.getSize();
+    buffer.clear();
+
+    // 列番号の表示
+    buffer += "  ";
+    for (int col = 0; col < size; col++)
+    {
+        buffer += ' ';
+        buffer += std::to_string(col);
+    }
+    buffer += '\n';
+
+    // 盤面の表示
+    for (int row = 0; row < size; row++)
+    {
+        if (row < 10)
+        {
+            buffer += ' ';
+        }
+        buffer += std::to_string(row);
+        buffer += ' ';
+        for (int col = 0; col < size; col++)
+        {
+            buffer += ' ';
+            buffer += stoneSymbol(board.getStone(row, col));
+        }
+        buffer += '\n';
+    }
+
+    writeFrame();
+}
+
+void TerminalRenderer::appendCursorMove(int line, int column)
+{
+    buffer += "\x1b[";
+    buffer += std::to_string(line);
+    buffer += ';';
+    buffer += std::to_string(column);
+    buffer += 'H';
+}
+
+void TerminalRenderer::writeFrame()
+{
+    // 1フレームは1回の write で送る（途中までしか書けなかった場合だけ続きを送る）
+    size_t written = 0;
+    while (written < buffer.size())
+    {
+        ssize_t n = ::write(outputFd, buffer.data() + written, buffer.size() - written);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    buffer.clear();
+}
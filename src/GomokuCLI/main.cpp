@@ -1,13 +1,131 @@
+#include "GomokuCLI/BatchRunner.h"
 #include "GomokuCLI/GomokuCLI.h"
+#include "GomokuCLI/PiskvorkProtocol.h"
+#include "GomokuLib/NeuralNetwork.h"
+#include "GomokuLib/Tracer.h"
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <unistd.h>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "Usage: GomokuCLI [--protocol piskvork] [--batch | --script <file>] [--format text|json] [--trace <file>] [--network <file>]" << std::endl;
+        std::cerr << "  --protocol piskvork   Run as a Gomocup/Piskvork engine on stdin/stdout" << std::endl;
+        std::cerr << "  --batch               Run commands from stdin without redrawing the board" << std::endl;
+        std::cerr << "  --script <file>       Run commands from a script file without redrawing the board" << std::endl;
+        std::cerr << "  --format text|json    Output format of batch results (default: text)" << std::endl;
+        std::cerr << "  --trace <file>        Write a Chrome trace (open in Perfetto or chrome://tracing)" << std::endl;
+        std::cerr << "  --network <file>      Evaluate analysis positions with an NNUE weight file" << std::endl;
+    }
+
+    // 終了時（例外で抜ける場合も含む）にトレースを書き終える
+    struct TraceSession
+    {
+        explicit TraceSession(const std::string &filepath)
+        {
+            if (!filepath.empty())
+            {
+                GomokuLib::Tracer::start(filepath);
+            }
+        }
+
+        ~TraceSession()
+        {
+            GomokuLib::Tracer::stop();
+        }
+    };
+}
 
 int main(int argc, char **argv)
 {
+    std::string protocol;
+    std::string scriptPath;
+    std::string tracePath;
+    std::string networkPath;
+    bool batch = false;
+    BatchFormat format = BatchFormat::TEXT;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--protocol" && i + 1 < argc)
+        {
+            protocol = argv[++i];
+        }
+        else if (arg == "--batch")
+        {
+            batch = true;
+        }
+        else if (arg == "--script" && i + 1 < argc)
+        {
+            batch = true;
+            scriptPath = argv[++i];
+        }
+        else if (arg == "--trace" && i + 1 < argc)
+        {
+            tracePath = argv[++i];
+        }
+        else if (arg == "--network" && i + 1 < argc)
+        {
+            networkPath = argv[++i];
+        }
+        else if (arg == "--format" && i + 1 < argc && (std::string(argv[i + 1]) == "text" || std::string(argv[i + 1]) == "json"))
+        {
+            format = (std::string(argv[++i]) == "json") ? BatchFormat::JSON : BatchFormat::TEXT;
+        }
+        else
+        {
+            printUsage();
+            return (arg == "--help" || arg == "-h") ? 0 : 2;
+        }
+    }
+
     try
     {
-        GomokuCLI cli;
-        cli.run();
+        TraceSession trace(tracePath);
+        if (protocol == "piskvork")
+        {
+            // 対話用の出力は一切行わず、プロトコルの応答だけを書き出す
+            std::ios::sync_with_stdio(false);
+            PiskvorkProtocol engine(std::cin, STDOUT_FILENO);
+            engine.run();
+        }
+        else if (!protocol.empty())
+        {
+            std::cerr << "Unknown protocol: " << protocol << std::endl;
+            printUsage();
+            return 2;
+        }
+        else if (batch)
+        {
+            // 結果の記録だけを出力し、失敗したコマンドがあれば終了コード 1 を返す
+            BatchRunner runner(format, STDOUT_FILENO);
+            if (!networkPath.empty())
+            {
+                runner.setNetwork(std::make_shared<const GomokuLib::NeuralNetwork>(GomokuLib::NeuralNetwork::load(networkPath)));
+            }
+            if (scriptPath.empty())
+            {
+                runner.runStream(STDIN_FILENO);
+            }
+            else
+            {
+                runner.runFile(scriptPath);
+            }
+            return runner.getErrorCount() > 0 ? 1 : 0;
+        }
+        else
+        {
+            GomokuCLI cli;
+            if (!networkPath.empty())
+            {
+                // 重みはメモリマップで読み込み、解析のたびに共有する
+                cli.setNetwork(std::make_shared<const GomokuLib::NeuralNetwork>(GomokuLib::NeuralNetwork::load(networkPath)));
+            }
+            cli.run();
+        }
     }
     catch (const std::exception &e)
     {
@@ -0,0 +1,117 @@
+#include "GomokuGUI/AnalysisBridge.h"
+#include <QPointer>
+#include <exception>
+
+AnalysisBridge::AnalysisBridge(QObject *parent)
+    : QObject(parent), generation(0), gameWorker(1), gameGeneration(0)
+{
+    qRegisterMetaType<GomokuLib::SearchResult>();
+    qRegisterMetaType<GomokuLib::GameAnalysis>();
+}
+
+AnalysisBridge::~AnalysisBridge()
+{
+    // ワーカーが終わってからでないと、破棄したオブジェクトに通知を送ってしまう
+    handle.cancel();
+    gameToken.cancel();
+    analyzer.waitIdle();
+    gameWorker.waitIdle();
+}
+
+void AnalysisBridge::start(const GomokuLib::Board &board, GomokuLib::Stone player,
+                           const GomokuLib::SearchLimits &limits)
+{
+    cancel();
+
+    quint64 id = generation;
+    QPointer<AnalysisBridge> self(this);
+
+    // ワーカースレッドからは直接シグナルを出さず、このオブジェクトのスレッドで処理させる
+    auto onProgress = [self, id](const GomokuLib::SearchResult &partial)
+    {
+        QMetaObject::invokeMethod(
+            self.data(), [self, id, partial]()
+            {
+                if (self && self->generation == id)
+                {
+                    emit self->progress(partial);
+                } },
+            Qt::QueuedConnection);
+    };
+    auto onComplete = [self, id](const GomokuLib::SearchResult &result)
+    {
+        QMetaObject::invokeMethod(
+            self.data(), [self, id, result]()
+            {
+                if (self && self->generation == id)
+                {
+                    emit self->finished(result);
+                } },
+            Qt::QueuedConnection);
+    };
+
+    handle = analyzer.analyze(board, player, limits, onProgress, onComplete);
+}
+
+void AnalysisBridge::cancel()
+{
+    handle.cancel();
+    handle = GomokuLib::AnalysisHandle();
+    generation++;
+}
+
+bool AnalysisBridge::isRunning() const
+{
+    return handle.isValid() && !handle.isFinished();
+}
+
+void AnalysisBridge::startGame(int boardSize, std::vector<std::pair<int, int>> moves,
+                               const GomokuLib::GameAnalysisOptions &options)
+{
+    cancelGame();
+
+    quint64 id = gameGeneration;
+    QPointer<AnalysisBridge> self(this);
+    GomokuLib::CancellationToken token = gameToken;
+
+    gameWorker.post([self, id, token, boardSize, moves = std::move(moves), options]()
+                    {
+        auto onProgress = [self, id](size_t done, size_t total)
+        {
+            QMetaObject::invokeMethod(
+                self.data(), [self, id, done, total]()
+                {
+                    if (self && self->gameGeneration == id)
+                    {
+                        emit self->gameProgress(static_cast<int>(done), static_cast<int>(total));
+                    } },
+                Qt::QueuedConnection);
+        };
+
+        GomokuLib::GameAnalysis analysis;
+        try
+        {
+            analysis = GomokuLib::GameAnalyzer::analyze(boardSize, GomokuLib::MoveSpan(moves.data(), moves.size()),
+                                                        options, token, onProgress);
+        }
+        catch (const std::exception &)
+        {
+            return;
+        }
+
+        QMetaObject::invokeMethod(
+            self.data(), [self, id, analysis]()
+            {
+                if (self && self->gameGeneration == id)
+                {
+                    emit self->gameFinished(analysis);
+                } },
+            Qt::QueuedConnection); });
+}
+
+void AnalysisBridge::cancelGame()
+{
+    gameToken.cancel();
+    gameToken = GomokuLib::CancellationToken();
+    gameGeneration++;
+}
@@ -1,71 +1,232 @@
 #include "GomokuGUI/BoardWidget.h"
 #include <QPainter>
 #include <QMouseEvent>
+#include <QPaintEvent>
+#include <QResizeEvent>
+#include <QRegion>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // 盤面の背景色
+    const QColor BOARD_COLOR(240, 217, 181);
+
+    // 石の半径（交点の間隔に対する割合）
+    constexpr double STONE_RADIUS_RATIO = 0.45;
+}
 
 BoardWidget::BoardWidget(QWidget *parent)
     : QWidget(parent),
-      board(nullptr)
+      board(nullptr),
+      cellPitch(30.0),
+      lastFrameTime(0.0)
 {
     setMinimumSize(400, 400);
+
+    // 全ての画素を自分で描くので、背景の消去を省く
+    setAttribute(Qt::WA_OpaquePaintEvent);
 }
 
 void BoardWidget::setBoard(const GomokuLib::Board *newBoard)
 {
     board = newBoard;
+    rebuildLayers();
     update();
 }
 
-void BoardWidget::paintEvent(QPaintEvent *event)
+void BoardWidget::stoneChanged(int row, int col)
 {
-    QWidget::paintEvent(event);
-    QPainter painter(this);
-    // 背景
-    painter.fillRect(rect(), QColor(240, 217, 181));
+    if (!board || row < 0 || row >= board->getSize() || col < 0 || col >= board->getSize())
+        return;
+
+    update(paintStone(row, col));
+}
 
+void BoardWidget::syncStones()
+{
     if (!board)
         return;
-    int boardSize = board->getSize();
 
-    // グリッド線を描画
-    for (int i = 0; i < boardSize; i++)
+    int boardSize = board->getSize();
+    if (drawnStones.size() != static_cast<size_t>(boardSize) * boardSize)
     {
-        // 水平線
-        painter.drawLine(10, 10 + i * 30, 10 + (boardSize - 1) * 30, 10 + i * 30);
-        // 垂直線
-        painter.drawLine(10 + i * 30, 10, 10 + i * 30, 10 + (boardSize - 1) * 30);
+        rebuildLayers();
+        update();
+        return;
     }
 
-    // 石を描画
+    QRegion dirty;
     for (int r = 0; r < boardSize; r++)
     {
         for (int c = 0; c < boardSize; c++)
         {
-            auto s = board->getStone(r, c);
-            if (s == GomokuLib::Stone::BLACK || s == GomokuLib::Stone::WHITE)
+            if (board->getStone(r, c) != drawnStones[static_cast<size_t>(r) * boardSize + c])
             {
-                int x = 10 + c * 30;
-                int y = 10 + r * 30;
-                QColor color = (s == GomokuLib::Stone::BLACK) ? Qt::black : Qt::white;
-                painter.setBrush(color);
-                painter.drawEllipse(x - 10 + 15, y - 10 + 15, 20, 20);
+                dirty += paintStone(r, c);
             }
         }
     }
+
+    if (!dirty.isEmpty())
+    {
+        update(dirty);
+    }
+}
+
+double BoardWidget::getLastFrameTime() const
+{
+    return lastFrameTime;
+}
+
+void BoardWidget::paintEvent(QPaintEvent *event)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QPainter painter(this);
+    if (gridLayer.isNull())
+    {
+        painter.fillRect(rect(), BOARD_COLOR);
+    }
+    else
+    {
+        // 描き直す範囲だけを2つのレイヤーから転送する
+        double ratio = gridLayer.devicePixelRatioF();
+        for (const QRect &target : event->region())
+        {
+            QRectF source(target.x() * ratio, target.y() * ratio, target.width() * ratio, target.height() * ratio);
+            painter.drawPixmap(QRectF(target), gridLayer, source);
+            painter.drawPixmap(QRectF(target), stoneLayer, source);
+        }
+    }
+
+    lastFrameTime = timer.nsecsElapsed() / 1.0e6;
+    emit frameRendered(lastFrameTime);
 }
 
 void BoardWidget::mousePressEvent(QMouseEvent *event)
 {
     if (!board)
         return;
-    int x = event->x() - 10;
-    int y = event->y() - 10;
 
-    int col = x / 30;
-    int row = y / 30;
+    // 最も近い交点を選ぶ
+    int col = static_cast<int>(std::lround((event->x() - origin.x()) / cellPitch));
+    int row = static_cast<int>(std::lround((event->y() - origin.y()) / cellPitch));
 
     if (row >= 0 && row < board->getSize() && col >= 0 && col < board->getSize())
     {
         emit moveSelected(row, col);
     }
     QWidget::mousePressEvent(event);
-}
\ No newline at end of file
+}
+
+void BoardWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    rebuildLayers();
+}
+
+void BoardWidget::rebuildLayers()
+{
+    if (!board || width() <= 0 || height() <= 0)
+    {
+        gridLayer = QPixmap();
+        stoneLayer = QPixmap();
+        drawnStones.clear();
+        return;
+    }
+
+    // 盤面が正方形のままウィジェットに収まるように、端に半マス分の余白を取って配置する
+    int boardSize = board->getSize();
+    double side = std::min(width(), height());
+    cellPitch = side / boardSize;
+    origin = QPointF((width() - side) / 2.0 + cellPitch / 2.0, (height() - side) / 2.0 + cellPitch / 2.0);
+
+    double ratio = devicePixelRatioF();
+    QSize pixelSize(static_cast<int>(std::ceil(width() * ratio)), static_cast<int>(std::ceil(height() * ratio)));
+
+    gridLayer = QPixmap(pixelSize);
+    gridLayer.setDevicePixelRatio(ratio);
+    paintGridLayer();
+
+    stoneLayer = QPixmap(pixelSize);
+    stoneLayer.setDevicePixelRatio(ratio);
+    stoneLayer.fill(Qt::transparent);
+
+    // 石のレイヤーを盤面に合わせて描き直す
+    drawnStones.assign(static_cast<size_t>(boardSize) * boardSize, GomokuLib::Stone::EMPTY);
+    for (int r = 0; r < boardSize; r++)
+    {
+        for (int c = 0; c < boardSize; c++)
+        {
+            if (board->getStone(r, c) != GomokuLib::Stone::EMPTY)
+            {
+                paintStone(r, c);
+            }
+        }
+    }
+}
+
+void BoardWidget::paintGridLayer()
+{
+    gridLayer.fill(BOARD_COLOR);
+
+    QPainter painter(&gridLayer);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    int boardSize = board->getSize();
+    double end = (boardSize - 1) * cellPitch;
+
+    // グリッド線を描画
+    for (int i = 0; i < boardSize; i++)
+    {
+        double offset = i * cellPitch;
+        // 水平線
+        painter.drawLine(QPointF(origin.x(), origin.y() + offset), QPointF(origin.x() + end, origin.y() + offset));
+        // 垂直線
+        painter.drawLine(QPointF(origin.x() + offset, origin.y()), QPointF(origin.x() + offset, origin.y() + end));
+    }
+}
+
+QRect BoardWidget::paintStone(int row, int col)
+{
+    int boardSize = board->getSize();
+    auto stone = board->getStone(row, col);
+    drawnStones[static_cast<size_t>(row) * boardSize + col] = stone;
+
+    QPainter painter(&stoneLayer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    double radius = cellPitch * STONE_RADIUS_RATIO;
+
+    // 前の石を消す（隣の石にかからないよう、四角ではなく石の輪郭より少し大きい円で消す）
+    painter.setCompositionMode(QPainter::CompositionMode_Clear);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Qt::black);
+    painter.drawEllipse(cellCenter(row, col), radius + 1.5, radius + 1.5);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setPen(Qt::black);
+
+    if (stone == GomokuLib::Stone::BLACK || stone == GomokuLib::Stone::WHITE)
+    {
+        QColor color = (stone == GomokuLib::Stone::BLACK) ? Qt::black : Qt::white;
+        painter.setBrush(color);
+        painter.drawEllipse(cellCenter(row, col), radius, radius);
+    }
+
+    return cellRect(row, col);
+}
+
+QPointF BoardWidget::cellCenter(int row, int col) const
+{
+    return QPointF(origin.x() + col * cellPitch, origin.y() + row * cellPitch);
+}
+
+QRect BoardWidget::cellRect(int row, int col) const
+{
+    // 石の輪郭とアンチエイリアスの分だけ余裕を持たせる
+    double half = cellPitch / 2.0;
+    QPointF center = cellCenter(row, col);
+    return QRectF(center.x() - half, center.y() - half, cellPitch, cellPitch).toAlignedRect().adjusted(-1, -1, 1, 1);
+}
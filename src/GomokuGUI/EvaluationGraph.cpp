@@ -0,0 +1,113 @@
+#include "GomokuGUI/EvaluationGraph.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QMouseEvent>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // 評価値の目盛り（この値で縦軸の約 76% に達する）
+    constexpr double SCORE_SCALE = GomokuLib::Engine::SCORE_OPEN_FOUR;
+
+    // グラフの余白
+    constexpr double MARGIN = 6.0;
+}
+
+EvaluationGraph::EvaluationGraph(QWidget *parent)
+    : QWidget(parent), currentPly(0)
+{
+    setMinimumHeight(80);
+}
+
+void EvaluationGraph::setAnalysis(const GomokuLib::GameAnalysis &newAnalysis)
+{
+    analysis = newAnalysis;
+    update();
+}
+
+void EvaluationGraph::clear()
+{
+    analysis = GomokuLib::GameAnalysis();
+    update();
+}
+
+void EvaluationGraph::setCurrentPly(int ply)
+{
+    if (ply == currentPly)
+        return;
+    currentPly = ply;
+    update();
+}
+
+QSize EvaluationGraph::sizeHint() const
+{
+    return QSize(400, 100);
+}
+
+double EvaluationGraph::plyToX(int ply) const
+{
+    int last = std::max(1, static_cast<int>(analysis.evaluations.size()) - 1);
+    return MARGIN + (width() - 2 * MARGIN) * ply / last;
+}
+
+double EvaluationGraph::scoreToY(int score) const
+{
+    // 勝ち負けを読み切った値は上端・下端に、それ以外はなめらかに縮める
+    double value = GomokuLib::Search::isWinScore(score) ? (score > 0 ? 1.0 : -1.0) : std::tanh(score / SCORE_SCALE);
+    double half = (height() - 2 * MARGIN) / 2.0;
+    return MARGIN + half - value * half;
+}
+
+void EvaluationGraph::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillRect(rect(), palette().base());
+
+    // 互角の線
+    painter.setPen(QPen(palette().mid().color(), 1, Qt::DashLine));
+    painter.drawLine(QPointF(MARGIN, scoreToY(0)), QPointF(width() - MARGIN, scoreToY(0)));
+
+    if (analysis.evaluations.empty())
+        return;
+
+    // 現在の手数
+    if (currentPly >= 0 && currentPly < static_cast<int>(analysis.evaluations.size()))
+    {
+        painter.setPen(QPen(palette().highlight().color(), 1));
+        painter.drawLine(QPointF(plyToX(currentPly), 0), QPointF(plyToX(currentPly), height()));
+    }
+
+    QPainterPath path;
+    path.moveTo(plyToX(0), scoreToY(analysis.evaluations[0]));
+    for (size_t i = 1; i < analysis.evaluations.size(); i++)
+    {
+        path.lineTo(plyToX(static_cast<int>(i)), scoreToY(analysis.evaluations[i]));
+    }
+    painter.setPen(QPen(palette().text().color(), 1.5));
+    painter.drawPath(path);
+
+    // 悪手は赤、勝ちの見逃しは橙の点で、着手後の局面の位置に示す
+    painter.setPen(Qt::NoPen);
+    for (const auto &move : analysis.moves)
+    {
+        if (move.judgement == GomokuLib::MoveJudgement::NONE)
+            continue;
+        painter.setBrush(move.judgement == GomokuLib::MoveJudgement::BLUNDER ? QColor(220, 40, 40) : QColor(240, 150, 0));
+        painter.drawEllipse(QPointF(plyToX(move.ply), scoreToY(analysis.evaluations[move.ply])), 4.0, 4.0);
+    }
+}
+
+void EvaluationGraph::mousePressEvent(QMouseEvent *event)
+{
+    if (analysis.evaluations.empty())
+        return;
+
+    // 最も近い手数を選ぶ
+    int last = static_cast<int>(analysis.evaluations.size()) - 1;
+    double step = (width() - 2 * MARGIN) / std::max(1, last);
+    int ply = static_cast<int>(std::lround((event->x() - MARGIN) / step));
+    emit plySelected(std::clamp(ply, 0, last));
+    QWidget::mousePressEvent(event);
+}
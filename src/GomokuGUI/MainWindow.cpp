@@ -9,6 +9,7 @@
 #include <QHBoxLayout>
 #include <QSplitter>
 #include <QLabel>
+#include <QSignalBlocker>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), game(nullptr)
@@ -25,12 +26,18 @@ MainWindow::MainWindow(QWidget *parent)
 
     QMenu *gameMenu = menuBar()->addMenu(tr("ゲーム"));
     QAction *undoAction = gameMenu->addAction(tr("一手戻す"));
+    QAction *redoAction = gameMenu->addAction(tr("一手進める"));
+    QAction *hintAction = gameMenu->addAction(tr("ヒント"));
+    QAction *analyzeGameAction = gameMenu->addAction(tr("棋譜を解析"));
 
     connect(newGameAction, &QAction::triggered, this, &MainWindow::newGame);
     connect(openAction, &QAction::triggered, this, &MainWindow::openGame);
     connect(saveAction, &QAction::triggered, this, &MainWindow::saveGame);
     connect(exitAction, &QAction::triggered, this, &QWidget::close);
     connect(undoAction, &QAction::triggered, this, &MainWindow::undoMove);
+    connect(redoAction, &QAction::triggered, this, &MainWindow::redoMove);
+    connect(hintAction, &QAction::triggered, this, &MainWindow::requestHint);
+    connect(analyzeGameAction, &QAction::triggered, this, &MainWindow::analyzeGame);
 
     // ツールバー
     QToolBar *toolBar = addToolBar(tr("MainToolbar"));
@@ -38,13 +45,19 @@ MainWindow::MainWindow(QWidget *parent)
     toolBar->addAction(openAction);
     toolBar->addAction(saveAction);
     toolBar->addAction(undoAction);
+    toolBar->addAction(redoAction);
+    toolBar->addAction(hintAction);
 
     // 中央ウィジェット
     QWidget *central = new QWidget(this);
     QHBoxLayout *layout = new QHBoxLayout(central);
 
     boardWidget = new BoardWidget(this);
-    moveHistoryList = new QListWidget(this);
+    moveHistoryModel = new MoveHistoryModel(this);
+    moveHistoryList = new QListView(this);
+    moveHistoryList->setModel(moveHistoryModel);
+    // 全ての行が同じ高さなので、行ごとの大きさの計算を省く
+    moveHistoryList->setUniformItemSizes(true);
     connect(boardWidget, &BoardWidget::moveSelected, this, &MainWindow::onMovePlayed);
 
     QSplitter *splitter = new QSplitter(this);
@@ -52,6 +65,22 @@ MainWindow::MainWindow(QWidget *parent)
     QVBoxLayout *boardLayout = new QVBoxLayout(boardContainer);
     boardLayout->addWidget(boardWidget);
 
+    // 棋譜の任意の手数に移動するスライダー
+    QHBoxLayout *timelineLayout = new QHBoxLayout();
+    timelineSlider = new QSlider(Qt::Horizontal, this);
+    timelineSlider->setTracking(true);
+    timelineLabel = new QLabel(this);
+    timelineLayout->addWidget(timelineSlider);
+    timelineLayout->addWidget(timelineLabel);
+    boardLayout->addLayout(timelineLayout);
+    connect(timelineSlider, &QSlider::valueChanged, this, &MainWindow::onTimelineMoved);
+
+    // 棋譜の解析結果の評価値グラフ（クリックした手数に移動する）
+    evaluationGraph = new EvaluationGraph(this);
+    evaluationGraph->hide();
+    boardLayout->addWidget(evaluationGraph);
+    connect(evaluationGraph, &EvaluationGraph::plySelected, timelineSlider, &QSlider::setValue);
+
     QWidget *historyContainer = new QWidget();
     QVBoxLayout *historyLayout = new QVBoxLayout(historyContainer);
     QLabel *label = new QLabel(tr("棋譜"));
@@ -64,6 +93,20 @@ MainWindow::MainWindow(QWidget *parent)
     layout->addWidget(splitter);
     setCentralWidget(central);
 
+    // 盤面の描画時間
+    frameTimeLabel = new QLabel(this);
+    statusBar()->addPermanentWidget(frameTimeLabel);
+    connect(boardWidget, &BoardWidget::frameRendered, this, [this](double milliseconds)
+            { frameTimeLabel->setText(tr("描画: %1 ms").arg(milliseconds, 0, 'f', 2)); });
+
+    // ヒントの解析（バックグラウンドで実行し、結果はステータスバーに表示する）
+    analysisBridge = new AnalysisBridge(this);
+    connect(analysisBridge, &AnalysisBridge::progress, this, &MainWindow::onAnalysisProgress);
+    connect(analysisBridge, &AnalysisBridge::finished, this, &MainWindow::onAnalysisFinished);
+    connect(analysisBridge, &AnalysisBridge::gameFinished, this, &MainWindow::onGameAnalysisFinished);
+    connect(analysisBridge, &AnalysisBridge::gameProgress, this, [this](int done, int total)
+            { statusBar()->showMessage(tr("棋譜を解析中... %1 / %2").arg(done).arg(total)); });
+
     resetGame();
 }
 
@@ -74,6 +117,10 @@ MainWindow::~MainWindow()
 
 void MainWindow::resetGame(int boardSize)
 {
+    analysisBridge->cancel();
+    analysisBridge->cancelGame();
+    evaluationGraph->clear();
+    evaluationGraph->hide();
     if (game)
     {
         delete game;
@@ -81,7 +128,7 @@ void MainWindow::resetGame(int boardSize)
     game = new GomokuLib::Game(boardSize);
 
     boardWidget->setBoard(&(game->getBoard()));
-    moveHistoryList->clear();
+    moveHistoryModel->setGame(game);
     updateUI();
 }
 
@@ -104,12 +151,17 @@ void MainWindow::openGame()
     try
     {
         GomokuLib::Game loaded = GomokuLib::Game::loadGame(filePath.toStdString());
+        analysisBridge->cancel();
+        analysisBridge->cancelGame();
+        evaluationGraph->clear();
+        evaluationGraph->hide();
         if (game)
         {
             delete game;
         }
-        game = new GomokuLib::Game(loaded);
+        game = new GomokuLib::Game(std::move(loaded));
         boardWidget->setBoard(&(game->getBoard()));
+        moveHistoryModel->setGame(game);
         updateUI();
     }
     catch (...)
@@ -139,12 +191,36 @@ void MainWindow::saveGame()
 
 void MainWindow::undoMove()
 {
-    if (game && game->undoMove())
+    if (!game)
+        return;
+
+    // 戻した石のマスだけを描き直す
+    auto moves = game->getMoveView();
+    if (moves.empty())
+        return;
+
+    auto lastMove = moves.back();
+    if (game->undoMove())
     {
+        analysisBridge->cancel();
+        boardWidget->stoneChanged(lastMove.first, lastMove.second);
         updateUI();
     }
 }
 
+void MainWindow::redoMove()
+{
+    if (!game || !game->redoMove())
+        return;
+
+    analysisBridge->cancel();
+
+    // 進めた石のマスだけを描き直す
+    auto lastMove = game->getMoveView().back();
+    boardWidget->stoneChanged(lastMove.first, lastMove.second);
+    updateUI();
+}
+
 void MainWindow::onMovePlayed(int row, int col)
 {
     if (!game)
@@ -154,21 +230,112 @@ void MainWindow::onMovePlayed(int row, int col)
     {
         statusBar()->showMessage(tr("無効な手です"), 2000);
     }
+    else if (result == GomokuLib::MoveResult::SUCCESS)
+    {
+        analysisBridge->cancel();
+        boardWidget->stoneChanged(row, col);
+    }
     updateUI();
 }
 
+void MainWindow::onTimelineMoved(int ply)
+{
+    if (!game || !game->jumpTo(static_cast<size_t>(ply)))
+        return;
+
+    analysisBridge->cancel();
+
+    // 移動で変わったマスだけを描き直す
+    boardWidget->syncStones();
+    updateUI();
+}
+
+void MainWindow::requestHint()
+{
+    if (!game || game->isGameOver())
+        return;
+
+    // 解析は盤面のコピーに対して行うので、その間も操作を続けられる
+    analysisBridge->start(game->getBoard(), game->getCurrentPlayer());
+    statusBar()->showMessage(tr("解析中..."));
+}
+
+void MainWindow::onAnalysisProgress(const GomokuLib::SearchResult &partial)
+{
+    statusBar()->showMessage(tr("解析中... 深さ %1: (%2, %3)")
+                                 .arg(partial.depth)
+                                 .arg(partial.bestMove.first)
+                                 .arg(partial.bestMove.second));
+}
+
+void MainWindow::onAnalysisFinished(const GomokuLib::SearchResult &result)
+{
+    if (result.bestMove.first < 0)
+    {
+        statusBar()->showMessage(tr("打てる手がありません"), 5000);
+        return;
+    }
+
+    QString message = tr("ヒント: (%1, %2)").arg(result.bestMove.first).arg(result.bestMove.second);
+    if (GomokuLib::Search::isWinScore(result.score))
+    {
+        message += (result.score > 0) ? tr("（勝ちを読み切りました）") : tr("（負けを読み切りました）");
+    }
+    statusBar()->showMessage(message, 10000);
+}
+
+void MainWindow::analyzeGame()
+{
+    if (!game)
+        return;
+
+    // 最後まで進めた棋譜全体を解析する（途中の局面を表示していても同じ）
+    auto line = game->getLineView();
+    if (line.empty())
+    {
+        statusBar()->showMessage(tr("解析する手がありません"), 3000);
+        return;
+    }
+
+    analysisBridge->startGame(game->getBoard().getSize(), std::vector<std::pair<int, int>>(line.begin(), line.end()));
+    statusBar()->showMessage(tr("棋譜を解析中..."));
+}
+
+void MainWindow::onGameAnalysisFinished(const GomokuLib::GameAnalysis &analysis)
+{
+    evaluationGraph->setAnalysis(analysis);
+    evaluationGraph->setCurrentPly(static_cast<int>(game->getPly()));
+    evaluationGraph->show();
+
+    int blunders = 0;
+    int missedWins = 0;
+    for (const auto &move : analysis.moves)
+    {
+        if (move.judgement == GomokuLib::MoveJudgement::BLUNDER)
+            blunders++;
+        else if (move.judgement == GomokuLib::MoveJudgement::MISSED_WIN)
+            missedWins++;
+    }
+    statusBar()->showMessage(tr("解析完了: 悪手 %1、勝ちの見逃し %2").arg(blunders).arg(missedWins), 10000);
+}
+
 void MainWindow::updateUI()
 {
     if (!game)
         return;
-    moveHistoryList->clear();
-    auto moves = game->getMoves();
-    GomokuLib::Stone s = GomokuLib::Stone::BLACK;
-    for (size_t i = 0; i < moves.size(); i++)
+
+    // 棋譜の一覧は増減した行だけを更新する
+    moveHistoryModel->sync();
+    moveHistoryList->scrollToBottom();
+
+    // スライダーの操作による通知を繰り返さないようにする
+    int length = static_cast<int>(game->getLineView().size());
+    int ply = static_cast<int>(game->getPly());
     {
-        QString color = (s == GomokuLib::Stone::BLACK) ? tr("黒") : tr("白");
-        moveHistoryList->addItem(QString("%1: (%2, %3) %4").arg(i + 1).arg(moves[i].first).arg(moves[i].second).arg(color));
-        s = (s == GomokuLib::Stone::BLACK) ? GomokuLib::Stone::WHITE : GomokuLib::Stone::BLACK;
+        QSignalBlocker blocker(timelineSlider);
+        timelineSlider->setRange(0, length);
+        timelineSlider->setValue(ply);
     }
-    boardWidget->update();
-}
\ No newline at end of file
+    timelineLabel->setText(QString("%1 / %2").arg(ply).arg(length));
+    evaluationGraph->setCurrentPly(ply);
+}
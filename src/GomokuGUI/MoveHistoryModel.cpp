@@ -0,0 +1,49 @@
+#include "GomokuGUI/MoveHistoryModel.h"
+
+MoveHistoryModel::MoveHistoryModel(QObject *parent)
+    : QAbstractListModel(parent),
+      game(nullptr),
+      rows(0)
+{
+}
+
+void MoveHistoryModel::setGame(const GomokuLib::Game *newGame)
+{
+    beginResetModel();
+    game = newGame;
+    rows = game ? static_cast<int>(game->getMoveView().size()) : 0;
+    endResetModel();
+}
+
+void MoveHistoryModel::sync()
+{
+    int count = game ? static_cast<int>(game->getMoveView().size()) : 0;
+    if (count > rows)
+    {
+        beginInsertRows(QModelIndex(), rows, count - 1);
+        rows = count;
+        endInsertRows();
+    }
+    else if (count < rows)
+    {
+        beginRemoveRows(QModelIndex(), count, rows - 1);
+        rows = count;
+        endRemoveRows();
+    }
+}
+
+int MoveHistoryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : rows;
+}
+
+QVariant MoveHistoryModel::data(const QModelIndex &index, int role) const
+{
+    if (!game || !index.isValid() || index.row() >= rows || role != Qt::DisplayRole)
+        return QVariant();
+
+    const auto &move = game->getMoveView()[static_cast<size_t>(index.row())];
+    // 黒から交互に打つので、偶数番目が黒
+    QString color = (index.row() % 2 == 0) ? tr("黒") : tr("白");
+    return QString("%1: (%2, %3) %4").arg(index.row() + 1).arg(move.first).arg(move.second).arg(color);
+}
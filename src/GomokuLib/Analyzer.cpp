@@ -0,0 +1,94 @@
+#include "GomokuLib/Analyzer.h"
+#include <chrono>
+
+namespace GomokuLib
+{
+
+    bool AnalysisHandle::isValid() const
+    {
+        return state != nullptr;
+    }
+
+    void AnalysisHandle::cancel() const
+    {
+        if (state)
+        {
+            state->token.cancel();
+        }
+    }
+
+    bool AnalysisHandle::isCancelled() const
+    {
+        return state && state->token.isCancelled();
+    }
+
+    bool AnalysisHandle::isFinished() const
+    {
+        return result.valid() && result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    SearchResult AnalysisHandle::wait() const
+    {
+        return result.get();
+    }
+
+    SearchResult AnalysisHandle::getLatest() const
+    {
+        if (!state)
+        {
+            return SearchResult();
+        }
+        std::lock_guard<std::mutex> lock(state->mutex);
+        return state->latest;
+    }
+
+    Analyzer::Analyzer(size_t threadCount)
+        : pool(threadCount == 0 ? 1 : threadCount)
+    {
+    }
+
+    AnalysisHandle Analyzer::analyze(const Board &board, Stone player, const SearchLimits &limits,
+                                     ProgressCallback onProgress, CompletionCallback onComplete)
+    {
+        AnalysisHandle handle;
+        handle.state = std::make_shared<AnalysisHandle::State>();
+
+        // 呼び出し元の盤面はこの後も変わるので、コピーを渡す
+        auto state = handle.state;
+        auto task = [state, board, player, limits, onProgress = std::move(onProgress), onComplete = std::move(onComplete)]()
+        {
+            // 途中経過はハンドルから参照できるように保存してから通知する
+            auto progress = [&](const SearchResult &partial)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->latest = partial;
+                }
+                if (onProgress)
+                {
+                    onProgress(partial);
+                }
+            };
+
+            SearchResult result = Search::run(board, player, limits, state->token, progress);
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->latest = result;
+            }
+            if (onComplete)
+            {
+                onComplete(result);
+            }
+            return result;
+        };
+
+        handle.result = pool.submit(std::move(task)).share();
+        return handle;
+    }
+
+    void Analyzer::waitIdle()
+    {
+        pool.waitIdle();
+    }
+
+} // namespace GomokuLib
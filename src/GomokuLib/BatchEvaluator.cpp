@@ -0,0 +1,354 @@
+#include "GomokuLib/BatchEvaluator.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // Request::state の値
+        constexpr uint32_t STATE_PENDING = 0;
+        constexpr uint32_t STATE_DONE = 1;
+        constexpr uint32_t STATE_SLEEPING = 2;
+
+        // 眠る前に結果を待って譲る回数
+        constexpr int SPIN_COUNT = 16;
+
+        static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+                      "futex requires a plain 32-bit atomic");
+
+        uint64_t nowNanoseconds()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch())
+                                             .count());
+        }
+
+        // word が expected のままなら起こされるまで眠る（timeout が nullptr なら期限なし）
+        void futexWait(std::atomic<uint32_t> &word, uint32_t expected, const timespec *timeout)
+        {
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+        }
+
+        void futexWake(std::atomic<uint32_t> &word, int count)
+        {
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+        }
+    }
+
+    EvaluationBatch::EvaluationBatch(int boardSize, size_t capacity)
+        : boardSize(boardSize), capacity(capacity), count(0)
+    {
+        if (boardSize < 1 || boardSize > BoardScan::MAX_PACKED_SIZE || capacity == 0)
+        {
+            throw std::runtime_error("Unsupported evaluation batch size");
+        }
+        blackRows.resize(capacity * boardSize);
+        whiteRows.resize(capacity * boardSize);
+        sidesToMove.resize(capacity);
+        scores.resize(capacity);
+    }
+
+    void EvaluationBatch::clear()
+    {
+        count = 0;
+    }
+
+    bool EvaluationBatch::add(const Board &board, Stone sideToMove)
+    {
+        if (count == capacity || board.getSize() != boardSize)
+        {
+            return false;
+        }
+        std::copy_n(board.getPackedRows(Stone::BLACK), boardSize, blackRows.data() + count * boardSize);
+        std::copy_n(board.getPackedRows(Stone::WHITE), boardSize, whiteRows.data() + count * boardSize);
+        sidesToMove[count] = sideToMove;
+        scores[count] = 0;
+        count++;
+        return true;
+    }
+
+    Stone EvaluationBatch::getStone(size_t index, int row, int col) const
+    {
+        uint64_t bit = uint64_t(1) << col;
+        if (getBlackRows(index)[row] & bit)
+            return Stone::BLACK;
+        if (getWhiteRows(index)[row] & bit)
+            return Stone::WHITE;
+        return Stone::EMPTY;
+    }
+
+    BatchEvaluator::BatchEvaluator(int boardSize, Evaluator evaluator, size_t batchSize, long long maxDelayMicroseconds)
+        : boardSize(boardSize), batchSize(batchSize), maxDelayMicroseconds(maxDelayMicroseconds),
+          evaluator(std::move(evaluator)), head(&stub), tail(&stub), submitted(0), dispatcherSleeping(false),
+          stopping(false), batchCount(0), positionCount(0), fullBatchCount(0)
+    {
+        if (boardSize < 1 || boardSize > BoardScan::MAX_PACKED_SIZE || batchSize == 0 || !this->evaluator)
+        {
+            throw std::runtime_error("Invalid batch evaluator settings");
+        }
+        dispatcher = std::thread(&BatchEvaluator::dispatchLoop, this);
+    }
+
+    BatchEvaluator::~BatchEvaluator()
+    {
+        stopping.store(true, std::memory_order_release);
+        submitted.fetch_add(1);
+        futexWake(submitted, 1);
+        dispatcher.join();
+    }
+
+    void BatchEvaluator::push(Request *request)
+    {
+        request->next.store(nullptr, std::memory_order_relaxed);
+        Request *previous = head.exchange(request, std::memory_order_acq_rel);
+        previous->next.store(request, std::memory_order_release);
+    }
+
+    BatchEvaluator::Request *BatchEvaluator::pop()
+    {
+        // 評価用のスレッドだけが呼ぶ（tail は1つのスレッドからしか触らない）
+        Request *first = tail;
+        Request *next = first->next.load(std::memory_order_acquire);
+        if (first == &stub)
+        {
+            if (next == nullptr)
+            {
+                return nullptr;
+            }
+            tail = next;
+            first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr)
+        {
+            tail = next;
+            return first;
+        }
+
+        // 積んでいる途中の局面がある（つなぎ終えると submitted が増えるので、その後で取り出せる）
+        if (first != head.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+
+        // 最後の1つを取り出すために、番兵をつないでおく
+        push(&stub);
+        next = first->next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            tail = next;
+            return first;
+        }
+        return nullptr;
+    }
+
+    BatchEvaluator::Request *BatchEvaluator::waitForRequest(uint64_t deadline)
+    {
+        while (true)
+        {
+            Request *request = pop();
+            if (request != nullptr)
+            {
+                return request;
+            }
+            if (stopping.load(std::memory_order_acquire))
+            {
+                return nullptr;
+            }
+
+            // 眠ることを知らせてから、もう一度確かめる（その間に積まれた局面を見落とさない）
+            uint32_t seen = submitted.load();
+            dispatcherSleeping.store(true);
+            request = pop();
+            if (request != nullptr)
+            {
+                dispatcherSleeping.store(false, std::memory_order_relaxed);
+                return request;
+            }
+
+            if (deadline == 0)
+            {
+                futexWait(submitted, seen, nullptr);
+            }
+            else
+            {
+                uint64_t now = nowNanoseconds();
+                if (now >= deadline)
+                {
+                    dispatcherSleeping.store(false, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                uint64_t remaining = deadline - now;
+                timespec timeout{static_cast<time_t>(remaining / 1000000000), static_cast<long>(remaining % 1000000000)};
+                futexWait(submitted, seen, &timeout);
+            }
+            dispatcherSleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    void BatchEvaluator::complete(Request *request)
+    {
+        // 待っている側が眠っていた場合だけ起こす（起こした後は request に触れない）
+        if (request->state.exchange(STATE_DONE, std::memory_order_acq_rel) == STATE_SLEEPING)
+        {
+            futexWake(request->state, 1);
+        }
+    }
+
+    void BatchEvaluator::dispatchLoop()
+    {
+        EvaluationBatch batch(boardSize, batchSize);
+        std::vector<Request *> requests;
+        requests.reserve(batchSize);
+
+        while (true)
+        {
+            Request *first = waitForRequest(0);
+            if (first == nullptr)
+            {
+                return;
+            }
+
+            // 満杯になるか、最初の局面を受け取ってから期限が来るまで集める
+            batch.clear();
+            requests.clear();
+            batch.add(*first->board, first->sideToMove);
+            requests.push_back(first);
+            uint64_t deadline = first->submitted + static_cast<uint64_t>(maxDelayMicroseconds) * 1000;
+            while (requests.size() < batchSize)
+            {
+                Request *request = waitForRequest(deadline);
+                if (request == nullptr)
+                {
+                    break;
+                }
+                batch.add(*request->board, request->sideToMove);
+                requests.push_back(request);
+            }
+
+            uint64_t start = nowNanoseconds();
+            for (Request *request : requests)
+            {
+                delay.record(start > request->submitted ? start - request->submitted : 0);
+            }
+
+            try
+            {
+                evaluator(batch);
+                for (size_t i = 0; i < requests.size(); i++)
+                {
+                    requests[i]->score = batch.getScore(i);
+                }
+            }
+            catch (...)
+            {
+                std::exception_ptr error = std::current_exception();
+                for (Request *request : requests)
+                {
+                    request->error = error;
+                }
+            }
+
+            batchCount.fetch_add(1, std::memory_order_relaxed);
+            positionCount.fetch_add(requests.size(), std::memory_order_relaxed);
+            if (requests.size() == batchSize)
+            {
+                fullBatchCount.fetch_add(1, std::memory_order_relaxed);
+            }
+            for (Request *request : requests)
+            {
+                complete(request);
+            }
+        }
+    }
+
+    int BatchEvaluator::evaluate(const Board &board, Stone sideToMove)
+    {
+        if (board.getSize() != boardSize)
+        {
+            throw std::runtime_error("Batch evaluator was created for a different board size");
+        }
+
+        Request request;
+        request.board = &board;
+        request.sideToMove = sideToMove;
+        request.submitted = nowNanoseconds();
+        push(&request);
+        submitted.fetch_add(1);
+        if (dispatcherSleeping.load())
+        {
+            futexWake(submitted, 1);
+        }
+
+        // 少し譲って待ち、それでも終わらなければ評価用のスレッドに起こしてもらう
+        for (int i = 0; i < SPIN_COUNT && request.state.load(std::memory_order_acquire) != STATE_DONE; i++)
+        {
+            std::this_thread::yield();
+        }
+        uint32_t expected = STATE_PENDING;
+        if (request.state.compare_exchange_strong(expected, STATE_SLEEPING, std::memory_order_acq_rel))
+        {
+            while (request.state.load(std::memory_order_acquire) == STATE_SLEEPING)
+            {
+                futexWait(request.state, STATE_SLEEPING, nullptr);
+            }
+        }
+
+        if (request.error)
+        {
+            std::rethrow_exception(request.error);
+        }
+        return request.score;
+    }
+
+    int BatchEvaluator::getBoardSize() const
+    {
+        return boardSize;
+    }
+
+    BatchEvaluatorStats BatchEvaluator::getStats() const
+    {
+        BatchEvaluatorStats stats;
+        stats.batchSize = batchSize;
+        stats.batches = batchCount.load(std::memory_order_relaxed);
+        stats.positions = positionCount.load(std::memory_order_relaxed);
+        stats.fullBatches = fullBatchCount.load(std::memory_order_relaxed);
+        stats.meanDelayMicroseconds = delay.getMean() / 1000.0;
+        stats.p50DelayMicroseconds = delay.getPercentile(50.0) / 1000.0;
+        stats.p99DelayMicroseconds = delay.getPercentile(99.0) / 1000.0;
+        return stats;
+    }
+
+    void BatchEvaluator::resetStats()
+    {
+        batchCount.store(0, std::memory_order_relaxed);
+        positionCount.store(0, std::memory_order_relaxed);
+        fullBatchCount.store(0, std::memory_order_relaxed);
+        delay.reset();
+    }
+
+    BatchEvaluator::Evaluator BatchEvaluator::networkEvaluator(std::shared_ptr<const NeuralNetwork> network)
+    {
+        return [network](EvaluationBatch &batch)
+        {
+            if (batch.getBoardSize() != network->getBoardSize())
+            {
+                throw std::runtime_error("Neural network was created for a different board size");
+            }
+            NeuralAccumulator accumulator(*network);
+            for (size_t i = 0; i < batch.size(); i++)
+            {
+                accumulator.refresh(batch.getBlackRows(i), batch.getWhiteRows(i));
+                batch.setScore(i, accumulator.evaluate(batch.getSideToMove(i)));
+            }
+        };
+    }
+
+} // namespace GomokuLib
@@ -1,12 +1,61 @@
 #include "GomokuLib/Board.h"
+#include "GomokuLib/Instrumentation.h"
+#include "GomokuLib/Tracer.h"
+#include <algorithm>
 
 namespace GomokuLib
 {
 
-    Board::Board(int size) : size(size)
+    Board::Board(int size, const allocator_type &allocator) : size(0), stoneCount(0), cells(allocator), packed(allocator)
     {
-        // 盤面の初期化
-        grid.resize(size, std::vector<Stone>(size, Stone::EMPTY));
+        reset(size);
+    }
+
+    Board::Board(const Board &other, const allocator_type &allocator)
+        : size(other.size), stoneCount(other.stoneCount), cells(other.cells, allocator), packed(other.packed, allocator)
+    {
+    }
+
+    Board::Board(Board &&other, const allocator_type &allocator)
+        : size(other.size), stoneCount(other.stoneCount), cells(std::move(other.cells), allocator),
+          packed(std::move(other.packed), allocator)
+    {
+    }
+
+    Board::allocator_type Board::getAllocator() const
+    {
+        return cells.get_allocator();
+    }
+
+    void Board::reset()
+    {
+        reset(size);
+    }
+
+    void Board::reset(int newSize)
+    {
+        // 確保済みの領域を使い回す（大きくなる場合だけ確保し直す）
+        size = newSize;
+        stoneCount = 0;
+        cells.assign(static_cast<size_t>(size) * size, Stone::EMPTY);
+        if (size <= BoardScan::MAX_PACKED_SIZE)
+        {
+            packed.assign(2 * static_cast<size_t>(size + BoardScan::ROW_PADDING), 0);
+        }
+        else
+        {
+            packed.clear();
+        }
+    }
+
+    uint64_t *Board::packedRows(Stone stone)
+    {
+        return packed.data() + ((stone == Stone::WHITE) ? size + BoardScan::ROW_PADDING : 0);
+    }
+
+    const uint64_t *Board::packedRows(Stone stone) const
+    {
+        return packed.data() + ((stone == Stone::WHITE) ? size + BoardScan::ROW_PADDING : 0);
     }
 
     bool Board::isValidPosition(int row, int col) const
@@ -25,18 +74,32 @@ namespace GomokuLib
         // 石を取り除く場合
         if (stone == Stone::EMPTY)
         {
-            grid[row][col] = Stone::EMPTY;
+            if (cell(row, col) != Stone::EMPTY)
+            {
+                stoneCount--;
+            }
+            cell(row, col) = Stone::EMPTY;
+            if (!packed.empty())
+            {
+                packedRows(Stone::BLACK)[row] &= ~(uint64_t(1) << col);
+                packedRows(Stone::WHITE)[row] &= ~(uint64_t(1) << col);
+            }
             return true;
         }
 
         // すでに石がある場合は配置できない
-        if (grid[row][col] != Stone::EMPTY)
+        if (cell(row, col) != Stone::EMPTY)
         {
             return false;
         }
 
         // 石を配置
-        grid[row][col] = stone;
+        cell(row, col) = stone;
+        stoneCount++;
+        if (!packed.empty() && (stone == Stone::BLACK || stone == Stone::WHITE))
+        {
+            packedRows(stone)[row] |= uint64_t(1) << col;
+        }
         return true;
     }
 
@@ -46,7 +109,7 @@ namespace GomokuLib
         {
             return Stone::EMPTY;
         }
-        return grid[row][col];
+        return cell(row, col);
     }
 
     bool Board::checkLine(int row, int col, int dRow, int dCol, Stone stone) const
@@ -59,7 +122,7 @@ namespace GomokuLib
             int newRow = row + i * dRow;
             int newCol = col + i * dCol;
 
-            if (!isValidPosition(newRow, newCol) || grid[newRow][newCol] != stone)
+            if (!isValidPosition(newRow, newCol) || cell(newRow, newCol) != stone)
             {
                 break;
             }
@@ -70,6 +133,51 @@ namespace GomokuLib
     }
 
     Stone Board::checkWinner() const
+    {
+        GOMOKU_COUNT(WIN_CHECKS, 1);
+        GOMOKU_COUNT(CELLS_SCANNED, size * size);
+
+        Stone winner = packed.empty() ? findFiveInGrid() : findFiveInRows();
+        if (winner != Stone::EMPTY)
+        {
+            return winner;
+        }
+
+        // 勝者がいない場合
+        if (isFull())
+        {
+            return Stone::DRAW;
+        }
+
+        return Stone::EMPTY;
+    }
+
+    Stone Board::findFiveInRows() const
+    {
+        // 黒と白の5連の始点を全ての行について一度に求める
+        uint64_t blackStarts[BoardScan::MAX_PACKED_SIZE + BoardScan::ROW_PADDING];
+        uint64_t whiteStarts[BoardScan::MAX_PACKED_SIZE + BoardScan::ROW_PADDING];
+        BoardScan::findFiveStarts(packedRows(Stone::BLACK), size, blackStarts);
+        BoardScan::findFiveStarts(packedRows(Stone::WHITE), size, whiteStarts);
+
+        // 行優先で最初の始点の色（マス目を順に調べた場合と同じ結果になる）
+        for (int row = 0; row < size; row++)
+        {
+            uint64_t black = blackStarts[row];
+            uint64_t white = whiteStarts[row];
+            if (black | white)
+            {
+                if (!white)
+                    return Stone::BLACK;
+                if (!black)
+                    return Stone::WHITE;
+                return (__builtin_ctzll(black) < __builtin_ctzll(white)) ? Stone::BLACK : Stone::WHITE;
+            }
+        }
+        return Stone::EMPTY;
+    }
+
+    Stone Board::findFiveInGrid() const
     {
         // 勝者判定の方向: 水平、垂直、右下がり対角線、左下がり対角線
         const int directions[4][2] = {
@@ -83,7 +191,7 @@ namespace GomokuLib
         {
             for (int col = 0; col < size; col++)
             {
-                Stone stone = grid[row][col];
+                Stone stone = cell(row, col);
 
                 // 空マスはスキップ
                 if (stone == Stone::EMPTY)
@@ -101,29 +209,103 @@ namespace GomokuLib
                 }
             }
         }
-
-        // 勝者がいない場合
-        if (isFull())
-        {
-            return Stone::DRAW;
-        }
-
         return Stone::EMPTY;
     }
 
-    bool Board::isFull() const
+    LineFeatures Board::countLineFeatures() const
     {
+        LineFeatures features;
+        if (!packed.empty())
+        {
+            BoardScan::countWindows(packedRows(Stone::BLACK), packedRows(Stone::WHITE), size, features.black.data());
+            BoardScan::countWindows(packedRows(Stone::WHITE), packedRows(Stone::BLACK), size, features.white.data());
+            return features;
+        }
+
+        // 大きな盤面では窓を1つずつ数える
+        const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
         for (int row = 0; row < size; row++)
         {
             for (int col = 0; col < size; col++)
             {
-                if (grid[row][col] == Stone::EMPTY)
+                for (const auto &direction : directions)
                 {
-                    return false;
+                    int endRow = row + 4 * direction[0];
+                    int endCol = col + 4 * direction[1];
+                    if (!isValidPosition(endRow, endCol))
+                        continue;
+
+                    int black = 0;
+                    int white = 0;
+                    for (int k = 0; k < 5; k++)
+                    {
+                        Stone stone = cell(row + k * direction[0], col + k * direction[1]);
+                        black += (stone == Stone::BLACK);
+                        white += (stone == Stone::WHITE);
+                    }
+                    if (white == 0)
+                        features.black[black]++;
+                    if (black == 0)
+                        features.white[white]++;
                 }
             }
         }
-        return true;
+        return features;
+    }
+
+    bool Board::checkWinAt(int row, int col) const
+    {
+        GOMOKU_TRACE_SCOPE("board", "Board::checkWinAt");
+        if (!isValidPosition(row, col))
+        {
+            return false;
+        }
+
+        Stone stone = cell(row, col);
+        if (stone == Stone::EMPTY || stone == Stone::DRAW)
+        {
+            return false;
+        }
+
+        // 水平、垂直、右下がり対角線、左下がり対角線
+        const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+
+        // 調べたマスの数はまとめて一度だけ加える
+        GOMOKU_COUNT(WIN_CHECKS, 1);
+        int scanned = 0;
+
+        for (int d = 0; d < 4; d++)
+        {
+            int dRow = directions[d][0];
+            int dCol = directions[d][1];
+            int count = 1;
+
+            // 正方向と逆方向に連続する石を数える
+            for (int r = row + dRow, c = col + dCol; isValidPosition(r, c) && cell(r, c) == stone; r += dRow, c += dCol)
+            {
+                count++;
+            }
+            for (int r = row - dRow, c = col - dCol; isValidPosition(r, c) && cell(r, c) == stone; r -= dRow, c -= dCol)
+            {
+                count++;
+            }
+
+            scanned += count;
+            if (count >= 5)
+            {
+                GOMOKU_COUNT(CELLS_SCANNED, scanned);
+                return true;
+            }
+        }
+
+        GOMOKU_COUNT(CELLS_SCANNED, scanned);
+        return false;
+    }
+
+    bool Board::isFull() const
+    {
+        // 石の数は placeStone で管理している
+        return stoneCount >= size * size;
     }
 
     int Board::getSize() const
@@ -131,4 +313,59 @@ namespace GomokuLib
         return size;
     }
 
+    const uint64_t *Board::getPackedRows(Stone stone) const
+    {
+        return packed.empty() ? nullptr : packedRows(stone);
+    }
+
+    size_t Board::snapshotSize(int size)
+    {
+        return (static_cast<size_t>(size) * size + 3) / 4;
+    }
+
+    BoardSnapshot Board::saveSnapshot() const
+    {
+        BoardSnapshot snapshot(snapshotSize(size));
+        saveSnapshot(snapshot.data());
+        return snapshot;
+    }
+
+    void Board::saveSnapshot(uint8_t *destination) const
+    {
+        // 1バイトに4マスずつ詰める
+        std::fill_n(destination, snapshotSize(size), 0);
+        for (size_t index = 0; index < cells.size(); index++)
+        {
+            destination[index / 4] |= static_cast<uint8_t>(static_cast<uint8_t>(cells[index]) << ((index % 4) * 2));
+        }
+    }
+
+    void Board::restoreSnapshot(const BoardSnapshot &snapshot)
+    {
+        restoreSnapshot(snapshot.data());
+    }
+
+    void Board::restoreSnapshot(const uint8_t *source)
+    {
+        size_t index = 0;
+        stoneCount = 0;
+        std::fill(packed.begin(), packed.end(), 0);
+        for (int row = 0; row < size; row++)
+        {
+            for (int col = 0; col < size; col++, index++)
+            {
+                Stone stone = static_cast<Stone>((source[index / 4] >> ((index % 4) * 2)) & 0x3);
+                cell(row, col) = stone;
+                if (stone != Stone::EMPTY)
+                {
+                    stoneCount++;
+                }
+                if (!packed.empty() && (stone == Stone::BLACK || stone == Stone::WHITE))
+                {
+                    packedRows(stone)[row] |= uint64_t(1) << col;
+                }
+            }
+        }
+    }
+
 } // namespace GomokuLib
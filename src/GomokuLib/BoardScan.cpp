@@ -0,0 +1,81 @@
+#include "GomokuLib/BoardScan.h"
+#include "BoardScanKernel.h"
+#include "DispatchTable.h"
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // 64 ビット整数を1レーンのベクトルとして扱う（どの CPU でも使える実装）
+        struct ScalarVector
+        {
+            using type = uint64_t;
+            static constexpr int LANES = 1;
+
+            static type load(const uint64_t *p) { return *p; }
+            static void store(uint64_t *p, type v) { *p = v; }
+            static type set1(uint64_t value) { return value; }
+            static type and_(type a, type b) { return a & b; }
+            static type or_(type a, type b) { return a | b; }
+            static type xor_(type a, type b) { return a ^ b; }
+            static type andnot(type a, type b) { return ~a & b; }
+            template <int K>
+            static type srl(type v) { return v >> K; }
+            template <int K>
+            static type sll(type v) { return v << K; }
+            static uint64_t popcount(type v) { return static_cast<uint64_t>(__builtin_popcountll(v)); }
+        };
+    }
+
+    void BoardScanKernel::fiveStartsScalar(const uint64_t *own, int size, uint64_t *out)
+    {
+        BoardScanKernel::fiveStarts<ScalarVector>(own, size, out);
+    }
+
+    void BoardScanKernel::countWindowsScalar(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts)
+    {
+        BoardScanKernel::countWindows<ScalarVector>(own, other, size, counts);
+    }
+
+    bool BoardScan::isSupported(SimdLevel level)
+    {
+        return CpuDispatch::isSupported(level);
+    }
+
+    SimdLevel BoardScan::detectLevel()
+    {
+        return CpuDispatch::detectLevel();
+    }
+
+    std::vector<SimdLevel> BoardScan::supportedLevels()
+    {
+        return CpuDispatch::supportedLevels();
+    }
+
+    SimdLevel BoardScan::getLevel()
+    {
+        return CpuDispatch::getLevel();
+    }
+
+    void BoardScan::setLevel(SimdLevel level)
+    {
+        CpuDispatch::setLevel(level);
+    }
+
+    const char *BoardScan::levelToString(SimdLevel level)
+    {
+        return CpuDispatch::levelToString(level);
+    }
+
+    void BoardScan::findFiveStarts(const uint64_t *own, int size, uint64_t *out)
+    {
+        activeDispatch().fiveStarts(own, size, out);
+    }
+
+    void BoardScan::countWindows(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts)
+    {
+        activeDispatch().countWindows(own, other, size, counts);
+    }
+
+} // namespace GomokuLib
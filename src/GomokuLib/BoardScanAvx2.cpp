@@ -0,0 +1,45 @@
+// AVX2 のカーネル（4行ずつ処理する。-mavx2 -mpopcnt でコンパイルする）
+#include "BoardScanKernel.h"
+#include <immintrin.h>
+
+namespace GomokuLib
+{
+    namespace
+    {
+        struct Avx2Vector
+        {
+            using type = __m256i;
+            static constexpr int LANES = 4;
+
+            static type load(const uint64_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+            static void store(uint64_t *p, type v) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v); }
+            static type set1(uint64_t value) { return _mm256_set1_epi64x(static_cast<long long>(value)); }
+            static type and_(type a, type b) { return _mm256_and_si256(a, b); }
+            static type or_(type a, type b) { return _mm256_or_si256(a, b); }
+            static type xor_(type a, type b) { return _mm256_xor_si256(a, b); }
+            static type andnot(type a, type b) { return _mm256_andnot_si256(a, b); }
+            template <int K>
+            static type srl(type v) { return _mm256_srli_epi64(v, K); }
+            template <int K>
+            static type sll(type v) { return _mm256_slli_epi64(v, K); }
+            static uint64_t popcount(type v)
+            {
+                return _mm_popcnt_u64(static_cast<uint64_t>(_mm256_extract_epi64(v, 0))) +
+                       _mm_popcnt_u64(static_cast<uint64_t>(_mm256_extract_epi64(v, 1))) +
+                       _mm_popcnt_u64(static_cast<uint64_t>(_mm256_extract_epi64(v, 2))) +
+                       _mm_popcnt_u64(static_cast<uint64_t>(_mm256_extract_epi64(v, 3)));
+            }
+        };
+    }
+
+    void BoardScanKernel::fiveStartsAvx2(const uint64_t *own, int size, uint64_t *out)
+    {
+        BoardScanKernel::fiveStarts<Avx2Vector>(own, size, out);
+    }
+
+    void BoardScanKernel::countWindowsAvx2(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts)
+    {
+        BoardScanKernel::countWindows<Avx2Vector>(own, other, size, counts);
+    }
+
+} // namespace GomokuLib
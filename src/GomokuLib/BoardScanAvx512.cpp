@@ -0,0 +1,53 @@
+// AVX-512 のカーネル（8行ずつ処理する。-mavx512f -mpopcnt でコンパイルする）
+#include "BoardScanKernel.h"
+#include <immintrin.h>
+
+namespace GomokuLib
+{
+    namespace
+    {
+        struct Avx512Vector
+        {
+            using type = __m512i;
+            static constexpr int LANES = 8;
+
+            static type load(const uint64_t *p) { return _mm512_loadu_si512(p); }
+            static void store(uint64_t *p, type v) { _mm512_storeu_si512(p, v); }
+            static type set1(uint64_t value) { return _mm512_set1_epi64(static_cast<long long>(value)); }
+            static type and_(type a, type b) { return _mm512_and_si512(a, b); }
+            static type or_(type a, type b) { return _mm512_or_si512(a, b); }
+            static type xor_(type a, type b) { return _mm512_xor_si512(a, b); }
+            static type andnot(type a, type b) { return _mm512_andnot_si512(a, b); }
+            template <int K>
+            static type srl(type v) { return _mm512_srli_epi64(v, K); }
+            template <int K>
+            static type sll(type v) { return _mm512_slli_epi64(v, K); }
+            static uint64_t popcount(type v)
+            {
+                // 空のレーンが多いので、0 でないレーンだけを数える
+                alignas(64) uint64_t lanes[LANES];
+                __mmask8 nonZero = _mm512_test_epi64_mask(v, v);
+                if (!nonZero)
+                    return 0;
+                _mm512_store_si512(lanes, v);
+                uint64_t total = 0;
+                for (int lane = 0; lane < LANES; lane++)
+                {
+                    total += _mm_popcnt_u64(lanes[lane]);
+                }
+                return total;
+            }
+        };
+    }
+
+    void BoardScanKernel::fiveStartsAvx512(const uint64_t *own, int size, uint64_t *out)
+    {
+        BoardScanKernel::fiveStarts<Avx512Vector>(own, size, out);
+    }
+
+    void BoardScanKernel::countWindowsAvx512(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts)
+    {
+        BoardScanKernel::countWindows<Avx512Vector>(own, other, size, counts);
+    }
+
+} // namespace GomokuLib
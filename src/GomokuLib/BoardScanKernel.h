@@ -0,0 +1,142 @@
+#pragma once
+
+// 盤面全体を走査するカーネルの共通の実装（ライブラリの内部でのみ使う）
+// 各命令セットの翻訳単位が、それぞれのコンパイルオプションでこのテンプレートを実体化する
+// 別の命令セットで作られた関数がリンク時に混ざらないよう、ここでは標準ライブラリを使わない
+
+#include <cstdint>
+
+namespace GomokuLib
+{
+    namespace BoardScanKernel
+    {
+        // 1行をビット列（列 c がビット c）で表した盤面を、行をまとめてベクトルで処理する
+        // V はベクトルの型と演算を与える（LANES 行を同時に処理する）
+        //   and_ / or_ / xor_ / andnot(a, b) = ~a & b / srl<K> / sll<K> / load / store / set1 / popcount（全レーンの合計）
+
+        // 5連の始点（横は左端、縦・斜めは上端）の列のビットを行ごとに out に書き出す
+        // own と out は size + BoardScan::ROW_PADDING 行分の領域があり、size 行目以降は 0
+        template <typename V>
+        inline void fiveStarts(const uint64_t *own, int size, uint64_t *out)
+        {
+            for (int r = 0; r < size; r += V::LANES)
+            {
+                auto r0 = V::load(own + r);
+                auto r1 = V::load(own + r + 1);
+                auto r2 = V::load(own + r + 2);
+                auto r3 = V::load(own + r + 3);
+                auto r4 = V::load(own + r + 4);
+
+                auto horizontal = V::and_(V::and_(r0, V::template srl<1>(r0)),
+                                          V::and_(V::and_(V::template srl<2>(r0), V::template srl<3>(r0)), V::template srl<4>(r0)));
+                auto vertical = V::and_(V::and_(r0, r1), V::and_(V::and_(r2, r3), r4));
+                auto diagonal = V::and_(V::and_(r0, V::template srl<1>(r1)),
+                                        V::and_(V::and_(V::template srl<2>(r2), V::template srl<3>(r3)), V::template srl<4>(r4)));
+                auto antiDiagonal = V::and_(V::and_(r0, V::template sll<1>(r1)),
+                                            V::and_(V::and_(V::template sll<2>(r2), V::template sll<3>(r3)), V::template sll<4>(r4)));
+
+                V::store(out + r, V::or_(V::or_(horizontal, vertical), V::or_(diagonal, antiDiagonal)));
+            }
+        }
+
+        // 5マスの窓のうち、相手の石を含まないものを自分の石の数 (0〜5) ごとに数えて counts に加える
+        // 5つのビット列を足し合わせ、窓ごとの石の数を3ビットに分けて求める
+        template <typename V>
+        inline void countWindowsInDirection(typename V::type w0, typename V::type w1, typename V::type w2,
+                                            typename V::type w3, typename V::type w4, typename V::type open,
+                                            uint64_t *counts)
+        {
+            auto sum012 = V::xor_(V::xor_(w0, w1), w2);
+            auto carry012 = V::or_(V::and_(w0, w1), V::and_(w2, V::xor_(w0, w1)));
+            auto bit0 = V::xor_(V::xor_(sum012, w3), w4);
+            auto carry34 = V::or_(V::and_(w3, w4), V::and_(sum012, V::xor_(w3, w4)));
+            auto bit1 = V::xor_(carry012, carry34);
+            auto bit2 = V::and_(carry012, carry34);
+
+            auto zero0 = V::andnot(bit0, open);
+            auto one0 = V::and_(bit0, open);
+            auto low0 = V::andnot(bit2, V::andnot(bit1, zero0));
+            auto low1 = V::andnot(bit2, V::andnot(bit1, one0));
+            counts[0] += V::popcount(low0);
+            counts[1] += V::popcount(low1);
+            counts[2] += V::popcount(V::andnot(bit2, V::and_(bit1, zero0)));
+            counts[3] += V::popcount(V::andnot(bit2, V::and_(bit1, one0)));
+            counts[4] += V::popcount(V::and_(bit2, V::andnot(bit1, zero0)));
+            counts[5] += V::popcount(V::and_(bit2, V::andnot(bit1, one0)));
+        }
+
+        template <typename V>
+        inline void countWindows(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts)
+        {
+            if (size < 5)
+                return;
+
+            // 窓が盤面に収まる始点の列（横と右下がりは左端から size - 5 まで、左下がりは 4 列目から）
+            const uint64_t allColumns = (size >= 64) ? ~uint64_t(0) : ((uint64_t(1) << size) - 1);
+            const uint64_t leftColumns = (uint64_t(1) << (size - 4)) - 1;
+            const uint64_t rightColumns = allColumns & ~uint64_t(0xF);
+
+            uint64_t rowMask[V::LANES];    // 盤面内の行
+            uint64_t windowMask[V::LANES]; // 縦と斜めの窓が収まる行
+            for (int r = 0; r < size; r += V::LANES)
+            {
+                for (int lane = 0; lane < V::LANES; lane++)
+                {
+                    rowMask[lane] = (r + lane < size) ? ~uint64_t(0) : 0;
+                    windowMask[lane] = (r + lane <= size - 5) ? ~uint64_t(0) : 0;
+                }
+                auto rows = V::load(rowMask);
+                auto windows = V::load(windowMask);
+
+                auto a0 = V::load(own + r);
+                auto a1 = V::load(own + r + 1);
+                auto a2 = V::load(own + r + 2);
+                auto a3 = V::load(own + r + 3);
+                auto a4 = V::load(own + r + 4);
+                auto b0 = V::load(other + r);
+                auto b1 = V::load(other + r + 1);
+                auto b2 = V::load(other + r + 2);
+                auto b3 = V::load(other + r + 3);
+                auto b4 = V::load(other + r + 4);
+
+                // 横
+                auto blocked = V::or_(V::or_(b0, V::template srl<1>(b0)),
+                                      V::or_(V::or_(V::template srl<2>(b0), V::template srl<3>(b0)), V::template srl<4>(b0)));
+                countWindowsInDirection<V>(a0, V::template srl<1>(a0), V::template srl<2>(a0), V::template srl<3>(a0),
+                                           V::template srl<4>(a0),
+                                           V::andnot(blocked, V::and_(rows, V::set1(leftColumns))), counts);
+
+                // 縦
+                blocked = V::or_(V::or_(b0, b1), V::or_(V::or_(b2, b3), b4));
+                countWindowsInDirection<V>(a0, a1, a2, a3, a4,
+                                           V::andnot(blocked, V::and_(windows, V::set1(allColumns))), counts);
+
+                // 右下がり
+                blocked = V::or_(V::or_(b0, V::template srl<1>(b1)),
+                                 V::or_(V::or_(V::template srl<2>(b2), V::template srl<3>(b3)), V::template srl<4>(b4)));
+                countWindowsInDirection<V>(a0, V::template srl<1>(a1), V::template srl<2>(a2), V::template srl<3>(a3),
+                                           V::template srl<4>(a4),
+                                           V::andnot(blocked, V::and_(windows, V::set1(leftColumns))), counts);
+
+                // 左下がり
+                blocked = V::or_(V::or_(b0, V::template sll<1>(b1)),
+                                 V::or_(V::or_(V::template sll<2>(b2), V::template sll<3>(b3)), V::template sll<4>(b4)));
+                countWindowsInDirection<V>(a0, V::template sll<1>(a1), V::template sll<2>(a2), V::template sll<3>(a3),
+                                           V::template sll<4>(a4),
+                                           V::andnot(blocked, V::and_(windows, V::set1(rightColumns))), counts);
+            }
+        }
+
+        // 各命令セットの実装（BoardScan.cpp が実行時に選ぶ）
+        void fiveStartsScalar(const uint64_t *own, int size, uint64_t *out);
+        void countWindowsScalar(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts);
+#if defined(GOMOKU_X86_KERNELS)
+        void fiveStartsSse2(const uint64_t *own, int size, uint64_t *out);
+        void countWindowsSse2(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts);
+        void fiveStartsAvx2(const uint64_t *own, int size, uint64_t *out);
+        void countWindowsAvx2(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts);
+        void fiveStartsAvx512(const uint64_t *own, int size, uint64_t *out);
+        void countWindowsAvx512(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts);
+#endif
+    }
+} // namespace GomokuLib
@@ -0,0 +1,44 @@
+// SSE2 のカーネル（2行ずつ処理する）
+#include "BoardScanKernel.h"
+#include <emmintrin.h>
+
+namespace GomokuLib
+{
+    namespace
+    {
+        struct Sse2Vector
+        {
+            using type = __m128i;
+            static constexpr int LANES = 2;
+
+            static type load(const uint64_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+            static void store(uint64_t *p, type v) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v); }
+            static type set1(uint64_t value) { return _mm_set1_epi64x(static_cast<long long>(value)); }
+            static type and_(type a, type b) { return _mm_and_si128(a, b); }
+            static type or_(type a, type b) { return _mm_or_si128(a, b); }
+            static type xor_(type a, type b) { return _mm_xor_si128(a, b); }
+            static type andnot(type a, type b) { return _mm_andnot_si128(a, b); }
+            template <int K>
+            static type srl(type v) { return _mm_srli_epi64(v, K); }
+            template <int K>
+            static type sll(type v) { return _mm_slli_epi64(v, K); }
+            static uint64_t popcount(type v)
+            {
+                alignas(16) uint64_t lanes[LANES];
+                _mm_store_si128(reinterpret_cast<__m128i *>(lanes), v);
+                return __builtin_popcountll(lanes[0]) + __builtin_popcountll(lanes[1]);
+            }
+        };
+    }
+
+    void BoardScanKernel::fiveStartsSse2(const uint64_t *own, int size, uint64_t *out)
+    {
+        BoardScanKernel::fiveStarts<Sse2Vector>(own, size, out);
+    }
+
+    void BoardScanKernel::countWindowsSse2(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts)
+    {
+        BoardScanKernel::countWindows<Sse2Vector>(own, other, size, counts);
+    }
+
+} // namespace GomokuLib
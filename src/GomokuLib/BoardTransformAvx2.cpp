@@ -0,0 +1,17 @@
+// 盤面の対称変換と Zobrist ハッシュの AVX2 版（-mavx2 -mpopcnt -mbmi でコンパイルする）
+#include "BoardTransformKernel.h"
+
+namespace GomokuLib
+{
+
+    void BoardTransformKernel::transformCellsAvx2(const Stone *in, Stone *out, int size, int rowStart, int rowStep, int colStep)
+    {
+        BoardTransformKernel::transformCells(in, out, size, rowStart, rowStep, colStep);
+    }
+
+    uint64_t BoardTransformKernel::hashStonesAvx2(const uint64_t *black, const uint64_t *white, int size, const uint64_t *keys)
+    {
+        return BoardTransformKernel::hashStones(black, white, size, keys);
+    }
+
+} // namespace GomokuLib
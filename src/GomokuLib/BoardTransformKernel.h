@@ -0,0 +1,68 @@
+#pragma once
+
+// 盤面の対称変換と Zobrist ハッシュのカーネル（ライブラリの内部でのみ使う）
+// 各命令セットの翻訳単位が、それぞれのコンパイルオプションでこのテンプレートを実体化する
+// （同じ C++ のループを、コンパイラが命令セットに合わせてベクトル化する）
+
+#include "GomokuLib/Common.h"
+#include <cstdint>
+
+namespace GomokuLib
+{
+    namespace BoardTransformKernel
+    {
+        // out[r * size + c] = in[rowStart + r * rowStep + c * colStep]
+        // 対称変換は出力のマスから元のマスへの1次式なので、行ごとに一定の間隔で読む
+        template <typename T>
+        inline void transformCells(const T *in, T *out, int size, int rowStart, int rowStep, int colStep)
+        {
+            for (int r = 0; r < size; r++)
+            {
+                const T *source = in + rowStart + r * rowStep;
+                T *target = out + r * size;
+                // 間隔が ±1 のときは連続した読み出しになるので分けておく
+                if (colStep == 1)
+                {
+                    for (int c = 0; c < size; c++)
+                        target[c] = source[c];
+                }
+                else if (colStep == -1)
+                {
+                    for (int c = 0; c < size; c++)
+                        target[c] = source[-c];
+                }
+                else
+                {
+                    for (int c = 0; c < size; c++)
+                        target[c] = source[c * colStep];
+                }
+            }
+        }
+
+        // 行のビット列の立っているビットごとに、マスと色の乱数（keys[マス * 2 + 色]、色は黒 0・白 1）を排他的論理和する
+        inline uint64_t hashStones(const uint64_t *black, const uint64_t *white, int size, const uint64_t *keys)
+        {
+            uint64_t key = 0;
+            for (int r = 0; r < size; r++)
+            {
+                const uint64_t *rowKeys = keys + static_cast<int64_t>(r) * size * 2;
+                for (uint64_t bits = black[r]; bits != 0; bits &= bits - 1)
+                {
+                    key ^= rowKeys[__builtin_ctzll(bits) * 2];
+                }
+                for (uint64_t bits = white[r]; bits != 0; bits &= bits - 1)
+                {
+                    key ^= rowKeys[__builtin_ctzll(bits) * 2 + 1];
+                }
+            }
+            return key;
+        }
+
+        void transformCellsScalar(const Stone *in, Stone *out, int size, int rowStart, int rowStep, int colStep);
+        uint64_t hashStonesScalar(const uint64_t *black, const uint64_t *white, int size, const uint64_t *keys);
+#if defined(GOMOKU_X86_KERNELS)
+        void transformCellsAvx2(const Stone *in, Stone *out, int size, int rowStart, int rowStep, int colStep);
+        uint64_t hashStonesAvx2(const uint64_t *black, const uint64_t *white, int size, const uint64_t *keys);
+#endif
+    }
+} // namespace GomokuLib
@@ -0,0 +1,221 @@
+#include "GomokuLib/CpuDispatch.h"
+#include "BoardScanKernel.h"
+#include "BoardTransformKernel.h"
+#include "DispatchTable.h"
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        constexpr SimdLevel ALL_LEVELS[] = {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512};
+
+        const DispatchTable SCALAR_TABLE = {
+            SimdLevel::SCALAR, SimdLevel::SCALAR,
+            BoardScanKernel::fiveStartsScalar, BoardScanKernel::countWindowsScalar,
+            NeuralNetworkKernel::forwardScalar,
+            BoardTransformKernel::transformCellsScalar, BoardTransformKernel::hashStonesScalar};
+#if defined(GOMOKU_X86_KERNELS)
+        // SSE2 版があるのは盤面の走査だけ
+        const DispatchTable SSE2_TABLE = {
+            SimdLevel::SSE2, SimdLevel::SCALAR,
+            BoardScanKernel::fiveStartsSse2, BoardScanKernel::countWindowsSse2,
+            NeuralNetworkKernel::forwardScalar,
+            BoardTransformKernel::transformCellsScalar, BoardTransformKernel::hashStonesScalar};
+        const DispatchTable AVX2_TABLE = {
+            SimdLevel::AVX2, SimdLevel::AVX2,
+            BoardScanKernel::fiveStartsAvx2, BoardScanKernel::countWindowsAvx2,
+            NeuralNetworkKernel::forwardAvx2,
+            BoardTransformKernel::transformCellsAvx2, BoardTransformKernel::hashStonesAvx2};
+        // AVX-512 版があるのは盤面の走査だけ（残りは AVX2 版を使う）
+        const DispatchTable AVX512_TABLE = {
+            SimdLevel::AVX512, SimdLevel::AVX2,
+            BoardScanKernel::fiveStartsAvx512, BoardScanKernel::countWindowsAvx512,
+            NeuralNetworkKernel::forwardAvx2,
+            BoardTransformKernel::transformCellsAvx2, BoardTransformKernel::hashStonesAvx2};
+#endif
+
+        const DispatchTable &tableFor(SimdLevel level)
+        {
+            switch (level)
+            {
+#if defined(GOMOKU_X86_KERNELS)
+            case SimdLevel::SSE2:
+                return SSE2_TABLE;
+            case SimdLevel::AVX2:
+                return AVX2_TABLE;
+            case SimdLevel::AVX512:
+                return AVX512_TABLE;
+#endif
+            default:
+                return SCALAR_TABLE;
+            }
+        }
+
+        CpuFeatures detectFeatures()
+        {
+            CpuFeatures features;
+#if defined(GOMOKU_X86_KERNELS)
+            __builtin_cpu_init();
+            features.sse2 = __builtin_cpu_supports("sse2");
+            features.popcnt = __builtin_cpu_supports("popcnt");
+            features.bmi = __builtin_cpu_supports("bmi");
+            features.avx2 = __builtin_cpu_supports("avx2");
+            features.avx512f = __builtin_cpu_supports("avx512f");
+#endif
+            return features;
+        }
+    }
+
+    std::atomic<const DispatchTable *> CpuDispatchDetail::active(nullptr);
+
+    const DispatchTable &CpuDispatchDetail::initialize()
+    {
+        // 複数のスレッドが同時に初めて使っても、どれも同じ表を選ぶ
+        const DispatchTable *table = &tableFor(CpuDispatch::defaultLevel());
+        const DispatchTable *expected = nullptr;
+        active.compare_exchange_strong(expected, table, std::memory_order_acq_rel);
+        return *active.load(std::memory_order_acquire);
+    }
+
+    void BoardTransformKernel::transformCellsScalar(const Stone *in, Stone *out, int size, int rowStart, int rowStep, int colStep)
+    {
+        BoardTransformKernel::transformCells(in, out, size, rowStart, rowStep, colStep);
+    }
+
+    uint64_t BoardTransformKernel::hashStonesScalar(const uint64_t *black, const uint64_t *white, int size, const uint64_t *keys)
+    {
+        return BoardTransformKernel::hashStones(black, white, size, keys);
+    }
+
+    const CpuFeatures &CpuDispatch::getFeatures()
+    {
+        static const CpuFeatures features = detectFeatures();
+        return features;
+    }
+
+    bool CpuDispatch::isSupported(SimdLevel level)
+    {
+        const CpuFeatures &features = getFeatures();
+        switch (level)
+        {
+        case SimdLevel::SCALAR:
+            return true;
+#if defined(GOMOKU_X86_KERNELS)
+        case SimdLevel::SSE2:
+            return features.sse2;
+        case SimdLevel::AVX2:
+            return features.avx2 && features.popcnt && features.bmi;
+        case SimdLevel::AVX512:
+            return features.avx512f && features.avx2 && features.popcnt && features.bmi;
+#endif
+        default:
+            (void)features;
+            return false;
+        }
+    }
+
+    SimdLevel CpuDispatch::detectLevel()
+    {
+        for (SimdLevel level : {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE2})
+        {
+            if (isSupported(level))
+            {
+                return level;
+            }
+        }
+        return SimdLevel::SCALAR;
+    }
+
+    std::vector<SimdLevel> CpuDispatch::supportedLevels()
+    {
+        std::vector<SimdLevel> levels;
+        for (SimdLevel level : ALL_LEVELS)
+        {
+            if (isSupported(level))
+            {
+                levels.push_back(level);
+            }
+        }
+        return levels;
+    }
+
+    SimdLevel CpuDispatch::defaultLevel()
+    {
+        SimdLevel requested;
+        const char *name = std::getenv(ENVIRONMENT_VARIABLE);
+        if (!name || !parseLevel(name, requested))
+        {
+            return detectLevel();
+        }
+
+        // 指定より上の命令セットは使わない
+        SimdLevel level = SimdLevel::SCALAR;
+        for (SimdLevel candidate : ALL_LEVELS)
+        {
+            if (candidate <= requested && isSupported(candidate))
+            {
+                level = candidate;
+            }
+        }
+        return level;
+    }
+
+    SimdLevel CpuDispatch::getLevel()
+    {
+        return activeDispatch().level;
+    }
+
+    void CpuDispatch::setLevel(SimdLevel level)
+    {
+        if (!isSupported(level))
+        {
+            throw std::runtime_error(std::string("SIMD level is not supported on this CPU: ") + levelToString(level));
+        }
+        CpuDispatchDetail::active.store(&tableFor(level), std::memory_order_release);
+    }
+
+    void CpuDispatch::resetLevel()
+    {
+        CpuDispatchDetail::active.store(&tableFor(defaultLevel()), std::memory_order_release);
+    }
+
+    const char *CpuDispatch::levelToString(SimdLevel level)
+    {
+        switch (level)
+        {
+        case SimdLevel::SCALAR:
+            return "scalar";
+        case SimdLevel::SSE2:
+            return "sse2";
+        case SimdLevel::AVX2:
+            return "avx2";
+        case SimdLevel::AVX512:
+            return "avx512";
+        default:
+            return "unknown";
+        }
+    }
+
+    bool CpuDispatch::parseLevel(const std::string &name, SimdLevel &level)
+    {
+        std::string lower;
+        for (char ch : name)
+        {
+            lower += static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+        }
+        for (SimdLevel candidate : ALL_LEVELS)
+        {
+            if (lower == levelToString(candidate))
+            {
+                level = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace GomokuLib
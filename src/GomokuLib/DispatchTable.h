@@ -0,0 +1,48 @@
+#pragma once
+
+// 命令セットごとのカーネルの表（ライブラリの内部でのみ使う）
+
+#include "GomokuLib/Common.h"
+#include "GomokuLib/CpuDispatch.h"
+#include "NeuralNetworkKernel.h"
+#include <atomic>
+#include <cstdint>
+
+namespace GomokuLib
+{
+
+    struct DispatchTable
+    {
+        SimdLevel level;       // 表の命令セット
+        SimdLevel neuralLevel; // ニューラルネットワークの実装の命令セット
+
+        // BoardScan::findFiveStarts / countWindows
+        void (*fiveStarts)(const uint64_t *own, int size, uint64_t *out);
+        void (*countWindows)(const uint64_t *own, const uint64_t *other, int size, uint64_t *counts);
+
+        // 第2層と出力層
+        int32_t (*neuralForward)(const NeuralNetworkKernel::Layers &layers, const int16_t *own, const int16_t *other);
+
+        // 盤面の対称変換（BoardTransformKernel::transformCells）
+        void (*transformCells)(const Stone *in, Stone *out, int size, int rowStart, int rowStep, int colStep);
+
+        // 石の Zobrist ハッシュ（BoardTransformKernel::hashStones）
+        uint64_t (*hashStones)(const uint64_t *black, const uint64_t *white, int size, const uint64_t *keys);
+    };
+
+    namespace CpuDispatchDetail
+    {
+        extern std::atomic<const DispatchTable *> active;
+
+        // 初めて使うときに表を決める
+        const DispatchTable &initialize();
+    }
+
+    // 使う表（カーネルを呼ぶたびに引くので、決まった後はアトミックな読み出し1回だけ）
+    inline const DispatchTable &activeDispatch()
+    {
+        const DispatchTable *table = CpuDispatchDetail::active.load(std::memory_order_acquire);
+        return table ? *table : CpuDispatchDetail::initialize();
+    }
+
+} // namespace GomokuLib
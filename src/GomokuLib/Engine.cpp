@@ -0,0 +1,170 @@
+#include "GomokuLib/Engine.h"
+#include <cstdlib>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // 連続する石の数と空いている端の数から形の評価値を求める
+        int shapeScore(int length, int openEnds)
+        {
+            if (length >= 5)
+                return Engine::SCORE_FIVE;
+            if (openEnds == 0)
+                return 0;
+
+            switch (length)
+            {
+            case 4:
+                return openEnds == 2 ? Engine::SCORE_OPEN_FOUR : Engine::SCORE_FOUR;
+            case 3:
+                return openEnds == 2 ? Engine::SCORE_OPEN_THREE : Engine::SCORE_THREE;
+            case 2:
+                return openEnds == 2 ? Engine::SCORE_OPEN_TWO : Engine::SCORE_TWO;
+            default:
+                return openEnds == 2 ? Engine::SCORE_ONE : 0;
+            }
+        }
+    }
+
+    int Engine::scoreMove(const Board &board, int row, int col, Stone stone)
+    {
+        // 水平、垂直、右下がり対角線、左下がり対角線
+        const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        int size = board.getSize();
+        int score = 0;
+
+        for (int d = 0; d < 4; d++)
+        {
+            int dRow = directions[d][0];
+            int dCol = directions[d][1];
+            int length = 1;
+            int openEnds = 0;
+
+            // 正方向
+            int r = row + dRow;
+            int c = col + dCol;
+            while (r >= 0 && r < size && c >= 0 && c < size && board.getStone(r, c) == stone)
+            {
+                length++;
+                r += dRow;
+                c += dCol;
+            }
+            if (r >= 0 && r < size && c >= 0 && c < size && board.getStone(r, c) == Stone::EMPTY)
+            {
+                openEnds++;
+            }
+
+            // 逆方向
+            r = row - dRow;
+            c = col - dCol;
+            while (r >= 0 && r < size && c >= 0 && c < size && board.getStone(r, c) == stone)
+            {
+                length++;
+                r -= dRow;
+                c -= dCol;
+            }
+            if (r >= 0 && r < size && c >= 0 && c < size && board.getStone(r, c) == Stone::EMPTY)
+            {
+                openEnds++;
+            }
+
+            score += shapeScore(length, openEnds);
+        }
+
+        return score;
+    }
+
+    std::vector<std::pair<int, int>> Engine::candidateMoves(const Board &board, int distance)
+    {
+        int size = board.getSize();
+        std::vector<char> marked(static_cast<size_t>(size) * size, 0);
+        bool hasStone = false;
+
+        // 石の周囲の空きマスに印を付ける
+        for (int row = 0; row < size; row++)
+        {
+            for (int col = 0; col < size; col++)
+            {
+                if (board.getStone(row, col) == Stone::EMPTY)
+                {
+                    continue;
+                }
+                hasStone = true;
+                for (int r = row - distance; r <= row + distance; r++)
+                {
+                    for (int c = col - distance; c <= col + distance; c++)
+                    {
+                        if (r >= 0 && r < size && c >= 0 && c < size)
+                        {
+                            marked[static_cast<size_t>(r) * size + c] = 1;
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<std::pair<int, int>> candidates;
+        if (!hasStone)
+        {
+            candidates.emplace_back(size / 2, size / 2);
+            return candidates;
+        }
+
+        for (int row = 0; row < size; row++)
+        {
+            for (int col = 0; col < size; col++)
+            {
+                if (marked[static_cast<size_t>(row) * size + col] && board.getStone(row, col) == Stone::EMPTY)
+                {
+                    candidates.emplace_back(row, col);
+                }
+            }
+        }
+        return candidates;
+    }
+
+    std::pair<int, int> Engine::chooseMove(const Board &board, Stone player)
+    {
+        Stone opponent = (player == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
+        int size = board.getSize();
+        int center = size / 2;
+
+        std::pair<int, int> best(-1, -1);
+        long long bestScore = -1;
+        int bestDistance = 0;
+
+        for (const auto &move : candidateMoves(board))
+        {
+            // 攻めを少しだけ重く見る（自分の五連 > 相手の五連の阻止 > 自分の四 ...）
+            long long score = 10LL * scoreMove(board, move.first, move.second, player) +
+                              9LL * scoreMove(board, move.first, move.second, opponent);
+            int distance = std::abs(move.first - center) + std::abs(move.second - center);
+
+            // 同点なら中央に近い手を選ぶ
+            if (score > bestScore || (score == bestScore && distance < bestDistance))
+            {
+                best = move;
+                bestScore = score;
+                bestDistance = distance;
+            }
+        }
+
+        // 石の周囲が全て埋まっている場合は残りの空きマスから選ぶ
+        for (int row = 0; row < size && best.first < 0; row++)
+        {
+            for (int col = 0; col < size; col++)
+            {
+                if (board.getStone(row, col) == Stone::EMPTY)
+                {
+                    best = std::make_pair(row, col);
+                    break;
+                }
+            }
+        }
+
+        return best;
+    }
+
+} // namespace GomokuLib
@@ -1,18 +1,105 @@
 #include "GomokuLib/Game.h"
+#include "GomokuLib/GameJournal.h"
+#include "GomokuLib/Instrumentation.h"
+#include "GomokuLib/Tracer.h"
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
+#include <istream>
+#include <ostream>
 #include <stdexcept>
 
 namespace GomokuLib
 {
 
-    Game::Game(int boardSize) : board(boardSize), currentPlayer(Stone::BLACK)
+    Game::Game(int boardSize, const allocator_type &allocator)
+        : board(boardSize, allocator), currentPlayer(Stone::BLACK), winner(Stone::EMPTY), nodes(allocator),
+          freeNodes(allocator), snapshots(allocator), freeSnapshots(allocator), path(allocator), moves(allocator), ply(0)
     {
-        // ゲームの初期化
+        initializeRoot();
+    }
+
+    Game::Game(const Game &other, const allocator_type &allocator)
+        : board(other.board, allocator), currentPlayer(other.currentPlayer), winner(other.winner),
+          nodes(other.nodes, allocator), freeNodes(other.freeNodes, allocator), snapshots(other.snapshots, allocator),
+          freeSnapshots(other.freeSnapshots, allocator), path(other.path, allocator), moves(other.moves, allocator),
+          ply(other.ply), clock(other.clock)
+    {
+    }
+
+    Game::Game(Game &&other, const allocator_type &allocator)
+        : board(std::move(other.board), allocator), currentPlayer(other.currentPlayer), winner(other.winner),
+          nodes(std::move(other.nodes), allocator), freeNodes(std::move(other.freeNodes), allocator),
+          snapshots(std::move(other.snapshots), allocator), freeSnapshots(std::move(other.freeSnapshots), allocator),
+          path(std::move(other.path), allocator), moves(std::move(other.moves), allocator), ply(other.ply),
+          clock(other.clock)
+    {
+    }
+
+    Game::allocator_type Game::getAllocator() const
+    {
+        return nodes.get_allocator();
+    }
+
+    void Game::reset()
+    {
+        reset(board.getSize());
+    }
+
+    void Game::reset(int boardSize)
+    {
+        board.reset(boardSize);
+        currentPlayer = Stone::BLACK;
+        winner = Stone::EMPTY;
+        nodes.clear();
+        freeNodes.clear();
+        snapshots.clear();
+        freeSnapshots.clear();
+        path.clear();
+        moves.clear();
+        ply = 0;
+        clock.reset();
+        initializeRoot();
+        record(JournalOperation::RESET, boardSize);
+    }
+
+    void Game::initializeRoot()
+    {
+        // 根の節点に初期局面を保存する
+        nodes.push_back({std::make_pair(-1, -1), NO_NODE, NO_NODE, NO_NODE, NO_NODE, NO_SNAPSHOT});
+        nodes[ROOT_NODE].snapshot = storeSnapshot();
+        path.push_back(ROOT_NODE);
+    }
+
+    uint32_t Game::storeSnapshot()
+    {
+        size_t bytes = Board::snapshotSize(board.getSize());
+        uint32_t snapshot;
+        if (!freeSnapshots.empty())
+        {
+            snapshot = freeSnapshots.back();
+            freeSnapshots.pop_back();
+        }
+        else
+        {
+            snapshot = static_cast<uint32_t>(snapshots.size() / bytes);
+            snapshots.resize(snapshots.size() + bytes);
+        }
+        board.saveSnapshot(snapshots.data() + snapshot * bytes);
+        return snapshot;
     }
 
     MoveResult Game::playTurn(int row, int col)
     {
-        // ゲーム終了チェック
+        GOMOKU_TRACE_SCOPE("game", "Game::playTurn");
+
+        // ゲーム終了チェック（持ち時間があれば、着手する前に時間切れを確かめる）
+        GameClock::TimePoint now;
+        if (clock.isTimed())
+        {
+            now = GameClock::Clock::now();
+            clock.checkFlag(now);
+        }
         if (isGameOver())
         {
             return MoveResult::GAME_OVER;
@@ -24,15 +111,81 @@ namespace GomokuLib
             return MoveResult::INVALID_MOVE;
         }
 
-        // 着手を記録
-        moves.push_back(std::make_pair(row, col));
+        // 同じ局面から同じ手が打たれたことがあれば、その節点をたどる
+        uint32_t child = findChild(path[ply], row, col);
+        if (child == NO_NODE)
+        {
+            child = allocateNode(path[ply], row, col);
+            if ((ply + 1) % CHECKPOINT_INTERVAL == 0)
+            {
+                nodes[child].snapshot = storeSnapshot();
+            }
+        }
+
+        // 現在の棋譜の次の手と違う場合は、それ以降の棋譜を新しい変化の手順に切り替える
+        if (ply + 1 >= path.size() || path[ply + 1] != child)
+        {
+            rebuildLineFrom(child);
+        }
+        ply++;
+
+        // 勝敗判定（最後の着手を含むラインだけを調べれば十分）
+        if (board.checkWinAt(row, col))
+        {
+            winner = currentPlayer;
+        }
+        else if (board.isFull())
+        {
+            winner = Stone::DRAW;
+        }
+
+        // 時計を押して相手の時計に切り替える（終局したら止める）
+        if (clock.isTimed())
+        {
+            clock.press(currentPlayer, now);
+            if (winner != Stone::EMPTY)
+            {
+                clock.stop(now);
+            }
+        }
 
         // プレイヤー交代
         currentPlayer = (currentPlayer == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
 
+        GOMOKU_COUNT(MOVES_APPLIED, 1);
+        record(JournalOperation::PLAY, row, col);
         return MoveResult::SUCCESS;
     }
 
+    void Game::setTimeControl(const TimeControl &control)
+    {
+        clock = GameClock(control);
+    }
+
+    const GameClock &Game::getClock() const
+    {
+        return clock;
+    }
+
+    GameClock &Game::getClock()
+    {
+        return clock;
+    }
+
+    void Game::startClock()
+    {
+        if (!isGameOver())
+        {
+            clock.start(currentPlayer);
+        }
+    }
+
+    bool Game::checkTime()
+    {
+        clock.checkFlag();
+        return clock.getFlagged() != Stone::EMPTY;
+    }
+
     Stone Game::getCurrentPlayer() const
     {
         return currentPlayer;
@@ -45,42 +198,365 @@ namespace GomokuLib
 
     bool Game::isGameOver() const
     {
-        return board.checkWinner() != Stone::EMPTY || board.isFull();
+        return winner != Stone::EMPTY || clock.getFlagged() != Stone::EMPTY;
     }
 
     Stone Game::getWinner() const
     {
-        return board.checkWinner();
+        Stone flagged = clock.getFlagged();
+        if (winner == Stone::EMPTY && flagged != Stone::EMPTY)
+        {
+            return (flagged == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
+        }
+        return winner;
     }
 
     std::vector<std::pair<int, int>> Game::getMoves() const
     {
-        return moves;
+        return std::vector<std::pair<int, int>>(moves.begin(), moves.begin() + ply);
+    }
+
+    MoveSpan Game::getMoveView() const
+    {
+        return MoveSpan(moves.data(), ply);
+    }
+
+    MoveSpan Game::getLineView() const
+    {
+        return MoveSpan(moves.data(), moves.size());
+    }
+
+    size_t Game::getPly() const
+    {
+        return ply;
     }
 
     bool Game::undoMove()
+    {
+        if (!stepBack())
+        {
+            return false;
+        }
+        record(JournalOperation::UNDO);
+        return true;
+    }
+
+    bool Game::stepBack()
     {
         // 着手がない場合
-        if (moves.empty())
+        if (ply == 0)
         {
             return false;
         }
 
-        // 最後の着手を取得して削除
-        auto lastMove = moves.back();
-        moves.pop_back();
+        // 最後の着手を取得（棋譜には残しておく）
+        ply--;
+        auto lastMove = moves[ply];
 
         // 盤面から石を取り除く
         int row = lastMove.first;
         int col = lastMove.second;
         board.placeStone(row, col, Stone::EMPTY);
 
-        // プレイヤーを前の手番に戻す
+        // 終局後の手は最後の着手だけなので、戻せば必ず対局中に戻る
+        winner = Stone::EMPTY;
+
+        // プレイヤーを前の手番に戻す（動いている時計も戻した側に切り替える）
         currentPlayer = (currentPlayer == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
+        if (clock.isRunning())
+        {
+            clock.start(currentPlayer);
+        }
+
+        return true;
+    }
+
+    bool Game::redoMove()
+    {
+        if (ply >= moves.size() || !moveTo(ply + 1))
+        {
+            return false;
+        }
+        record(JournalOperation::REDO);
+        return true;
+    }
+
+    bool Game::jumpTo(size_t targetPly)
+    {
+        if (!moveTo(targetPly))
+        {
+            return false;
+        }
+        record(JournalOperation::JUMP, static_cast<int>(targetPly));
+        return true;
+    }
+
+    bool Game::moveTo(size_t targetPly)
+    {
+        if (targetPly > moves.size())
+        {
+            return false;
+        }
+        if (targetPly == ply)
+        {
+            return true;
+        }
+
+        // 今の局面から一手ずつ進める・戻すより、直前の保存点から進めた方が近ければ盤面を復元する
+        size_t checkpoint = targetPly / CHECKPOINT_INTERVAL * CHECKPOINT_INTERVAL;
+        size_t distance = (targetPly > ply) ? targetPly - ply : ply - targetPly;
+        if (targetPly - checkpoint < distance)
+        {
+            size_t bytes = Board::snapshotSize(board.getSize());
+            board.restoreSnapshot(snapshots.data() + nodes[path[checkpoint]].snapshot * bytes);
+            ply = checkpoint;
+        }
+
+        while (ply > targetPly)
+        {
+            ply--;
+            board.placeStone(moves[ply].first, moves[ply].second, Stone::EMPTY);
+        }
+        while (ply < targetPly)
+        {
+            board.placeStone(moves[ply].first, moves[ply].second, stoneForPly(ply));
+            ply++;
+        }
+
+        updateStateAfterJump();
+        return true;
+    }
+
+    std::vector<std::pair<int, int>> Game::getVariations() const
+    {
+        std::vector<std::pair<int, int>> variations;
+        for (uint32_t child = nodes[path[ply]].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+        {
+            variations.push_back(nodes[child].move);
+        }
+        return variations;
+    }
+
+    bool Game::selectVariation(size_t index)
+    {
+        uint32_t child = childAt(path[ply], index);
+        if (child == NO_NODE)
+        {
+            return false;
+        }
+
+        // 盤面は現在の局面のままで、この先の棋譜だけを差し替える
+        if (ply + 1 >= path.size() || path[ply + 1] != child)
+        {
+            rebuildLineFrom(child);
+        }
+        record(JournalOperation::SELECT_VARIATION, static_cast<int>(index));
+        return true;
+    }
+
+    bool Game::pruneVariation(size_t index)
+    {
+        uint32_t child = childAt(path[ply], index);
+        if (child == NO_NODE)
+        {
+            return false;
+        }
 
+        removeChild(child);
+        record(JournalOperation::PRUNE_VARIATION, static_cast<int>(index));
         return true;
     }
 
+    bool Game::takeBackMove()
+    {
+        if (ply == 0)
+        {
+            return false;
+        }
+
+        uint32_t node = path[ply];
+        stepBack();
+        removeChild(node);
+        record(JournalOperation::TAKE_BACK);
+        return true;
+    }
+
+    void Game::setJournal(GameJournal *value)
+    {
+        journal.target = value;
+    }
+
+    GameJournal *Game::getJournal() const
+    {
+        return journal.target;
+    }
+
+    void Game::record(JournalOperation operation, int first, int second)
+    {
+        if (journal.target != nullptr)
+        {
+            journal.target->append(*this, operation, first, second);
+        }
+    }
+
+    size_t Game::getVariationNodeCount() const
+    {
+        // 根は着手ではないので数えない
+        return nodes.size() - freeNodes.size() - 1;
+    }
+
+    Stone Game::stoneForPly(size_t index)
+    {
+        return (index % 2 == 0) ? Stone::BLACK : Stone::WHITE;
+    }
+
+    void Game::updateStateAfterJump()
+    {
+        currentPlayer = stoneForPly(ply);
+
+        // 勝負が付くのは最後の着手だけなので、直前の手を調べれば十分
+        winner = Stone::EMPTY;
+        if (ply > 0 && board.checkWinAt(moves[ply - 1].first, moves[ply - 1].second))
+        {
+            winner = board.getStone(moves[ply - 1].first, moves[ply - 1].second);
+        }
+        else if (board.isFull())
+        {
+            winner = Stone::DRAW;
+        }
+
+        // 動いている時計は移動した局面の手番側に切り替える
+        if (clock.isRunning())
+        {
+            clock.start(currentPlayer);
+        }
+    }
+
+    uint32_t Game::allocateNode(uint32_t parent, int row, int col)
+    {
+        uint32_t node;
+        if (!freeNodes.empty())
+        {
+            node = freeNodes.back();
+            freeNodes.pop_back();
+        }
+        else
+        {
+            node = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+        }
+        nodes[node] = {std::make_pair(row, col), parent, NO_NODE, NO_NODE, NO_NODE, NO_SNAPSHOT};
+
+        // 変化は打たれた順に並べる
+        if (nodes[parent].firstChild == NO_NODE)
+        {
+            nodes[parent].firstChild = node;
+        }
+        else
+        {
+            uint32_t last = nodes[parent].firstChild;
+            while (nodes[last].nextSibling != NO_NODE)
+            {
+                last = nodes[last].nextSibling;
+            }
+            nodes[last].nextSibling = node;
+        }
+        return node;
+    }
+
+    void Game::releaseSubtree(uint32_t node)
+    {
+        // 解放した節点の一覧をそのまま探索の待ち行列に使う（一時的な領域を確保しない）
+        size_t first = freeNodes.size();
+        freeNodes.push_back(node);
+        for (size_t i = first; i < freeNodes.size(); i++)
+        {
+            uint32_t current = freeNodes[i];
+            for (uint32_t child = nodes[current].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+            {
+                freeNodes.push_back(child);
+            }
+            if (nodes[current].snapshot != NO_SNAPSHOT)
+            {
+                freeSnapshots.push_back(nodes[current].snapshot);
+                nodes[current].snapshot = NO_SNAPSHOT;
+            }
+        }
+    }
+
+    void Game::removeChild(uint32_t child)
+    {
+        uint32_t current = nodes[child].parent;
+
+        // 兄弟のつながりから外す
+        if (nodes[current].firstChild == child)
+        {
+            nodes[current].firstChild = nodes[child].nextSibling;
+        }
+        else
+        {
+            uint32_t previous = nodes[current].firstChild;
+            while (nodes[previous].nextSibling != child)
+            {
+                previous = nodes[previous].nextSibling;
+            }
+            nodes[previous].nextSibling = nodes[child].nextSibling;
+        }
+
+        // 現在の棋譜の変化を消した場合は、残った最初の変化に切り替える
+        if (nodes[current].selectedChild == child)
+        {
+            nodes[current].selectedChild = nodes[current].firstChild;
+            path.resize(ply + 1);
+            moves.resize(ply);
+            extendLine();
+        }
+
+        releaseSubtree(child);
+    }
+
+    uint32_t Game::findChild(uint32_t node, int row, int col) const
+    {
+        for (uint32_t child = nodes[node].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+        {
+            if (nodes[child].move.first == row && nodes[child].move.second == col)
+            {
+                return child;
+            }
+        }
+        return NO_NODE;
+    }
+
+    uint32_t Game::childAt(uint32_t node, size_t index) const
+    {
+        uint32_t child = nodes[node].firstChild;
+        for (size_t i = 0; i < index && child != NO_NODE; i++)
+        {
+            child = nodes[child].nextSibling;
+        }
+        return child;
+    }
+
+    void Game::rebuildLineFrom(uint32_t child)
+    {
+        nodes[path[ply]].selectedChild = child;
+        path.resize(ply + 1);
+        moves.resize(ply);
+        path.push_back(child);
+        moves.push_back(nodes[child].move);
+        extendLine();
+    }
+
+    void Game::extendLine()
+    {
+        // 各節点で選ばれている子を葉までたどる
+        for (uint32_t node = nodes[path.back()].selectedChild; node != NO_NODE; node = nodes[node].selectedChild)
+        {
+            path.push_back(node);
+            moves.push_back(nodes[node].move);
+        }
+    }
+
     Game Game::loadGame(const std::string &filepath)
     {
         std::ifstream file(filepath);
@@ -88,24 +564,78 @@ namespace GomokuLib
         {
             throw std::runtime_error("Failed to open file: " + filepath);
         }
+        return loadGame(file);
+    }
 
+    Game Game::loadGame(std::istream &file)
+    {
+        GOMOKU_TIMED_SCOPE("game.load");
+        GOMOKU_TRACE_SCOPE("io", "Game::loadGame");
         std::string line;
         int boardSize = 0;
         Game game(15); // デフォルトサイズで初期化
 
+        // VARIATIONS: 以降は変化の木（番号は先行順で、0 は初期局面）
+        bool readingVariations = false;
+        size_t savedPly = 0;
+        std::vector<uint32_t> loadedNodes;
+        std::vector<std::pair<uint32_t, uint32_t>> selectedNodes; // (親, 選ばれている子)
+
         while (std::getline(file, line))
         {
+            GOMOKU_COUNT(BYTES_PARSED, line.size() + 1);
+
             // コメント行をスキップ
             if (line.empty() || line[0] == '#')
             {
                 continue;
             }
 
+            if (readingVariations)
+            {
+                // 変化の行: <親の番号> <行>,<列> [*]（* は棋譜で選ばれている子）
+                size_t space = line.find(' ');
+                size_t comma = line.find(',', space);
+                if (space == std::string::npos || comma == std::string::npos)
+                {
+                    throw std::runtime_error("Malformed variation line: " + line);
+                }
+                size_t parentNumber = std::stoul(line.substr(0, space));
+                int row = std::stoi(line.substr(space + 1, comma - space - 1));
+                int col = std::stoi(line.substr(comma + 1));
+                if (parentNumber >= loadedNodes.size())
+                {
+                    throw std::runtime_error("Unknown parent in variation line: " + line);
+                }
+
+                // 先行順なので、親は現在の手順上にある
+                uint32_t parent = loadedNodes[parentNumber];
+                while (game.path[game.ply] != parent && game.undoMove())
+                {
+                }
+                if (game.path[game.ply] != parent || game.playTurn(row, col) != MoveResult::SUCCESS)
+                {
+                    throw std::runtime_error("Invalid variation move: " + line);
+                }
+
+                loadedNodes.push_back(game.path[game.ply]);
+                if (line.find('*', comma) != std::string::npos)
+                {
+                    selectedNodes.emplace_back(parent, game.path[game.ply]);
+                }
+            }
             // 盤面サイズの行
-            if (line.find("SIZE:") == 0)
+            else if (line.find("SIZE:") == 0)
             {
                 boardSize = std::stoi(line.substr(5));
-                game = Game(boardSize);
+                game.reset(boardSize);
+            }
+            // 変化の木の開始
+            else if (line.find("VARIATIONS:") == 0)
+            {
+                readingVariations = true;
+                savedPly = game.ply;
+                loadedNodes.push_back(ROOT_NODE);
             }
             // 着手の行
             else if (line.find("MOVES:") != std::string::npos)
@@ -126,30 +656,69 @@ namespace GomokuLib
 
                     Stone stone = (stoneChar == 'B') ? Stone::BLACK : Stone::WHITE;
 
-                    // ゲーム状態を進めるため、currentPlayerを正しい色に設定
-                    game.currentPlayer = stone;
+                    // 石の色は手数から決まる（goto や打ち直しも手数で色を決めるので、交互でない棋譜は受け付けない）
+                    if (stone != stoneForPly(game.ply))
+                    {
+                        throw std::runtime_error("Move out of turn: " + line);
+                    }
                     game.playTurn(row, col);
                 }
             }
         }
 
+        // 変化を読み込んだ場合は、保存されていた手順を選び直して元の局面に戻る
+        if (readingVariations)
+        {
+            for (const auto &selected : selectedNodes)
+            {
+                game.nodes[selected.first].selectedChild = selected.second;
+            }
+            game.jumpTo(0);
+            game.path.resize(1);
+            game.moves.clear();
+            game.extendLine();
+            game.jumpTo(std::min(savedPly, game.moves.size()));
+        }
+
         return game;
     }
 
     void Game::saveGame(const std::string &filepath) const
     {
-        std::ofstream file(filepath);
-        if (!file.is_open())
+        // 書き終えてから置き換えるので、書いている途中で落ちても元のファイルは残る
+        std::string temporary = filepath + ".tmp";
+        {
+            std::ofstream file(temporary);
+            if (!file.is_open())
+            {
+                throw std::runtime_error("Failed to open file for writing: " + filepath);
+            }
+            saveGame(file);
+            file.close();
+            if (!file)
+            {
+                std::remove(temporary.c_str());
+                throw std::runtime_error("Failed to write file: " + filepath);
+            }
+        }
+        if (std::rename(temporary.c_str(), filepath.c_str()) != 0)
         {
-            throw std::runtime_error("Failed to open file for writing: " + filepath);
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Failed to replace file: " + filepath);
         }
+    }
+
+    void Game::saveGame(std::ostream &file) const
+    {
+        GOMOKU_TIMED_SCOPE("game.save");
+        GOMOKU_TRACE_SCOPE("io", "Game::saveGame");
 
         // 盤面サイズを書き出す
         file << "SIZE: " << board.getSize() << std::endl;
         file << "MOVES:" << std::endl;
 
         Stone currentStone = Stone::BLACK; // 最初は黒から
-        for (const auto &move : moves)
+        for (const auto &move : getMoveView())
         {
             char stoneChar = (currentStone == Stone::BLACK) ? 'B' : 'W';
             file << move.first << "," << move.second << "," << stoneChar << std::endl;
@@ -158,7 +727,41 @@ namespace GomokuLib
             currentStone = (currentStone == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
         }
 
-        file.close();
+        // 戻した手や別の変化がある場合は、木全体を先行順で書き出す
+        if (getVariationNodeCount() > ply)
+        {
+            file << "VARIATIONS:" << std::endl;
+
+            std::vector<uint32_t> numbers(nodes.size(), 0);
+            uint32_t nextNumber = 1;
+            std::vector<uint32_t> pending;
+            std::vector<uint32_t> children;
+            pending.push_back(ROOT_NODE);
+            while (!pending.empty())
+            {
+                uint32_t node = pending.back();
+                pending.pop_back();
+                if (node != ROOT_NODE)
+                {
+                    const VariationNode &current = nodes[node];
+                    numbers[node] = nextNumber++;
+                    file << numbers[current.parent] << " " << current.move.first << "," << current.move.second;
+                    if (nodes[current.parent].selectedChild == node)
+                    {
+                        file << " *";
+                    }
+                    file << "\n";
+                }
+
+                // 子は打たれた順に書き出したいので、逆順に積む
+                children.clear();
+                for (uint32_t child = nodes[node].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+                {
+                    children.push_back(child);
+                }
+                pending.insert(pending.end(), children.rbegin(), children.rend());
+            }
+        }
     }
 
 } // namespace GomokuLib
@@ -0,0 +1,216 @@
+#include "GomokuLib/GameAnalyzer.h"
+#include "GomokuLib/Instrumentation.h"
+#include "GomokuLib/ThreadPool.h"
+#include "GomokuLib/Tracer.h"
+#include "GomokuLib/TranspositionTable.h"
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // 手数 index の局面の手番（黒から交互）
+        Stone playerAt(size_t index)
+        {
+            return (index % 2 == 0) ? Stone::BLACK : Stone::WHITE;
+        }
+
+        bool isWinFor(int score)
+        {
+            return score > 0 && Search::isWinScore(score);
+        }
+
+        // 1つの局面の深さごとの評価値（手番側から見た値）
+        struct PositionScores
+        {
+            SearchResult result;
+            std::vector<int> byDepth; // byDepth[d - 1] が深さ d の評価値
+            bool terminal = false;    // 終局した局面（評価値は深さによらない）
+
+            // 評価値を比べられる最大の深さ（勝ち負けを読み切った後はそれ以上深くても同じ値）
+            int availableDepth() const
+            {
+                if (byDepth.empty())
+                    return 0;
+                if (terminal || Search::isWinScore(byDepth.back()))
+                    return std::numeric_limits<int>::max() - 1;
+                return static_cast<int>(byDepth.size());
+            }
+
+            // 深さ depth の評価値（1 <= depth <= availableDepth）
+            int at(int depth) const
+            {
+                size_t index = std::min(static_cast<size_t>(depth), byDepth.size()) - 1;
+                return byDepth[index];
+            }
+        };
+    }
+
+    GameAnalysis GameAnalyzer::analyze(int boardSize, MoveSpan moves, const GameAnalysisOptions &options,
+                                       const CancellationToken &token, const ProgressCallback &onProgress)
+    {
+        GOMOKU_TIMED_SCOPE("analysis.game");
+        GOMOKU_TRACE_SCOPE("analysis", "GameAnalyzer::analyze");
+
+        // 各局面を作っておく（タスクはそれぞれ自分の局面をコピーして読む）
+        // 局面は対局の長さだけまとめて確保し、解析が終わったら一度に解放する
+        std::pmr::monotonic_buffer_resource arena;
+        std::pmr::vector<Board> positions(&arena);
+        std::vector<bool> terminal;
+        positions.reserve(moves.size() + 1);
+        terminal.reserve(moves.size() + 1);
+
+        Board board(boardSize);
+        positions.push_back(board);
+        terminal.push_back(false);
+        for (size_t i = 0; i < moves.size(); i++)
+        {
+            const auto &move = moves[i];
+            if (terminal.back() || !board.placeStone(move.first, move.second, playerAt(i)))
+            {
+                throw std::runtime_error("Invalid move in game record at move " + std::to_string(i + 1));
+            }
+            positions.push_back(board);
+            terminal.push_back(board.checkWinAt(move.first, move.second) || board.isFull());
+        }
+
+        // 深さ1から読み終えた深さまでの評価値を全て残す
+        // 着手の前後の局面は、同じ深さの読みとして比べるために前の局面を1手深く読んだ値と比べる
+        // （同じ深さどうしで比べると末端の手番が入れ替わり、評価値が偏る）
+        SearchLimits limits = options.limits;
+        limits.maxDepth = std::max(limits.maxDepth, 2);
+
+        const size_t total = positions.size();
+        std::vector<PositionScores> scores(total);
+        std::atomic<size_t> done(0);
+        {
+            TranspositionTable table(boardSize, options.tableEntries);
+            ThreadPool pool(options.threadCount);
+
+            std::vector<std::future<void>> futures;
+            futures.reserve(total);
+            for (size_t i = 0; i < total; i++)
+            {
+                if (terminal[i])
+                {
+                    // 終局した局面は読まずに評価する（直前の手で五連ができていれば手番側の負け）
+                    const auto &last = moves[i - 1];
+                    scores[i].terminal = true;
+                    scores[i].byDepth.push_back(positions[i].checkWinAt(last.first, last.second) ? -Search::SCORE_WIN : 0);
+                    continue;
+                }
+                futures.push_back(pool.submit([&, i]()
+                                              {
+                    GOMOKU_TRACE_SCOPE("analysis", "analysis.position", "ply", static_cast<int64_t>(i));
+                    PositionScores &entry = scores[i];
+                    if (!token.isCancelled())
+                    {
+                        entry.result = Search::run(positions[i], playerAt(i), limits, token,
+                                                   [&entry](const SearchResult &partial)
+                                                   { entry.byDepth.push_back(partial.score); },
+                                                   &table);
+                    }
+                    if (onProgress)
+                    {
+                        onProgress(++done, total);
+                    }
+                }));
+            }
+
+            for (auto &future : futures)
+            {
+                future.get();
+            }
+        }
+
+        GameAnalysis analysis;
+        analysis.boardSize = boardSize;
+        analysis.evaluations.resize(total);
+        analysis.depths.resize(total);
+
+        for (size_t i = 0; i < total; i++)
+        {
+            const PositionScores &entry = scores[i];
+            int depth = std::min(entry.availableDepth(), limits.maxDepth);
+            analysis.depths[i] = entry.terminal ? 0 : static_cast<int>(entry.byDepth.size());
+            analysis.nodes += entry.result.nodes;
+
+            // 奇数と偶数の深さの偏りを打ち消すため、最後の2つの深さの平均を使う
+            int score = 0;
+            if (depth >= 2 && !Search::isWinScore(entry.at(depth)) && !Search::isWinScore(entry.at(depth - 1)))
+            {
+                score = static_cast<int>((static_cast<long long>(entry.at(depth)) + entry.at(depth - 1)) / 2);
+            }
+            else if (depth >= 1)
+            {
+                score = entry.at(depth);
+            }
+            analysis.evaluations[i] = (playerAt(i) == Stone::BLACK) ? score : -score;
+        }
+
+        for (size_t i = 0; i < moves.size(); i++)
+        {
+            MoveAnalysis entry;
+            entry.ply = static_cast<int>(i + 1);
+            entry.player = playerAt(i);
+            entry.move = moves[i];
+            entry.bestMove = scores[i].result.bestMove;
+
+            // 着手前の局面を depth、着手後の局面を depth - 1 で読んだ値を比べる
+            int depth = std::min({scores[i].availableDepth(), scores[i + 1].availableDepth() + 1, limits.maxDepth});
+            if (depth < 2)
+            {
+                // 読めなかった局面の前後は判定しない
+                analysis.moves.push_back(entry);
+                continue;
+            }
+
+            entry.scoreBefore = scores[i].at(depth);
+            entry.scoreAfter = -scores[i + 1].at(depth - 1);
+            entry.loss = std::max(0LL, static_cast<long long>(entry.scoreBefore) - entry.scoreAfter);
+
+            // 最善手どおりに打った手は判定しない
+            if (entry.move != entry.bestMove)
+            {
+                if (isWinFor(entry.scoreBefore) && !isWinFor(entry.scoreAfter))
+                {
+                    entry.judgement = MoveJudgement::MISSED_WIN;
+                }
+                else if (entry.loss >= options.blunderThreshold)
+                {
+                    entry.judgement = MoveJudgement::BLUNDER;
+                }
+            }
+            analysis.moves.push_back(entry);
+        }
+
+        analysis.completed = !token.isCancelled();
+        return analysis;
+    }
+
+    GameAnalysis GameAnalyzer::analyze(const Game &game, const GameAnalysisOptions &options,
+                                       const CancellationToken &token, const ProgressCallback &onProgress)
+    {
+        return analyze(game.getBoard().getSize(), game.getMoveView(), options, token, onProgress);
+    }
+
+    const char *GameAnalyzer::judgementToString(MoveJudgement judgement)
+    {
+        switch (judgement)
+        {
+        case MoveJudgement::BLUNDER:
+            return "blunder";
+        case MoveJudgement::MISSED_WIN:
+            return "missed-win";
+        default:
+            return "none";
+        }
+    }
+
+} // namespace GomokuLib
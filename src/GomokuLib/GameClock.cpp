@@ -0,0 +1,146 @@
+#include "GomokuLib/GameClock.h"
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        int64_t elapsedMs(GameClock::TimePoint from, GameClock::TimePoint to)
+        {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+        }
+
+        Stone opponentOf(Stone player)
+        {
+            return (player == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
+        }
+    }
+
+    GameClock::GameClock() : GameClock(TimeControl())
+    {
+    }
+
+    GameClock::GameClock(const TimeControl &control) : control(control)
+    {
+        reset();
+    }
+
+    const TimeControl &GameClock::getControl() const
+    {
+        return control;
+    }
+
+    bool GameClock::isTimed() const
+    {
+        return control.isTimed();
+    }
+
+    void GameClock::reset()
+    {
+        remaining[0] = control.initialMs;
+        remaining[1] = control.initialMs;
+        running = Stone::EMPTY;
+        turnStart = TimePoint();
+        flagged = Stone::EMPTY;
+    }
+
+    void GameClock::chargeRunning(TimePoint now)
+    {
+        if (running != Stone::EMPTY)
+        {
+            remaining[indexOf(running)] -= elapsedMs(turnStart, now);
+            running = Stone::EMPTY;
+        }
+    }
+
+    void GameClock::start(Stone player, TimePoint now)
+    {
+        if (!isTimed())
+        {
+            return;
+        }
+        chargeRunning(now);
+        running = player;
+        turnStart = now;
+    }
+
+    void GameClock::stop(TimePoint now)
+    {
+        chargeRunning(now);
+    }
+
+    bool GameClock::press(Stone player, TimePoint now)
+    {
+        if (!isTimed())
+        {
+            return true;
+        }
+
+        // 止まっていた時計で指した手は時間を使っていない
+        int64_t used = (running == player) ? elapsedMs(turnStart, now) : 0;
+        chargeRunning(now);
+        if (remaining[indexOf(player)] < 0 || (control.maxMoveMs > 0 && used > control.maxMoveMs))
+        {
+            flagged = player;
+            return false;
+        }
+
+        remaining[indexOf(player)] += control.incrementMs;
+        running = opponentOf(player);
+        turnStart = now;
+        return true;
+    }
+
+    int64_t GameClock::getRemaining(Stone player, TimePoint now) const
+    {
+        int64_t value = remaining[indexOf(player)];
+        if (running == player)
+        {
+            value -= elapsedMs(turnStart, now);
+        }
+        return value;
+    }
+
+    int64_t GameClock::getElapsed(TimePoint now) const
+    {
+        return (running == Stone::EMPTY) ? 0 : elapsedMs(turnStart, now);
+    }
+
+    Stone GameClock::checkFlag(TimePoint now)
+    {
+        if (flagged == Stone::EMPTY && running != Stone::EMPTY)
+        {
+            int64_t used = elapsedMs(turnStart, now);
+            if (used > remaining[indexOf(running)] || (control.maxMoveMs > 0 && used > control.maxMoveMs))
+            {
+                flagged = running;
+            }
+        }
+        return flagged;
+    }
+
+    void GameClock::setRemaining(Stone player, int64_t milliseconds, TimePoint now)
+    {
+        remaining[indexOf(player)] = milliseconds;
+        if (running == player)
+        {
+            turnStart = now;
+        }
+    }
+
+    bool GameClock::isRunning() const
+    {
+        return running != Stone::EMPTY;
+    }
+
+    Stone GameClock::getRunning() const
+    {
+        return running;
+    }
+
+    Stone GameClock::getFlagged() const
+    {
+        return flagged;
+    }
+
+} // namespace GomokuLib
@@ -0,0 +1,490 @@
+#include "GomokuLib/GameJournal.h"
+#include "GomokuLib/Instrumentation.h"
+#include "GomokuLib/Tracer.h"
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        constexpr char MAGIC[8] = {'G', 'M', 'K', 'J', 'R', 'N', 'L', '1'};
+
+        // 棋譜全体のファイルの先頭に書く世代の行（loadGame はコメントとして読み飛ばす）
+        const std::string GENERATION_PREFIX = "# JOURNAL ";
+
+        void storeU16(uint8_t *destination, uint16_t value)
+        {
+            destination[0] = static_cast<uint8_t>(value);
+            destination[1] = static_cast<uint8_t>(value >> 8);
+        }
+
+        uint16_t loadU16(const uint8_t *source)
+        {
+            return static_cast<uint16_t>(source[0] | (source[1] << 8));
+        }
+
+        void storeU64(uint8_t *destination, uint64_t value)
+        {
+            for (int i = 0; i < 8; i++)
+            {
+                destination[i] = static_cast<uint8_t>(value >> (8 * i));
+            }
+        }
+
+        uint64_t loadU64(const uint8_t *source)
+        {
+            uint64_t value = 0;
+            for (int i = 0; i < 8; i++)
+            {
+                value |= static_cast<uint64_t>(source[i]) << (8 * i);
+            }
+            return value;
+        }
+
+        // レコードの先頭 6 バイトの FNV-1a（書きかけや未書き込みの領域を見分ける）
+        uint16_t checksum(const uint8_t *record)
+        {
+            uint32_t hash = 2166136261u;
+            for (int i = 0; i < 6; i++)
+            {
+                hash = (hash ^ record[i]) * 16777619u;
+            }
+            return static_cast<uint16_t>(hash ^ (hash >> 16));
+        }
+
+        void writeAll(int fd, const uint8_t *data, size_t size, const std::string &filepath)
+        {
+            size_t written = 0;
+            while (written < size)
+            {
+                ssize_t n = ::write(fd, data + written, size - written);
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n <= 0)
+                {
+                    throw std::runtime_error("Failed to write game journal: " + filepath);
+                }
+                written += static_cast<size_t>(n);
+            }
+        }
+
+        // ファイルまたはディレクトリの内容をディスクに書き込む
+        void syncPath(const std::string &path, bool directory)
+        {
+            int descriptor = ::open(path.c_str(), (directory ? O_RDONLY | O_DIRECTORY : O_RDONLY) | O_CLOEXEC);
+            if (descriptor < 0)
+            {
+                throw std::runtime_error("Failed to open for sync: " + path);
+            }
+            int result = ::fsync(descriptor);
+            ::close(descriptor);
+            if (result != 0)
+            {
+                throw std::runtime_error("Failed to sync: " + path);
+            }
+        }
+
+        std::string parentDirectory(const std::string &path)
+        {
+            std::string parent = std::filesystem::path(path).parent_path().string();
+            return parent.empty() ? "." : parent;
+        }
+
+        // 呼び出し側の持ち時間と残り時間を、復元した対局に引き継ぐ
+        void restoreClock(Game &game, const GameClock &clock)
+        {
+            if (!clock.isTimed())
+            {
+                return;
+            }
+            auto now = GameClock::Clock::now();
+            game.setTimeControl(clock.getControl());
+            game.getClock().setRemaining(Stone::BLACK, clock.getRemaining(Stone::BLACK, now), now);
+            game.getClock().setRemaining(Stone::WHITE, clock.getRemaining(Stone::WHITE, now), now);
+            if (clock.isRunning())
+            {
+                game.startClock();
+            }
+        }
+    }
+
+    GameJournal::GameJournal(const std::string &filepath, const GameJournalOptions &options)
+        : snapshotPath(filepath), journalPath(filepath + ".journal"), options(options), fd(-1), waiters(0),
+          stopping(false), syncError(0)
+    {
+        if (options.syncIntervalMs < 1)
+        {
+            throw std::runtime_error("Journal sync interval must be positive");
+        }
+    }
+
+    GameJournal::~GameJournal()
+    {
+        if (syncer.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            syncer.join();
+        }
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+
+    Game GameJournal::open(const Game &initial)
+    {
+        GOMOKU_TIMED_SCOPE("journal.open");
+        GOMOKU_TRACE_SCOPE("io", "GameJournal::open");
+        if (fd >= 0)
+        {
+            throw std::runtime_error("Game journal is already open: " + snapshotPath);
+        }
+
+        // 棋譜全体（最初の行に世代がある。なければ世代 0 の普通の棋譜として扱う）
+        bool hasSnapshot = std::filesystem::exists(snapshotPath);
+        uint64_t generation = 0;
+        Game game = initial;
+        // 時計を外して再生する（時計があると、再生する着手ごとに時計を押して増分を加えてしまう）
+        game.setTimeControl(TimeControl());
+        if (hasSnapshot)
+        {
+            std::ifstream file(snapshotPath);
+            if (!file.is_open())
+            {
+                throw std::runtime_error("Failed to open file: " + snapshotPath);
+            }
+            std::string line;
+            if (std::getline(file, line) && line.compare(0, GENERATION_PREFIX.size(), GENERATION_PREFIX) == 0)
+            {
+                generation = std::stoull(line.substr(GENERATION_PREFIX.size()));
+            }
+            file.clear();
+            file.seekg(0);
+            game = Game::loadGame(file);
+        }
+
+        fd = ::open(journalPath.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Failed to open game journal: " + journalPath);
+        }
+
+        // 復元に失敗した場合は開いていない状態に戻す
+        uint64_t replayed = 0;
+        uint64_t discarded = 0;
+        try
+        {
+            std::vector<uint8_t> contents;
+            uint8_t chunk[4096];
+            while (true)
+            {
+                ssize_t n = ::read(fd, chunk, sizeof(chunk));
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n < 0)
+                {
+                    throw std::runtime_error("Failed to read game journal: " + journalPath);
+                }
+                if (n == 0)
+                {
+                    break;
+                }
+                contents.insert(contents.end(), chunk, chunk + n);
+            }
+
+            bool valid = contents.size() >= HEADER_SIZE && std::memcmp(contents.data(), MAGIC, sizeof(MAGIC)) == 0;
+            uint64_t journalGeneration = valid ? loadU64(contents.data() + sizeof(MAGIC)) : 0;
+            if (valid && journalGeneration > generation)
+            {
+                throw std::runtime_error("Game journal is newer than its snapshot: " + journalPath);
+            }
+
+            if (valid && journalGeneration == generation)
+            {
+                if (!hasSnapshot && contents.size() > HEADER_SIZE)
+                {
+                    throw std::runtime_error("Game journal has no snapshot: " + snapshotPath);
+                }
+
+                // 壊れていない記録を順に再生する（最初に壊れている記録から後ろは書きかけとして捨てる）
+                size_t offset = HEADER_SIZE;
+                JournalOperation operation;
+                int first;
+                int second;
+                while (offset + RECORD_SIZE <= contents.size() &&
+                       decode(contents.data() + offset, operation, first, second))
+                {
+                    if (!apply(game, operation, first, second))
+                    {
+                        throw std::runtime_error("Game journal contains an invalid operation: " + journalPath);
+                    }
+                    offset += RECORD_SIZE;
+                    replayed++;
+                }
+                discarded = contents.size() - offset;
+                if (discarded > 0 && ::ftruncate(fd, static_cast<off_t>(offset)) != 0)
+                {
+                    throw std::runtime_error("Failed to truncate game journal: " + journalPath);
+                }
+            }
+            else
+            {
+                // 記録がない・ヘッダが書きかけ・棋譜全体を書き出した後で空にする前に止まった場合は、記録を作り直す
+                resetJournal(generation);
+            }
+
+            if (!hasSnapshot)
+            {
+                writeSnapshot(game, generation);
+            }
+        }
+        catch (...)
+        {
+            ::close(fd);
+            fd = -1;
+            throw;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.generation = generation;
+            stats.recordsSinceSnapshot = replayed;
+            stats.replayed = replayed;
+            stats.discardedBytes = discarded;
+        }
+        syncer = std::thread(&GameJournal::syncLoop, this);
+        restoreClock(game, initial.getClock());
+        return game;
+    }
+
+    void GameJournal::resetJournal(uint64_t generation)
+    {
+        uint8_t header[HEADER_SIZE];
+        std::memcpy(header, MAGIC, sizeof(MAGIC));
+        storeU64(header + sizeof(MAGIC), generation);
+        if (::ftruncate(fd, 0) != 0)
+        {
+            throw std::runtime_error("Failed to truncate game journal: " + journalPath);
+        }
+        writeAll(fd, header, sizeof(header), journalPath);
+        if (::fdatasync(fd) != 0)
+        {
+            throw std::runtime_error("Failed to sync game journal: " + journalPath);
+        }
+    }
+
+    void GameJournal::writeSnapshot(const Game &game, uint64_t generation) const
+    {
+        std::string temporary = snapshotPath + ".tmp";
+        {
+            std::ofstream file(temporary);
+            if (!file.is_open())
+            {
+                throw std::runtime_error("Failed to open file for writing: " + temporary);
+            }
+            file << GENERATION_PREFIX << generation << "\n";
+            game.saveGame(file);
+            file.close();
+            if (!file)
+            {
+                throw std::runtime_error("Failed to write file: " + temporary);
+            }
+        }
+        syncPath(temporary, false);
+        if (std::rename(temporary.c_str(), snapshotPath.c_str()) != 0)
+        {
+            throw std::runtime_error("Failed to replace file: " + snapshotPath);
+        }
+        syncPath(parentDirectory(snapshotPath), true);
+    }
+
+    void GameJournal::append(const Game &game, JournalOperation operation, int first, int second)
+    {
+        if (fd < 0)
+        {
+            throw std::runtime_error("Game journal is not open: " + snapshotPath);
+        }
+
+        uint8_t record[RECORD_SIZE];
+        encode(operation, first, second, record);
+        writeAll(fd, record, sizeof(record), journalPath);
+
+        bool compactNow;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.appended++;
+            stats.recordsSinceSnapshot++;
+            compactNow = options.compactionRecords > 0 && stats.recordsSinceSnapshot >= options.compactionRecords;
+        }
+        if (compactNow)
+        {
+            compact(game);
+        }
+    }
+
+    void GameJournal::compact(const Game &game)
+    {
+        GOMOKU_TIMED_SCOPE("journal.compact");
+        GOMOKU_TRACE_SCOPE("io", "GameJournal::compact");
+        if (fd < 0)
+        {
+            throw std::runtime_error("Game journal is not open: " + snapshotPath);
+        }
+
+        // 新しい世代の棋譜全体を置き換えてから記録を空にする
+        // その間に落ちた場合は、古い世代の記録が残るが、復元のときに世代が合わないので再生しない
+        uint64_t generation;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            generation = stats.generation + 1;
+        }
+        writeSnapshot(game, generation);
+        resetJournal(generation);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.generation = generation;
+            stats.compactions++;
+            stats.recordsSinceSnapshot = 0;
+            stats.durable = stats.appended;
+        }
+        synced.notify_all();
+    }
+
+    void GameJournal::syncLoop()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            wake.wait_for(lock, std::chrono::milliseconds(options.syncIntervalMs),
+                          [this]()
+                          { return stopping || (waiters > 0 && stats.durable < stats.appended); });
+
+            if (stats.durable >= stats.appended)
+            {
+                if (stopping)
+                {
+                    return;
+                }
+                continue;
+            }
+
+            // 同期している間に追記された操作は次の同期に回す
+            uint64_t target = stats.appended;
+            lock.unlock();
+            int result = ::fdatasync(fd);
+            int error = (result == 0) ? 0 : errno;
+            lock.lock();
+
+            stats.syncs++;
+            syncError = error;
+            if (error == 0 && target > stats.durable)
+            {
+                stats.durable = target;
+            }
+            synced.notify_all();
+            if (stopping && (error != 0 || stats.durable >= stats.appended))
+            {
+                return;
+            }
+        }
+    }
+
+    void GameJournal::sync()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!syncer.joinable())
+        {
+            throw std::runtime_error("Game journal is not open: " + snapshotPath);
+        }
+
+        uint64_t target = stats.appended;
+        uint64_t syncs = stats.syncs;
+        waiters++;
+        wake.notify_one();
+        synced.wait(lock, [this, target, syncs]()
+                    { return stats.durable >= target || (syncError != 0 && stats.syncs != syncs); });
+        waiters--;
+        if (stats.durable < target)
+        {
+            throw std::runtime_error("Failed to sync game journal: " + journalPath + ": " + std::strerror(syncError));
+        }
+    }
+
+    GameJournalStats GameJournal::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+    void GameJournal::encode(JournalOperation operation, int first, int second, uint8_t *record)
+    {
+        record[0] = static_cast<uint8_t>(operation);
+        record[1] = 0;
+        storeU16(record + 2, static_cast<uint16_t>(first));
+        storeU16(record + 4, static_cast<uint16_t>(second));
+        storeU16(record + 6, checksum(record));
+    }
+
+    bool GameJournal::decode(const uint8_t *record, JournalOperation &operation, int &first, int &second)
+    {
+        if (record[0] < static_cast<uint8_t>(JournalOperation::PLAY) ||
+            record[0] > static_cast<uint8_t>(JournalOperation::RESET) || record[1] != 0 ||
+            loadU16(record + 6) != checksum(record))
+        {
+            return false;
+        }
+        operation = static_cast<JournalOperation>(record[0]);
+        first = loadU16(record + 2);
+        second = loadU16(record + 4);
+        return true;
+    }
+
+    bool GameJournal::apply(Game &game, JournalOperation operation, int first, int second)
+    {
+        switch (operation)
+        {
+        case JournalOperation::PLAY:
+            return game.playTurn(first, second) == MoveResult::SUCCESS;
+        case JournalOperation::UNDO:
+            return game.undoMove();
+        case JournalOperation::TAKE_BACK:
+            return game.takeBackMove();
+        case JournalOperation::REDO:
+            return game.redoMove();
+        case JournalOperation::JUMP:
+            return game.jumpTo(static_cast<size_t>(first));
+        case JournalOperation::SELECT_VARIATION:
+            return game.selectVariation(static_cast<size_t>(first));
+        case JournalOperation::PRUNE_VARIATION:
+            return game.pruneVariation(static_cast<size_t>(first));
+        case JournalOperation::RESET:
+            if (first < 1)
+            {
+                return false;
+            }
+            game.reset(first);
+            return true;
+        }
+        return false;
+    }
+
+} // namespace GomokuLib
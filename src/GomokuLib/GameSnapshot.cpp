@@ -0,0 +1,144 @@
+#include "GomokuLib/GameSnapshot.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // 対局の状態を書き写す（再利用した状態の領域をそのまま使う）
+        void fillSnapshot(const Game &game, uint64_t version, GameSnapshot &snapshot)
+        {
+            const Board &board = game.getBoard();
+            int size = board.getSize();
+            snapshot.version = version;
+            snapshot.boardSize = size;
+            snapshot.currentPlayer = game.getCurrentPlayer();
+            snapshot.winner = game.isGameOver() ? game.getWinner() : Stone::EMPTY;
+            snapshot.cells.resize(static_cast<size_t>(size) * size);
+            for (int row = 0; row < size; row++)
+            {
+                for (int col = 0; col < size; col++)
+                {
+                    snapshot.cells[static_cast<size_t>(row) * size + col] = board.getStone(row, col);
+                }
+            }
+            MoveSpan moves = game.getMoveView();
+            snapshot.moves.assign(moves.begin(), moves.end());
+        }
+    }
+
+    SnapshotPublisher::SnapshotPublisher(const Game &game, size_t maxReaders)
+        : slots(std::make_unique<ReaderSlot[]>(maxReaders)), slotCount(maxReaders), globalEpoch(0), current(nullptr),
+          publishedVersion(0), nextVersion(1)
+    {
+        auto *snapshot = new GameSnapshot();
+        fillSnapshot(game, nextVersion++, *snapshot);
+        current.store(snapshot);
+        publishedVersion.store(snapshot->version);
+    }
+
+    SnapshotPublisher::~SnapshotPublisher()
+    {
+        delete current.load();
+        for (const Retired &entry : retired)
+        {
+            delete entry.snapshot;
+        }
+        for (GameSnapshot *snapshot : pool)
+        {
+            delete snapshot;
+        }
+    }
+
+    void SnapshotPublisher::publish(const Game &game)
+    {
+        GameSnapshot *snapshot;
+        if (!pool.empty())
+        {
+            snapshot = pool.back();
+            pool.pop_back();
+        }
+        else
+        {
+            snapshot = new GameSnapshot();
+        }
+        fillSnapshot(game, nextVersion++, *snapshot);
+
+        // 差し替えてからエポックを進める。差し替える前にポインタを読んだ観戦者は、進める前のエポックで読んでいる
+        const GameSnapshot *previous = current.exchange(snapshot);
+        publishedVersion.store(snapshot->version, std::memory_order_release);
+        uint64_t epoch = globalEpoch.fetch_add(1);
+        retired.push_back({const_cast<GameSnapshot *>(previous), epoch});
+        reclaim();
+    }
+
+    void SnapshotPublisher::reclaim()
+    {
+        // 読んでいる観戦者のうち、最も古いエポック
+        uint64_t oldest = IDLE;
+        for (size_t i = 0; i < slotCount; i++)
+        {
+            oldest = std::min(oldest, slots[i].epoch.load());
+        }
+
+        // 差し替えたときのエポックより後から読み始めた観戦者しかいなければ、誰もその状態を持っていない
+        auto reusable = std::stable_partition(retired.begin(), retired.end(), [oldest](const Retired &entry)
+                                              { return entry.epoch >= oldest; });
+        for (auto it = reusable; it != retired.end(); ++it)
+        {
+            pool.push_back(it->snapshot);
+        }
+        retired.erase(reusable, retired.end());
+    }
+
+    uint64_t SnapshotPublisher::getVersion() const
+    {
+        // current を読んでから version を読むまでに、その状態が回収されて書き換えられることがあるので、別に持つ番号を読む
+        return publishedVersion.load(std::memory_order_acquire);
+    }
+
+    size_t SnapshotPublisher::getRetiredCount() const
+    {
+        return retired.size();
+    }
+
+    size_t SnapshotPublisher::getMaxReaders() const
+    {
+        return slotCount;
+    }
+
+    SnapshotReader::SnapshotReader(SnapshotPublisher &publisher) : publisher(&publisher), slot(nullptr)
+    {
+        for (size_t i = 0; i < publisher.slotCount; i++)
+        {
+            bool expected = false;
+            if (publisher.slots[i].claimed.compare_exchange_strong(expected, true))
+            {
+                slot = &publisher.slots[i];
+                return;
+            }
+        }
+        throw std::runtime_error("Too many snapshot readers");
+    }
+
+    SnapshotReader::~SnapshotReader()
+    {
+        slot->epoch.store(SnapshotPublisher::IDLE);
+        slot->claimed.store(false, std::memory_order_release);
+    }
+
+    SnapshotReader::Guard SnapshotReader::read()
+    {
+        // エポックを書いてからポインタを読む（この順序は seq_cst で保証する）
+        slot->epoch.store(publisher->globalEpoch.load());
+        return Guard(slot, publisher->current.load());
+    }
+
+    SnapshotReader::Guard::~Guard()
+    {
+        slot->epoch.store(SnapshotPublisher::IDLE, std::memory_order_release);
+    }
+
+} // namespace GomokuLib
@@ -0,0 +1,213 @@
+#include "GomokuLib/Instrumentation.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // 全スレッドのカウンタと名前付きタイマーの登録簿
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<Instrumentation::ThreadCounters *> threads;
+            std::array<uint64_t, Instrumentation::COUNTER_COUNT> retired{}; // 終了したスレッドの値
+            std::array<uint64_t, Instrumentation::COUNTER_COUNT> baseline{}; // reset した時点の値
+            std::map<std::string, std::unique_ptr<LatencyHistogram>> timers;
+        };
+
+        // スレッドの終了時にも使うので、破棄しない
+        Registry &registry()
+        {
+            static Registry *instance = new Registry();
+            return *instance;
+        }
+
+        // 登録されている全スレッドの合計（mutex を持って呼ぶ）
+        std::array<uint64_t, Instrumentation::COUNTER_COUNT> totalsLocked(const Registry &reg)
+        {
+            auto totals = reg.retired;
+            for (const auto *counters : reg.threads)
+            {
+                for (size_t i = 0; i < Instrumentation::COUNTER_COUNT; i++)
+                {
+                    totals[i] += counters->get(i);
+                }
+            }
+            return totals;
+        }
+
+        // Prometheus のラベル値と JSON の文字列のエスケープ
+        std::string escape(const std::string &text)
+        {
+            std::string escaped;
+            for (char c : text)
+            {
+                if (c == '"' || c == '\\')
+                    escaped += '\\';
+                escaped += c;
+            }
+            return escaped;
+        }
+    }
+
+    Instrumentation::ThreadCounters::ThreadCounters()
+    {
+        for (auto &value : values)
+        {
+            value.store(0, std::memory_order_relaxed);
+        }
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.threads.push_back(this);
+    }
+
+    Instrumentation::ThreadCounters::~ThreadCounters()
+    {
+        // 終了したスレッドの値は合計に残す
+        if (current == this)
+        {
+            current = nullptr;
+        }
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (size_t i = 0; i < COUNTER_COUNT; i++)
+        {
+            reg.retired[i] += get(i);
+        }
+        reg.threads.erase(std::remove(reg.threads.begin(), reg.threads.end(), this), reg.threads.end());
+    }
+
+    Instrumentation::ThreadCounters &Instrumentation::registerThread()
+    {
+        // スレッドの終了時に破棄され、値は retired に移る
+        thread_local ThreadCounters counters;
+        current = &counters;
+        return counters;
+    }
+
+    LatencyHistogram &Instrumentation::timer(const std::string &name)
+    {
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto &histogram = reg.timers[name];
+        if (!histogram)
+        {
+            histogram = std::make_unique<LatencyHistogram>();
+        }
+        return *histogram;
+    }
+
+    InstrumentationSnapshot Instrumentation::snapshot()
+    {
+        InstrumentationSnapshot result;
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+
+        auto totals = totalsLocked(reg);
+        for (size_t i = 0; i < COUNTER_COUNT; i++)
+        {
+            result.counters[i] = totals[i] - reg.baseline[i];
+        }
+
+        for (const auto &entry : reg.timers)
+        {
+            const LatencyHistogram &histogram = *entry.second;
+            if (histogram.getCount() == 0)
+                continue;
+
+            InstrumentationSnapshot::TimerStats stats;
+            stats.name = entry.first;
+            stats.count = histogram.getCount();
+            stats.mean = histogram.getMean();
+            stats.p50 = histogram.getPercentile(50);
+            stats.p90 = histogram.getPercentile(90);
+            stats.p99 = histogram.getPercentile(99);
+            stats.max = histogram.getMax();
+            stats.total = static_cast<uint64_t>(stats.mean * stats.count);
+            result.timers.push_back(stats);
+        }
+        return result;
+    }
+
+    void Instrumentation::reset()
+    {
+        // 他のスレッドのカウンタは書き換えず、今の値を基準として覚えておく
+        Registry &reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.baseline = totalsLocked(reg);
+        for (auto &entry : reg.timers)
+        {
+            entry.second->reset();
+        }
+    }
+
+    const char *Instrumentation::counterName(Counter counter)
+    {
+        switch (counter)
+        {
+        case Counter::MOVES_APPLIED:
+            return "moves_applied";
+        case Counter::WIN_CHECKS:
+            return "win_checks";
+        case Counter::CELLS_SCANNED:
+            return "cells_scanned";
+        case Counter::BYTES_PARSED:
+            return "bytes_parsed";
+        default:
+            return "unknown";
+        }
+    }
+
+    std::string Instrumentation::toJson(const InstrumentationSnapshot &snapshot)
+    {
+        std::ostringstream out;
+        out << "{\"enabled\": " << (ENABLED ? "true" : "false") << ", \"counters\": {";
+        for (size_t i = 0; i < COUNTER_COUNT; i++)
+        {
+            out << (i ? ", " : "") << "\"" << counterName(static_cast<Counter>(i)) << "\": " << snapshot.counters[i];
+        }
+        out << "}, \"timers\": [";
+        for (size_t i = 0; i < snapshot.timers.size(); i++)
+        {
+            const auto &timer = snapshot.timers[i];
+            out << (i ? "," : "") << "\n  {\"name\": \"" << escape(timer.name) << "\", \"count\": " << timer.count
+                << ", \"meanNs\": " << static_cast<uint64_t>(timer.mean) << ", \"p50Ns\": " << timer.p50
+                << ", \"p90Ns\": " << timer.p90 << ", \"p99Ns\": " << timer.p99 << ", \"maxNs\": " << timer.max << "}";
+        }
+        out << (snapshot.timers.empty() ? "" : "\n") << "]}";
+        return out.str();
+    }
+
+    std::string Instrumentation::toPrometheus(const InstrumentationSnapshot &snapshot)
+    {
+        std::ostringstream out;
+        for (size_t i = 0; i < COUNTER_COUNT; i++)
+        {
+            std::string name = std::string("gomoku_") + counterName(static_cast<Counter>(i)) + "_total";
+            out << "# TYPE " << name << " counter\n";
+            out << name << " " << snapshot.counters[i] << "\n";
+        }
+
+        // 時間は秒で書き出す
+        out << "# TYPE gomoku_latency_seconds summary\n";
+        for (const auto &timer : snapshot.timers)
+        {
+            std::string label = "name=\"" + escape(timer.name) + "\"";
+            const std::pair<const char *, uint64_t> quantiles[] = {{"0.5", timer.p50}, {"0.9", timer.p90}, {"0.99", timer.p99}};
+            for (const auto &quantile : quantiles)
+            {
+                out << "gomoku_latency_seconds{" << label << ",quantile=\"" << quantile.first << "\"} "
+                    << quantile.second / 1e9 << "\n";
+            }
+            out << "gomoku_latency_seconds_sum{" << label << "} " << timer.total / 1e9 << "\n";
+            out << "gomoku_latency_seconds_count{" << label << "} " << timer.count << "\n";
+        }
+        return out.str();
+    }
+
+} // namespace GomokuLib
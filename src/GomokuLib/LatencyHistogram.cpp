@@ -0,0 +1,119 @@
+#include "GomokuLib/LatencyHistogram.h"
+#include <algorithm>
+#include <cmath>
+
+namespace GomokuLib
+{
+
+    LatencyHistogram::LatencyHistogram() : total(0), maxValue(0)
+    {
+        for (auto &bucket : buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    int LatencyHistogram::bucketIndex(uint64_t value)
+    {
+        // SUB_BUCKETS 未満の値はそのまま先頭の区間に入る
+        if (value < static_cast<uint64_t>(SUB_BUCKETS))
+        {
+            return static_cast<int>(value);
+        }
+
+        // 最上位ビットの位置で区間を決め、その下の SUB_BUCKET_BITS ビットで区間内の位置を決める
+        int msb = 63 - __builtin_clzll(value);
+        int shift = msb - SUB_BUCKET_BITS;
+        int sub = static_cast<int>((value >> shift) & (SUB_BUCKETS - 1));
+        return (shift + 1) * SUB_BUCKETS + sub;
+    }
+
+    uint64_t LatencyHistogram::bucketUpperBound(int index)
+    {
+        if (index < SUB_BUCKETS)
+        {
+            return static_cast<uint64_t>(index);
+        }
+
+        int shift = index / SUB_BUCKETS - 1;
+        uint64_t sub = static_cast<uint64_t>(index % SUB_BUCKETS);
+        uint64_t lower = (static_cast<uint64_t>(SUB_BUCKETS) + sub) << shift;
+        return lower + ((1ULL << shift) - 1);
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram &other)
+    {
+        for (int i = 0; i < BUCKET_COUNT; i++)
+        {
+            uint64_t count = other.buckets[i].load(std::memory_order_relaxed);
+            if (count)
+            {
+                buckets[i].fetch_add(count, std::memory_order_relaxed);
+            }
+        }
+        total.fetch_add(other.total.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+        uint64_t otherMax = other.maxValue.load(std::memory_order_relaxed);
+        uint64_t current = maxValue.load(std::memory_order_relaxed);
+        while (otherMax > current && !maxValue.compare_exchange_weak(current, otherMax, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void LatencyHistogram::reset()
+    {
+        for (auto &bucket : buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        total.store(0, std::memory_order_relaxed);
+        maxValue.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::getCount() const
+    {
+        uint64_t count = 0;
+        for (const auto &bucket : buckets)
+        {
+            count += bucket.load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+    double LatencyHistogram::getMean() const
+    {
+        uint64_t count = getCount();
+        return count ? static_cast<double>(total.load(std::memory_order_relaxed)) / count : 0.0;
+    }
+
+    uint64_t LatencyHistogram::getMax() const
+    {
+        return maxValue.load(std::memory_order_relaxed);
+    }
+
+    uint64_t LatencyHistogram::getPercentile(double percentile) const
+    {
+        uint64_t count = getCount();
+        if (count == 0)
+        {
+            return 0;
+        }
+
+        // percentile 以上を占める最初のバケットの上限を返す
+        percentile = std::min(100.0, std::max(0.0, percentile));
+        uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * count));
+        target = std::max<uint64_t>(target, 1);
+
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; i++)
+        {
+            seen += buckets[i].load(std::memory_order_relaxed);
+            if (seen >= target)
+            {
+                return std::min(bucketUpperBound(i), getMax());
+            }
+        }
+        return getMax();
+    }
+
+} // namespace GomokuLib
@@ -0,0 +1,88 @@
+#include "GomokuLib/MappedFile.h"
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace GomokuLib
+{
+
+    MappedFile::MappedFile(const std::string &filepath) : data(nullptr), size(0)
+    {
+        int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Failed to open file: " + filepath);
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat file: " + filepath);
+        }
+
+        size = static_cast<size_t>(st.st_size);
+        if (size > 0)
+        {
+            void *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("Failed to map file: " + filepath);
+            }
+            // 先頭から順に読むことをカーネルに伝えて先読みを促す
+            ::madvise(addr, size, MADV_SEQUENTIAL);
+            data = static_cast<const char *>(addr);
+        }
+
+        // マップ後はファイルディスクリプタは不要
+        ::close(fd);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        release();
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept : data(other.data), size(other.size)
+    {
+        other.data = nullptr;
+        other.size = 0;
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            data = other.data;
+            size = other.size;
+            other.data = nullptr;
+            other.size = 0;
+        }
+        return *this;
+    }
+
+    void MappedFile::release()
+    {
+        if (data)
+        {
+            ::munmap(const_cast<char *>(data), size);
+            data = nullptr;
+            size = 0;
+        }
+    }
+
+    std::string_view MappedFile::getContents() const
+    {
+        return std::string_view(data ? data : "", size);
+    }
+
+    size_t MappedFile::getSize() const
+    {
+        return size;
+    }
+
+} // namespace GomokuLib
@@ -0,0 +1,312 @@
+#include "GomokuLib/NeuralNetwork.h"
+#include "GomokuLib/Engine.h"
+#include "GomokuLib/MappedFile.h"
+#include "DispatchTable.h"
+#include "NeuralNetworkKernel.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace GomokuLib
+{
+
+    static_assert(NeuralNetwork::HIDDEN == NeuralNetworkKernel::HIDDEN, "HIDDEN must match the kernels");
+    static_assert(NeuralNetwork::OUTPUT_HIDDEN == NeuralNetworkKernel::OUTPUT_HIDDEN, "OUTPUT_HIDDEN must match the kernels");
+    static_assert(NeuralNetwork::L1_SHIFT == NeuralNetworkKernel::L1_SHIFT, "L1_SHIFT must match the kernels");
+
+    constexpr char NeuralNetwork::MAGIC[8];
+
+    namespace
+    {
+        constexpr size_t HEADER_SIZE = sizeof(NeuralNetwork::MAGIC) + 4 * sizeof(uint32_t);
+        constexpr int INPUT_SIZE = 2 * NeuralNetwork::HIDDEN;
+
+        // ファイルの内容を先頭から順に読む
+        class Reader
+        {
+        public:
+            explicit Reader(std::string_view contents) : contents(contents), offset(0) {}
+
+            template <typename T>
+            void read(T *values, size_t count)
+            {
+                size_t bytes = sizeof(T) * count;
+                if (contents.size() - offset < bytes)
+                {
+                    throw std::runtime_error("Neural network file is truncated");
+                }
+                std::memcpy(values, contents.data() + offset, bytes);
+                offset += bytes;
+            }
+
+            template <typename T>
+            T read()
+            {
+                T value;
+                read(&value, 1);
+                return value;
+            }
+
+            bool atEnd() const { return offset == contents.size(); }
+
+        private:
+            std::string_view contents;
+            size_t offset;
+        };
+
+        // 再現性のある乱数
+        uint64_t splitMix64(uint64_t &state)
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        int randomInRange(uint64_t &state, int low, int high)
+        {
+            return low + static_cast<int>(splitMix64(state) % static_cast<uint64_t>(high - low + 1));
+        }
+    }
+
+    int32_t NeuralNetworkKernel::forwardScalar(const Layers &layers, const int16_t *own, const int16_t *other)
+    {
+        uint8_t input[INPUT_SIZE];
+        for (int j = 0; j < NeuralNetwork::HIDDEN; j++)
+        {
+            input[j] = static_cast<uint8_t>(std::clamp<int>(own[j], 0, 127));
+            input[NeuralNetwork::HIDDEN + j] = static_cast<uint8_t>(std::clamp<int>(other[j], 0, 127));
+        }
+
+        int32_t output = layers.outputBias;
+        for (int k = 0; k < NeuralNetwork::OUTPUT_HIDDEN; k++)
+        {
+            const int8_t *weights = layers.hiddenWeights + k * INPUT_SIZE;
+            int32_t sum = layers.hiddenBias[k];
+            for (int j = 0; j < INPUT_SIZE; j++)
+            {
+                sum += weights[j] * input[j];
+            }
+            output += layers.outputWeights[k] * std::clamp(sum >> NeuralNetwork::L1_SHIFT, 0, 127);
+        }
+        return output;
+    }
+
+    NeuralNetwork::NeuralNetwork(int boardSize, int outputScale)
+        : boardSize(boardSize), outputScale(outputScale),
+          features(static_cast<size_t>(2) * boardSize * boardSize * HIDDEN), bias(HIDDEN),
+          hiddenWeights(static_cast<size_t>(OUTPUT_HIDDEN) * INPUT_SIZE), hiddenBias(OUTPUT_HIDDEN),
+          outputWeights(OUTPUT_HIDDEN), outputBias(0)
+    {
+    }
+
+    NeuralNetwork NeuralNetwork::load(const std::string &filepath)
+    {
+        MappedFile file(filepath);
+        Reader reader(file.getContents());
+
+        char magic[sizeof(MAGIC)];
+        reader.read(magic, sizeof(magic));
+        if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            throw std::runtime_error("Not a neural network file: " + filepath);
+        }
+
+        uint32_t size = reader.read<uint32_t>();
+        uint32_t hidden = reader.read<uint32_t>();
+        uint32_t outputHidden = reader.read<uint32_t>();
+        int32_t scale = reader.read<int32_t>();
+        if (size < 5 || size > static_cast<uint32_t>(BoardScan::MAX_PACKED_SIZE) || hidden != HIDDEN || outputHidden != OUTPUT_HIDDEN)
+        {
+            throw std::runtime_error("Unsupported neural network architecture in " + filepath);
+        }
+
+        NeuralNetwork network(static_cast<int>(size), scale);
+        reader.read(network.features.data(), network.features.size());
+        reader.read(network.bias.data(), network.bias.size());
+        reader.read(network.hiddenWeights.data(), network.hiddenWeights.size());
+        reader.read(network.hiddenBias.data(), network.hiddenBias.size());
+        reader.read(network.outputWeights.data(), network.outputWeights.size());
+        network.outputBias = reader.read<int32_t>();
+        if (!reader.atEnd())
+        {
+            throw std::runtime_error("Unexpected data after the neural network weights in " + filepath);
+        }
+        return network;
+    }
+
+    NeuralNetwork NeuralNetwork::random(int boardSize, uint64_t seed)
+    {
+        if (boardSize < 5 || boardSize > BoardScan::MAX_PACKED_SIZE)
+        {
+            throw std::runtime_error("Unsupported board size for neural network");
+        }
+
+        NeuralNetwork network(boardSize, 256);
+        uint64_t state = seed;
+        for (auto &weight : network.features)
+            weight = static_cast<int16_t>(randomInRange(state, -16, 16));
+        for (auto &value : network.bias)
+            value = static_cast<int16_t>(randomInRange(state, 0, 96));
+        for (auto &weight : network.hiddenWeights)
+            weight = static_cast<int8_t>(randomInRange(state, -32, 32));
+        for (auto &value : network.hiddenBias)
+            value = randomInRange(state, -2048, 2048);
+        for (auto &weight : network.outputWeights)
+            weight = static_cast<int8_t>(randomInRange(state, -64, 64));
+        network.outputBias = randomInRange(state, -256, 256);
+        return network;
+    }
+
+    void NeuralNetwork::save(const std::string &filepath) const
+    {
+        std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            throw std::runtime_error("Failed to open file for writing: " + filepath);
+        }
+
+        auto write = [&file](const auto *values, size_t count)
+        {
+            file.write(reinterpret_cast<const char *>(values), static_cast<std::streamsize>(sizeof(*values) * count));
+        };
+        const uint32_t header[3] = {static_cast<uint32_t>(boardSize), HIDDEN, OUTPUT_HIDDEN};
+        const int32_t scale = outputScale;
+        write(MAGIC, sizeof(MAGIC));
+        write(header, 3);
+        write(&scale, 1);
+        write(features.data(), features.size());
+        write(bias.data(), bias.size());
+        write(hiddenWeights.data(), hiddenWeights.size());
+        write(hiddenBias.data(), hiddenBias.size());
+        write(outputWeights.data(), outputWeights.size());
+        write(&outputBias, 1);
+        if (!file)
+        {
+            throw std::runtime_error("Failed to write neural network: " + filepath);
+        }
+    }
+
+    int NeuralNetwork::getBoardSize() const
+    {
+        return boardSize;
+    }
+
+    SimdLevel NeuralNetwork::getLevel()
+    {
+        return activeDispatch().neuralLevel;
+    }
+
+    void NeuralNetwork::setLevel(SimdLevel level)
+    {
+        if ((level != SimdLevel::SCALAR && level != SimdLevel::AVX2) || !CpuDispatch::isSupported(level))
+        {
+            throw std::runtime_error(std::string("SIMD level is not available for the neural network: ") + CpuDispatch::levelToString(level));
+        }
+        CpuDispatch::setLevel(level);
+    }
+
+    int NeuralNetwork::forward(const int16_t *own, const int16_t *other) const
+    {
+        NeuralNetworkKernel::Layers layers = {hiddenWeights.data(), hiddenBias.data(), outputWeights.data(), outputBias};
+        int64_t score = static_cast<int64_t>(activeDispatch().neuralForward(layers, own, other)) * outputScale / OUTPUT_DIVISOR;
+        return static_cast<int>(std::clamp<int64_t>(score, -Engine::SCORE_FIVE, Engine::SCORE_FIVE));
+    }
+
+    const int16_t *NeuralNetwork::featureWeights(int feature) const
+    {
+        return features.data() + static_cast<size_t>(feature) * HIDDEN;
+    }
+
+    const int16_t *NeuralNetwork::featureBias() const
+    {
+        return bias.data();
+    }
+
+    int NeuralNetwork::featureIndex(Stone perspective, int row, int col, Stone stone) const
+    {
+        int cell = row * boardSize + col;
+        return (stone == perspective) ? cell : boardSize * boardSize + cell;
+    }
+
+    NeuralAccumulator::NeuralAccumulator(const NeuralNetwork &network, const Board &board)
+        : network(network)
+    {
+        if (board.getSize() != network.getBoardSize())
+        {
+            throw std::runtime_error("Neural network was created for a different board size");
+        }
+        refresh(board);
+    }
+
+    NeuralAccumulator::NeuralAccumulator(const NeuralNetwork &network) : network(network)
+    {
+        std::copy_n(network.featureBias(), NeuralNetwork::HIDDEN, black.begin());
+        std::copy_n(network.featureBias(), NeuralNetwork::HIDDEN, white.begin());
+    }
+
+    void NeuralAccumulator::refresh(const Board &board)
+    {
+        std::copy_n(network.featureBias(), NeuralNetwork::HIDDEN, black.begin());
+        std::copy_n(network.featureBias(), NeuralNetwork::HIDDEN, white.begin());
+        for (int row = 0; row < board.getSize(); row++)
+        {
+            for (int col = 0; col < board.getSize(); col++)
+            {
+                Stone stone = board.getStone(row, col);
+                if (stone == Stone::BLACK || stone == Stone::WHITE)
+                {
+                    addStone(row, col, stone);
+                }
+            }
+        }
+    }
+
+    void NeuralAccumulator::refresh(const uint64_t *blackRows, const uint64_t *whiteRows)
+    {
+        std::copy_n(network.featureBias(), NeuralNetwork::HIDDEN, black.begin());
+        std::copy_n(network.featureBias(), NeuralNetwork::HIDDEN, white.begin());
+        for (int row = 0; row < network.getBoardSize(); row++)
+        {
+            // 石のあるビットだけをたどる
+            for (uint64_t bits = blackRows[row]; bits != 0; bits &= bits - 1)
+            {
+                addStone(row, __builtin_ctzll(bits), Stone::BLACK);
+            }
+            for (uint64_t bits = whiteRows[row]; bits != 0; bits &= bits - 1)
+            {
+                addStone(row, __builtin_ctzll(bits), Stone::WHITE);
+            }
+        }
+    }
+
+    void NeuralAccumulator::addStone(int row, int col, Stone stone)
+    {
+        const int16_t *forBlack = network.featureWeights(network.featureIndex(Stone::BLACK, row, col, stone));
+        const int16_t *forWhite = network.featureWeights(network.featureIndex(Stone::WHITE, row, col, stone));
+        for (int j = 0; j < NeuralNetwork::HIDDEN; j++)
+        {
+            black[j] = static_cast<int16_t>(black[j] + forBlack[j]);
+            white[j] = static_cast<int16_t>(white[j] + forWhite[j]);
+        }
+    }
+
+    void NeuralAccumulator::removeStone(int row, int col, Stone stone)
+    {
+        const int16_t *forBlack = network.featureWeights(network.featureIndex(Stone::BLACK, row, col, stone));
+        const int16_t *forWhite = network.featureWeights(network.featureIndex(Stone::WHITE, row, col, stone));
+        for (int j = 0; j < NeuralNetwork::HIDDEN; j++)
+        {
+            black[j] = static_cast<int16_t>(black[j] - forBlack[j]);
+            white[j] = static_cast<int16_t>(white[j] - forWhite[j]);
+        }
+    }
+
+    int NeuralAccumulator::evaluate(Stone sideToMove) const
+    {
+        return (sideToMove == Stone::WHITE) ? network.forward(white.data(), black.data())
+                                            : network.forward(black.data(), white.data());
+    }
+
+} // namespace GomokuLib
@@ -0,0 +1,70 @@
+// ニューラルネットワークの AVX2 版（-mavx2 でコンパイルする）
+#include "NeuralNetworkKernel.h"
+#include <immintrin.h>
+
+namespace GomokuLib
+{
+    namespace
+    {
+        constexpr int INPUT_SIZE = 2 * NeuralNetworkKernel::HIDDEN;
+        constexpr int INPUT_CHUNKS = INPUT_SIZE / 32;
+
+        // 16 個の int16 を2つ、0〜127 に切り詰めて 32 バイトに詰める（元の順番のまま）
+        __m256i clampPack(const int16_t *values)
+        {
+            const __m256i limit = _mm256_set1_epi16(127);
+            __m256i low = _mm256_min_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)), limit);
+            __m256i high = _mm256_min_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + 16)), limit);
+            // packus は 128 ビットずつ交互に詰めるので並べ直す
+            return _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+        }
+
+        // 4つの i32 × 8 のそれぞれの合計を、i32 × 4 にまとめる
+        __m128i horizontalSum4(__m256i a, __m256i b, __m256i c, __m256i d)
+        {
+            __m256i sum = _mm256_hadd_epi32(_mm256_hadd_epi32(a, b), _mm256_hadd_epi32(c, d));
+            return _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        }
+    }
+
+    int32_t NeuralNetworkKernel::forwardAvx2(const Layers &layers, const int16_t *own, const int16_t *other)
+    {
+        __m256i input[INPUT_CHUNKS];
+        for (int c = 0; c < INPUT_CHUNKS / 2; c++)
+        {
+            input[c] = clampPack(own + c * 32);
+            input[INPUT_CHUNKS / 2 + c] = clampPack(other + c * 32);
+        }
+
+        // 第2層は4つずつまとめて計算する（入力を読み込む回数と、横方向の足し算を減らす）
+        const __m256i ones = _mm256_set1_epi16(1);
+        int32_t output = layers.outputBias;
+        for (int k = 0; k < NeuralNetworkKernel::OUTPUT_HIDDEN; k += 4)
+        {
+            const int8_t *weights = layers.hiddenWeights + k * INPUT_SIZE;
+            __m256i sums[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+            for (int c = 0; c < INPUT_CHUNKS; c++)
+            {
+                for (int i = 0; i < 4; i++)
+                {
+                    // u8 × i8 の積を隣どうし i16 で足し（127 × 128 × 2 なので飽和しない）、i32 にまとめる
+                    __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(weights + i * INPUT_SIZE + c * 32));
+                    sums[i] = _mm256_add_epi32(sums[i], _mm256_madd_epi16(_mm256_maddubs_epi16(input[c], w), ones));
+                }
+            }
+
+            alignas(16) int32_t hidden[4];
+            __m128i bias = _mm_loadu_si128(reinterpret_cast<const __m128i *>(layers.hiddenBias + k));
+            __m128i value = _mm_srai_epi32(_mm_add_epi32(horizontalSum4(sums[0], sums[1], sums[2], sums[3]), bias),
+                                           NeuralNetworkKernel::L1_SHIFT);
+            value = _mm_min_epi32(_mm_max_epi32(value, _mm_setzero_si128()), _mm_set1_epi32(127));
+            _mm_store_si128(reinterpret_cast<__m128i *>(hidden), value);
+            for (int i = 0; i < 4; i++)
+            {
+                output += layers.outputWeights[k + i] * hidden[i];
+            }
+        }
+        return output;
+    }
+
+} // namespace GomokuLib
@@ -0,0 +1,33 @@
+#pragma once
+
+// ニューラルネットワークの第2層と出力層の計算（ライブラリの内部でのみ使う）
+// AVX2 版は別の翻訳単位で -mavx2 を付けてコンパイルする
+
+#include <cstdint>
+
+namespace GomokuLib
+{
+    namespace NeuralNetworkKernel
+    {
+        // NeuralNetwork と同じ大きさ（AVX2 版の翻訳単位に標準ライブラリのヘッダーを持ち込まないよう、ここにも置く）
+        constexpr int HIDDEN = 256;
+        constexpr int OUTPUT_HIDDEN = 32;
+        constexpr int L1_SHIFT = 6;
+
+        // 第2層と出力層の重み
+        struct Layers
+        {
+            const int8_t *hiddenWeights; // [OUTPUT_HIDDEN][2 * HIDDEN]
+            const int32_t *hiddenBias;   // [OUTPUT_HIDDEN]
+            const int8_t *outputWeights; // [OUTPUT_HIDDEN]
+            int32_t outputBias;
+        };
+
+        // アキュムレータを 0〜127 に切り詰めて全結合層を計算し、出力層の値を返す
+        // （どちらの実装も同じ値を返す）
+        int32_t forwardScalar(const Layers &layers, const int16_t *own, const int16_t *other);
+#if defined(GOMOKU_X86_KERNELS)
+        int32_t forwardAvx2(const Layers &layers, const int16_t *own, const int16_t *other);
+#endif
+    }
+} // namespace GomokuLib
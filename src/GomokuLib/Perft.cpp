@@ -0,0 +1,176 @@
+#include "GomokuLib/Perft.h"
+#include "GomokuLib/ThreadArena.h"
+#include "GomokuLib/ThreadPool.h"
+#include <chrono>
+#include <future>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // 再帰で数える（盤面の全てのマスに打ってみて、打てた手だけをたどる）
+        void countRecursive(Game &game, int depth, PerftResult &result)
+        {
+            if (depth == 0)
+            {
+                result.sequences++;
+                return;
+            }
+
+            int size = game.getBoard().getSize();
+            for (int r = 0; r < size; r++)
+            {
+                for (int c = 0; c < size; c++)
+                {
+                    if (game.playTurn(r, c) != MoveResult::SUCCESS)
+                    {
+                        continue;
+                    }
+                    result.nodes++;
+
+                    // 終局した局面からは先に進めない
+                    if (game.isGameOver())
+                    {
+                        result.terminals++;
+                        if (depth == 1)
+                        {
+                            result.sequences++;
+                        }
+                    }
+                    else
+                    {
+                        countRecursive(game, depth - 1, result);
+                    }
+                    game.takeBackMove();
+                }
+            }
+        }
+
+        // 数えるための対局（現在の局面までの手だけを打ち直した、変化も時計もない対局）
+        // takeBackMove は棋譜の木から節点を消すので、元の対局の変化や戻した手の先をたどらないようにする
+        Game workingCopy(const Game &game, const Game::allocator_type &allocator = Game::allocator_type())
+        {
+            Game copy(game.getBoard().getSize(), allocator);
+            for (const auto &move : game.getMoveView())
+            {
+                copy.playTurn(move.first, move.second);
+            }
+            return copy;
+        }
+
+        // 終局していない対局の並びを数える
+        PerftResult countFrom(Game &game, int depth)
+        {
+            PerftResult result;
+            countRecursive(game, depth, result);
+            return result;
+        }
+
+        double secondsSince(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    PerftResult Perft::count(const Game &game, int depth)
+    {
+        auto start = std::chrono::steady_clock::now();
+        PerftResult result;
+        if (game.isGameOver())
+        {
+            // 終局した局面から打てる並びは長さ 0 のものだけ
+            result.sequences = (depth == 0) ? 1 : 0;
+        }
+        else
+        {
+            Game copy = workingCopy(game);
+            result = countFrom(copy, depth);
+        }
+        result.seconds = secondsSince(start);
+        return result;
+    }
+
+    std::vector<std::pair<std::pair<int, int>, uint64_t>> Perft::divide(const Game &game, int depth)
+    {
+        std::vector<std::pair<std::pair<int, int>, uint64_t>> counts;
+        if (depth < 1 || game.isGameOver())
+        {
+            return counts;
+        }
+
+        Game copy = workingCopy(game);
+        int size = copy.getBoard().getSize();
+        for (int r = 0; r < size; r++)
+        {
+            for (int c = 0; c < size; c++)
+            {
+                if (copy.playTurn(r, c) != MoveResult::SUCCESS)
+                {
+                    continue;
+                }
+                uint64_t sequences = copy.isGameOver() ? (depth == 1 ? 1 : 0) : countFrom(copy, depth - 1).sequences;
+                counts.emplace_back(std::make_pair(r, c), sequences);
+                copy.takeBackMove();
+            }
+        }
+        return counts;
+    }
+
+    PerftResult Perft::countParallel(const Game &game, int depth, size_t threadCount)
+    {
+        if (depth < 2 || game.isGameOver())
+        {
+            return count(game, depth);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::future<PerftResult>> futures;
+        {
+            ThreadPool pool(threadCount);
+            int size = game.getBoard().getSize();
+            for (int r = 0; r < size; r++)
+            {
+                for (int c = 0; c < size; c++)
+                {
+                    if (game.getBoard().getStone(r, c) != Stone::EMPTY)
+                    {
+                        continue;
+                    }
+
+                    // 初手ごとに独立したタスクにする（対局はタスクごとに、実行するスレッドの領域にコピーする）
+                    futures.push_back(pool.submit([&game, depth, r, c]()
+                                                  {
+                        Game copy = workingCopy(game, ThreadArena::get());
+                        copy.playTurn(r, c);
+                        PerftResult sub;
+                        sub.nodes = 1;
+                        if (copy.isGameOver())
+                        {
+                            sub.terminals = 1;
+                        }
+                        else
+                        {
+                            PerftResult rest = countFrom(copy, depth - 1);
+                            sub.sequences = rest.sequences;
+                            sub.nodes += rest.nodes;
+                            sub.terminals = rest.terminals;
+                        }
+                        return sub; }));
+                }
+            }
+        }
+
+        PerftResult total;
+        for (auto &future : futures)
+        {
+            PerftResult sub = future.get();
+            total.sequences += sub.sequences;
+            total.nodes += sub.nodes;
+            total.terminals += sub.terminals;
+        }
+        total.seconds = secondsSince(start);
+        return total;
+    }
+
+} // namespace GomokuLib
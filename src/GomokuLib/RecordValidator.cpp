@@ -0,0 +1,197 @@
+#include "GomokuLib/RecordValidator.h"
+#include "GomokuLib/Game.h"
+#include "GomokuLib/Instrumentation.h"
+#include "GomokuLib/MappedFile.h"
+#include "GomokuLib/Tracer.h"
+#include <charconv>
+#include <memory>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // 前後の空白を取り除く
+        std::string_view trim(std::string_view text)
+        {
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+            {
+                text.remove_prefix(1);
+            }
+            while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+            {
+                text.remove_suffix(1);
+            }
+            return text;
+        }
+
+        // 整数に変換（全体が整数でなければ false）
+        bool parseInt(std::string_view text, int &value)
+        {
+            text = trim(text);
+            if (text.empty())
+            {
+                return false;
+            }
+            auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+            return result.ec == std::errc() && result.ptr == text.data() + text.size();
+        }
+    }
+
+    RecordSummary RecordValidator::validate(std::string_view contents)
+    {
+        GOMOKU_COUNT(BYTES_PARSED, contents.size());
+
+        RecordSummary summary;
+        summary.boardSize = 15; // SIZE 行がない場合は loadGame と同じく 15
+        summary.winner = Stone::EMPTY;
+
+        std::unique_ptr<Game> game;
+        int lineNumber = 0;
+        int moveIndex = 0;
+
+        auto addIssue = [&](RecordIssueType type, const std::string &message)
+        {
+            summary.issues.push_back({type, lineNumber, moveIndex, message});
+        };
+
+        size_t pos = 0;
+        while (pos < contents.size())
+        {
+            size_t end = contents.find('\n', pos);
+            if (end == std::string_view::npos)
+            {
+                end = contents.size();
+            }
+            std::string_view line = trim(contents.substr(pos, end - pos));
+            pos = end + 1;
+            lineNumber++;
+
+            // 空行とコメント行をスキップ
+            if (line.empty() || line[0] == '#')
+            {
+                continue;
+            }
+
+            // 盤面サイズの行
+            if (line.substr(0, 5) == "SIZE:")
+            {
+                int size = 0;
+                if (moveIndex > 0)
+                {
+                    addIssue(RecordIssueType::PARSE_ERROR, "SIZE appears after moves");
+                }
+                else if (!parseInt(line.substr(5), size))
+                {
+                    addIssue(RecordIssueType::PARSE_ERROR, "Malformed SIZE line");
+                }
+                else if (size < MIN_BOARD_SIZE || size > MAX_BOARD_SIZE)
+                {
+                    addIssue(RecordIssueType::INVALID_SIZE, "Board size out of range: " + std::to_string(size));
+                }
+                else
+                {
+                    summary.boardSize = size;
+                    game.reset();
+                }
+                continue;
+            }
+
+            // VARIATIONS: 以降は変化の木で、対局の手順は MOVES で終わっている
+            if (line.substr(0, 11) == "VARIATIONS:")
+            {
+                break;
+            }
+
+            // MOVES: 行はスキップ
+            if (line.find("MOVES:") != std::string_view::npos)
+            {
+                continue;
+            }
+
+            // 着手データ (行,列,色)
+            moveIndex++;
+            size_t pos1 = line.find(',');
+            size_t pos2 = pos1 == std::string_view::npos ? pos1 : line.find(',', pos1 + 1);
+            int row = 0;
+            int col = 0;
+            if (pos2 == std::string_view::npos ||
+                !parseInt(line.substr(0, pos1), row) ||
+                !parseInt(line.substr(pos1 + 1, pos2 - pos1 - 1), col))
+            {
+                addIssue(RecordIssueType::PARSE_ERROR, "Malformed move line");
+                continue;
+            }
+
+            std::string_view color = trim(line.substr(pos2 + 1));
+            if (color != "B" && color != "W")
+            {
+                addIssue(RecordIssueType::PARSE_ERROR, "Unknown stone color");
+                continue;
+            }
+
+            if (!game)
+            {
+                game = std::make_unique<Game>(summary.boardSize);
+            }
+
+            // 手番の色が交互になっているか（記録の色ではなく本来の手番で続行する）
+            Stone expected = game->getCurrentPlayer();
+            Stone recorded = (color == "B") ? Stone::BLACK : Stone::WHITE;
+            if (recorded != expected)
+            {
+                addIssue(RecordIssueType::WRONG_COLOR_ORDER,
+                         std::string("Expected ") + (expected == Stone::BLACK ? "B" : "W") + " but found " + std::string(color));
+            }
+
+            switch (game->playTurn(row, col))
+            {
+            case MoveResult::SUCCESS:
+                summary.moves.emplace_back(row, col);
+                break;
+            case MoveResult::INVALID_MOVE:
+                addIssue(RecordIssueType::ILLEGAL_MOVE,
+                         "Illegal move at (" + std::to_string(row) + "," + std::to_string(col) + ")");
+                break;
+            case MoveResult::GAME_OVER:
+                addIssue(RecordIssueType::MOVE_AFTER_GAME_OVER,
+                         "Move at (" + std::to_string(row) + "," + std::to_string(col) + ") after the game ended");
+                break;
+            }
+        }
+
+        if (game)
+        {
+            summary.winner = game->getWinner();
+        }
+
+        return summary;
+    }
+
+    RecordSummary RecordValidator::validateFile(const std::string &filepath)
+    {
+        GOMOKU_TIMED_SCOPE("record.validate");
+        GOMOKU_TRACE_SCOPE("io", "RecordValidator::validateFile");
+        MappedFile file(filepath);
+        return validate(file.getContents());
+    }
+
+    const char *RecordValidator::issueTypeToString(RecordIssueType type)
+    {
+        switch (type)
+        {
+        case RecordIssueType::PARSE_ERROR:
+            return "parse-error";
+        case RecordIssueType::INVALID_SIZE:
+            return "invalid-size";
+        case RecordIssueType::ILLEGAL_MOVE:
+            return "illegal-move";
+        case RecordIssueType::MOVE_AFTER_GAME_OVER:
+            return "move-after-game-over";
+        case RecordIssueType::WRONG_COLOR_ORDER:
+            return "wrong-color-order";
+        }
+        return "unknown";
+    }
+
+} // namespace GomokuLib
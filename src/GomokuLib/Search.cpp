@@ -0,0 +1,407 @@
+#include "GomokuLib/Search.h"
+#include "GomokuLib/Engine.h"
+#include "GomokuLib/Instrumentation.h"
+#include "GomokuLib/ThreadArena.h"
+#include "GomokuLib/Tracer.h"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // キャンセルを確認する間隔（局面数）
+        constexpr uint64_t CANCEL_CHECK_INTERVAL = 1024;
+
+        // 時間の上限を確認する間隔（局面数。時計を読むのはこの間隔だけにする）
+        constexpr uint64_t TIME_CHECK_INTERVAL = 64;
+
+        // キャンセルされたときに探索を打ち切るための例外
+        struct SearchAborted
+        {
+        };
+
+        // 評価値付きの候補手
+        struct ScoredMove
+        {
+            std::pair<int, int> move;
+            long long order; // 並べ替え用（攻め 10、守り 9 の重み）
+            int attack;      // 自分が置いた場合の形の評価値
+        };
+
+        Stone opponentOf(Stone stone)
+        {
+            return (stone == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
+        }
+
+        // 勝ちの評価値を置換表に入れる形に変換する（根からの手数を、その局面からの手数に直す）
+        int scoreToTable(int score, int plyFromRoot)
+        {
+            if (score >= Search::SCORE_WIN - 1000)
+                return score + plyFromRoot;
+            if (score <= -Search::SCORE_WIN + 1000)
+                return score - plyFromRoot;
+            return score;
+        }
+
+        int scoreFromTable(int score, int plyFromRoot)
+        {
+            if (score >= Search::SCORE_WIN - 1000)
+                return score - plyFromRoot;
+            if (score <= -Search::SCORE_WIN + 1000)
+                return score + plyFromRoot;
+            return score;
+        }
+
+        // 1回の探索の状態
+        class SearchContext
+        {
+        public:
+            SearchContext(const Board &board, Stone player, const SearchLimits &limits,
+                          const CancellationToken &token, TranspositionTable *table)
+                : board(board, ThreadArena::get()), limits(limits), token(token), table(table), key(0), nodes(0),
+                  timer(limits.time)
+            {
+                if (table)
+                {
+                    key = table->hash(board, player);
+                }
+                // 盤面の大きさが違う評価器やネットワークは使えないので、手書きの評価で探索する
+                if (limits.evaluator && limits.evaluator->getBoardSize() == board.getSize())
+                {
+                    evaluator = limits.evaluator.get();
+                }
+                else if (limits.network && limits.network->getBoardSize() == board.getSize())
+                {
+                    accumulator = std::make_unique<NeuralAccumulator>(*limits.network, board);
+                }
+            }
+
+            Board board;
+            const SearchLimits &limits;
+            const CancellationToken &token;
+            TranspositionTable *table;
+            uint64_t key; // 現在の局面のハッシュ（table がある場合のみ更新する）
+            uint64_t nodes;
+            TimeManager timer;                              // 時間の制限（limits.time が無制限なら止めない）
+            std::unique_ptr<NeuralAccumulator> accumulator; // ネットワークで評価する場合のみ（着手ごとに差分で更新する）
+            BatchEvaluator *evaluator = nullptr;            // まとめて評価する場合のみ
+
+            // 石を置いて手番を渡す・取り除いて手番を戻す
+            void makeMove(const std::pair<int, int> &move, Stone player)
+            {
+                board.placeStone(move.first, move.second, player);
+                if (accumulator)
+                {
+                    accumulator->addStone(move.first, move.second, player);
+                }
+                if (table)
+                {
+                    key ^= table->stoneKey(move.first, move.second, player) ^ table->sideToMoveKey();
+                }
+            }
+
+            void unmakeMove(const std::pair<int, int> &move, Stone player)
+            {
+                board.placeStone(move.first, move.second, Stone::EMPTY);
+                if (accumulator)
+                {
+                    accumulator->removeStone(move.first, move.second, player);
+                }
+                if (table)
+                {
+                    key ^= table->stoneKey(move.first, move.second, player) ^ table->sideToMoveKey();
+                }
+            }
+
+            void storeEntry(int score, int depth, BoundType bound, const std::pair<int, int> &move, int plyFromRoot)
+            {
+                if (table)
+                {
+                    TableEntry entry;
+                    entry.score = scoreToTable(score, plyFromRoot);
+                    entry.depth = depth;
+                    entry.bound = bound;
+                    entry.move = move;
+                    table->store(key, entry);
+                }
+            }
+
+            // 候補手を評価の高い順に並べ、上位 maxCandidates 手に絞る
+            std::vector<ScoredMove> orderedMoves(Stone player)
+            {
+                Stone opponent = opponentOf(player);
+                std::vector<ScoredMove> moves;
+                for (const auto &move : Engine::candidateMoves(board))
+                {
+                    int attack = Engine::scoreMove(board, move.first, move.second, player);
+                    int defense = Engine::scoreMove(board, move.first, move.second, opponent);
+                    moves.push_back({move, 10LL * attack + 9LL * defense, attack});
+                }
+                std::stable_sort(moves.begin(), moves.end(),
+                                 [](const ScoredMove &a, const ScoredMove &b)
+                                 { return a.order > b.order; });
+                if (limits.maxCandidates > 0 && moves.size() > static_cast<size_t>(limits.maxCandidates))
+                {
+                    moves.resize(static_cast<size_t>(limits.maxCandidates));
+                }
+                return moves;
+            }
+
+            // 末端の評価（手番側の最も良い手の形と、相手の最も良い手の形の差。評価器かネットワークがあればその評価）
+            int evaluate(Stone player)
+            {
+                if (evaluator)
+                {
+                    return evaluator->evaluate(board, player);
+                }
+                if (accumulator)
+                {
+                    return accumulator->evaluate(player);
+                }
+
+                Stone opponent = opponentOf(player);
+                int own = 0;
+                int other = 0;
+                for (const auto &move : Engine::candidateMoves(board))
+                {
+                    own = std::max(own, Engine::scoreMove(board, move.first, move.second, player));
+                    other = std::max(other, Engine::scoreMove(board, move.first, move.second, opponent));
+                }
+                // 次に打てるのは手番側なので、相手の脅威は少し割り引く
+                return own - other * 9 / 10;
+            }
+
+            // ネガマックス形式のアルファベータ探索（pv に最善の手順を返す）
+            int negamax(int depth, int alpha, int beta, Stone player, int plyFromRoot,
+                        std::vector<std::pair<int, int>> &pv)
+            {
+                pv.clear();
+                if (++nodes % CANCEL_CHECK_INTERVAL == 0 && token.isCancelled())
+                {
+                    throw SearchAborted();
+                }
+                if (limits.maxNodes > 0 && nodes > limits.maxNodes)
+                {
+                    throw SearchAborted();
+                }
+                if (nodes % TIME_CHECK_INTERVAL == 0 && timer.isHardExpired())
+                {
+                    throw SearchAborted();
+                }
+
+                if (board.isFull())
+                {
+                    return 0;
+                }
+
+                // 置換表に十分な深さの結果があれば読まずに済ませる
+                std::pair<int, int> tableMove{-1, -1};
+                TableEntry entry;
+                if (table && table->probe(key, entry))
+                {
+                    tableMove = entry.move;
+                    if (entry.depth >= depth)
+                    {
+                        int score = scoreFromTable(entry.score, plyFromRoot);
+                        if (entry.bound == BoundType::EXACT ||
+                            (entry.bound == BoundType::LOWER && score >= beta) ||
+                            (entry.bound == BoundType::UPPER && score <= alpha))
+                        {
+                            if (tableMove.first >= 0)
+                            {
+                                pv.push_back(tableMove);
+                            }
+                            return score;
+                        }
+                    }
+                }
+
+                if (depth == 0)
+                {
+                    int score = evaluate(player);
+                    storeEntry(score, 0, BoundType::EXACT, tableMove, plyFromRoot);
+                    return score;
+                }
+
+                auto moves = orderedMoves(player);
+                if (moves.empty())
+                {
+                    return 0;
+                }
+
+                // 五連を作れるなら読むまでもない
+                if (moves.front().attack >= Engine::SCORE_FIVE)
+                {
+                    pv.push_back(moves.front().move);
+                    return Search::SCORE_WIN - plyFromRoot;
+                }
+
+                // 置換表の最善手を先に読む
+                auto previous = std::find_if(moves.begin(), moves.end(),
+                                             [&](const ScoredMove &m)
+                                             { return m.move == tableMove; });
+                if (previous != moves.end())
+                {
+                    std::rotate(moves.begin(), previous, previous + 1);
+                }
+
+                const int originalAlpha = alpha;
+                int best = -Search::SCORE_WIN - 1;
+                std::vector<std::pair<int, int>> childPv;
+                for (const auto &candidate : moves)
+                {
+                    makeMove(candidate.move, player);
+                    int score = -negamax(depth - 1, -beta, -alpha, opponentOf(player), plyFromRoot + 1, childPv);
+                    unmakeMove(candidate.move, player);
+
+                    if (score > best)
+                    {
+                        best = score;
+                        pv.assign(1, candidate.move);
+                        pv.insert(pv.end(), childPv.begin(), childPv.end());
+                    }
+                    alpha = std::max(alpha, score);
+                    if (alpha >= beta)
+                    {
+                        break;
+                    }
+                }
+
+                BoundType bound = (best <= originalAlpha) ? BoundType::UPPER
+                                  : (best >= beta)        ? BoundType::LOWER
+                                                          : BoundType::EXACT;
+                storeEntry(best, depth, bound, pv.front(), plyFromRoot);
+                return best;
+            }
+
+            // ルート局面の探索（前回の最善手を先に読む）
+            SearchResult searchRoot(int depth, Stone player, const std::pair<int, int> &previousBest)
+            {
+                SearchResult result;
+                result.depth = depth;
+
+                auto moves = orderedMoves(player);
+                auto previous = std::find_if(moves.begin(), moves.end(),
+                                             [&](const ScoredMove &m)
+                                             { return m.move == previousBest; });
+                if (previous != moves.end())
+                {
+                    std::rotate(moves.begin(), previous, previous + 1);
+                }
+
+                int alpha = -Search::SCORE_WIN - 1;
+                const int beta = Search::SCORE_WIN + 1;
+                std::vector<std::pair<int, int>> childPv;
+                size_t losing = 0; // 負けと読めた手の数（窓の外の値は上界なので、負けの値なら本当に負け）
+                for (const auto &candidate : moves)
+                {
+                    int score;
+                    if (candidate.attack >= Engine::SCORE_FIVE)
+                    {
+                        score = Search::SCORE_WIN;
+                        childPv.clear();
+                    }
+                    else
+                    {
+                        makeMove(candidate.move, player);
+                        score = -negamax(depth - 1, -beta, -alpha, opponentOf(player), 1, childPv);
+                        unmakeMove(candidate.move, player);
+                    }
+                    if (score <= -Search::SCORE_WIN + 1000)
+                    {
+                        losing++;
+                    }
+
+                    if (score > alpha || result.bestMove.first < 0)
+                    {
+                        alpha = std::max(alpha, score);
+                        result.bestMove = candidate.move;
+                        result.score = score;
+                        result.principalVariation.assign(1, candidate.move);
+                        result.principalVariation.insert(result.principalVariation.end(), childPv.begin(), childPv.end());
+                    }
+                }
+
+                if (result.bestMove.first >= 0)
+                {
+                    storeEntry(result.score, depth, BoundType::EXACT, result.bestMove, 0);
+                }
+                result.forced = moves.size() - losing <= 1;
+                return result;
+            }
+        };
+    }
+
+    SearchResult Search::run(const Board &board, Stone player, const SearchLimits &limits,
+                             const CancellationToken &token, const ProgressCallback &onProgress,
+                             TranspositionTable *table)
+    {
+        GOMOKU_TIMED_SCOPE("search.run");
+        GOMOKU_TRACE_SCOPE("search", "Search::run");
+        if (table && table->getBoardSize() != board.getSize())
+        {
+            throw std::runtime_error("Transposition table was created for a different board size");
+        }
+
+        SearchContext context(board, player, limits, token, table);
+        SearchResult best;
+
+        // 探索できない場合でも打てる手は返す
+        best.bestMove = Engine::chooseMove(board, player);
+        if (best.bestMove.first >= 0)
+        {
+            best.principalVariation.push_back(best.bestMove);
+        }
+
+        for (int depth = 1; depth <= limits.maxDepth; depth++)
+        {
+            GOMOKU_TRACE_SCOPE("search", "search.iteration", "depth", depth);
+            SearchResult result;
+            try
+            {
+                result = context.searchRoot(depth, player, best.bestMove);
+            }
+            catch (const SearchAborted &)
+            {
+                best.nodes = context.nodes;
+                return best;
+            }
+
+            if (result.bestMove.first < 0)
+            {
+                break;
+            }
+            best = result;
+            best.nodes = context.nodes;
+            if (onProgress)
+            {
+                onProgress(best);
+            }
+
+            // 勝ち負けが読み切れたらそれ以上深く読む必要はない
+            if (isWinScore(best.score))
+            {
+                break;
+            }
+
+            // 時間の目安を過ぎたか、他に手がなければ次の深さに進まない
+            if (!context.timer.shouldContinue(best.bestMove, best.forced))
+            {
+                break;
+            }
+        }
+
+        best.nodes = context.nodes;
+        best.completed = !token.isCancelled();
+        return best;
+    }
+
+    bool Search::isWinScore(int score)
+    {
+        return score >= SCORE_WIN - 1000 || score <= -SCORE_WIN + 1000;
+    }
+
+} // namespace GomokuLib
@@ -0,0 +1,253 @@
+#include "GomokuLib/SelfPlay.h"
+#include "GomokuLib/Engine.h"
+#include "GomokuLib/Instrumentation.h"
+#include "GomokuLib/ThreadPool.h"
+#include "GomokuLib/Tracer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <future>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // 再現性のある乱数
+        uint64_t splitMix64(uint64_t &state)
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        Stone opponentOf(Stone player)
+        {
+            return (player == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
+        }
+
+        // ワーカーごとの進み具合（他のワーカーと同じキャッシュラインに載らないようにする）
+        struct alignas(64) WorkerCounters
+        {
+            std::atomic<uint64_t> games{0};
+            std::atomic<uint64_t> samples{0};
+            std::atomic<uint64_t> resumedSamples{0};
+        };
+
+        // 書いているのは自分のワーカーだけなので、読み出して足して書き戻せばよい
+        void add(std::atomic<uint64_t> &counter, uint64_t amount)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        // 1つのシャードの対局を全て打つ
+        void runShard(const SelfPlayOptions &options, uint32_t shardIndex, uint32_t shardCount,
+                      WorkerCounters &counters, const CancellationToken &token)
+        {
+            TrainingShardInfo info;
+            info.boardSize = options.boardSize;
+            info.seed = options.seed;
+            info.shardIndex = shardIndex;
+            info.shardCount = shardCount;
+            TrainingShardWriter writer(SelfPlay::shardPath(options.outputDirectory, shardIndex), info, options.resume);
+            add(counters.resumedSamples, writer.getRecordCount());
+
+            // 書き終えた最後の対局の次から打つ
+            uint64_t first = (writer.getLastGame() >= 0) ? static_cast<uint64_t>(writer.getLastGame()) + shardCount : shardIndex;
+
+            std::vector<TrainingSample> samples;
+            TrainingSample transformed;
+            for (uint64_t game = first; game < options.games; game += shardCount)
+            {
+                if (!SelfPlay::playGame(options, static_cast<uint32_t>(game), samples, token))
+                {
+                    break;
+                }
+
+                for (const auto &sample : samples)
+                {
+                    if (!options.augment)
+                    {
+                        writer.append(sample);
+                        continue;
+                    }
+                    for (int symmetry = 0; symmetry < TrainingData::SYMMETRY_COUNT; symmetry++)
+                    {
+                        TrainingData::applySymmetry(sample, options.boardSize, symmetry, transformed);
+                        writer.append(transformed);
+                    }
+                }
+                add(counters.samples, samples.size() * (options.augment ? TrainingData::SYMMETRY_COUNT : 1));
+                add(counters.games, 1);
+            }
+            writer.sync();
+        }
+
+        SelfPlayStats collect(const std::vector<std::unique_ptr<WorkerCounters>> &counters,
+                              std::chrono::steady_clock::time_point start)
+        {
+            SelfPlayStats stats;
+            for (const auto &worker : counters)
+            {
+                stats.games += worker->games.load(std::memory_order_relaxed);
+                stats.samples += worker->samples.load(std::memory_order_relaxed);
+                stats.resumedSamples += worker->resumedSamples.load(std::memory_order_relaxed);
+            }
+            stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return stats;
+        }
+    }
+
+    uint64_t SelfPlay::gameSeed(uint64_t seed, uint32_t game)
+    {
+        uint64_t state = seed ^ (static_cast<uint64_t>(game) * 0xD1B54A32D192ED03ULL);
+        return splitMix64(state);
+    }
+
+    std::string SelfPlay::shardPath(const std::string &directory, size_t shardIndex)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "shard-%04zu.bin", shardIndex);
+        return (std::filesystem::path(directory) / name).string();
+    }
+
+    bool SelfPlay::playGame(const SelfPlayOptions &options, uint32_t game, std::vector<TrainingSample> &samples,
+                            const CancellationToken &token)
+    {
+        GOMOKU_TIMED_SCOPE("selfplay.game");
+        GOMOKU_TRACE_SCOPE("selfplay", "SelfPlay::playGame", "game", game);
+
+        const int size = options.boardSize;
+        uint64_t state = gameSeed(options.seed, game);
+        Board board(size);
+        Stone player = Stone::BLACK;
+        Stone winner = Stone::EMPTY;
+        samples.clear();
+
+        for (int ply = 0;; ply++)
+        {
+            if (token.isCancelled())
+            {
+                return false;
+            }
+
+            std::pair<int, int> move;
+            if (ply < options.openingPlies)
+            {
+                // 序盤は石の隣から乱数で選んで、対局ごとに違う局面にする
+                auto candidates = Engine::candidateMoves(board, 1);
+                if (candidates.empty())
+                {
+                    break;
+                }
+                move = candidates[splitMix64(state) % candidates.size()];
+            }
+            else
+            {
+                SearchResult result = Search::run(board, player, options.limits);
+                move = result.bestMove;
+                if (move.first < 0)
+                {
+                    break;
+                }
+
+                TrainingSample sample;
+                sample.game = game;
+                sample.ply = ply;
+                sample.sideToMove = player;
+                sample.bestMove = move;
+                sample.score = result.score;
+                sample.cells.resize(static_cast<size_t>(size) * size);
+                for (int r = 0; r < size; r++)
+                {
+                    for (int c = 0; c < size; c++)
+                    {
+                        sample.cells[static_cast<size_t>(r) * size + c] = board.getStone(r, c);
+                    }
+                }
+                samples.push_back(std::move(sample));
+            }
+
+            board.placeStone(move.first, move.second, player);
+            if (board.checkWinAt(move.first, move.second))
+            {
+                winner = player;
+                break;
+            }
+            if (board.isFull())
+            {
+                break;
+            }
+            player = opponentOf(player);
+        }
+
+        // 対局の結果は、終局してから各局面の手番側の立場で書き込む
+        for (auto &sample : samples)
+        {
+            sample.outcome = (winner == Stone::EMPTY) ? 0 : (sample.sideToMove == winner ? 1 : -1);
+        }
+        return true;
+    }
+
+    SelfPlayStats SelfPlay::run(const SelfPlayOptions &options, const CancellationToken &token,
+                                const ProgressCallback &onProgress, double reportInterval)
+    {
+        if (options.games > std::numeric_limits<uint32_t>::max())
+        {
+            throw std::runtime_error("Too many self-play games");
+        }
+
+        size_t shardCount = options.shardCount;
+        if (shardCount == 0)
+        {
+            shardCount = std::max(1u, std::thread::hardware_concurrency());
+        }
+        std::filesystem::create_directories(options.outputDirectory);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::unique_ptr<WorkerCounters>> counters;
+        for (size_t i = 0; i < shardCount; i++)
+        {
+            counters.push_back(std::make_unique<WorkerCounters>());
+        }
+
+        // ワーカーはそれぞれ自分のシャードと書き出し用のバッファを持ち、共有するのは進み具合の数だけ
+        std::vector<std::future<void>> futures;
+        {
+            ThreadPool pool(shardCount);
+            for (size_t shard = 0; shard < shardCount; shard++)
+            {
+                futures.push_back(pool.submit([&options, &counters, &token, shard, shardCount]()
+                                              { runShard(options, static_cast<uint32_t>(shard), static_cast<uint32_t>(shardCount),
+                                                         *counters[shard], token); }));
+            }
+
+            auto interval = std::chrono::duration<double>(reportInterval);
+            for (auto &future : futures)
+            {
+                while (future.wait_for(interval) != std::future_status::ready)
+                {
+                    if (onProgress)
+                    {
+                        onProgress(collect(counters, start));
+                    }
+                }
+            }
+        }
+
+        // ワーカーの例外（書き込みの失敗など）はここで投げ直す
+        for (auto &future : futures)
+        {
+            future.get();
+        }
+        return collect(counters, start);
+    }
+
+} // namespace GomokuLib
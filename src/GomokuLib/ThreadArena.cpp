@@ -0,0 +1,13 @@
+#include "GomokuLib/ThreadArena.h"
+
+namespace GomokuLib
+{
+
+    std::pmr::memory_resource *ThreadArena::get()
+    {
+        // 同じスレッドからしか使わないので、ロックのないプールで十分
+        thread_local std::pmr::unsynchronized_pool_resource arena;
+        return &arena;
+    }
+
+} // namespace GomokuLib
@@ -0,0 +1,172 @@
+#include "GomokuLib/ThreadPool.h"
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // 現在のスレッドが属するプールとワーカー番号
+        thread_local const ThreadPool *currentPool = nullptr;
+        thread_local size_t currentIndex = 0;
+    }
+
+    ThreadPool::ThreadPool(size_t threadCount)
+        : nextQueue(0), pendingTasks(0), stopping(false)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+        if (threadCount == 0)
+        {
+            threadCount = 1;
+        }
+
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            queues.push_back(std::make_unique<WorkQueue>());
+        }
+        for (size_t i = 0; i < threadCount; i++)
+        {
+            workers.emplace_back([this, i]()
+                                 { workerLoop(i); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        waitIdle();
+
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wakeUp.notify_all();
+
+        for (auto &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::post(Task task)
+    {
+        pendingTasks.fetch_add(1, std::memory_order_relaxed);
+
+        // ワーカー自身が投入したタスクは自分のキューへ（キャッシュの局所性を保つ）
+        size_t index;
+        if (currentPool == this)
+        {
+            index = currentIndex;
+        }
+        else
+        {
+            index = nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(queues[index]->mutex);
+            queues[index]->tasks.push_back(std::move(task));
+        }
+
+        // 待機中のワーカーを起こす（通知の取りこぼしを防ぐため sleepMutex を経由する）
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        wakeUp.notify_one();
+    }
+
+    bool ThreadPool::popTask(size_t index, Task &task)
+    {
+        // 自分のキューは末尾から（LIFO）
+        {
+            WorkQueue &own = *queues[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                return true;
+            }
+        }
+
+        // 他のワーカーのキューは先頭から盗む（FIFO）
+        for (size_t i = 1; i < queues.size(); i++)
+        {
+            WorkQueue &victim = *queues[(index + i) % queues.size()];
+            std::unique_lock<std::mutex> lock(victim.mutex, std::try_to_lock);
+            if (lock.owns_lock() && !victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void ThreadPool::workerLoop(size_t index)
+    {
+        currentPool = this;
+        currentIndex = index;
+
+        Task task;
+        while (true)
+        {
+            if (popTask(index, task))
+            {
+                task();
+                task = nullptr;
+
+                // 最後のタスクが終わったら待機中のスレッドに通知
+                if (pendingTasks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                {
+                    std::lock_guard<std::mutex> lock(sleepMutex);
+                    allDone.notify_all();
+                }
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (stopping)
+            {
+                return;
+            }
+
+            // タスクがキューに残っている間は眠らない（try_lock で取り損ねた場合も含む）
+            bool hasQueued = false;
+            for (auto &queue : queues)
+            {
+                std::lock_guard<std::mutex> queueLock(queue->mutex);
+                if (!queue->tasks.empty())
+                {
+                    hasQueued = true;
+                    break;
+                }
+            }
+            if (!hasQueued)
+            {
+                wakeUp.wait(lock);
+            }
+        }
+    }
+
+    void ThreadPool::waitIdle()
+    {
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        allDone.wait(lock, [this]()
+                     { return pendingTasks.load(std::memory_order_acquire) == 0; });
+    }
+
+    size_t ThreadPool::getThreadCount() const
+    {
+        return workers.size();
+    }
+
+    int ThreadPool::currentWorkerIndex() const
+    {
+        return currentPool == this ? static_cast<int>(currentIndex) : -1;
+    }
+
+} // namespace GomokuLib
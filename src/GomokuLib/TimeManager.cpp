@@ -0,0 +1,142 @@
+#include "GomokuLib/TimeManager.h"
+#include "GomokuLib/Game.h"
+#include <algorithm>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // 最善手が変わったときに目安を延ばす倍率と、変わらなかったときに縮める倍率
+        constexpr double UNSTABLE_GROWTH = 1.6;
+        constexpr double STABLE_DECAY = 0.85;
+
+        // 目安に掛ける倍率の範囲
+        constexpr double MIN_SCALE = 0.5;
+        constexpr double MAX_SCALE = static_cast<double>(TimeManager::HARD_RATIO);
+
+        // 次の深さは少なくとも今の深さのこの倍の時間がかかるとみなす
+        constexpr int64_t NEXT_ITERATION_RATIO = 2;
+    }
+
+    TimeBudget TimeManager::allocate(const TimeControl &control, int64_t remainingMs, int boardSize, size_t ply)
+    {
+        TimeBudget budget;
+        if (!control.isTimed())
+        {
+            return budget;
+        }
+
+        // 遅れに備える分を除いた、この先に使える時間（尽きていても最小の時間で指す）
+        int64_t available = remainingMs - control.overheadMs;
+        if (available <= 0)
+        {
+            budget.softMs = 1;
+            budget.hardMs = 1;
+            return budget;
+        }
+
+        // 残りの手数の見込み（序盤ほど多く、盤面の空きを両者で分けた数は超えない）
+        int64_t emptyCells = std::max<int64_t>(1, static_cast<int64_t>(boardSize) * boardSize - static_cast<int64_t>(ply));
+        int64_t movesToGo = std::max(MIN_MOVES_TO_GO, OPENING_MOVES_TO_GO - static_cast<int64_t>(ply / 4));
+        movesToGo = std::min(movesToGo, (emptyCells + 1) / 2);
+
+        // 増分は毎手戻ってくるので、その大部分をこの手に使う
+        budget.softMs = available / movesToGo + control.incrementMs * 3 / 4;
+        if (ply < OPENING_PLIES)
+        {
+            budget.softMs /= 2;
+        }
+        budget.hardMs = std::min({budget.softMs * HARD_RATIO, available / HARD_SHARE + control.incrementMs, available});
+
+        // 1手の上限があれば、遅れに備える分を残してその中に収める
+        if (control.maxMoveMs > 0)
+        {
+            budget.hardMs = std::min(budget.hardMs, control.maxMoveMs - control.overheadMs);
+        }
+
+        budget.hardMs = std::max<int64_t>(1, budget.hardMs);
+        budget.softMs = std::clamp<int64_t>(budget.softMs, 1, budget.hardMs);
+        return budget;
+    }
+
+    TimeBudget TimeManager::allocate(const Game &game, TimePoint now)
+    {
+        const GameClock &clock = game.getClock();
+        if (!clock.isTimed())
+        {
+            return TimeBudget();
+        }
+
+        // 手番側の時計が動いていれば、この手に既に使った時間を1手の上限から除く
+        Stone player = game.getCurrentPlayer();
+        TimeControl control = clock.getControl();
+        if (control.maxMoveMs > 0 && clock.getRunning() == player)
+        {
+            control.maxMoveMs = std::max<int64_t>(1, control.maxMoveMs - clock.getElapsed(now));
+        }
+        return allocate(control, clock.getRemaining(player, now), game.getBoard().getSize(), game.getPly());
+    }
+
+    TimeManager::TimeManager(const TimeBudget &budget, TimePoint start)
+        : budget(budget), startTime(start), hardDeadline(start + std::chrono::milliseconds(budget.hardMs)),
+          previousBest(-1, -1), scale(1.0), lastIterationEnd(0)
+    {
+    }
+
+    const TimeBudget &TimeManager::getBudget() const
+    {
+        return budget;
+    }
+
+    bool TimeManager::isLimited() const
+    {
+        return budget.isLimited();
+    }
+
+    bool TimeManager::shouldContinue(const std::pair<int, int> &bestMove, bool forced, TimePoint now)
+    {
+        if (!isLimited())
+        {
+            return true;
+        }
+        if (forced)
+        {
+            return false;
+        }
+
+        int64_t elapsed = getElapsed(now);
+        int64_t iteration = elapsed - lastIterationEnd;
+        lastIterationEnd = elapsed;
+
+        // 最善手が変わるうちは迷っているので長く読み、変わらなければ早めに切り上げる
+        if (previousBest.first >= 0 && bestMove != previousBest)
+        {
+            scale = std::min(MAX_SCALE, scale * UNSTABLE_GROWTH);
+        }
+        else if (previousBest.first >= 0)
+        {
+            scale = std::max(MIN_SCALE, scale * STABLE_DECAY);
+        }
+        previousBest = bestMove;
+
+        if (elapsed >= getSoftLimit())
+        {
+            return false;
+        }
+
+        // 上限までに次の深さを読み終えられそうになければ始めない
+        return elapsed + iteration * NEXT_ITERATION_RATIO <= budget.hardMs;
+    }
+
+    int64_t TimeManager::getSoftLimit() const
+    {
+        return std::min(budget.hardMs, static_cast<int64_t>(static_cast<double>(budget.softMs) * scale));
+    }
+
+    int64_t TimeManager::getElapsed(TimePoint now) const
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(now - startTime).count();
+    }
+
+} // namespace GomokuLib
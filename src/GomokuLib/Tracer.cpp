@@ -0,0 +1,219 @@
+#include "GomokuLib/Tracer.h"
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace GomokuLib
+{
+
+    std::atomic<bool> Tracer::enabled(false);
+    std::atomic<int64_t> Tracer::epoch(0);
+
+    namespace
+    {
+        // 書き出しの間隔
+        constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(100);
+
+        // 全スレッドのバッファと書き出し先
+        struct TraceState
+        {
+            std::mutex mutex; // buffers と書き出し先を守る
+            std::vector<std::shared_ptr<Tracer::ThreadBuffer>> buffers;
+            uint32_t nextThreadId = 1;
+            uint64_t retiredDropped = 0; // 終了したスレッドのバッファで捨てた区間
+            uint64_t droppedAtStart = 0;
+
+            std::ofstream file;
+            bool firstEvent = true;
+            uint64_t written = 0;
+
+            std::thread flusher;
+            std::mutex flusherMutex;
+            std::condition_variable flusherWake;
+            bool stopRequested = false;
+        };
+
+        // スレッドの終了時にも使うので、破棄しない
+        TraceState &state()
+        {
+            static TraceState *instance = new TraceState();
+            return *instance;
+        }
+
+        uint64_t droppedLocked(const TraceState &s)
+        {
+            uint64_t total = s.retiredDropped;
+            for (const auto &buffer : s.buffers)
+            {
+                total += buffer->getDropped();
+            }
+            return total;
+        }
+
+        void writeEvent(TraceState &s, uint32_t threadId, const TraceEvent &event)
+        {
+            // Chrome のトレース形式の時間はマイクロ秒
+            char line[512];
+            int length = std::snprintf(line, sizeof(line),
+                                       "%s\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u",
+                                       s.firstEvent ? "" : ",", event.name, event.category,
+                                       event.start / 1000.0, event.duration / 1000.0, threadId);
+            if (length > 0 && static_cast<size_t>(length) < sizeof(line) && event.argName)
+            {
+                length += std::snprintf(line + length, sizeof(line) - length, ",\"args\":{\"%s\":%lld}",
+                                        event.argName, static_cast<long long>(event.argValue));
+            }
+            if (length <= 0 || static_cast<size_t>(length) >= sizeof(line) - 1)
+            {
+                return;
+            }
+            line[length++] = '}';
+            s.file.write(line, length);
+            s.firstEvent = false;
+            s.written++;
+        }
+
+        // 全てのバッファの区間を書き出し、終了したスレッドのバッファを捨てる（mutex を持って呼ぶ）
+        void drainLocked(TraceState &s, bool write)
+        {
+            for (size_t i = 0; i < s.buffers.size();)
+            {
+                auto &buffer = s.buffers[i];
+                uint32_t threadId = buffer->getThreadId();
+                buffer->drain([&](const TraceEvent &event)
+                              {
+                                  if (write)
+                                      writeEvent(s, threadId, event);
+                              });
+
+                // 持ち主のスレッドが終了していれば、もう書き込まれることはない
+                if (buffer.use_count() == 1)
+                {
+                    s.retiredDropped += buffer->getDropped();
+                    s.buffers.erase(s.buffers.begin() + i);
+                    continue;
+                }
+                i++;
+            }
+            if (write)
+            {
+                s.file.flush();
+            }
+        }
+
+        void flushLoop()
+        {
+            TraceState &s = state();
+            std::unique_lock<std::mutex> wait(s.flusherMutex);
+            while (!s.stopRequested)
+            {
+                s.flusherWake.wait_for(wait, FLUSH_INTERVAL);
+                std::lock_guard<std::mutex> lock(s.mutex);
+                drainLocked(s, true);
+            }
+        }
+    }
+
+    // スレッドが終了したらバッファを手放す（残っている区間は書き出し側が読んでから捨てる）
+    struct Tracer::BufferOwner
+    {
+        std::shared_ptr<ThreadBuffer> buffer;
+
+        ~BufferOwner()
+        {
+            // 書き出し側は use_count でスレッドの終了を判断する
+            current = nullptr;
+            TraceState &s = state();
+            std::lock_guard<std::mutex> lock(s.mutex);
+            buffer.reset();
+        }
+    };
+
+    Tracer::ThreadBuffer::ThreadBuffer(uint32_t threadId)
+        : head(0), tail(0), dropped(0), threadId(threadId)
+    {
+    }
+
+    Tracer::ThreadBuffer &Tracer::registerThread()
+    {
+        thread_local BufferOwner owner;
+        TraceState &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        owner.buffer = std::make_shared<ThreadBuffer>(s.nextThreadId++);
+        s.buffers.push_back(owner.buffer);
+        current = owner.buffer.get();
+        return *owner.buffer;
+    }
+
+    void Tracer::start(const std::string &filepath)
+    {
+        stop();
+
+        TraceState &s = state();
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.file.open(filepath, std::ios::out | std::ios::trunc);
+            if (!s.file.is_open())
+            {
+                throw std::runtime_error("Failed to open trace file: " + filepath);
+            }
+            s.file << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+            // 前回の記録の後に残った区間は捨てる
+            drainLocked(s, false);
+            s.firstEvent = true;
+            s.written = 0;
+            s.droppedAtStart = droppedLocked(s);
+            s.stopRequested = false;
+
+            epoch.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch())
+                            .count(),
+                        std::memory_order_relaxed);
+        }
+        s.flusher = std::thread(flushLoop);
+        enabled.store(true, std::memory_order_relaxed);
+    }
+
+    void Tracer::stop()
+    {
+        TraceState &s = state();
+        if (!s.flusher.joinable())
+        {
+            return;
+        }
+
+        enabled.store(false, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> wait(s.flusherMutex);
+            s.stopRequested = true;
+        }
+        s.flusherWake.notify_one();
+        s.flusher.join();
+
+        std::lock_guard<std::mutex> lock(s.mutex);
+        drainLocked(s, true);
+        s.file << "\n]}\n";
+        s.file.close();
+    }
+
+    uint64_t Tracer::getWrittenCount()
+    {
+        TraceState &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.written;
+    }
+
+    uint64_t Tracer::getDroppedCount()
+    {
+        TraceState &s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return droppedLocked(s) - s.droppedAtStart;
+    }
+
+} // namespace GomokuLib
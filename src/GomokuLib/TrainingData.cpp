@@ -0,0 +1,379 @@
+#include "GomokuLib/TrainingData.h"
+#include "DispatchTable.h"
+#include "GomokuLib/BoardScan.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace GomokuLib
+{
+
+    constexpr char TrainingData::MAGIC[8];
+
+    namespace
+    {
+        constexpr uint32_t FORMAT_VERSION = 1;
+
+        // レコードの先頭のフィールド（局面のビット列はその後ろ）
+        constexpr size_t RECORD_FIXED_SIZE = 16;
+        constexpr uint8_t NO_MOVE = 0xFF;
+
+        template <typename T>
+        void store(uint8_t *destination, T value)
+        {
+            std::memcpy(destination, &value, sizeof(T));
+        }
+
+        template <typename T>
+        T load(const uint8_t *source)
+        {
+            T value;
+            std::memcpy(&value, source, sizeof(T));
+            return value;
+        }
+
+        size_t bitmapBytes(int boardSize)
+        {
+            return (static_cast<size_t>(boardSize) * boardSize + 7) / 8;
+        }
+
+        bool isSupportedSize(int boardSize)
+        {
+            return boardSize >= 5 && boardSize <= BoardScan::MAX_PACKED_SIZE;
+        }
+
+        bool sameInfo(const TrainingShardInfo &a, const TrainingShardInfo &b)
+        {
+            return a.boardSize == b.boardSize && a.seed == b.seed && a.shardIndex == b.shardIndex &&
+                   a.shardCount == b.shardCount;
+        }
+    }
+
+    size_t TrainingData::recordSize(int boardSize)
+    {
+        return RECORD_FIXED_SIZE + 2 * bitmapBytes(boardSize);
+    }
+
+    std::pair<int, int> TrainingData::transform(int row, int col, int boardSize, int symmetry)
+    {
+        // 4 のビットで対角線について裏返し、残りの2ビットの回数だけ 90 度回す
+        if (symmetry & 4)
+        {
+            std::swap(row, col);
+        }
+        for (int i = 0; i < (symmetry & 3); i++)
+        {
+            int rotated = col;
+            col = boardSize - 1 - row;
+            row = rotated;
+        }
+        return {row, col};
+    }
+
+    void TrainingData::applySymmetry(const TrainingSample &sample, int boardSize, int symmetry, TrainingSample &out)
+    {
+        out.game = sample.game;
+        out.ply = sample.ply;
+        out.symmetry = symmetry;
+        out.sideToMove = sample.sideToMove;
+        out.outcome = sample.outcome;
+        out.score = sample.score;
+        out.bestMove = sample.bestMove;
+        if (sample.bestMove.first >= 0)
+        {
+            out.bestMove = transform(sample.bestMove.first, sample.bestMove.second, boardSize, symmetry);
+        }
+
+        // 変換は符号付きの置換行列なので、逆変換はその転置になる
+        // 出力のマス (r, c) の元のマスは rowStart + r * rowStep + c * colStep
+        auto origin = transform(0, 0, boardSize, symmetry);
+        auto down = transform(1, 0, boardSize, symmetry);
+        auto right = transform(0, 1, boardSize, symmetry);
+        int rowStep = (down.first - origin.first) * boardSize + (right.first - origin.first);
+        int colStep = (down.second - origin.second) * boardSize + (right.second - origin.second);
+        int rowStart = -(rowStep * origin.first + colStep * origin.second);
+
+        out.cells.resize(sample.cells.size());
+        activeDispatch().transformCells(sample.cells.data(), out.cells.data(), boardSize, rowStart, rowStep, colStep);
+    }
+
+    void TrainingData::encode(const TrainingSample &sample, int boardSize, uint8_t *record)
+    {
+        store<uint32_t>(record, sample.game);
+        store<uint16_t>(record + 4, static_cast<uint16_t>(sample.ply));
+        record[6] = static_cast<uint8_t>(sample.symmetry);
+        record[7] = static_cast<uint8_t>(sample.sideToMove);
+        record[8] = static_cast<uint8_t>(static_cast<int8_t>(sample.outcome));
+        record[9] = sample.bestMove.first < 0 ? NO_MOVE : static_cast<uint8_t>(sample.bestMove.first);
+        record[10] = sample.bestMove.first < 0 ? NO_MOVE : static_cast<uint8_t>(sample.bestMove.second);
+        record[11] = 0;
+        store<int32_t>(record + 12, sample.score);
+
+        size_t bytes = bitmapBytes(boardSize);
+        uint8_t *black = record + RECORD_FIXED_SIZE;
+        uint8_t *white = black + bytes;
+        std::memset(black, 0, 2 * bytes);
+        for (size_t i = 0; i < sample.cells.size(); i++)
+        {
+            if (sample.cells[i] == Stone::BLACK)
+                black[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+            else if (sample.cells[i] == Stone::WHITE)
+                white[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+        }
+    }
+
+    void TrainingData::decode(const uint8_t *record, int boardSize, TrainingSample &out)
+    {
+        out.game = load<uint32_t>(record);
+        out.ply = load<uint16_t>(record + 4);
+        out.symmetry = record[6];
+        out.sideToMove = static_cast<Stone>(record[7]);
+        out.outcome = static_cast<int8_t>(record[8]);
+        out.bestMove = {-1, -1};
+        if (record[9] != NO_MOVE)
+        {
+            out.bestMove = {record[9], record[10]};
+        }
+        out.score = load<int32_t>(record + 12);
+
+        size_t bytes = bitmapBytes(boardSize);
+        const uint8_t *black = record + RECORD_FIXED_SIZE;
+        const uint8_t *white = black + bytes;
+        out.cells.assign(static_cast<size_t>(boardSize) * boardSize, Stone::EMPTY);
+        for (size_t i = 0; i < out.cells.size(); i++)
+        {
+            if (black[i / 8] & (1u << (i % 8)))
+                out.cells[i] = Stone::BLACK;
+            else if (white[i / 8] & (1u << (i % 8)))
+                out.cells[i] = Stone::WHITE;
+        }
+    }
+
+    void TrainingData::encodeHeader(const TrainingShardInfo &info, uint8_t *header)
+    {
+        std::memset(header, 0, HEADER_SIZE);
+        std::memcpy(header, MAGIC, sizeof(MAGIC));
+        store<uint32_t>(header + 8, FORMAT_VERSION);
+        store<uint32_t>(header + 12, static_cast<uint32_t>(info.boardSize));
+        store<uint32_t>(header + 16, static_cast<uint32_t>(recordSize(info.boardSize)));
+        store<uint32_t>(header + 20, info.shardIndex);
+        store<uint32_t>(header + 24, info.shardCount);
+        store<uint64_t>(header + 32, info.seed);
+    }
+
+    TrainingShardInfo TrainingData::decodeHeader(const uint8_t *header, size_t size)
+    {
+        if (size < HEADER_SIZE || std::memcmp(header, MAGIC, sizeof(MAGIC)) != 0)
+        {
+            throw std::runtime_error("Not a training data shard");
+        }
+        if (load<uint32_t>(header + 8) != FORMAT_VERSION)
+        {
+            throw std::runtime_error("Unsupported training data version");
+        }
+
+        TrainingShardInfo info;
+        info.boardSize = static_cast<int>(load<uint32_t>(header + 12));
+        info.shardIndex = load<uint32_t>(header + 20);
+        info.shardCount = load<uint32_t>(header + 24);
+        info.seed = load<uint64_t>(header + 32);
+        if (!isSupportedSize(info.boardSize) || load<uint32_t>(header + 16) != recordSize(info.boardSize) ||
+            info.shardIndex >= info.shardCount)
+        {
+            throw std::runtime_error("Corrupted training data header");
+        }
+        return info;
+    }
+
+    TrainingShardWriter::TrainingShardWriter(const std::string &filepath, const TrainingShardInfo &info, bool resume,
+                                             size_t bufferBytes)
+        : fd(-1), info(info), recordBytes(0), buffered(0), recordCount(0), lastGame(-1), filepath(filepath)
+    {
+        if (!isSupportedSize(info.boardSize) || info.shardIndex >= info.shardCount)
+        {
+            throw std::runtime_error("Invalid training shard settings for " + filepath);
+        }
+        recordBytes = TrainingData::recordSize(info.boardSize);
+        buffer.resize(std::max(bufferBytes, recordBytes));
+
+        fd = ::open(filepath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | (resume ? 0 : O_TRUNC), 0644);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Failed to open file for writing: " + filepath);
+        }
+
+        try
+        {
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+            {
+                throw std::runtime_error("Failed to stat file: " + filepath);
+            }
+
+            uint8_t header[TrainingData::HEADER_SIZE];
+            size_t existing = static_cast<size_t>(st.st_size);
+            if (existing >= TrainingData::HEADER_SIZE)
+            {
+                // 続きから書くシャードは、同じ条件で作ったものに限る
+                if (::pread(fd, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+                    !sameInfo(TrainingData::decodeHeader(header, sizeof(header)), info))
+                {
+                    throw std::runtime_error("Existing shard was created with different settings: " + filepath);
+                }
+                recordCount = (existing - TrainingData::HEADER_SIZE) / recordBytes;
+                truncateLastGame();
+            }
+            else
+            {
+                // ヘッダーを書く前に止まったファイルは空として扱う
+                TrainingData::encodeHeader(info, header);
+                if (::ftruncate(fd, 0) != 0 || ::pwrite(fd, header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+                {
+                    throw std::runtime_error("Failed to write training shard header: " + filepath);
+                }
+            }
+
+            if (::lseek(fd, static_cast<off_t>(TrainingData::HEADER_SIZE + recordCount * recordBytes), SEEK_SET) < 0)
+            {
+                throw std::runtime_error("Failed to seek in training shard: " + filepath);
+            }
+        }
+        catch (...)
+        {
+            ::close(fd);
+            throw;
+        }
+    }
+
+    TrainingShardWriter::~TrainingShardWriter()
+    {
+        try
+        {
+            flush();
+        }
+        catch (...)
+        {
+            // デストラクタからは例外を投げない（書き出せなかったレコードは再開時に作り直す）
+        }
+        ::close(fd);
+    }
+
+    void TrainingShardWriter::truncateLastGame()
+    {
+        auto gameAt = [this](uint64_t index)
+        {
+            uint32_t game = 0;
+            off_t offset = static_cast<off_t>(TrainingData::HEADER_SIZE + index * recordBytes);
+            if (::pread(fd, &game, sizeof(game), offset) != static_cast<ssize_t>(sizeof(game)))
+            {
+                throw std::runtime_error("Failed to read training shard: " + filepath);
+            }
+            return game;
+        };
+
+        // 1つの対局のレコードは続けて並ぶので、最後の対局の先頭まで戻る
+        if (recordCount > 0)
+        {
+            uint32_t last = gameAt(recordCount - 1);
+            while (recordCount > 0 && gameAt(recordCount - 1) == last)
+            {
+                recordCount--;
+            }
+        }
+        lastGame = (recordCount > 0) ? static_cast<int64_t>(gameAt(recordCount - 1)) : -1;
+
+        // 書きかけのレコードもここで取り除かれる
+        if (::ftruncate(fd, static_cast<off_t>(TrainingData::HEADER_SIZE + recordCount * recordBytes)) != 0)
+        {
+            throw std::runtime_error("Failed to truncate training shard: " + filepath);
+        }
+    }
+
+    void TrainingShardWriter::append(const TrainingSample &sample)
+    {
+        if (buffered + recordBytes > buffer.size())
+        {
+            flush();
+        }
+        TrainingData::encode(sample, info.boardSize, buffer.data() + buffered);
+        buffered += recordBytes;
+        recordCount++;
+        lastGame = sample.game;
+    }
+
+    void TrainingShardWriter::flush()
+    {
+        size_t written = 0;
+        while (written < buffered)
+        {
+            ssize_t n = ::write(fd, buffer.data() + written, buffered - written);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n <= 0)
+            {
+                throw std::runtime_error("Failed to write training shard: " + filepath);
+            }
+            written += static_cast<size_t>(n);
+        }
+        buffered = 0;
+    }
+
+    void TrainingShardWriter::sync()
+    {
+        flush();
+        if (::fdatasync(fd) != 0)
+        {
+            throw std::runtime_error("Failed to sync training shard: " + filepath);
+        }
+    }
+
+    uint64_t TrainingShardWriter::getRecordCount() const
+    {
+        return recordCount;
+    }
+
+    int64_t TrainingShardWriter::getLastGame() const
+    {
+        return lastGame;
+    }
+
+    size_t TrainingShardWriter::getBufferedBytes() const
+    {
+        return buffered;
+    }
+
+    TrainingShardReader::TrainingShardReader(const std::string &filepath) : file(filepath), recordBytes(0), recordCount(0)
+    {
+        auto contents = file.getContents();
+        info = TrainingData::decodeHeader(reinterpret_cast<const uint8_t *>(contents.data()), contents.size());
+        recordBytes = TrainingData::recordSize(info.boardSize);
+        recordCount = (contents.size() - TrainingData::HEADER_SIZE) / recordBytes;
+    }
+
+    const TrainingShardInfo &TrainingShardReader::getInfo() const
+    {
+        return info;
+    }
+
+    uint64_t TrainingShardReader::getRecordCount() const
+    {
+        return recordCount;
+    }
+
+    void TrainingShardReader::read(uint64_t index, TrainingSample &out) const
+    {
+        if (index >= recordCount)
+        {
+            throw std::runtime_error("Training record index out of range");
+        }
+        const auto *records = reinterpret_cast<const uint8_t *>(file.getContents().data()) + TrainingData::HEADER_SIZE;
+        TrainingData::decode(records + index * recordBytes, info.boardSize, out);
+    }
+
+} // namespace GomokuLib
@@ -0,0 +1,161 @@
+#include "GomokuLib/TranspositionTable.h"
+#include "DispatchTable.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace GomokuLib
+{
+
+    namespace
+    {
+        // データの詰め方: 評価値 32 ビット | 深さ 8 ビット | 種類 2 ビット | 着手 22 ビット
+        constexpr int DEPTH_SHIFT = 32;
+        constexpr int BOUND_SHIFT = 40;
+        constexpr int MOVE_SHIFT = 42;
+        constexpr uint64_t MOVE_MASK = (uint64_t(1) << 22) - 1;
+
+        // 再現性のある乱数（同じ盤面サイズなら常に同じハッシュになる）
+        uint64_t splitMix64(uint64_t &state)
+        {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+    }
+
+    TranspositionTable::TranspositionTable(int boardSize, size_t entryCount)
+        : boardSize(boardSize), sideKey(0), mask(0)
+    {
+        // 着手は (行 * サイズ + 列 + 1) を 22 ビットに詰める
+        if (boardSize <= 0 || static_cast<uint64_t>(boardSize) * boardSize >= MOVE_MASK)
+        {
+            throw std::runtime_error("Unsupported board size for transposition table");
+        }
+
+        uint64_t seed = 0x5EED0000ULL + static_cast<uint64_t>(boardSize);
+        stoneKeys.resize(static_cast<size_t>(boardSize) * boardSize * 2);
+        for (auto &key : stoneKeys)
+        {
+            key = splitMix64(seed);
+        }
+        sideKey = splitMix64(seed);
+
+        size_t capacity = 1;
+        while (capacity < entryCount)
+        {
+            capacity <<= 1;
+        }
+        slots = std::make_unique<Slot[]>(capacity);
+        mask = capacity - 1;
+    }
+
+    int TranspositionTable::getBoardSize() const
+    {
+        return boardSize;
+    }
+
+    size_t TranspositionTable::getCapacity() const
+    {
+        return mask + 1;
+    }
+
+    uint64_t TranspositionTable::hash(const Board &board, Stone player) const
+    {
+        uint64_t key = (player == Stone::WHITE) ? sideKey : 0;
+
+        // 行のビット列がある盤面は、立っているビットだけをたどる
+        const uint64_t *black = board.getPackedRows(Stone::BLACK);
+        if (black)
+        {
+            return key ^ activeDispatch().hashStones(black, board.getPackedRows(Stone::WHITE), boardSize, stoneKeys.data());
+        }
+
+        for (int r = 0; r < boardSize; r++)
+        {
+            for (int c = 0; c < boardSize; c++)
+            {
+                Stone stone = board.getStone(r, c);
+                if (stone == Stone::BLACK || stone == Stone::WHITE)
+                {
+                    key ^= stoneKey(r, c, stone);
+                }
+            }
+        }
+        return key;
+    }
+
+    uint64_t TranspositionTable::stoneKey(int row, int col, Stone stone) const
+    {
+        size_t cell = static_cast<size_t>(row) * boardSize + col;
+        return stoneKeys[cell * 2 + (stone == Stone::WHITE ? 1 : 0)];
+    }
+
+    uint64_t TranspositionTable::sideToMoveKey() const
+    {
+        return sideKey;
+    }
+
+    bool TranspositionTable::probe(uint64_t key, TableEntry &entry) const
+    {
+        const Slot &slot = slots[key & mask];
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+        // 別の局面か、他のスレッドが書き込み途中のエントリ
+        if ((check ^ data) != key || data == 0)
+        {
+            return false;
+        }
+
+        entry.score = static_cast<int32_t>(static_cast<uint32_t>(data));
+        entry.depth = static_cast<int>((data >> DEPTH_SHIFT) & 0xFF);
+        entry.bound = static_cast<BoundType>((data >> BOUND_SHIFT) & 0x3);
+        uint64_t move = (data >> MOVE_SHIFT) & MOVE_MASK;
+        if (move == 0)
+        {
+            entry.move = {-1, -1};
+        }
+        else
+        {
+            entry.move = {static_cast<int>((move - 1) / boardSize), static_cast<int>((move - 1) % boardSize)};
+        }
+        return entry.bound != BoundType::NONE;
+    }
+
+    void TranspositionTable::store(uint64_t key, const TableEntry &entry)
+    {
+        Slot &slot = slots[key & mask];
+
+        // 同じ局面をより浅く読んだ結果では上書きしない
+        uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+        uint64_t oldCheck = slot.check.load(std::memory_order_relaxed);
+        if ((oldCheck ^ oldData) == key && static_cast<int>((oldData >> DEPTH_SHIFT) & 0xFF) > entry.depth)
+        {
+            return;
+        }
+
+        uint64_t move = 0;
+        if (entry.move.first >= 0)
+        {
+            move = static_cast<uint64_t>(entry.move.first) * boardSize + entry.move.second + 1;
+        }
+        uint64_t data = static_cast<uint64_t>(static_cast<uint32_t>(entry.score)) |
+                        (static_cast<uint64_t>(std::min(std::max(entry.depth, 0), 255)) << DEPTH_SHIFT) |
+                        (static_cast<uint64_t>(entry.bound) << BOUND_SHIFT) |
+                        (move << MOVE_SHIFT);
+
+        slot.check.store(key ^ data, std::memory_order_relaxed);
+        slot.data.store(data, std::memory_order_relaxed);
+    }
+
+    void TranspositionTable::clear()
+    {
+        for (size_t i = 0; i <= mask; i++)
+        {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data.store(0, std::memory_order_relaxed);
+        }
+    }
+
+} // namespace GomokuLib
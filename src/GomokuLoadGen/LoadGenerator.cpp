@@ -0,0 +1,553 @@
+#include "GomokuLoadGen/LoadGenerator.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    // 1回の epoll_wait で受け取るイベント数
+    constexpr int MAX_EVENTS = 256;
+
+    // 単調増加の現在時刻（ナノ秒）
+    uint64_t nowNanoseconds()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    // ナノ秒をマイクロ秒の文字列に変換
+    std::string formatMicros(uint64_t nanoseconds)
+    {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << nanoseconds / 1000.0 << "us";
+        return oss.str();
+    }
+
+    // 1接続分のクライアントの状態
+    struct Client
+    {
+        int fd;
+        std::string input;          // 未処理の受信データ
+        LoadCommand pending;        // 応答待ちのコマンド
+        uint64_t sentAt;            // コマンドを送った時刻
+        std::vector<int> cells;     // 着手順に並べたマス（先頭 played 個が着手済み）
+        size_t played;              // 着手済みの数
+        std::mt19937_64 rng;        // クライアントごとの乱数
+    };
+
+    // 1接続分の観戦者の状態
+    struct Watcher
+    {
+        int fd;
+        std::string input;     // 未処理の受信データ
+        uint64_t lastSequence; // 最後に受け取った変更の番号
+        bool synced;           // 盤面全体を受け取ったか（それまでの差分は使えない）
+        bool counted;          // 最初の盤面全体を受け取って subscribedWatchers に数えたか
+    };
+
+    std::atomic<uint64_t> totalCommands(0);
+    std::atomic<uint64_t> totalErrors(0);
+    std::atomic<uint64_t> totalGames(0);
+
+    // 観戦の集計
+    std::atomic<uint64_t> totalDeltas(0);       // 受け取った差分の行数
+    std::atomic<uint64_t> totalSnapshots(0);    // 受け取った盤面全体の数
+    std::atomic<uint64_t> totalGaps(0);         // 番号が飛んだ回数（resync で盤面全体を取り直す）
+    std::atomic<uint64_t> totalBytes(0);        // 観戦者が受け取ったバイト数
+    std::atomic<uint64_t> subscribedWatchers(0); // 観戦を始めた接続の数
+
+    // 対局者が作ったセッション（観戦者が割り当てる）
+    std::mutex sessionMutex;
+    std::vector<uint64_t> sessionIds;
+
+    // 応答から "<key>=<数値>" を取り出す（なければ 0）
+    uint64_t parseField(const std::string &reply, const std::string &key)
+    {
+        size_t pos = reply.find(key + "=");
+        return pos == std::string::npos ? 0 : std::strtoull(reply.c_str() + pos + key.size() + 1, nullptr, 10);
+    }
+}
+
+LoadGenerator::LoadGenerator(const LoadConfig &config) : config(config)
+{
+    for (auto &histogram : latency)
+    {
+        histogram = std::make_unique<GomokuLib::LatencyHistogram>();
+    }
+}
+
+int LoadGenerator::connectToServer() const
+{
+    int fd;
+    if (!config.unixPath.empty())
+    {
+        fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, config.unixPath.c_str(), sizeof(addr.sun_path) - 1);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            return -1;
+        }
+    }
+    else
+    {
+        fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(config.port));
+        ::inet_pton(AF_INET, config.host.c_str(), &addr.sin_addr);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+            return -1;
+        }
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+std::string LoadGenerator::queryServer(const std::string &line) const
+{
+    int fd = connectToServer();
+    if (fd < 0)
+    {
+        return "";
+    }
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+
+    std::string reply;
+    std::string request = line + "\n";
+    if (::send(fd, request.data(), request.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(request.size()))
+    {
+        char buffer[4096];
+        while (reply.find('\n') == std::string::npos)
+        {
+            ssize_t n = ::read(fd, buffer, sizeof(buffer));
+            if (n <= 0)
+            {
+                break;
+            }
+            reply.append(buffer, static_cast<size_t>(n));
+        }
+    }
+    ::close(fd);
+    return reply.substr(0, reply.find('\n'));
+}
+
+void LoadGenerator::runWorker(size_t workerIndex, size_t connectionCount, uint64_t seed, uint64_t deadline)
+{
+    std::array<GomokuLib::LatencyHistogram, static_cast<size_t>(LoadCommand::COUNT)> local;
+    std::vector<Client> clients(connectionCount);
+    int epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+
+    // コマンドを送信（応答は1行なので送信バッファが溢れることはない）
+    auto send = [&](Client &client, LoadCommand command, const std::string &line)
+    {
+        client.pending = command;
+        client.sentAt = nowNanoseconds();
+        ssize_t n = ::send(client.fd, line.data(), line.size(), MSG_NOSIGNAL);
+        if (n != static_cast<ssize_t>(line.size()))
+        {
+            totalErrors++;
+        }
+    };
+
+    auto startGame = [&](Client &client)
+    {
+        std::shuffle(client.cells.begin(), client.cells.end(), client.rng);
+        client.played = 0;
+        send(client, LoadCommand::START, "start " + std::to_string(config.boardSize) + "\n");
+    };
+
+    // 直前の応答に続くコマンドを選んで送る
+    auto sendNext = [&](Client &client)
+    {
+        int roll = static_cast<int>(client.rng() % 100);
+        if (client.played > 0 && roll < config.undoPercent)
+        {
+            client.played--;
+            send(client, LoadCommand::UNDO, "undo\n");
+        }
+        else if (roll < config.undoPercent + config.movesPercent)
+        {
+            send(client, LoadCommand::MOVES, "moves\n");
+        }
+        else if (client.played < client.cells.size())
+        {
+            int cell = client.cells[client.played++];
+            send(client, LoadCommand::PLACE,
+                 "place " + std::to_string(cell / config.boardSize) + " " + std::to_string(cell % config.boardSize) + "\n");
+        }
+        else
+        {
+            startGame(client);
+        }
+    };
+
+    for (size_t i = 0; i < connectionCount; i++)
+    {
+        Client &client = clients[i];
+        client.fd = connectToServer();
+        if (client.fd < 0)
+        {
+            std::cerr << "Error: Failed to connect client " << i << " of worker " << workerIndex << std::endl;
+            totalErrors++;
+            continue;
+        }
+        client.cells.resize(static_cast<size_t>(config.boardSize) * config.boardSize);
+        std::iota(client.cells.begin(), client.cells.end(), 0);
+        client.rng.seed(seed + i);
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = &client;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &ev);
+        startGame(client);
+    }
+
+    epoll_event events[MAX_EVENTS];
+    char buffer[16384];
+
+    while (nowNanoseconds() < deadline)
+    {
+        int count = ::epoll_wait(epollFd, events, MAX_EVENTS, 100);
+        for (int e = 0; e < count; e++)
+        {
+            Client &client = *static_cast<Client *>(events[e].data.ptr);
+            ssize_t n = ::read(client.fd, buffer, sizeof(buffer));
+            if (n <= 0)
+            {
+                if (n == 0)
+                {
+                    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, client.fd, nullptr);
+                    totalErrors++;
+                }
+                continue;
+            }
+            client.input.append(buffer, static_cast<size_t>(n));
+
+            size_t end = client.input.find('\n');
+            if (end == std::string::npos)
+            {
+                continue;
+            }
+            std::string reply = client.input.substr(0, end);
+            client.input.erase(0, end + 1);
+
+            local[static_cast<size_t>(client.pending)].record(nowNanoseconds() - client.sentAt);
+            totalCommands.fetch_add(1, std::memory_order_relaxed);
+
+            bool ok = reply.compare(0, 2, "OK") == 0;
+            if (!ok)
+            {
+                totalErrors++;
+            }
+
+            if (client.pending == LoadCommand::START && ok && config.watchers > 0)
+            {
+                std::lock_guard<std::mutex> lock(sessionMutex);
+                sessionIds.push_back(std::strtoull(reply.c_str() + 3, nullptr, 10));
+            }
+
+            // 終局または失敗したら新しい対局を始める（観戦されているセッションは一手戻して続ける）
+            if (client.pending == LoadCommand::PLACE &&
+                (!ok || reply.find(" WIN ") != std::string::npos || reply.find(" DRAW") != std::string::npos))
+            {
+                totalGames++;
+                if (ok && config.watchers > 0)
+                {
+                    // 同じ勝ちの手を繰り返さないよう、戻した手を残りの手と混ぜる
+                    client.played--;
+                    std::shuffle(client.cells.begin() + static_cast<std::ptrdiff_t>(client.played), client.cells.end(),
+                                 client.rng);
+                    send(client, LoadCommand::UNDO, "undo\n");
+                }
+                else
+                {
+                    startGame(client);
+                }
+            }
+            else if (client.pending == LoadCommand::START && !ok)
+            {
+                startGame(client);
+            }
+            else
+            {
+                sendNext(client);
+            }
+        }
+    }
+
+    for (auto &client : clients)
+    {
+        if (client.fd >= 0)
+        {
+            ::close(client.fd);
+        }
+    }
+    ::close(epollFd);
+
+    for (size_t c = 0; c < local.size(); c++)
+    {
+        latency[c]->merge(local[c]);
+    }
+}
+
+void LoadGenerator::runWatchers(size_t firstWatcher, size_t watcherCount, uint64_t deadline)
+{
+    std::vector<uint64_t> ids;
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex);
+        ids = sessionIds;
+    }
+    if (ids.empty())
+    {
+        return;
+    }
+
+    std::vector<Watcher> watchers(watcherCount);
+    int epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+
+    for (size_t i = 0; i < watcherCount; i++)
+    {
+        Watcher &watcher = watchers[i];
+        watcher.fd = connectToServer();
+        watcher.lastSequence = 0;
+        watcher.synced = false;
+        watcher.counted = false;
+        if (watcher.fd < 0)
+        {
+            std::cerr << "Error: Failed to connect watcher " << firstWatcher + i << std::endl;
+            totalErrors++;
+            continue;
+        }
+
+        std::string line = "watch " + std::to_string(ids[(firstWatcher + i) % ids.size()]) + "\n";
+        ::send(watcher.fd, line.data(), line.size(), MSG_NOSIGNAL);
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.ptr = &watcher;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, watcher.fd, &ev);
+    }
+
+    epoll_event events[MAX_EVENTS];
+    char buffer[65536];
+    uint64_t deltas = 0;
+    uint64_t bytes = 0;
+
+    while (nowNanoseconds() < deadline)
+    {
+        int count = ::epoll_wait(epollFd, events, MAX_EVENTS, 100);
+        for (int e = 0; e < count; e++)
+        {
+            Watcher &watcher = *static_cast<Watcher *>(events[e].data.ptr);
+            ssize_t n;
+            while ((n = ::read(watcher.fd, buffer, sizeof(buffer))) > 0)
+            {
+                watcher.input.append(buffer, static_cast<size_t>(n));
+                bytes += static_cast<uint64_t>(n);
+            }
+            if (n == 0)
+            {
+                ::epoll_ctl(epollFd, EPOLL_CTL_DEL, watcher.fd, nullptr);
+                totalErrors++;
+            }
+
+            // 番号が続いているかを確かめながら行を読む
+            size_t start = 0;
+            size_t end;
+            while ((end = watcher.input.find('\n', start)) != std::string::npos)
+            {
+                const char *line = watcher.input.c_str() + start;
+                if (std::strncmp(line, "SNAP ", 5) == 0)
+                {
+                    watcher.lastSequence = std::strtoull(line + 5, nullptr, 10);
+                    watcher.synced = true;
+                    totalSnapshots++;
+                    if (!watcher.counted)
+                    {
+                        watcher.counted = true;
+                        subscribedWatchers++;
+                    }
+                }
+                else if (std::strncmp(line, "EV ", 3) == 0 && watcher.synced)
+                {
+                    uint64_t sequence = std::strtoull(line + 3, nullptr, 10);
+                    if (sequence != watcher.lastSequence + 1)
+                    {
+                        // 取りこぼしたので盤面全体を取り直す
+                        totalGaps++;
+                        watcher.synced = false;
+                        ::send(watcher.fd, "resync\n", 7, MSG_NOSIGNAL);
+                    }
+                    watcher.lastSequence = sequence;
+                    deltas++;
+                }
+                else if (std::strncmp(line, "ERR", 3) == 0)
+                {
+                    totalErrors++;
+                }
+                start = end + 1;
+            }
+            watcher.input.erase(0, start);
+        }
+    }
+
+    for (auto &watcher : watchers)
+    {
+        if (watcher.fd >= 0)
+        {
+            ::close(watcher.fd);
+        }
+    }
+    ::close(epollFd);
+
+    totalDeltas += deltas;
+    totalBytes += bytes;
+}
+
+int LoadGenerator::run()
+{
+    size_t threadCount = config.threads;
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = std::min(threadCount, std::max<size_t>(1, config.connections));
+
+    std::cout << "Running " << config.connections << " sessions on " << threadCount << " threads for "
+              << config.durationSeconds << "s" << std::endl;
+
+    auto startTime = std::chrono::steady_clock::now();
+    uint64_t deadline = nowNanoseconds() + static_cast<uint64_t>(config.durationSeconds * 1e9);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t++)
+    {
+        size_t count = config.connections / threadCount + (t < config.connections % threadCount ? 1 : 0);
+        threads.emplace_back([this, t, count, deadline]()
+                             { runWorker(t, count, 0x9E3779B97F4A7C15ULL * (t + 1), deadline); });
+    }
+
+    // 全ての対局者がセッションを作ってから観戦者を張り、その前後のサーバーのメモリの差を観戦者の数で割る
+    uint64_t rssBefore = 0;
+    uint64_t rssAfter = 0;
+    double watchSeconds = 0.0;
+    if (config.watchers > 0)
+    {
+        while (nowNanoseconds() < deadline)
+        {
+            {
+                std::lock_guard<std::mutex> lock(sessionMutex);
+                if (sessionIds.size() >= config.connections)
+                {
+                    break;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        rssBefore = parseField(queryServer("stats"), "rss");
+
+        auto watchStart = std::chrono::steady_clock::now();
+        for (size_t t = 0; t < threadCount; t++)
+        {
+            size_t first = config.watchers / threadCount * t + std::min(t, config.watchers % threadCount);
+            size_t count = config.watchers / threadCount + (t < config.watchers % threadCount ? 1 : 0);
+            threads.emplace_back([this, first, count, deadline]()
+                                 { runWatchers(first, count, deadline); });
+        }
+
+        while (subscribedWatchers.load() < config.watchers && nowNanoseconds() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        rssAfter = parseField(queryServer("stats"), "rss");
+        watchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - watchStart).count();
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::cout << "Commands: " << totalCommands.load() << " (" << std::fixed << std::setprecision(0)
+              << totalCommands.load() / seconds << " /s), games: " << totalGames.load()
+              << ", errors: " << totalErrors.load() << std::endl;
+    if (config.watchers > 0)
+    {
+        double watching = seconds - watchSeconds;
+        std::cout << "Watchers: " << subscribedWatchers.load() << ", deltas: " << totalDeltas.load() << " ("
+                  << totalDeltas.load() / watching << " /s, " << std::setprecision(1)
+                  << totalBytes.load() / watching / (1024 * 1024) << " MiB/s), snapshots: " << totalSnapshots.load()
+                  << ", gaps: " << totalGaps.load() << std::endl;
+        if (rssBefore > 0 && rssAfter >= rssBefore)
+        {
+            std::cout << "Server memory per watcher: " << (rssAfter - rssBefore) * 1024.0 / config.watchers
+                      << " bytes (rss " << rssBefore << "KiB -> " << rssAfter << "KiB)" << std::endl;
+        }
+        std::cout << std::setprecision(0);
+    }
+    std::cout << std::left << std::setw(10) << "command" << std::right << std::setw(12) << "count" << std::setw(12)
+              << "p50" << std::setw(12) << "p99" << std::setw(12) << "max" << std::endl;
+    for (size_t c = 0; c < latency.size(); c++)
+    {
+        const auto &histogram = *latency[c];
+        if (histogram.getCount() == 0)
+        {
+            continue;
+        }
+        std::cout << std::left << std::setw(10) << commandName(static_cast<LoadCommand>(c)) << std::right
+                  << std::setw(12) << histogram.getCount() << std::setw(12) << formatMicros(histogram.getPercentile(50))
+                  << std::setw(12) << formatMicros(histogram.getPercentile(99)) << std::setw(12)
+                  << formatMicros(histogram.getMax()) << std::endl;
+    }
+
+    return totalErrors.load() == 0 ? 0 : 1;
+}
+
+const char *LoadGenerator::commandName(LoadCommand command)
+{
+    switch (command)
+    {
+    case LoadCommand::START:
+        return "start";
+    case LoadCommand::PLACE:
+        return "place";
+    case LoadCommand::UNDO:
+        return "undo";
+    case LoadCommand::MOVES:
+        return "moves";
+    default:
+        return "unknown";
+    }
+}
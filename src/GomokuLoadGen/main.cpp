@@ -0,0 +1,87 @@
+#include "GomokuLoadGen/LoadGenerator.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "Usage: GomokuLoadGen [options]" << std::endl;
+        std::cerr << "Options:" << std::endl;
+        std::cerr << "  --host <addr>          Server address (default: 127.0.0.1)" << std::endl;
+        std::cerr << "  --port <port>          Server TCP port (default: 7777)" << std::endl;
+        std::cerr << "  --unix <path>          Connect through a Unix domain socket instead of TCP" << std::endl;
+        std::cerr << "  --connections <n>      Concurrent sessions (default: 1000)" << std::endl;
+        std::cerr << "  --threads <n>          Client threads (default: all cores)" << std::endl;
+        std::cerr << "  --duration <seconds>   Test duration (default: 10)" << std::endl;
+        std::cerr << "  --size <n>             Board size (default: 15)" << std::endl;
+        std::cerr << "  --undo <percent>       Share of undo commands (default: 5)" << std::endl;
+        std::cerr << "  --moves <percent>      Share of moves commands (default: 2)" << std::endl;
+        std::cerr << "  --watchers <n>         Spectator connections spread over the sessions (default: 0)" << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    LoadConfig config;
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--host" && hasValue)
+                config.host = argv[++i];
+            else if (arg == "--port" && hasValue)
+                config.port = std::stoi(argv[++i]);
+            else if (arg == "--unix" && hasValue)
+                config.unixPath = argv[++i];
+            else if (arg == "--connections" && hasValue)
+                config.connections = static_cast<size_t>(std::stoul(argv[++i]));
+            else if (arg == "--threads" && hasValue)
+                config.threads = static_cast<size_t>(std::stoul(argv[++i]));
+            else if (arg == "--duration" && hasValue)
+                config.durationSeconds = std::stod(argv[++i]);
+            else if (arg == "--size" && hasValue)
+                config.boardSize = std::stoi(argv[++i]);
+            else if (arg == "--undo" && hasValue)
+                config.undoPercent = std::stoi(argv[++i]);
+            else if (arg == "--moves" && hasValue)
+                config.movesPercent = std::stoi(argv[++i]);
+            else if (arg == "--watchers" && hasValue)
+                config.watchers = static_cast<size_t>(std::stoul(argv[++i]));
+            else
+            {
+                printUsage();
+                return arg == "--help" || arg == "-h" ? 0 : 2;
+            }
+        }
+    }
+    catch (const std::exception &)
+    {
+        printUsage();
+        return 2;
+    }
+
+    // 大量の同時接続に備えてディスクリプタ数の上限を引き上げる
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    try
+    {
+        LoadGenerator generator(config);
+        return generator.run();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,121 @@
+#include "GomokuLib/SelfPlay.h"
+#include <csignal>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <pthread.h>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "Usage: GomokuSelfPlay [options]" << std::endl;
+        std::cerr << "Options:" << std::endl;
+        std::cerr << "  --output <dir>         Directory for the shard files (default: selfplay)" << std::endl;
+        std::cerr << "  --games <n>            Total number of games (default: 1000)" << std::endl;
+        std::cerr << "  --size <n>             Board size (default: 15)" << std::endl;
+        std::cerr << "  --seed <n>             Random seed; same seed and shards give the same data (default: 1)" << std::endl;
+        std::cerr << "  --shards <n>           Shards and worker threads (default: all cores)" << std::endl;
+        std::cerr << "  --opening <plies>      Random opening moves per game (default: 4)" << std::endl;
+        std::cerr << "  --depth <n>            Search depth per move (default: 3)" << std::endl;
+        std::cerr << "  --nodes <n>            Search node limit per move (default: 20000)" << std::endl;
+        std::cerr << "  --network <file>       Evaluate with an NNUE weight file" << std::endl;
+        std::cerr << "  --no-augment           Write each position once instead of in all 8 symmetries" << std::endl;
+        std::cerr << "  --resume               Continue existing shards after a crash or interruption" << std::endl;
+    }
+
+    void printStats(const GomokuLib::SelfPlayStats &stats)
+    {
+        std::printf("%llu games, %llu samples, %.0f samples/s (%.2fM/h)\n",
+                    static_cast<unsigned long long>(stats.games), static_cast<unsigned long long>(stats.samples),
+                    stats.samplesPerSecond(), stats.samplesPerSecond() * 3600.0 / 1e6);
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    GomokuLib::SelfPlayOptions options;
+    std::string networkPath;
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (arg == "--output" && hasValue)
+                options.outputDirectory = argv[++i];
+            else if (arg == "--games" && hasValue)
+                options.games = std::stoull(argv[++i]);
+            else if (arg == "--size" && hasValue)
+                options.boardSize = std::stoi(argv[++i]);
+            else if (arg == "--seed" && hasValue)
+                options.seed = std::stoull(argv[++i]);
+            else if (arg == "--shards" && hasValue)
+                options.shardCount = static_cast<size_t>(std::stoul(argv[++i]));
+            else if (arg == "--opening" && hasValue)
+                options.openingPlies = std::stoi(argv[++i]);
+            else if (arg == "--depth" && hasValue)
+                options.limits.maxDepth = std::stoi(argv[++i]);
+            else if (arg == "--nodes" && hasValue)
+                options.limits.maxNodes = std::stoull(argv[++i]);
+            else if (arg == "--network" && hasValue)
+                networkPath = argv[++i];
+            else if (arg == "--no-augment")
+                options.augment = false;
+            else if (arg == "--resume")
+                options.resume = true;
+            else
+            {
+                printUsage();
+                return arg == "--help" || arg == "-h" ? 0 : 2;
+            }
+        }
+    }
+    catch (const std::exception &)
+    {
+        printUsage();
+        return 2;
+    }
+
+    try
+    {
+        if (!networkPath.empty())
+        {
+            options.limits.network = std::make_shared<const GomokuLib::NeuralNetwork>(GomokuLib::NeuralNetwork::load(networkPath));
+        }
+
+        // Ctrl+C では打ちかけの対局を捨てて、書き終えた対局までを残して終わる（--resume で続きから作れる）
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        GomokuLib::CancellationToken token;
+        std::thread signalThread([token, signals]()
+                                 {
+                                     int signal = 0;
+                                     sigwait(&signals, &signal);
+                                     token.cancel(); });
+        signalThread.detach();
+
+        auto stats = GomokuLib::SelfPlay::run(options, token, [](const GomokuLib::SelfPlayStats &progress)
+                                              { printStats(progress); });
+        if (stats.resumedSamples > 0)
+        {
+            std::printf("Resumed after %llu existing samples\n", static_cast<unsigned long long>(stats.resumedSamples));
+        }
+        printStats(stats);
+        return token.isCancelled() ? 1 : 0;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+}
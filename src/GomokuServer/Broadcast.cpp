@@ -0,0 +1,179 @@
+#include "GomokuServer/Broadcast.h"
+#include <algorithm>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace
+{
+    // 1回の writev で渡すバッファの最大数
+    constexpr size_t MAX_IOVECS = 64;
+
+    // 送信済みのエントリがこの数以上で、かつ全体の半分以上になったら詰める
+    // （送りきるまで待つと、追いつかない観戦者のキューは送信済みの分まで伸び続ける）
+    constexpr size_t COMPACT_THRESHOLD = 256;
+
+    // 石の文字表現
+    const char *stoneToString(GomokuLib::Stone stone)
+    {
+        switch (stone)
+        {
+        case GomokuLib::Stone::BLACK:
+            return "B";
+        case GomokuLib::Stone::WHITE:
+            return "W";
+        case GomokuLib::Stone::DRAW:
+            return "DRAW";
+        default:
+            return "-";
+        }
+    }
+
+    void appendHeader(std::string &out, uint64_t sequence)
+    {
+        out += "EV ";
+        out += std::to_string(sequence);
+    }
+}
+
+void Broadcast::appendPlace(std::string &out, uint64_t sequence, GomokuLib::Stone player, int row, int col)
+{
+    appendHeader(out, sequence);
+    out += " PLACE ";
+    out += stoneToString(player);
+    out += " " + std::to_string(row) + " " + std::to_string(col) + "\n";
+}
+
+void Broadcast::appendUndo(std::string &out, uint64_t sequence)
+{
+    appendHeader(out, sequence);
+    out += " UNDO\n";
+}
+
+void Broadcast::appendResult(std::string &out, uint64_t sequence, GomokuLib::Stone winner)
+{
+    appendHeader(out, sequence);
+    out += winner == GomokuLib::Stone::DRAW ? " RESULT DRAW\n" : std::string(" RESULT WIN ") + stoneToString(winner) + "\n";
+}
+
+void Broadcast::appendClosed(std::string &out, uint64_t sequence)
+{
+    appendHeader(out, sequence);
+    out += " CLOSED\n";
+}
+
+void Broadcast::appendSnapshot(std::string &out, uint64_t sequence, const GomokuLib::Game &game)
+{
+    const auto moves = game.getMoveView();
+    out += "SNAP " + std::to_string(sequence) + " " + std::to_string(game.getBoard().getSize()) + " " +
+           stoneToString(game.isGameOver() ? game.getWinner() : GomokuLib::Stone::EMPTY) + " " +
+           std::to_string(moves.size());
+    for (const auto &move : moves)
+    {
+        out += " " + std::to_string(move.first) + "," + std::to_string(move.second);
+    }
+    out += "\n";
+}
+
+SendQueue::SendQueue() : head(0), offset(0), bytes(0)
+{
+}
+
+void SendQueue::push(BroadcastBuffer buffer, bool droppable)
+{
+    if (buffer->empty())
+    {
+        return;
+    }
+    bytes += buffer->size();
+    entries.push_back({std::move(buffer), droppable});
+}
+
+void SendQueue::dropPending()
+{
+    // 送りかけのバッファを途中で切ると行が壊れるので、先頭は残す
+    size_t keepFrom = head + (offset > 0 ? 1 : 0);
+    auto first = entries.begin() + static_cast<std::ptrdiff_t>(std::min(keepFrom, entries.size()));
+    auto kept = std::stable_partition(first, entries.end(), [](const Entry &entry)
+                                      { return !entry.droppable; });
+    for (auto it = kept; it != entries.end(); ++it)
+    {
+        bytes -= it->buffer->size();
+    }
+    entries.erase(kept, entries.end());
+}
+
+bool SendQueue::send(int fd)
+{
+    while (head < entries.size())
+    {
+        iovec iov[MAX_IOVECS];
+        size_t count = std::min(entries.size() - head, MAX_IOVECS);
+        size_t requested = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            const std::string &data = *entries[head + i].buffer;
+            size_t skip = i == 0 ? offset : 0;
+            iov[i].iov_base = const_cast<char *>(data.data() + skip);
+            iov[i].iov_len = data.size() - skip;
+            requested += iov[i].iov_len;
+        }
+
+        // sendmsg は writev と同じくまとめて送り、切断済みの相手でも SIGPIPE を出さない
+        msghdr message{};
+        message.msg_iov = iov;
+        message.msg_iovlen = count;
+        ssize_t n = ::sendmsg(fd, &message, MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        // 送りきったバッファの参照を外す
+        size_t sent = static_cast<size_t>(n);
+        bytes -= sent;
+        while (sent > 0)
+        {
+            size_t remaining = entries[head].buffer->size() - offset;
+            if (sent < remaining)
+            {
+                offset += sent;
+                break;
+            }
+            sent -= remaining;
+            entries[head++].buffer.reset();
+            offset = 0;
+        }
+        if (static_cast<size_t>(n) < requested)
+        {
+            // 送信バッファが一杯になった
+            break;
+        }
+    }
+
+    if (head == entries.size())
+    {
+        entries.clear();
+        head = 0;
+    }
+    else if (head >= COMPACT_THRESHOLD && head * 2 >= entries.size())
+    {
+        entries.erase(entries.begin(), entries.begin() + static_cast<std::ptrdiff_t>(head));
+        head = 0;
+    }
+    return true;
+}
+
+bool SendQueue::empty() const
+{
+    return head == entries.size();
+}
+
+size_t SendQueue::getBytes() const
+{
+    return bytes;
+}
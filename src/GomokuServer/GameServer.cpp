@@ -0,0 +1,221 @@
+#include "GomokuServer/GameServer.h"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    // ナノ秒をマイクロ秒の文字列に変換
+    std::string formatMicros(uint64_t nanoseconds)
+    {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << nanoseconds / 1000.0 << "us";
+        return oss.str();
+    }
+}
+
+GameServer::GameServer(const ServerConfig &config) : config(config), unixListenFd(-1)
+{
+    if (config.tcpPort < 0 && config.unixPath.empty())
+    {
+        throw std::runtime_error("No listening socket configured");
+    }
+
+    // Unix ソケットは1つだけ作り、全シャードで共有する
+    if (!config.unixPath.empty())
+    {
+        sockaddr_un addr{};
+        if (config.unixPath.size() >= sizeof(addr.sun_path))
+        {
+            throw std::runtime_error("Unix socket path is too long: " + config.unixPath);
+        }
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, config.unixPath.c_str(), sizeof(addr.sun_path) - 1);
+
+        ::unlink(config.unixPath.c_str());
+        unixListenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (unixListenFd < 0 ||
+            ::bind(unixListenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+            ::listen(unixListenFd, SOMAXCONN) != 0)
+        {
+            std::string reason = std::strerror(errno);
+            if (unixListenFd >= 0)
+            {
+                ::close(unixListenFd);
+            }
+            throw std::runtime_error("Failed to listen on " + config.unixPath + ": " + reason);
+        }
+    }
+
+    size_t threadCount = config.threads;
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        shards.push_back(std::make_unique<Shard>(i, *this, config.tcpPort, unixListenFd));
+    }
+}
+
+GameServer::~GameServer()
+{
+    shards.clear();
+    if (unixListenFd >= 0)
+    {
+        ::close(unixListenFd);
+        ::unlink(config.unixPath.c_str());
+    }
+}
+
+void GameServer::run()
+{
+    std::vector<std::thread> threads;
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+
+    for (auto &shard : shards)
+    {
+        Shard *raw = shard.get();
+        threads.emplace_back([raw]()
+                             { raw->run(); });
+
+        // シャードのスレッドをコアに固定してキャッシュの局所性を保つ
+        if (config.pinThreads)
+        {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(raw->getIndex() % cores, &cpuset);
+            pthread_setaffinity_np(threads.back().native_handle(), sizeof(cpuset), &cpuset);
+        }
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+void GameServer::stop()
+{
+    for (auto &shard : shards)
+    {
+        shard->stop();
+    }
+}
+
+Shard &GameServer::shardFor(uint64_t sessionId)
+{
+    return *shards[sessionId % shards.size()];
+}
+
+size_t GameServer::getShardCount() const
+{
+    return shards.size();
+}
+
+std::string GameServer::latencySummary() const
+{
+    std::ostringstream oss;
+    bool first = true;
+    for (size_t c = 0; c < static_cast<size_t>(ServerCommand::COUNT); c++)
+    {
+        GomokuLib::LatencyHistogram merged;
+        for (const auto &shard : shards)
+        {
+            merged.merge(shard->getLatency(static_cast<ServerCommand>(c)));
+        }
+        if (merged.getCount() == 0)
+        {
+            continue;
+        }
+
+        oss << (first ? "" : " | ") << commandName(static_cast<ServerCommand>(c)) << " n=" << merged.getCount()
+            << " p50=" << formatMicros(merged.getPercentile(50)) << " p99=" << formatMicros(merged.getPercentile(99));
+        first = false;
+    }
+    return first ? "no commands" : oss.str();
+}
+
+std::string GameServer::latencyReport() const
+{
+    std::ostringstream oss;
+    oss << std::left << std::setw(10) << "command" << std::right << std::setw(12) << "count" << std::setw(12) << "p50"
+        << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+
+    for (size_t c = 0; c < static_cast<size_t>(ServerCommand::COUNT); c++)
+    {
+        GomokuLib::LatencyHistogram merged;
+        for (const auto &shard : shards)
+        {
+            merged.merge(shard->getLatency(static_cast<ServerCommand>(c)));
+        }
+        if (merged.getCount() == 0)
+        {
+            continue;
+        }
+
+        oss << std::left << std::setw(10) << commandName(static_cast<ServerCommand>(c)) << std::right
+            << std::setw(12) << merged.getCount() << std::setw(12) << formatMicros(merged.getPercentile(50))
+            << std::setw(12) << formatMicros(merged.getPercentile(99)) << std::setw(12)
+            << formatMicros(merged.getMax()) << "\n";
+    }
+    return oss.str();
+}
+
+std::string GameServer::resourceSummary() const
+{
+    size_t watchers = 0;
+    for (const auto &shard : shards)
+    {
+        watchers += shard->getWatcherCount();
+    }
+
+    // 常駐しているページ数（/proc/self/statm の2番目）
+    size_t pages = 0;
+    size_t residentPages = 0;
+    std::ifstream statm("/proc/self/statm");
+    statm >> pages >> residentPages;
+    size_t residentKiB = residentPages * static_cast<size_t>(::sysconf(_SC_PAGESIZE)) / 1024;
+
+    return "watchers=" + std::to_string(watchers) + " rss=" + std::to_string(residentKiB) + "KiB";
+}
+
+const char *GameServer::commandName(ServerCommand command)
+{
+    switch (command)
+    {
+    case ServerCommand::START:
+        return "start";
+    case ServerCommand::ATTACH:
+        return "attach";
+    case ServerCommand::PLACE:
+        return "place";
+    case ServerCommand::UNDO:
+        return "undo";
+    case ServerCommand::MOVES:
+        return "moves";
+    case ServerCommand::STATUS:
+        return "status";
+    case ServerCommand::CLOSE:
+        return "close";
+    case ServerCommand::WATCH:
+        return "watch";
+    case ServerCommand::RESYNC:
+        return "resync";
+    case ServerCommand::STATS:
+        return "stats";
+    case ServerCommand::QUIT:
+        return "quit";
+    default:
+        return "unknown";
+    }
+}
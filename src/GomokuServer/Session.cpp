@@ -0,0 +1,53 @@
+#include "GomokuServer/Session.h"
+
+SessionPool::SessionPool() : allocated(0)
+{
+}
+
+std::unique_ptr<Session> SessionPool::acquire(uint64_t id, int boardSize)
+{
+    std::unique_ptr<Session> session;
+    if (!freeList.empty())
+    {
+        session = std::move(freeList.back());
+        freeList.pop_back();
+    }
+    else
+    {
+        session = std::make_unique<Session>();
+        allocated++;
+    }
+
+    // 再利用したセッションは、前の対局の領域を使い回して初期局面に戻す
+    session->id = id;
+    if (session->game)
+    {
+        session->game->reset(boardSize);
+    }
+    else
+    {
+        session->game.emplace(boardSize);
+    }
+    session->attachedConnections = 0;
+    session->sequence = 0;
+    session->watchers.clear();
+    session->snapshot.reset();
+    session->snapshotSequence = 0;
+    return session;
+}
+
+void SessionPool::release(std::unique_ptr<Session> session)
+{
+    // 対局は次に使うまで残しておく（reset で領域を使い回す）
+    freeList.push_back(std::move(session));
+}
+
+size_t SessionPool::getAllocatedCount() const
+{
+    return allocated;
+}
+
+size_t SessionPool::getFreeCount() const
+{
+    return freeList.size();
+}
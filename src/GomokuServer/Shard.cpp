@@ -0,0 +1,990 @@
+#include "GomokuServer/Shard.h"
+#include "GomokuServer/GameServer.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    // epoll のデータに入れる目印（接続以外のディスクリプタ用）
+    char wakeTag;
+    char tcpTag;
+    char unixTag;
+
+    // 1行の最大長
+    constexpr size_t MAX_LINE_LENGTH = 4096;
+
+    // 1回の epoll_wait で受け取るイベント数
+    constexpr int MAX_EVENTS = 256;
+
+    // 観戦者の送信待ちの上限（超えたら差分を捨てて、追いついてから盤面全体を送る）
+    constexpr size_t MAX_WATCH_BACKLOG = 64 * 1024;
+
+    // サーバーで受け付ける盤面サイズの範囲
+    constexpr int MIN_BOARD_SIZE = 5;
+    constexpr int MAX_BOARD_SIZE = 100;
+
+    // 単調増加の現在時刻（ナノ秒）
+    uint64_t nowNanoseconds()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    // 空白区切りで分割
+    std::vector<std::string_view> tokenize(std::string_view line)
+    {
+        std::vector<std::string_view> tokens;
+        size_t pos = 0;
+        while (pos < line.size())
+        {
+            while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t'))
+            {
+                pos++;
+            }
+            size_t start = pos;
+            while (pos < line.size() && line[pos] != ' ' && line[pos] != '\t')
+            {
+                pos++;
+            }
+            if (pos > start)
+            {
+                tokens.push_back(line.substr(start, pos - start));
+            }
+        }
+        return tokens;
+    }
+
+    // 大文字小文字を区別せずに比較
+    bool equalsIgnoreCase(std::string_view a, const char *b)
+    {
+        size_t length = std::strlen(b);
+        if (a.size() != length)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < length; i++)
+        {
+            if (std::tolower(static_cast<unsigned char>(a[i])) != b[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 整数に変換
+    template <typename T>
+    bool parseNumber(std::string_view text, T &value)
+    {
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() && result.ptr == text.data() + text.size();
+    }
+
+    // 石の文字表現
+    const char *stoneToString(GomokuLib::Stone stone)
+    {
+        switch (stone)
+        {
+        case GomokuLib::Stone::BLACK:
+            return "B";
+        case GomokuLib::Stone::WHITE:
+            return "W";
+        case GomokuLib::Stone::DRAW:
+            return "DRAW";
+        default:
+            return "-";
+        }
+    }
+}
+
+Shard::Shard(size_t index, GameServer &server, int tcpPort, int unixListenFd)
+    : index(index), server(server), epollFd(-1), wakeFd(-1), tcpListenFd(-1), unixListenFd(unixListenFd),
+      stopping(false), nextSequence(1), watcherCount(0)
+{
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0)
+    {
+        throw std::runtime_error("Failed to create epoll instance");
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.ptr = &wakeTag;
+    ::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev);
+
+    // TCP はシャードごとに SO_REUSEPORT で待ち受け、カーネルに接続を振り分けさせる
+    if (tcpPort >= 0)
+    {
+        tcpListenFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (tcpListenFd < 0)
+        {
+            throw std::runtime_error("Failed to create TCP socket");
+        }
+        int one = 1;
+        ::setsockopt(tcpListenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        ::setsockopt(tcpListenFd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(static_cast<uint16_t>(tcpPort));
+        if (::bind(tcpListenFd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+            ::listen(tcpListenFd, SOMAXCONN) != 0)
+        {
+            ::close(tcpListenFd);
+            throw std::runtime_error("Failed to listen on TCP port " + std::to_string(tcpPort) + ": " + std::strerror(errno));
+        }
+
+        ev.events = EPOLLIN;
+        ev.data.ptr = &tcpTag;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, tcpListenFd, &ev);
+    }
+
+    // Unix ソケットは全シャードで共有し、EPOLLEXCLUSIVE で1シャードだけを起こす
+    if (unixListenFd >= 0)
+    {
+        ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+        ev.data.ptr = &unixTag;
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, unixListenFd, &ev);
+    }
+}
+
+Shard::~Shard()
+{
+    for (auto &entry : connections)
+    {
+        ::close(entry.first->fd);
+    }
+    for (Connection *conn : inbox)
+    {
+        ::close(conn->fd);
+        delete conn;
+    }
+    if (tcpListenFd >= 0)
+    {
+        ::close(tcpListenFd);
+    }
+    ::close(wakeFd);
+    ::close(epollFd);
+}
+
+void Shard::run()
+{
+    epoll_event events[MAX_EVENTS];
+
+    while (!stopping.load(std::memory_order_acquire))
+    {
+        int count = ::epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            void *tag = events[i].data.ptr;
+            if (tag == &wakeTag)
+            {
+                uint64_t value;
+                while (::read(wakeFd, &value, sizeof(value)) > 0)
+                {
+                }
+                drainInbox();
+            }
+            else if (tag == &tcpTag)
+            {
+                acceptConnections(tcpListenFd, true);
+            }
+            else if (tag == &unixTag)
+            {
+                acceptConnections(unixListenFd, false);
+            }
+            else
+            {
+                handleEvents(static_cast<Connection *>(tag), events[i].events);
+            }
+        }
+
+        // このループで積んだ差分は観戦者ごとに1回の writev で送る
+        flushPending();
+    }
+}
+
+void Shard::stop()
+{
+    stopping.store(true, std::memory_order_release);
+    uint64_t one = 1;
+    ssize_t written = ::write(wakeFd, &one, sizeof(one));
+    (void)written;
+}
+
+void Shard::adopt(Connection *conn)
+{
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex);
+        inbox.push_back(conn);
+    }
+    uint64_t one = 1;
+    ssize_t written = ::write(wakeFd, &one, sizeof(one));
+    (void)written;
+}
+
+const GomokuLib::LatencyHistogram &Shard::getLatency(ServerCommand command) const
+{
+    return latency[static_cast<size_t>(command)];
+}
+
+size_t Shard::getIndex() const
+{
+    return index;
+}
+
+size_t Shard::getWatcherCount() const
+{
+    return watcherCount.load(std::memory_order_relaxed);
+}
+
+void Shard::acceptConnections(int listenFd, bool tcp)
+{
+    while (true)
+    {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            // EAGAIN: 他のシャードが先に受け付けた、または待ち行列が空
+            return;
+        }
+
+        if (tcp)
+        {
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        auto conn = std::make_unique<Connection>();
+        conn->fd = fd;
+        conn->session = nullptr;
+        conn->waitingWrite = false;
+        conn->closing = false;
+        conn->pendingId = 0;
+        conn->pendingSince = 0;
+        conn->pendingWatch = false;
+        conn->watching = nullptr;
+        conn->watchIndex = 0;
+        conn->needsSnapshot = false;
+        conn->flushQueued = false;
+        registerConnection(std::move(conn));
+    }
+}
+
+void Shard::registerConnection(std::unique_ptr<Connection> conn)
+{
+    epoll_event ev{};
+    ev.events = EPOLLIN | (conn->waitingWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    ev.data.ptr = conn.get();
+    if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, conn->fd, &ev) != 0)
+    {
+        ::close(conn->fd);
+        return;
+    }
+    Connection *raw = conn.get();
+    connections.emplace(raw, std::move(conn));
+}
+
+void Shard::handleEvents(Connection *conn, uint32_t events)
+{
+    bool peerClosed = false;
+
+    if (events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+    {
+        char buffer[16384];
+        while (true)
+        {
+            ssize_t n = ::read(conn->fd, buffer, sizeof(buffer));
+            if (n > 0)
+            {
+                conn->input.append(buffer, static_cast<size_t>(n));
+                continue;
+            }
+            if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+            {
+                peerClosed = true;
+            }
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+
+        // 他のシャードへ移った接続にはもう触れない
+        if (!processInput(conn))
+        {
+            return;
+        }
+    }
+
+    if (!flush(conn))
+    {
+        return;
+    }
+
+    if (peerClosed || (conn->closing && conn->output.empty() && conn->queue.empty()))
+    {
+        closeConnection(conn);
+    }
+}
+
+void Shard::drainInbox()
+{
+    std::vector<Connection *> adopted;
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex);
+        adopted.swap(inbox);
+    }
+
+    for (Connection *conn : adopted)
+    {
+        registerConnection(std::unique_ptr<Connection>(conn));
+        if (connections.find(conn) == connections.end())
+        {
+            continue;
+        }
+
+        completeAttach(conn);
+
+        // 移動前に受信していた後続のコマンドを処理する
+        if (!processInput(conn) || !flush(conn))
+        {
+            continue;
+        }
+        if (conn->closing && conn->output.empty() && conn->queue.empty())
+        {
+            closeConnection(conn);
+        }
+    }
+}
+
+bool Shard::processInput(Connection *conn)
+{
+    size_t consumed = 0;
+    while (true)
+    {
+        size_t end = conn->input.find('\n', consumed);
+        if (end == std::string::npos)
+        {
+            break;
+        }
+
+        std::string_view line(conn->input.data() + consumed, end - consumed);
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        consumed = end + 1;
+
+        if (executeLine(conn, line) == LineResult::MIGRATE)
+        {
+            // 残りの入力は接続と一緒に移動先のシャードで処理する
+            conn->input.erase(0, consumed);
+            migrateConnection(conn, server.shardFor(conn->pendingId));
+            return false;
+        }
+        if (conn->closing)
+        {
+            consumed = conn->input.size();
+            break;
+        }
+    }
+    conn->input.erase(0, consumed);
+
+    if (conn->input.size() > MAX_LINE_LENGTH)
+    {
+        conn->output += "ERR line too long\n";
+        conn->input.clear();
+        conn->closing = true;
+    }
+    return true;
+}
+
+Shard::LineResult Shard::executeLine(Connection *conn, std::string_view line)
+{
+    auto tokens = tokenize(line);
+    if (tokens.empty())
+    {
+        return LineResult::CONTINUE;
+    }
+
+    uint64_t start = nowNanoseconds();
+    ServerCommand command = ServerCommand::UNKNOWN;
+    const std::string_view verb = tokens[0];
+
+    if (equalsIgnoreCase(verb, "place"))
+    {
+        command = ServerCommand::PLACE;
+        handlePlace(conn, tokens);
+    }
+    else if (equalsIgnoreCase(verb, "start"))
+    {
+        command = ServerCommand::START;
+        handleStart(conn, tokens);
+    }
+    else if (equalsIgnoreCase(verb, "attach"))
+    {
+        command = ServerCommand::ATTACH;
+        if (handleAttach(conn, tokens) == LineResult::MIGRATE)
+        {
+            conn->pendingSince = start;
+            return LineResult::MIGRATE;
+        }
+    }
+    else if (equalsIgnoreCase(verb, "undo"))
+    {
+        command = ServerCommand::UNDO;
+        handleUndo(conn);
+    }
+    else if (equalsIgnoreCase(verb, "moves"))
+    {
+        command = ServerCommand::MOVES;
+        handleMoves(conn);
+    }
+    else if (equalsIgnoreCase(verb, "status"))
+    {
+        command = ServerCommand::STATUS;
+        handleStatus(conn);
+    }
+    else if (equalsIgnoreCase(verb, "close"))
+    {
+        command = ServerCommand::CLOSE;
+        handleClose(conn);
+    }
+    else if (equalsIgnoreCase(verb, "watch"))
+    {
+        command = ServerCommand::WATCH;
+        if (handleWatch(conn, tokens) == LineResult::MIGRATE)
+        {
+            conn->pendingSince = start;
+            return LineResult::MIGRATE;
+        }
+    }
+    else if (equalsIgnoreCase(verb, "resync"))
+    {
+        command = ServerCommand::RESYNC;
+        handleResync(conn);
+    }
+    else if (equalsIgnoreCase(verb, "stats"))
+    {
+        command = ServerCommand::STATS;
+        conn->output += "OK " + server.latencySummary() + " | " + server.resourceSummary() + "\n";
+    }
+    else if (equalsIgnoreCase(verb, "quit") || equalsIgnoreCase(verb, "exit"))
+    {
+        command = ServerCommand::QUIT;
+        conn->output += "OK bye\n";
+        conn->closing = true;
+    }
+    else
+    {
+        conn->output += "ERR unknown command\n";
+    }
+
+    latency[static_cast<size_t>(command)].record(nowNanoseconds() - start);
+    return LineResult::CONTINUE;
+}
+
+// コマンド実装: start <size>
+void Shard::handleStart(Connection *conn, const std::vector<std::string_view> &args)
+{
+    int size = 0;
+    if (args.size() < 2 || !parseNumber(args[1], size))
+    {
+        conn->output += "ERR usage: start <size>\n";
+        return;
+    }
+    if (size < MIN_BOARD_SIZE || size > MAX_BOARD_SIZE)
+    {
+        conn->output += "ERR board size must be between 5 and 100\n";
+        return;
+    }
+
+    // 新しいセッションはこの接続を受け付けたシャードに作る
+    detachSession(conn);
+    unsubscribe(conn);
+    uint64_t id = nextSequence++ * server.getShardCount() + index;
+    auto session = sessionPool.acquire(id, size);
+    Session *raw = session.get();
+    sessions.emplace(id, std::move(session));
+    attachSession(conn, raw);
+
+    conn->output += "OK " + std::to_string(id) + "\n";
+}
+
+// コマンド実装: attach <id>
+Shard::LineResult Shard::handleAttach(Connection *conn, const std::vector<std::string_view> &args)
+{
+    uint64_t id = 0;
+    if (args.size() < 2 || !parseNumber(args[1], id))
+    {
+        conn->output += "ERR usage: attach <id>\n";
+        return LineResult::CONTINUE;
+    }
+
+    // 他のシャードのセッションなら接続ごと移動する（セッションは共有しない）
+    conn->pendingId = id;
+    conn->pendingWatch = false;
+    if (&server.shardFor(id) != this)
+    {
+        return LineResult::MIGRATE;
+    }
+
+    completeAttach(conn);
+    return LineResult::CONTINUE;
+}
+
+// コマンド実装: watch <id>
+Shard::LineResult Shard::handleWatch(Connection *conn, const std::vector<std::string_view> &args)
+{
+    uint64_t id = 0;
+    if (args.size() < 2 || !parseNumber(args[1], id))
+    {
+        conn->output += "ERR usage: watch <id>\n";
+        return LineResult::CONTINUE;
+    }
+
+    // 観戦者の送信キューはセッションと同じシャードで扱う
+    conn->pendingId = id;
+    conn->pendingWatch = true;
+    if (&server.shardFor(id) != this)
+    {
+        return LineResult::MIGRATE;
+    }
+
+    completeAttach(conn);
+    return LineResult::CONTINUE;
+}
+
+// コマンド実装: resync
+void Shard::handleResync(Connection *conn)
+{
+    if (!conn->watching)
+    {
+        conn->output += "ERR not watching\n";
+        return;
+    }
+
+    // 送っていない差分は捨てて、応答の後に今の盤面全体を送る
+    conn->queue.dropPending();
+    conn->needsSnapshot = true;
+    conn->output += "OK\n";
+}
+
+void Shard::completeAttach(Connection *conn)
+{
+    uint64_t id = conn->pendingId;
+    bool watch = conn->pendingWatch;
+    conn->pendingId = 0;
+    conn->pendingWatch = false;
+
+    auto it = sessions.find(id);
+    if (it == sessions.end())
+    {
+        conn->output += "ERR no such session\n";
+    }
+    else if (watch)
+    {
+        // 途中から観戦する接続には、まず今の盤面全体を送る
+        detachSession(conn);
+        unsubscribe(conn);
+        subscribe(conn, it->second.get());
+        conn->output += "OK " + std::to_string(id) + "\n";
+        enqueue(conn, sessionSnapshot(*it->second), true);
+    }
+    else
+    {
+        unsubscribe(conn);
+        if (conn->session != it->second.get())
+        {
+            detachSession(conn);
+            attachSession(conn, it->second.get());
+        }
+        conn->output += "OK " + std::to_string(id) + "\n";
+    }
+
+    // 他のシャードから移ってきた場合は移動にかかった時間も含めて記録する
+    if (conn->pendingSince != 0)
+    {
+        ServerCommand command = watch ? ServerCommand::WATCH : ServerCommand::ATTACH;
+        latency[static_cast<size_t>(command)].record(nowNanoseconds() - conn->pendingSince);
+        conn->pendingSince = 0;
+    }
+}
+
+// コマンド実装: place <row> <col>
+void Shard::handlePlace(Connection *conn, const std::vector<std::string_view> &args)
+{
+    if (!conn->session)
+    {
+        conn->output += "ERR no session\n";
+        return;
+    }
+
+    int row = 0;
+    int col = 0;
+    if (args.size() < 3 || !parseNumber(args[1], row) || !parseNumber(args[2], col))
+    {
+        conn->output += "ERR usage: place <row> <col>\n";
+        return;
+    }
+
+    Session &session = *conn->session;
+    GomokuLib::Game &game = *session.game;
+    GomokuLib::Stone player = game.getCurrentPlayer();
+
+    switch (game.playTurn(row, col))
+    {
+    case GomokuLib::MoveResult::SUCCESS:
+    {
+        conn->output += "OK ";
+        conn->output += stoneToString(player);
+        conn->output += " " + std::to_string(row) + " " + std::to_string(col);
+        std::string delta;
+        Broadcast::appendPlace(delta, ++session.sequence, player, row, col);
+        if (game.isGameOver())
+        {
+            GomokuLib::Stone winner = game.getWinner();
+            conn->output += (winner == GomokuLib::Stone::DRAW) ? " DRAW" : std::string(" WIN ") + stoneToString(winner);
+            Broadcast::appendResult(delta, ++session.sequence, winner);
+        }
+        conn->output += "\n";
+        publish(session, std::move(delta));
+        break;
+    }
+    case GomokuLib::MoveResult::INVALID_MOVE:
+        conn->output += "ERR invalid move\n";
+        break;
+    case GomokuLib::MoveResult::GAME_OVER:
+        conn->output += "ERR game over\n";
+        break;
+    }
+}
+
+// コマンド実装: undo
+void Shard::handleUndo(Connection *conn)
+{
+    if (!conn->session)
+    {
+        conn->output += "ERR no session\n";
+        return;
+    }
+
+    Session &session = *conn->session;
+    if (!session.game->undoMove())
+    {
+        conn->output += "ERR nothing to undo\n";
+        return;
+    }
+    conn->output += "OK\n";
+
+    std::string delta;
+    Broadcast::appendUndo(delta, ++session.sequence);
+    publish(session, std::move(delta));
+}
+
+// コマンド実装: moves
+void Shard::handleMoves(Connection *conn)
+{
+    if (!conn->session)
+    {
+        conn->output += "ERR no session\n";
+        return;
+    }
+
+    const auto moves = conn->session->game->getMoveView();
+    conn->output += "OK " + std::to_string(moves.size());
+    for (const auto &move : moves)
+    {
+        conn->output += " " + std::to_string(move.first) + "," + std::to_string(move.second);
+    }
+    conn->output += "\n";
+}
+
+// コマンド実装: status
+void Shard::handleStatus(Connection *conn)
+{
+    if (!conn->session)
+    {
+        conn->output += "ERR no session\n";
+        return;
+    }
+
+    const GomokuLib::Game &game = *conn->session->game;
+    conn->output += "OK " + std::to_string(conn->session->id) + " " + std::to_string(game.getBoard().getSize()) + " " +
+                    stoneToString(game.getCurrentPlayer()) + " " + stoneToString(game.getWinner()) + " " +
+                    std::to_string(game.getMoveView().size()) + "\n";
+}
+
+// コマンド実装: close
+void Shard::handleClose(Connection *conn)
+{
+    if (conn->watching)
+    {
+        unsubscribe(conn);
+        conn->output += "OK\n";
+        return;
+    }
+    if (!conn->session)
+    {
+        conn->output += "ERR no session\n";
+        return;
+    }
+
+    detachSession(conn);
+    conn->output += "OK\n";
+}
+
+void Shard::subscribe(Connection *conn, Session *session)
+{
+    conn->watching = session;
+    conn->watchIndex = session->watchers.size();
+    conn->needsSnapshot = false;
+    session->watchers.push_back(conn);
+    watcherCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Shard::unsubscribe(Connection *conn)
+{
+    Session *session = conn->watching;
+    if (!session)
+    {
+        return;
+    }
+
+    // 最後の観戦者と入れ替えて外す
+    Connection *last = session->watchers.back();
+    session->watchers[conn->watchIndex] = last;
+    last->watchIndex = conn->watchIndex;
+    session->watchers.pop_back();
+
+    conn->watching = nullptr;
+    conn->needsSnapshot = false;
+    watcherCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void Shard::publish(Session &session, std::string delta)
+{
+    if (session.watchers.empty())
+    {
+        return;
+    }
+
+    auto buffer = std::make_shared<const std::string>(std::move(delta));
+    for (Connection *watcher : session.watchers)
+    {
+        // 盤面全体を送るまでは、それより前の差分を積んでも意味がない
+        if (watcher->needsSnapshot)
+        {
+            continue;
+        }
+        if (watcher->queue.getBytes() > MAX_WATCH_BACKLOG)
+        {
+            watcher->queue.dropPending();
+            watcher->needsSnapshot = true;
+            continue;
+        }
+        enqueue(watcher, buffer, true);
+    }
+}
+
+BroadcastBuffer Shard::sessionSnapshot(Session &session)
+{
+    if (!session.snapshot || session.snapshotSequence != session.sequence)
+    {
+        std::string text;
+        Broadcast::appendSnapshot(text, session.sequence, *session.game);
+        session.snapshot = std::make_shared<const std::string>(std::move(text));
+        session.snapshotSequence = session.sequence;
+    }
+    return session.snapshot;
+}
+
+void Shard::enqueue(Connection *conn, BroadcastBuffer buffer, bool droppable)
+{
+    // 先に積まれた応答の後ろに並べる
+    if (!conn->output.empty())
+    {
+        conn->queue.push(std::make_shared<const std::string>(std::move(conn->output)), false);
+        conn->output.clear();
+    }
+    conn->queue.push(std::move(buffer), droppable);
+
+    if (!conn->flushQueued)
+    {
+        conn->flushQueued = true;
+        pendingFlush.push_back(conn);
+    }
+}
+
+void Shard::flushPending()
+{
+    std::vector<Connection *> batch;
+    batch.swap(pendingFlush);
+    for (Connection *conn : batch)
+    {
+        conn->flushQueued = false;
+    }
+
+    // flush で閉じるのはその接続自身だけなので、残りの接続は有効なまま
+    for (Connection *conn : batch)
+    {
+        flush(conn);
+    }
+}
+
+void Shard::forgetPendingFlush(Connection *conn)
+{
+    if (conn->flushQueued)
+    {
+        pendingFlush.erase(std::find(pendingFlush.begin(), pendingFlush.end(), conn));
+        conn->flushQueued = false;
+    }
+}
+
+void Shard::attachSession(Connection *conn, Session *session)
+{
+    conn->session = session;
+    session->attachedConnections++;
+}
+
+void Shard::detachSession(Connection *conn)
+{
+    Session *session = conn->session;
+    if (!session)
+    {
+        return;
+    }
+    conn->session = nullptr;
+
+    // 誰も接続していないセッションはプールへ返す（観戦者には終わったことを知らせて外す）
+    if (--session->attachedConnections == 0)
+    {
+        auto it = sessions.find(session->id);
+        if (it != sessions.end())
+        {
+            if (!session->watchers.empty())
+            {
+                std::string delta;
+                Broadcast::appendClosed(delta, ++session->sequence);
+                auto buffer = std::make_shared<const std::string>(std::move(delta));
+                while (!session->watchers.empty())
+                {
+                    Connection *watcher = session->watchers.back();
+                    enqueue(watcher, buffer, false);
+                    unsubscribe(watcher);
+                }
+            }
+            sessionPool.release(std::move(it->second));
+            sessions.erase(it);
+        }
+    }
+}
+
+bool Shard::flush(Connection *conn)
+{
+    // 観戦中の差分が残っていれば、応答はその後ろに並べて順序を保つ
+    if (!conn->queue.empty() && !conn->output.empty())
+    {
+        conn->queue.push(std::make_shared<const std::string>(std::move(conn->output)), false);
+        conn->output.clear();
+    }
+
+    size_t sent = 0;
+    while (sent < conn->output.size())
+    {
+        ssize_t n = ::send(conn->fd, conn->output.data() + sent, conn->output.size() - sent, MSG_NOSIGNAL);
+        if (n > 0)
+        {
+            sent += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        closeConnection(conn);
+        return false;
+    }
+    conn->output.erase(0, sent);
+
+    if (!conn->queue.empty() && !conn->queue.send(conn->fd))
+    {
+        closeConnection(conn);
+        return false;
+    }
+
+    // 追いつけなかった観戦者には、送信待ちが空いてから今の盤面全体を送る
+    if (conn->needsSnapshot && conn->watching && conn->output.empty() && conn->queue.empty())
+    {
+        conn->needsSnapshot = false;
+        conn->queue.push(sessionSnapshot(*conn->watching), true);
+        if (!conn->queue.send(conn->fd))
+        {
+            closeConnection(conn);
+            return false;
+        }
+    }
+
+    // 送りきれなかった場合だけ書き込み可能イベントを待つ
+    bool wantWrite = !conn->output.empty() || !conn->queue.empty();
+    if (wantWrite != conn->waitingWrite)
+    {
+        conn->waitingWrite = wantWrite;
+        epoll_event ev{};
+        ev.events = EPOLLIN | (wantWrite ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+        ev.data.ptr = conn;
+        ::epoll_ctl(epollFd, EPOLL_CTL_MOD, conn->fd, &ev);
+    }
+    return true;
+}
+
+void Shard::closeConnection(Connection *conn)
+{
+    detachSession(conn);
+    unsubscribe(conn);
+    forgetPendingFlush(conn);
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, nullptr);
+    ::close(conn->fd);
+    connections.erase(conn);
+}
+
+void Shard::migrateConnection(Connection *conn, Shard &target)
+{
+    // このシャードから外してから渡す（以降はこのスレッドから触らない）
+    detachSession(conn);
+    unsubscribe(conn);
+    forgetPendingFlush(conn);
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, conn->fd, nullptr);
+    auto it = connections.find(conn);
+    Connection *raw = it->second.release();
+    connections.erase(it);
+    target.adopt(raw);
+}
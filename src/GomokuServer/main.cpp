@@ -0,0 +1,119 @@
+#include "GomokuServer/GameServer.h"
+#include <csignal>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <pthread.h>
+#include <sys/resource.h>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "Usage: GomokuServer [options]" << std::endl;
+        std::cerr << "Options:" << std::endl;
+        std::cerr << "  --port <port>      TCP port to listen on (default: 7777)" << std::endl;
+        std::cerr << "  --no-tcp           Do not listen on TCP" << std::endl;
+        std::cerr << "  --unix <path>      Also listen on a Unix domain socket" << std::endl;
+        std::cerr << "  --threads <n>      Number of event loops (default: all cores)" << std::endl;
+        std::cerr << "  --pin              Pin each event loop to a CPU core" << std::endl;
+    }
+
+    // 大量の同時接続に備えてディスクリプタ数の上限を引き上げる
+    void raiseFileLimit()
+    {
+        rlimit limit;
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+        {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ServerConfig config;
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            if (arg == "--port" && i + 1 < argc)
+            {
+                config.tcpPort = std::stoi(argv[++i]);
+            }
+            else if (arg == "--no-tcp")
+            {
+                config.tcpPort = -1;
+            }
+            else if (arg == "--unix" && i + 1 < argc)
+            {
+                config.unixPath = argv[++i];
+            }
+            else if (arg == "--threads" && i + 1 < argc)
+            {
+                config.threads = static_cast<size_t>(std::stoul(argv[++i]));
+            }
+            else if (arg == "--pin")
+            {
+                config.pinThreads = true;
+            }
+            else
+            {
+                printUsage();
+                return arg == "--help" || arg == "-h" ? 0 : 2;
+            }
+        }
+    }
+    catch (const std::exception &)
+    {
+        printUsage();
+        return 2;
+    }
+
+    try
+    {
+        raiseFileLimit();
+
+        // 終了シグナルは専用スレッドで受け取る（イベントループのスレッドには届かないようにする）
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+        GameServer server(config);
+        std::thread signalThread([&server, signals]()
+                                 {
+                                     int signal = 0;
+                                     sigwait(&signals, &signal);
+                                     server.stop(); });
+        signalThread.detach();
+
+        std::cout << "GomokuServer listening";
+        if (config.tcpPort >= 0)
+        {
+            std::cout << " on TCP port " << config.tcpPort;
+        }
+        if (!config.unixPath.empty())
+        {
+            std::cout << (config.tcpPort >= 0 ? " and " : " on ") << config.unixPath;
+        }
+        std::cout << " with " << server.getShardCount() << " event loops" << std::endl;
+
+        server.run();
+
+        std::cout << "Shutting down. Command latency:" << std::endl;
+        std::cout << server.latencyReport() << std::flush;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,528 @@
+#include "GomokuTool/GomokuTool.h"
+#include "GomokuLib/MappedFile.h"
+#include "GomokuLib/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // 1タスクで処理するファイル数（タスク投入のオーバーヘッドを抑える）
+    constexpr size_t FILES_PER_TASK = 32;
+
+    // JSON 文字列のエスケープ
+    std::string escapeJson(const std::string &text)
+    {
+        std::string result;
+        result.reserve(text.size() + 2);
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            case '\t':
+                result += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    std::ostringstream oss;
+                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                    result += oss.str();
+                }
+                else
+                {
+                    result += c;
+                }
+            }
+        }
+        return result;
+    }
+
+    // ワーカーごとの作業領域（ワーカー間で共有しないのでロック不要）
+    struct WorkerState
+    {
+        ArchiveStats stats;
+        std::vector<FileReport> reports;
+    };
+}
+
+void ArchiveStats::add(const GomokuLib::RecordSummary &summary, size_t fileBytes)
+{
+    files++;
+    bytes += fileBytes;
+    if (summary.isValid())
+    {
+        validFiles++;
+    }
+    else
+    {
+        invalidFiles++;
+    }
+
+    for (const auto &issue : summary.issues)
+    {
+        issues[issue.type]++;
+    }
+
+    totalMoves += summary.moves.size();
+    switch (summary.winner)
+    {
+    case GomokuLib::Stone::BLACK:
+        blackWins++;
+        break;
+    case GomokuLib::Stone::WHITE:
+        whiteWins++;
+        break;
+    case GomokuLib::Stone::DRAW:
+        draws++;
+        break;
+    default:
+        unfinished++;
+        break;
+    }
+
+    size_t bucket = summary.moves.size() / LENGTH_BUCKET;
+    if (lengthHistogram.size() <= bucket)
+    {
+        lengthHistogram.resize(bucket + 1, 0);
+    }
+    lengthHistogram[bucket]++;
+
+    if (!summary.moves.empty())
+    {
+        auto &heatmap = firstMoveHeatmap[summary.boardSize];
+        heatmap.resize(static_cast<size_t>(summary.boardSize) * summary.boardSize, 0);
+        const auto &first = summary.moves.front();
+        heatmap[static_cast<size_t>(first.first) * summary.boardSize + first.second]++;
+    }
+}
+
+void ArchiveStats::merge(const ArchiveStats &other)
+{
+    files += other.files;
+    validFiles += other.validFiles;
+    invalidFiles += other.invalidFiles;
+    unreadable += other.unreadable;
+    bytes += other.bytes;
+    totalMoves += other.totalMoves;
+    blackWins += other.blackWins;
+    whiteWins += other.whiteWins;
+    draws += other.draws;
+    unfinished += other.unfinished;
+
+    if (lengthHistogram.size() < other.lengthHistogram.size())
+    {
+        lengthHistogram.resize(other.lengthHistogram.size(), 0);
+    }
+    for (size_t i = 0; i < other.lengthHistogram.size(); i++)
+    {
+        lengthHistogram[i] += other.lengthHistogram[i];
+    }
+
+    for (const auto &entry : other.firstMoveHeatmap)
+    {
+        auto &heatmap = firstMoveHeatmap[entry.first];
+        heatmap.resize(entry.second.size(), 0);
+        for (size_t i = 0; i < entry.second.size(); i++)
+        {
+            heatmap[i] += entry.second[i];
+        }
+    }
+
+    for (const auto &entry : other.issues)
+    {
+        issues[entry.first] += entry.second;
+    }
+}
+
+GomokuTool::GomokuTool() : threadCount(0), jsonOutput(false), quiet(false)
+{
+}
+
+bool GomokuTool::parseArguments(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-j" || arg == "--threads")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: " << arg << " requires a number." << std::endl;
+                return false;
+            }
+            try
+            {
+                threadCount = static_cast<size_t>(std::stoul(argv[++i]));
+            }
+            catch (const std::exception &)
+            {
+                std::cerr << "Error: Invalid thread count: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--ext")
+        {
+            if (i + 1 >= argc)
+            {
+                std::cerr << "Error: --ext requires an extension." << std::endl;
+                return false;
+            }
+            std::string ext = argv[++i];
+            if (!ext.empty() && ext[0] != '.')
+            {
+                ext = "." + ext;
+            }
+            extensions.push_back(ext);
+        }
+        else if (arg == "--json")
+        {
+            jsonOutput = true;
+        }
+        else if (arg == "-q" || arg == "--quiet")
+        {
+            quiet = true;
+        }
+        else if (arg == "-h" || arg == "--help")
+        {
+            return false;
+        }
+        else if (!arg.empty() && arg[0] == '-')
+        {
+            std::cerr << "Error: Unknown option: " << arg << std::endl;
+            return false;
+        }
+        else
+        {
+            inputPaths.push_back(arg);
+        }
+    }
+
+    return !inputPaths.empty();
+}
+
+bool GomokuTool::matchesExtension(const std::string &path) const
+{
+    if (extensions.empty())
+    {
+        return true;
+    }
+    std::string ext = fs::path(path).extension().string();
+    return std::find(extensions.begin(), extensions.end(), ext) != extensions.end();
+}
+
+int GomokuTool::run(int argc, char **argv)
+{
+    if (!parseArguments(argc, argv))
+    {
+        printUsage();
+        return 2;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    GomokuLib::ThreadPool pool(threadCount);
+    std::vector<WorkerState> states(pool.getThreadCount());
+
+    // ファイルの束を1タスクとして検証する
+    auto submitBatch = [&](std::vector<std::string> batch)
+    {
+        pool.post([&states, &pool, batch = std::move(batch)]()
+                  {
+                      WorkerState &state = states[pool.currentWorkerIndex()];
+                      for (const auto &path : batch)
+                      {
+                          try
+                          {
+                              GomokuLib::MappedFile file(path);
+                              auto summary = GomokuLib::RecordValidator::validate(file.getContents());
+                              state.stats.add(summary, file.getSize());
+                              if (!summary.isValid())
+                              {
+                                  state.reports.push_back({path, "", std::move(summary.issues)});
+                              }
+                          }
+                          catch (const std::exception &e)
+                          {
+                              state.stats.unreadable++;
+                              state.reports.push_back({path, e.what(), {}});
+                          }
+                      } });
+    };
+
+    // ディレクトリを走査しながら順次タスクを投入する
+    std::vector<std::string> batch;
+    batch.reserve(FILES_PER_TASK);
+    auto enqueue = [&](const std::string &path)
+    {
+        batch.push_back(path);
+        if (batch.size() >= FILES_PER_TASK)
+        {
+            submitBatch(std::move(batch));
+            batch.clear();
+            batch.reserve(FILES_PER_TASK);
+        }
+    };
+
+    for (const auto &input : inputPaths)
+    {
+        std::error_code ec;
+        if (fs::is_directory(input, ec))
+        {
+            fs::recursive_directory_iterator it(input, fs::directory_options::skip_permission_denied, ec);
+            for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+            {
+                if (it->is_regular_file(ec) && matchesExtension(it->path().string()))
+                {
+                    enqueue(it->path().string());
+                }
+            }
+            if (ec)
+            {
+                std::cerr << "Warning: Failed to scan " << input << ": " << ec.message() << std::endl;
+            }
+        }
+        else
+        {
+            // 明示的に指定されたファイルは拡張子に関係なく対象にする
+            enqueue(input);
+        }
+    }
+    if (!batch.empty())
+    {
+        submitBatch(std::move(batch));
+    }
+
+    pool.waitIdle();
+
+    // ワーカーごとの結果を集約
+    ArchiveStats total;
+    std::vector<FileReport> reports;
+    for (auto &state : states)
+    {
+        total.merge(state.stats);
+        for (auto &report : state.reports)
+        {
+            reports.push_back(std::move(report));
+        }
+    }
+    std::sort(reports.begin(), reports.end(), [](const FileReport &a, const FileReport &b)
+              { return a.path < b.path; });
+
+    if (jsonOutput)
+    {
+        printJson(total, reports);
+    }
+    else
+    {
+        printText(total, reports);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        std::cout << "Processed " << total.files + total.unreadable << " files (" << total.bytes << " bytes) in "
+                  << std::fixed << std::setprecision(3) << seconds << "s using "
+                  << pool.getThreadCount() << " threads" << std::endl;
+    }
+
+    return (total.invalidFiles == 0 && total.unreadable == 0) ? 0 : 1;
+}
+
+void GomokuTool::printText(const ArchiveStats &stats, const std::vector<FileReport> &reports) const
+{
+    if (!quiet)
+    {
+        for (const auto &report : reports)
+        {
+            if (!report.error.empty())
+            {
+                std::cout << report.path << ": error: " << report.error << "\n";
+            }
+            for (const auto &issue : report.issues)
+            {
+                std::cout << report.path << ":" << issue.line << ": "
+                          << GomokuLib::RecordValidator::issueTypeToString(issue.type) << ": "
+                          << issue.message << "\n";
+            }
+        }
+        if (!reports.empty())
+        {
+            std::cout << "\n";
+        }
+    }
+
+    auto percent = [&](size_t count)
+    {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(1) << (stats.files ? 100.0 * count / stats.files : 0.0) << "%";
+        return oss.str();
+    };
+
+    std::cout << "Summary:" << "\n";
+    std::cout << "------------" << "\n";
+    std::cout << "Files:        " << stats.files << " (valid " << stats.validFiles << ", invalid "
+              << stats.invalidFiles << ", unreadable " << stats.unreadable << ")" << "\n";
+    std::cout << "Moves:        " << stats.totalMoves << "\n";
+    std::cout << "Black wins:   " << stats.blackWins << " (" << percent(stats.blackWins) << ")" << "\n";
+    std::cout << "White wins:   " << stats.whiteWins << " (" << percent(stats.whiteWins) << ")" << "\n";
+    std::cout << "Draws:        " << stats.draws << " (" << percent(stats.draws) << ")" << "\n";
+    std::cout << "Unfinished:   " << stats.unfinished << " (" << percent(stats.unfinished) << ")" << "\n";
+
+    if (!stats.issues.empty())
+    {
+        std::cout << "\nIssues:" << "\n";
+        for (const auto &entry : stats.issues)
+        {
+            std::cout << "  " << std::left << std::setw(22) << GomokuLib::RecordValidator::issueTypeToString(entry.first)
+                      << std::right << entry.second << "\n";
+        }
+    }
+
+    // 手数のヒストグラム
+    if (!stats.lengthHistogram.empty())
+    {
+        std::cout << "\nGame length histogram:" << "\n";
+        size_t maxCount = *std::max_element(stats.lengthHistogram.begin(), stats.lengthHistogram.end());
+        for (size_t i = 0; i < stats.lengthHistogram.size(); i++)
+        {
+            size_t count = stats.lengthHistogram[i];
+            size_t barLength = maxCount ? (count * 40 + maxCount - 1) / maxCount : 0;
+            std::cout << std::setw(4) << i * ArchiveStats::LENGTH_BUCKET << "-" << std::left << std::setw(4)
+                      << (i + 1) * ArchiveStats::LENGTH_BUCKET - 1 << std::right << std::setw(8) << count << " "
+                      << std::string(barLength, '#') << "\n";
+        }
+    }
+
+    // 初手のヒートマップ（盤面サイズごと）
+    for (const auto &entry : stats.firstMoveHeatmap)
+    {
+        int size = entry.first;
+        std::cout << "\nFirst move heatmap (" << size << "x" << size << "):" << "\n";
+        std::cout << "    ";
+        for (int col = 0; col < size; col++)
+        {
+            std::cout << std::setw(5) << col;
+        }
+        std::cout << "\n";
+        for (int row = 0; row < size; row++)
+        {
+            std::cout << std::setw(4) << row;
+            for (int col = 0; col < size; col++)
+            {
+                size_t count = entry.second[static_cast<size_t>(row) * size + col];
+                if (count == 0)
+                {
+                    std::cout << std::setw(5) << ".";
+                }
+                else
+                {
+                    std::cout << std::setw(5) << count;
+                }
+            }
+            std::cout << "\n";
+        }
+    }
+
+    std::cout << std::endl;
+}
+
+void GomokuTool::printJson(const ArchiveStats &stats, const std::vector<FileReport> &reports) const
+{
+    std::ostringstream out;
+    out << "{\n";
+    out << "  \"files\": " << stats.files << ",\n";
+    out << "  \"validFiles\": " << stats.validFiles << ",\n";
+    out << "  \"invalidFiles\": " << stats.invalidFiles << ",\n";
+    out << "  \"unreadable\": " << stats.unreadable << ",\n";
+    out << "  \"bytes\": " << stats.bytes << ",\n";
+    out << "  \"moves\": " << stats.totalMoves << ",\n";
+    out << "  \"results\": {\"black\": " << stats.blackWins << ", \"white\": " << stats.whiteWins
+        << ", \"draw\": " << stats.draws << ", \"unfinished\": " << stats.unfinished << "},\n";
+
+    out << "  \"issues\": {";
+    bool first = true;
+    for (const auto &entry : stats.issues)
+    {
+        out << (first ? "" : ", ") << "\"" << GomokuLib::RecordValidator::issueTypeToString(entry.first)
+            << "\": " << entry.second;
+        first = false;
+    }
+    out << "},\n";
+
+    out << "  \"lengthHistogram\": {\"bucket\": " << ArchiveStats::LENGTH_BUCKET << ", \"counts\": [";
+    for (size_t i = 0; i < stats.lengthHistogram.size(); i++)
+    {
+        out << (i ? ", " : "") << stats.lengthHistogram[i];
+    }
+    out << "]},\n";
+
+    out << "  \"firstMoveHeatmap\": {";
+    first = true;
+    for (const auto &entry : stats.firstMoveHeatmap)
+    {
+        out << (first ? "" : ", ") << "\"" << entry.first << "\": [";
+        for (size_t i = 0; i < entry.second.size(); i++)
+        {
+            out << (i ? ", " : "") << entry.second[i];
+        }
+        out << "]";
+        first = false;
+    }
+    out << "},\n";
+
+    out << "  \"reports\": [";
+    if (!quiet)
+    {
+        for (size_t i = 0; i < reports.size(); i++)
+        {
+            const auto &report = reports[i];
+            out << (i ? "," : "") << "\n    {\"path\": \"" << escapeJson(report.path) << "\"";
+            if (!report.error.empty())
+            {
+                out << ", \"error\": \"" << escapeJson(report.error) << "\"";
+            }
+            out << ", \"issues\": [";
+            for (size_t j = 0; j < report.issues.size(); j++)
+            {
+                const auto &issue = report.issues[j];
+                out << (j ? ", " : "") << "{\"type\": \""
+                    << GomokuLib::RecordValidator::issueTypeToString(issue.type) << "\", \"line\": " << issue.line
+                    << ", \"move\": " << issue.moveIndex << ", \"message\": \"" << escapeJson(issue.message) << "\"}";
+            }
+            out << "]}";
+        }
+        if (!reports.empty())
+        {
+            out << "\n  ";
+        }
+    }
+    out << "]\n";
+    out << "}\n";
+
+    std::cout << out.str() << std::flush;
+}
+
+void GomokuTool::printUsage() const
+{
+    std::cerr << "Usage: GomokuTool [options] <file-or-directory>..." << std::endl;
+    std::cerr << "Validate game records written by saveGame and print aggregate statistics." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  -j, --threads <n>   Number of worker threads (default: all cores)" << std::endl;
+    std::cerr << "  --ext <ext>         Only scan files with this extension (repeatable)" << std::endl;
+    std::cerr << "  --json              Print the report as JSON" << std::endl;
+    std::cerr << "  -q, --quiet         Do not print per-file issues" << std::endl;
+    std::cerr << "  -h, --help          Display this help message" << std::endl;
+}
@@ -0,0 +1,22 @@
+#include "GomokuTool/GomokuTool.h"
+#include <iostream>
+#include <stdexcept>
+
+int main(int argc, char **argv)
+{
+    try
+    {
+        GomokuTool tool;
+        return tool.run(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    }
+    catch (...)
+    {
+        std::cerr << "Unknown fatal error occurred" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/Analyzer.h"
+#include <atomic>
+
+using namespace GomokuLib;
+
+// 非同期の結果は同期の探索と同じ
+TEST(AnalyzerTest, MatchesSynchronousSearch)
+{
+    Board board(15);
+    board.placeStone(7, 7, Stone::BLACK);
+    board.placeStone(7, 8, Stone::WHITE);
+    board.placeStone(8, 8, Stone::BLACK);
+
+    SearchLimits limits;
+    limits.maxDepth = 3;
+
+    Analyzer analyzer;
+    std::atomic<int> progressCount(0);
+    std::atomic<bool> completed(false);
+    AnalysisHandle handle = analyzer.analyze(
+        board, Stone::WHITE, limits,
+        [&](const SearchResult &)
+        { progressCount++; },
+        [&](const SearchResult &)
+        { completed = true; });
+
+    // 解析は盤面のコピーに対して行われる
+    board.placeStone(0, 0, Stone::WHITE);
+
+    SearchResult result = handle.wait();
+    EXPECT_TRUE(handle.isFinished());
+    EXPECT_TRUE(result.completed);
+    EXPECT_EQ(progressCount.load(), 3);
+    EXPECT_TRUE(completed.load());
+    EXPECT_EQ(handle.getLatest().bestMove, result.bestMove);
+
+    board.placeStone(0, 0, Stone::EMPTY);
+    SearchResult expected = Search::run(board, Stone::WHITE, limits);
+    EXPECT_EQ(result.bestMove, expected.bestMove);
+    EXPECT_EQ(result.principalVariation, expected.principalVariation);
+}
+
+// キャンセルすると途中までの結果で完了する
+TEST(AnalyzerTest, Cancel)
+{
+    Board board(19);
+    board.placeStone(9, 9, Stone::BLACK);
+
+    SearchLimits limits;
+    limits.maxDepth = 30;
+    limits.maxCandidates = 30;
+
+    Analyzer analyzer;
+    AnalysisHandle handle = analyzer.analyze(board, Stone::WHITE, limits);
+    EXPECT_TRUE(handle.isValid());
+    handle.cancel();
+    EXPECT_TRUE(handle.isCancelled());
+
+    SearchResult result = handle.wait();
+    EXPECT_FALSE(result.completed);
+    EXPECT_GE(result.bestMove.first, 0);
+
+    // 空のハンドル
+    AnalysisHandle empty;
+    EXPECT_FALSE(empty.isValid());
+    EXPECT_FALSE(empty.isFinished());
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/BatchEvaluator.h"
+#include "GomokuLib/Search.h"
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace GomokuLib;
+
+namespace
+{
+    // 黒石の数 × 10 を手番側から見た値にする評価器
+    void countBlackStones(EvaluationBatch &batch)
+    {
+        for (size_t i = 0; i < batch.size(); i++)
+        {
+            int count = 0;
+            for (int row = 0; row < batch.getBoardSize(); row++)
+            {
+                count += __builtin_popcountll(batch.getBlackRows(i)[row]);
+            }
+            batch.setScore(i, batch.getSideToMove(i) == Stone::BLACK ? count * 10 : -count * 10);
+        }
+    }
+}
+
+// バッチの局面は元の盤面と同じ石を持つ
+TEST(BatchEvaluatorTest, BatchHoldsPositions)
+{
+    EvaluationBatch batch(9, 2);
+    Board board(9);
+    board.placeStone(0, 0, Stone::BLACK);
+    board.placeStone(8, 3, Stone::WHITE);
+    EXPECT_TRUE(batch.add(board, Stone::BLACK));
+    board.placeStone(4, 4, Stone::BLACK);
+    EXPECT_TRUE(batch.add(board, Stone::WHITE));
+    EXPECT_FALSE(batch.add(board, Stone::WHITE));
+
+    ASSERT_EQ(batch.size(), 2u);
+    EXPECT_EQ(batch.getStone(0, 0, 0), Stone::BLACK);
+    EXPECT_EQ(batch.getStone(0, 8, 3), Stone::WHITE);
+    EXPECT_EQ(batch.getStone(0, 4, 4), Stone::EMPTY);
+    EXPECT_EQ(batch.getStone(1, 4, 4), Stone::BLACK);
+    EXPECT_EQ(batch.getSideToMove(1), Stone::WHITE);
+
+    batch.clear();
+    EXPECT_EQ(batch.size(), 0u);
+}
+
+// 1スレッドだけなら期限が来たところで評価する
+TEST(BatchEvaluatorTest, EvaluatesAfterDeadline)
+{
+    BatchEvaluator evaluator(9, countBlackStones, 8, 100);
+    Board board(9);
+    board.placeStone(1, 1, Stone::BLACK);
+    board.placeStone(2, 2, Stone::BLACK);
+    EXPECT_EQ(evaluator.evaluate(board, Stone::BLACK), 20);
+    EXPECT_EQ(evaluator.evaluate(board, Stone::WHITE), -20);
+
+    BatchEvaluatorStats stats = evaluator.getStats();
+    EXPECT_EQ(stats.batches, 2u);
+    EXPECT_EQ(stats.positions, 2u);
+    EXPECT_EQ(stats.fullBatches, 0u);
+    EXPECT_DOUBLE_EQ(stats.fillRate(), 1.0 / 8.0);
+    EXPECT_GT(stats.meanDelayMicroseconds, 0.0);
+
+    evaluator.resetStats();
+    EXPECT_EQ(evaluator.getStats().batches, 0u);
+
+    Board other(15);
+    EXPECT_THROW(evaluator.evaluate(other, Stone::BLACK), std::runtime_error);
+}
+
+// 多くのスレッドから渡した局面を、それぞれ正しい結果で返す
+TEST(BatchEvaluatorTest, ManyThreads)
+{
+    const int threadCount = 8;
+    const int perThread = 200;
+    // 期限を長くして、全スレッドの局面がそろったところで満杯のバッチとして評価させる
+    BatchEvaluator evaluator(9, countBlackStones, threadCount, 50000);
+
+    std::vector<int> failures(threadCount, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&evaluator, &failures, t]()
+                             {
+            for (int i = 0; i < perThread; i++)
+            {
+                Board board(9);
+                int stones = (t + i) % 20;
+                for (int s = 0; s < stones; s++)
+                {
+                    board.placeStone(s / 9, s % 9, Stone::BLACK);
+                }
+                Stone side = (i % 2 == 0) ? Stone::BLACK : Stone::WHITE;
+                int expected = (side == Stone::BLACK) ? stones * 10 : -stones * 10;
+                if (evaluator.evaluate(board, side) != expected)
+                {
+                    failures[t]++;
+                }
+            } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int t = 0; t < threadCount; t++)
+    {
+        EXPECT_EQ(failures[t], 0) << "thread " << t;
+    }
+    BatchEvaluatorStats stats = evaluator.getStats();
+    EXPECT_EQ(stats.positions, static_cast<uint64_t>(threadCount * perThread));
+    EXPECT_GT(stats.fullBatches, 0u);
+    EXPECT_LE(stats.fillRate(), 1.0);
+    EXPECT_GE(stats.p99DelayMicroseconds, stats.p50DelayMicroseconds);
+}
+
+// 評価器の例外は局面を渡したスレッドに伝わる
+TEST(BatchEvaluatorTest, PropagatesEvaluatorErrors)
+{
+    BatchEvaluator evaluator(9, [](EvaluationBatch &)
+                             { throw std::runtime_error("evaluator failed"); }, 4, 100);
+    Board board(9);
+    EXPECT_THROW(evaluator.evaluate(board, Stone::BLACK), std::runtime_error);
+}
+
+// ネットワークの評価器はアキュムレータと同じ値を返し、探索でも同じ結果になる
+TEST(BatchEvaluatorTest, NetworkEvaluatorMatchesAccumulator)
+{
+    auto network = std::make_shared<const NeuralNetwork>(NeuralNetwork::random(15, 3));
+    auto evaluator = std::make_shared<BatchEvaluator>(15, BatchEvaluator::networkEvaluator(network), 4, 100);
+
+    Board board(15);
+    board.placeStone(7, 7, Stone::BLACK);
+    board.placeStone(7, 8, Stone::WHITE);
+    board.placeStone(8, 8, Stone::BLACK);
+    NeuralAccumulator accumulator(*network, board);
+    EXPECT_EQ(evaluator->evaluate(board, Stone::WHITE), accumulator.evaluate(Stone::WHITE));
+    EXPECT_EQ(evaluator->evaluate(board, Stone::BLACK), accumulator.evaluate(Stone::BLACK));
+
+    SearchLimits withNetwork;
+    withNetwork.maxDepth = 2;
+    withNetwork.maxCandidates = 6;
+    withNetwork.network = network;
+    SearchLimits withEvaluator;
+    withEvaluator.maxDepth = 2;
+    withEvaluator.maxCandidates = 6;
+    withEvaluator.evaluator = evaluator;
+    SearchResult expected = Search::run(board, Stone::WHITE, withNetwork);
+    SearchResult actual = Search::run(board, Stone::WHITE, withEvaluator);
+    EXPECT_EQ(actual.score, expected.score);
+    EXPECT_EQ(actual.bestMove, expected.bestMove);
+    EXPECT_GT(evaluator->getStats().positions, 2u);
+}
@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/Board.h"
+#include "GomokuLib/BoardScan.h"
+#include <random>
+
+using namespace GomokuLib;
+
+namespace
+{
+    // マス目を1つずつ調べる勝者判定（行優先で最初に始まる5連の色）
+    Stone referenceWinner(const Board &board)
+    {
+        const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        int size = board.getSize();
+        for (int row = 0; row < size; row++)
+        {
+            for (int col = 0; col < size; col++)
+            {
+                Stone stone = board.getStone(row, col);
+                if (stone == Stone::EMPTY)
+                    continue;
+                for (const auto &d : directions)
+                {
+                    int k = 1;
+                    // 盤面外は EMPTY なので、端で止まる
+                    while (k < 5 && board.getStone(row + k * d[0], col + k * d[1]) == stone)
+                    {
+                        k++;
+                    }
+                    if (k == 5)
+                        return stone;
+                }
+            }
+        }
+        return board.isFull() ? Stone::DRAW : Stone::EMPTY;
+    }
+
+    // 窓を1つずつ数える形の特徴
+    LineFeatures referenceFeatures(const Board &board)
+    {
+        const int directions[4][2] = {{0, 1}, {1, 0}, {1, 1}, {1, -1}};
+        int size = board.getSize();
+        LineFeatures features;
+        for (int row = 0; row < size; row++)
+        {
+            for (int col = 0; col < size; col++)
+            {
+                for (const auto &d : directions)
+                {
+                    int endRow = row + 4 * d[0];
+                    int endCol = col + 4 * d[1];
+                    if (endRow >= size || endCol < 0 || endCol >= size)
+                        continue;
+                    int black = 0;
+                    int white = 0;
+                    for (int k = 0; k < 5; k++)
+                    {
+                        Stone stone = board.getStone(row + k * d[0], col + k * d[1]);
+                        black += (stone == Stone::BLACK);
+                        white += (stone == Stone::WHITE);
+                    }
+                    if (white == 0)
+                        features.black[black]++;
+                    if (black == 0)
+                        features.white[white]++;
+                }
+            }
+        }
+        return features;
+    }
+
+    // 石を密度 density でランダムに置いた盤面
+    Board randomBoard(int size, double density, std::mt19937 &rng)
+    {
+        Board board(size);
+        std::uniform_real_distribution<double> place(0.0, 1.0);
+        std::bernoulli_distribution black(0.5);
+        for (int row = 0; row < size; row++)
+        {
+            for (int col = 0; col < size; col++)
+            {
+                if (place(rng) < density)
+                {
+                    board.placeStone(row, col, black(rng) ? Stone::BLACK : Stone::WHITE);
+                }
+            }
+        }
+        return board;
+    }
+}
+
+class BoardScanTest : public ::testing::TestWithParam<SimdLevel>
+{
+protected:
+    void SetUp() override
+    {
+        previousLevel = BoardScan::getLevel();
+        BoardScan::setLevel(GetParam());
+    }
+
+    void TearDown() override
+    {
+        BoardScan::setLevel(previousLevel);
+    }
+
+    SimdLevel previousLevel;
+};
+
+INSTANTIATE_TEST_SUITE_P(SimdLevels, BoardScanTest, ::testing::ValuesIn(BoardScan::supportedLevels()),
+                         [](const ::testing::TestParamInfo<SimdLevel> &info)
+                         { return std::string(BoardScan::levelToString(info.param)); });
+
+// 指定した命令セットで走査される
+TEST_P(BoardScanTest, UsesForcedLevel)
+{
+    EXPECT_EQ(BoardScan::getLevel(), GetParam());
+    EXPECT_TRUE(BoardScan::isSupported(SimdLevel::SCALAR));
+    EXPECT_TRUE(BoardScan::isSupported(BoardScan::detectLevel()));
+}
+
+// ランダムな盤面で、勝者と形の特徴がマス目を順に調べた結果と一致する
+TEST_P(BoardScanTest, MatchesReferenceOnRandomBoards)
+{
+    std::mt19937 rng(12345);
+    for (int size : {5, 6, 9, 15, 19, 31, 33, 63, 64, 65, 70})
+    {
+        for (double density : {0.1, 0.35, 0.6, 0.9})
+        {
+            for (int trial = 0; trial < 4; trial++)
+            {
+                Board board = randomBoard(size, density, rng);
+                ASSERT_EQ(board.checkWinner(), referenceWinner(board)) << "size " << size << " density " << density;
+
+                LineFeatures expected = referenceFeatures(board);
+                LineFeatures actual = board.countLineFeatures();
+                ASSERT_EQ(actual.black, expected.black) << "size " << size << " density " << density;
+                ASSERT_EQ(actual.white, expected.white) << "size " << size << " density " << density;
+            }
+        }
+    }
+}
+
+// 盤面の端に接する5連（ビット列の端の処理）
+TEST_P(BoardScanTest, FivesAtEdges)
+{
+    for (int size : {5, 15, 64})
+    {
+        // 最後の行の右端
+        Board horizontal(size);
+        for (int col = size - 5; col < size; col++)
+        {
+            horizontal.placeStone(size - 1, col, Stone::WHITE);
+        }
+        EXPECT_EQ(horizontal.checkWinner(), Stone::WHITE);
+        EXPECT_EQ(horizontal.countLineFeatures().white[5], 1);
+
+        // 右上から左下への斜め
+        Board antiDiagonal(size);
+        for (int k = 0; k < 5; k++)
+        {
+            antiDiagonal.placeStone(size - 5 + k, size - 1 - k, Stone::BLACK);
+        }
+        EXPECT_EQ(antiDiagonal.checkWinner(), Stone::BLACK);
+        EXPECT_EQ(antiDiagonal.countLineFeatures().black[5], 1);
+
+        // 最後の列の縦（4つでは勝ちにならない）
+        Board vertical(size);
+        for (int row = 0; row < 4; row++)
+        {
+            vertical.placeStone(row, size - 1, Stone::BLACK);
+        }
+        EXPECT_EQ(vertical.checkWinner(), Stone::EMPTY);
+        EXPECT_EQ(vertical.countLineFeatures().black[4], 1);
+        EXPECT_EQ(vertical.countLineFeatures().black[5], 0);
+    }
+}
+
+// 石を取り除いたり盤面を戻したりしても走査の結果が変わらない
+TEST_P(BoardScanTest, FollowsRemovalAndSnapshots)
+{
+    Board board(15);
+    for (int col = 3; col < 8; col++)
+    {
+        board.placeStone(7, col, Stone::BLACK);
+    }
+    BoardSnapshot won = board.saveSnapshot();
+    EXPECT_EQ(board.checkWinner(), Stone::BLACK);
+
+    board.placeStone(7, 5, Stone::EMPTY);
+    EXPECT_EQ(board.checkWinner(), Stone::EMPTY);
+    board.placeStone(7, 5, Stone::WHITE);
+    EXPECT_EQ(board.checkWinner(), Stone::EMPTY);
+    EXPECT_EQ(board.countLineFeatures().white, referenceFeatures(board).white);
+
+    board.restoreSnapshot(won);
+    EXPECT_EQ(board.checkWinner(), Stone::BLACK);
+    EXPECT_EQ(board.countLineFeatures().black, referenceFeatures(board).black);
+}
+
+// 使えない命令セットは指定できない
+TEST(BoardScanLevelTest, RejectsUnsupportedLevel)
+{
+    for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512})
+    {
+        if (!BoardScan::isSupported(level))
+        {
+            EXPECT_THROW(BoardScan::setLevel(level), std::runtime_error);
+        }
+    }
+}
@@ -3,13 +3,16 @@
 
 using namespace GomokuLib;
 
-// Boardクラスのテスト
-class BoardTest : public ::testing::Test
+// Boardクラスのテスト（盤面全体の走査は使える全ての命令セットで試す）
+class BoardTest : public ::testing::TestWithParam<SimdLevel>
 {
 protected:
     // 各テストケース前に実行
     void SetUp() override
     {
+        previousLevel = BoardScan::getLevel();
+        BoardScan::setLevel(GetParam());
+
         // 標準的な15x15の盤面を作成
         board15 = new Board(15);
 
@@ -22,14 +25,20 @@ protected:
     {
         delete board15;
         delete board5;
+        BoardScan::setLevel(previousLevel);
     }
 
     Board *board15;
     Board *board5;
+    SimdLevel previousLevel;
 };
 
+INSTANTIATE_TEST_SUITE_P(SimdLevels, BoardTest, ::testing::ValuesIn(BoardScan::supportedLevels()),
+                         [](const ::testing::TestParamInfo<SimdLevel> &info)
+                         { return std::string(BoardScan::levelToString(info.param)); });
+
 // 初期化のテスト
-TEST_F(BoardTest, Initialization)
+TEST_P(BoardTest, Initialization)
 {
     EXPECT_EQ(board15->getSize(), 15);
     EXPECT_EQ(board5->getSize(), 5);
@@ -45,7 +54,7 @@ TEST_F(BoardTest, Initialization)
 }
 
 // 石の配置と取得のテスト
-TEST_F(BoardTest, PlaceAndGetStone)
+TEST_P(BoardTest, PlaceAndGetStone)
 {
     // 適切な位置に石を置く
     EXPECT_TRUE(board15->placeStone(7, 7, Stone::BLACK));
@@ -66,7 +75,7 @@ TEST_F(BoardTest, PlaceAndGetStone)
 }
 
 // 勝利判定のテスト - 水平方向
-TEST_F(BoardTest, CheckWinnerHorizontal)
+TEST_P(BoardTest, CheckWinnerHorizontal)
 {
     // 水平方向に5つ並べる
     for (int i = 0; i < 5; ++i)
@@ -87,7 +96,7 @@ TEST_F(BoardTest, CheckWinnerHorizontal)
 }
 
 // 勝利判定のテスト - 垂直方向
-TEST_F(BoardTest, CheckWinnerVertical)
+TEST_P(BoardTest, CheckWinnerVertical)
 {
     // 垂直方向に5つ並べる
     for (int i = 0; i < 5; ++i)
@@ -100,7 +109,7 @@ TEST_F(BoardTest, CheckWinnerVertical)
 }
 
 // 勝利判定のテスト - 右下がり対角線
-TEST_F(BoardTest, CheckWinnerDiagonalDown)
+TEST_P(BoardTest, CheckWinnerDiagonalDown)
 {
     // 右下がり対角線に5つ並べる
     for (int i = 0; i < 5; ++i)
@@ -113,7 +122,7 @@ TEST_F(BoardTest, CheckWinnerDiagonalDown)
 }
 
 // 勝利判定のテスト - 左下がり対角線
-TEST_F(BoardTest, CheckWinnerDiagonalUp)
+TEST_P(BoardTest, CheckWinnerDiagonalUp)
 {
     // 左下がり対角線に5つ並べる
     for (int i = 0; i < 5; ++i)
@@ -126,7 +135,7 @@ TEST_F(BoardTest, CheckWinnerDiagonalUp)
 }
 
 // 盤面が埋まっているかのテスト
-TEST_F(BoardTest, IsFull)
+TEST_P(BoardTest, IsFull)
 {
     // 初期状態は埋まっていない
     EXPECT_FALSE(board5->isFull());
@@ -145,7 +154,7 @@ TEST_F(BoardTest, IsFull)
 }
 
 // 引き分け判定のテスト
-TEST_F(BoardTest, DrawGame)
+TEST_P(BoardTest, DrawGame)
 {
     // 5x5のパターンを配置
     Stone pattern[5][5] = {
@@ -168,4 +177,84 @@ TEST_F(BoardTest, DrawGame)
 
     // 引き分けを確認
     EXPECT_EQ(board5->checkWinner(), Stone::DRAW);
-}
\ No newline at end of file
+}
+// 最後の着手のみの勝利判定のテスト
+TEST_P(BoardTest, CheckWinAt)
+{
+    // 4つ並んだだけでは勝ちではない
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(board15->placeStone(3 + i, 10 - i, Stone::BLACK));
+    }
+    EXPECT_FALSE(board15->checkWinAt(6, 7));
+
+    // 途中の石を埋めても勝ちと判定される
+    EXPECT_TRUE(board15->placeStone(2, 11, Stone::BLACK));
+    EXPECT_TRUE(board15->checkWinAt(2, 11));
+    EXPECT_TRUE(board15->checkWinAt(4, 9));
+
+    // 空マスや盤面外は勝ちではない
+    EXPECT_FALSE(board15->checkWinAt(0, 0));
+    EXPECT_FALSE(board15->checkWinAt(-1, 3));
+}
+
+// 盤面の保存と復元のテスト
+TEST_P(BoardTest, SnapshotRoundTrip)
+{
+    EXPECT_TRUE(board5->placeStone(0, 0, Stone::BLACK));
+    EXPECT_TRUE(board5->placeStone(4, 4, Stone::WHITE));
+    EXPECT_TRUE(board5->placeStone(2, 3, Stone::BLACK));
+
+    // 25マスを1マス2ビットで保存する
+    BoardSnapshot snapshot = board5->saveSnapshot();
+    EXPECT_EQ(snapshot.size(), 7u);
+
+    // 盤面を変えてから復元すると元に戻る
+    EXPECT_TRUE(board5->placeStone(0, 0, Stone::EMPTY));
+    EXPECT_TRUE(board5->placeStone(1, 1, Stone::WHITE));
+    board5->restoreSnapshot(snapshot);
+
+    EXPECT_EQ(board5->getStone(0, 0), Stone::BLACK);
+    EXPECT_EQ(board5->getStone(4, 4), Stone::WHITE);
+    EXPECT_EQ(board5->getStone(2, 3), Stone::BLACK);
+    EXPECT_EQ(board5->getStone(1, 1), Stone::EMPTY);
+    EXPECT_EQ(board5->saveSnapshot(), snapshot);
+}
+
+// reset は石を全て取り除き、サイズを変えても正しく使える
+TEST_P(BoardTest, Reset)
+{
+    board15->placeStone(7, 7, Stone::BLACK);
+    board15->placeStone(7, 8, Stone::WHITE);
+    board15->reset();
+    EXPECT_EQ(board15->getSize(), 15);
+    EXPECT_EQ(board15->getStone(7, 7), Stone::EMPTY);
+    EXPECT_EQ(board15->saveSnapshot(), Board(15).saveSnapshot());
+
+    board15->reset(9);
+    EXPECT_EQ(board15->getSize(), 9);
+    EXPECT_FALSE(board15->placeStone(9, 0, Stone::BLACK));
+    for (int col = 0; col < 5; col++)
+    {
+        board15->placeStone(8, col, Stone::WHITE);
+    }
+    EXPECT_EQ(board15->checkWinner(), Stone::WHITE);
+    EXPECT_TRUE(board15->checkWinAt(8, 0));
+}
+
+// アロケータを指定したコピーはその領域から確保し、内容は元の盤面と同じになる
+TEST_P(BoardTest, CopyWithAllocator)
+{
+    board5->placeStone(1, 2, Stone::BLACK);
+    std::pmr::monotonic_buffer_resource arena;
+    Board copy(*board5, &arena);
+    EXPECT_EQ(copy.getAllocator().resource(), &arena);
+    EXPECT_EQ(copy.getStone(1, 2), Stone::BLACK);
+    EXPECT_EQ(copy.saveSnapshot(), board5->saveSnapshot());
+
+    // 代入は確保先を変えずに内容だけを移す
+    Board other(5);
+    other = copy;
+    EXPECT_EQ(other.getAllocator().resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(other.getStone(1, 2), Stone::BLACK);
+}
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include "GomokuServer/Broadcast.h"
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+using namespace GomokuLib;
+
+namespace
+{
+    // 送信側をノンブロッキングにし、送信バッファを小さくしたソケットの組
+    class SocketPair
+    {
+    public:
+        int sender = -1;
+        int receiver = -1;
+
+        SocketPair()
+        {
+            int fds[2];
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+            {
+                return;
+            }
+            sender = fds[0];
+            receiver = fds[1];
+            int size = 4096;
+            ::setsockopt(sender, SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+            ::setsockopt(receiver, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+            ::fcntl(sender, F_SETFL, ::fcntl(sender, F_GETFL) | O_NONBLOCK);
+            ::fcntl(receiver, F_SETFL, ::fcntl(receiver, F_GETFL) | O_NONBLOCK);
+        }
+
+        ~SocketPair()
+        {
+            closeReceiver();
+            if (sender >= 0)
+                ::close(sender);
+        }
+
+        void closeReceiver()
+        {
+            if (receiver >= 0)
+                ::close(receiver);
+            receiver = -1;
+        }
+
+        // 受信できるだけ（limit バイトまで）読む
+        std::string drain(size_t limit = SIZE_MAX) const
+        {
+            std::string data;
+            char chunk[4096];
+            ssize_t n;
+            while (data.size() < limit && (n = ::read(receiver, chunk, std::min(sizeof(chunk), limit - data.size()))) > 0)
+            {
+                data.append(chunk, static_cast<size_t>(n));
+            }
+            return data;
+        }
+    };
+
+    BroadcastBuffer makeBuffer(std::string text)
+    {
+        return std::make_shared<const std::string>(std::move(text));
+    }
+
+    // 送りきるまで送信と受信を繰り返し、受け取った全てを返す
+    // （1回に受け取る量を readLimit に絞ると、送信のたびに少しずつしか送れない遅い観戦者になる）
+    std::string sendAll(SendQueue &queue, const SocketPair &sockets, size_t readLimit = SIZE_MAX)
+    {
+        std::string received;
+        for (int round = 0; round < 100000 && !queue.empty(); round++)
+        {
+            EXPECT_TRUE(queue.send(sockets.sender));
+            received += sockets.drain(readLimit);
+        }
+        received += sockets.drain();
+        return received;
+    }
+}
+
+// 差分の行の形式
+TEST(BroadcastTest, EventLineFormats)
+{
+    std::string out;
+    Broadcast::appendPlace(out, 1, Stone::BLACK, 7, 8);
+    Broadcast::appendPlace(out, 2, Stone::WHITE, 0, 14);
+    Broadcast::appendUndo(out, 3);
+    Broadcast::appendResult(out, 4, Stone::BLACK);
+    Broadcast::appendResult(out, 5, Stone::WHITE);
+    Broadcast::appendResult(out, 6, Stone::DRAW);
+    Broadcast::appendClosed(out, 7);
+    EXPECT_EQ(out, "EV 1 PLACE B 7 8\n"
+                   "EV 2 PLACE W 0 14\n"
+                   "EV 3 UNDO\n"
+                   "EV 4 RESULT WIN B\n"
+                   "EV 5 RESULT WIN W\n"
+                   "EV 6 RESULT DRAW\n"
+                   "EV 7 CLOSED\n");
+}
+
+// 盤面全体の行は、その時点の番号・盤の大きさ・勝者・棋譜を持つ
+TEST(BroadcastTest, SnapshotLineFormat)
+{
+    Game game(9);
+    std::string out;
+    Broadcast::appendSnapshot(out, 0, game);
+    EXPECT_EQ(out, "SNAP 0 9 - 0\n");
+
+    for (int col = 0; col < 4; col++)
+    {
+        game.playTurn(0, col);
+        game.playTurn(1, col);
+    }
+    out.clear();
+    Broadcast::appendSnapshot(out, 12, game);
+    EXPECT_EQ(out, "SNAP 12 9 - 8 0,0 1,0 0,1 1,1 0,2 1,2 0,3 1,3\n");
+
+    game.playTurn(0, 4);
+    out.clear();
+    Broadcast::appendSnapshot(out, 13, game);
+    EXPECT_EQ(out, "SNAP 13 9 B 9 0,0 1,0 0,1 1,1 0,2 1,2 0,3 1,3 0,4\n");
+}
+
+// 送信バッファが一杯で一部しか送れなくても、続きから順に送る
+TEST(BroadcastTest, ResumesAfterPartialSend)
+{
+    SocketPair sockets;
+    ASSERT_GE(sockets.sender, 0);
+
+    // 送信済みのエントリを詰める数より多く並べる
+    SendQueue queue;
+    std::string expected;
+    for (int i = 0; i < 1000; i++)
+    {
+        std::string line = "EV " + std::to_string(i) + " " + std::string(static_cast<size_t>(i % 97), 'x') + "\n";
+        expected += line;
+        queue.push(makeBuffer(line), true);
+    }
+    queue.push(makeBuffer(""), false);
+    EXPECT_EQ(queue.getBytes(), expected.size());
+
+    // 1回では送りきれない
+    EXPECT_TRUE(queue.send(sockets.sender));
+    EXPECT_FALSE(queue.empty());
+    EXPECT_LT(queue.getBytes(), expected.size());
+
+    std::string received = sendAll(queue, sockets, 512);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.getBytes(), 0u);
+    EXPECT_EQ(received, expected);
+}
+
+// 送りかけのバッファは捨てずに最後まで送り、その後ろの捨ててよい差分だけを捨てる
+TEST(BroadcastTest, DropKeepsHalfSentBuffer)
+{
+    SocketPair sockets;
+    ASSERT_GE(sockets.sender, 0);
+
+    std::string large(1 << 20, 'a');
+    large.back() = '\n';
+    SendQueue queue;
+    queue.push(makeBuffer(large), true);
+    queue.push(makeBuffer("EV 2 UNDO\n"), true);
+    queue.push(makeBuffer("OK\n"), false);
+    queue.push(makeBuffer("EV 3 UNDO\n"), true);
+
+    EXPECT_TRUE(queue.send(sockets.sender));
+    size_t unsent = queue.getBytes();
+    size_t remainingOfLarge = unsent - std::string("EV 2 UNDO\nOK\nEV 3 UNDO\n").size();
+    ASSERT_GT(remainingOfLarge, 0u);
+    ASSERT_LT(remainingOfLarge, large.size());
+
+    queue.dropPending();
+    EXPECT_EQ(queue.getBytes(), remainingOfLarge + 3);
+    std::string received = sockets.drain();
+    received += sendAll(queue, sockets);
+    EXPECT_EQ(received, large + "OK\n");
+
+    // 送りかけでなければ、先頭の差分も捨てる
+    queue.push(makeBuffer("EV 4 UNDO\n"), true);
+    queue.push(makeBuffer("OK\n"), false);
+    queue.dropPending();
+    EXPECT_EQ(queue.getBytes(), 3u);
+    EXPECT_EQ(sendAll(queue, sockets), "OK\n");
+}
+
+// 相手が切断していれば false を返す（SIGPIPE で落ちない）
+TEST(BroadcastTest, ReportsClosedPeer)
+{
+    SocketPair sockets;
+    ASSERT_GE(sockets.sender, 0);
+    sockets.closeReceiver();
+
+    SendQueue queue;
+    queue.push(makeBuffer("EV 1 CLOSED\n"), false);
+    EXPECT_FALSE(queue.send(sockets.sender));
+}
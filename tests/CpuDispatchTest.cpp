@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/CpuDispatch.h"
+#include "GomokuLib/NeuralNetwork.h"
+#include "GomokuLib/TrainingData.h"
+#include "GomokuLib/TranspositionTable.h"
+#include <cstdlib>
+#include <random>
+
+using namespace GomokuLib;
+
+namespace
+{
+    // 乱数で石を置いた局面
+    TrainingSample randomSample(int size, std::mt19937 &rng)
+    {
+        TrainingSample sample;
+        sample.cells.resize(static_cast<size_t>(size) * size);
+        for (Stone &cell : sample.cells)
+        {
+            int roll = static_cast<int>(rng() % 4);
+            cell = roll == 0 ? Stone::BLACK : roll == 1 ? Stone::WHITE : Stone::EMPTY;
+        }
+        sample.bestMove = {static_cast<int>(rng() % size), static_cast<int>(rng() % size)};
+        return sample;
+    }
+}
+
+class CpuDispatchTest : public ::testing::TestWithParam<SimdLevel>
+{
+protected:
+    void SetUp() override
+    {
+        previousLevel = CpuDispatch::getLevel();
+        CpuDispatch::setLevel(GetParam());
+    }
+
+    void TearDown() override
+    {
+        CpuDispatch::setLevel(previousLevel);
+    }
+
+    SimdLevel previousLevel;
+};
+
+INSTANTIATE_TEST_SUITE_P(SimdLevels, CpuDispatchTest, ::testing::ValuesIn(CpuDispatch::supportedLevels()),
+                         [](const ::testing::TestParamInfo<SimdLevel> &info)
+                         { return std::string(CpuDispatch::levelToString(info.param)); });
+
+// 1つの命令セットの指定で全ての種類のカーネルが切り替わる
+TEST_P(CpuDispatchTest, SwitchesEveryKernel)
+{
+    EXPECT_EQ(CpuDispatch::getLevel(), GetParam());
+    EXPECT_EQ(BoardScan::getLevel(), GetParam());
+    EXPECT_EQ(NeuralNetwork::getLevel(), GetParam() >= SimdLevel::AVX2 ? SimdLevel::AVX2 : SimdLevel::SCALAR);
+}
+
+// 対称変換はマスごとに座標を変換した結果と一致する
+TEST_P(CpuDispatchTest, TransformMatchesCoordinateMap)
+{
+    std::mt19937 rng(7);
+    for (int size : {1, 5, 15, 19, 33})
+    {
+        TrainingSample sample = randomSample(size, rng);
+        TrainingSample out;
+        for (int symmetry = 0; symmetry < TrainingData::SYMMETRY_COUNT; symmetry++)
+        {
+            TrainingData::applySymmetry(sample, size, symmetry, out);
+            EXPECT_EQ(out.bestMove, TrainingData::transform(sample.bestMove.first, sample.bestMove.second, size, symmetry));
+            for (int r = 0; r < size; r++)
+            {
+                for (int c = 0; c < size; c++)
+                {
+                    auto target = TrainingData::transform(r, c, size, symmetry);
+                    ASSERT_EQ(out.cells[target.first * size + target.second], sample.cells[r * size + c])
+                        << "size " << size << " symmetry " << symmetry << " at " << r << "," << c;
+                }
+            }
+        }
+    }
+}
+
+// ハッシュは石ごとの乱数の排他的論理和と一致する
+TEST_P(CpuDispatchTest, HashMatchesStoneKeys)
+{
+    std::mt19937 rng(11);
+    for (int size : {5, 15, 64, 70})
+    {
+        TranspositionTable table(size, 16);
+        Board board(size);
+        uint64_t expected = 0;
+        for (int i = 0; i < size * 2; i++)
+        {
+            int row = static_cast<int>(rng() % size);
+            int col = static_cast<int>(rng() % size);
+            Stone stone = i % 2 == 0 ? Stone::BLACK : Stone::WHITE;
+            if (board.placeStone(row, col, stone))
+            {
+                expected ^= table.stoneKey(row, col, stone);
+            }
+        }
+        EXPECT_EQ(table.hash(board, Stone::BLACK), expected);
+        EXPECT_EQ(table.hash(board, Stone::WHITE), expected ^ table.sideToMoveKey());
+    }
+}
+
+// 命令セットの名前は大文字小文字を区別せずに読む
+TEST(CpuDispatchLevelTest, ParsesLevelNames)
+{
+    SimdLevel level = SimdLevel::SCALAR;
+    EXPECT_TRUE(CpuDispatch::parseLevel("AVX2", level));
+    EXPECT_EQ(level, SimdLevel::AVX2);
+    EXPECT_TRUE(CpuDispatch::parseLevel("avx512", level));
+    EXPECT_EQ(level, SimdLevel::AVX512);
+    EXPECT_TRUE(CpuDispatch::parseLevel("scalar", level));
+    EXPECT_EQ(level, SimdLevel::SCALAR);
+    EXPECT_FALSE(CpuDispatch::parseLevel("neon", level));
+    EXPECT_EQ(level, SimdLevel::SCALAR);
+}
+
+// 環境変数の命令セットを上限にし、使えなければそれより下で最も速いものを使う
+TEST(CpuDispatchLevelTest, DefaultLevelFollowsEnvironment)
+{
+    const char *saved = std::getenv(CpuDispatch::ENVIRONMENT_VARIABLE);
+    std::string previous = saved ? saved : "";
+
+    ::setenv(CpuDispatch::ENVIRONMENT_VARIABLE, "scalar", 1);
+    EXPECT_EQ(CpuDispatch::defaultLevel(), SimdLevel::SCALAR);
+
+    ::setenv(CpuDispatch::ENVIRONMENT_VARIABLE, "avx512", 1);
+    EXPECT_EQ(CpuDispatch::defaultLevel(), CpuDispatch::detectLevel());
+    EXPECT_TRUE(CpuDispatch::isSupported(CpuDispatch::defaultLevel()));
+
+    ::setenv(CpuDispatch::ENVIRONMENT_VARIABLE, "unknown", 1);
+    EXPECT_EQ(CpuDispatch::defaultLevel(), CpuDispatch::detectLevel());
+
+    ::unsetenv(CpuDispatch::ENVIRONMENT_VARIABLE);
+    EXPECT_EQ(CpuDispatch::defaultLevel(), CpuDispatch::detectLevel());
+
+    if (saved)
+    {
+        ::setenv(CpuDispatch::ENVIRONMENT_VARIABLE, previous.c_str(), 1);
+    }
+}
+
+// 使えない命令セットは指定できず、resetLevel で既定の命令セットに戻る
+TEST(CpuDispatchLevelTest, RejectsUnsupportedLevelAndResets)
+{
+    SimdLevel previous = CpuDispatch::getLevel();
+    for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512})
+    {
+        if (!CpuDispatch::isSupported(level))
+        {
+            EXPECT_THROW(CpuDispatch::setLevel(level), std::runtime_error);
+        }
+    }
+
+    CpuDispatch::setLevel(SimdLevel::SCALAR);
+    CpuDispatch::resetLevel();
+    EXPECT_EQ(CpuDispatch::getLevel(), CpuDispatch::defaultLevel());
+    CpuDispatch::setLevel(previous);
+}
@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/Engine.h"
+
+using namespace GomokuLib;
+
+// 空の盤面では中央に打つ
+TEST(EngineTest, EmptyBoardPlaysCenter)
+{
+    Board board(15);
+    EXPECT_EQ(Engine::chooseMove(board, Stone::BLACK), std::make_pair(7, 7));
+}
+
+// 五連を作れるなら必ず作る
+TEST(EngineTest, CompletesFive)
+{
+    Board board(15);
+    for (int i = 0; i < 4; ++i)
+    {
+        board.placeStone(7, 3 + i, Stone::BLACK);
+        board.placeStone(9, 3 + i, Stone::WHITE);
+    }
+
+    auto move = Engine::chooseMove(board, Stone::BLACK);
+    EXPECT_TRUE(move == std::make_pair(7, 2) || move == std::make_pair(7, 7));
+}
+
+// 相手の五連は阻止する
+TEST(EngineTest, BlocksFour)
+{
+    Board board(15);
+    for (int i = 0; i < 4; ++i)
+    {
+        board.placeStone(3 + i, 3 + i, Stone::WHITE);
+    }
+    board.placeStone(2, 2, Stone::BLACK);
+    board.placeStone(10, 0, Stone::BLACK);
+
+    EXPECT_EQ(Engine::chooseMove(board, Stone::BLACK), std::make_pair(7, 7));
+}
+
+// 形の評価値
+TEST(EngineTest, ScoreMove)
+{
+    Board board(15);
+    board.placeStone(7, 7, Stone::BLACK);
+    board.placeStone(7, 8, Stone::BLACK);
+
+    EXPECT_EQ(Engine::scoreMove(board, 7, 9, Stone::BLACK), Engine::SCORE_OPEN_THREE + 3 * Engine::SCORE_ONE);
+    EXPECT_EQ(Engine::scoreMove(board, 7, 9, Stone::WHITE), 4 * Engine::SCORE_ONE - Engine::SCORE_ONE);
+}
+
+// 候補手は石の周囲に限られる
+TEST(EngineTest, CandidateMoves)
+{
+    Board board(15);
+    board.placeStone(0, 0, Stone::BLACK);
+
+    auto candidates = Engine::candidateMoves(board, 2);
+    EXPECT_EQ(candidates.size(), 8);
+    for (const auto &move : candidates)
+    {
+        EXPECT_LE(move.first, 2);
+        EXPECT_LE(move.second, 2);
+    }
+}
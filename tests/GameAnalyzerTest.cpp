@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/GameAnalyzer.h"
+
+using namespace GomokuLib;
+
+namespace
+{
+    // 黒が横に四を作り、白は止めずに8手目を離れた場所に打ち、黒も9手目で五連を見逃す対局
+    std::vector<std::pair<int, int>> missedWinGame()
+    {
+        return {{7, 3}, {7, 2}, {7, 4}, {0, 0}, {7, 5}, {0, 2}, {7, 6}, {0, 4}, {14, 14}};
+    }
+}
+
+// 勝ちの見逃しと、四を止めなかった悪手を検出する
+TEST(GameAnalyzerTest, DetectsMistakes)
+{
+    auto moves = missedWinGame();
+    GameAnalysisOptions options;
+    options.threadCount = 2;
+    GameAnalysis analysis = GameAnalyzer::analyze(15, MoveSpan(moves.data(), moves.size()), options);
+
+    ASSERT_EQ(analysis.moves.size(), moves.size());
+    ASSERT_EQ(analysis.evaluations.size(), moves.size() + 1);
+    EXPECT_TRUE(analysis.completed);
+    EXPECT_GT(analysis.nodes, 0u);
+
+    const MoveAnalysis &missed = analysis.moves[8];
+    EXPECT_EQ(missed.ply, 9);
+    EXPECT_EQ(missed.player, Stone::BLACK);
+    EXPECT_EQ(missed.judgement, MoveJudgement::MISSED_WIN);
+    EXPECT_EQ(missed.bestMove, std::make_pair(7, 7));
+    EXPECT_TRUE(Search::isWinScore(missed.scoreBefore));
+    EXPECT_FALSE(Search::isWinScore(missed.scoreAfter));
+
+    // 白が四を止めなかった手で、評価値は黒の勝ちになる
+    const MoveAnalysis &blunder = analysis.moves[7];
+    EXPECT_EQ(blunder.player, Stone::WHITE);
+    EXPECT_EQ(blunder.judgement, MoveJudgement::BLUNDER);
+    EXPECT_TRUE(Search::isWinScore(analysis.evaluations[8]));
+    EXPECT_GT(analysis.evaluations[8], 0);
+
+    // 四を作った黒の手は問題なし
+    EXPECT_EQ(analysis.moves[6].judgement, MoveJudgement::NONE);
+}
+
+// 終局した局面は読まずに評価する
+TEST(GameAnalyzerTest, TerminalPosition)
+{
+    Game game(15);
+    for (int i = 0; i < 4; i++)
+    {
+        game.playTurn(7, 3 + i);
+        game.playTurn(0, 2 * i);
+    }
+    game.playTurn(7, 7);
+    ASSERT_TRUE(game.isGameOver());
+
+    GameAnalysis analysis = GameAnalyzer::analyze(game);
+    ASSERT_EQ(analysis.evaluations.size(), 10u);
+    EXPECT_EQ(analysis.depths.back(), 0);
+    EXPECT_EQ(analysis.evaluations.back(), Search::SCORE_WIN);
+    EXPECT_EQ(analysis.moves.back().judgement, MoveJudgement::NONE);
+    EXPECT_STREQ(GameAnalyzer::judgementToString(MoveJudgement::MISSED_WIN), "missed-win");
+}
+
+// 不正な棋譜とキャンセル
+TEST(GameAnalyzerTest, InvalidRecordAndCancel)
+{
+    std::vector<std::pair<int, int>> invalid = {{7, 7}, {7, 7}};
+    EXPECT_THROW(GameAnalyzer::analyze(15, MoveSpan(invalid.data(), invalid.size())), std::runtime_error);
+
+    auto moves = missedWinGame();
+    CancellationToken token;
+    token.cancel();
+    GameAnalysis analysis = GameAnalyzer::analyze(15, MoveSpan(moves.data(), moves.size()), GameAnalysisOptions(), token);
+    EXPECT_FALSE(analysis.completed);
+    EXPECT_EQ(analysis.moves.size(), moves.size());
+    for (const auto &move : analysis.moves)
+    {
+        EXPECT_EQ(move.judgement, MoveJudgement::NONE);
+    }
+}
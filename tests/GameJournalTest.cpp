@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/GameJournal.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace GomokuLib;
+
+namespace
+{
+    // 棋譜全体を比べるための保存形式の文字列
+    std::string savedText(const Game &game)
+    {
+        std::ostringstream out;
+        game.saveGame(out);
+        return out.str() + "ply=" + std::to_string(game.getPly());
+    }
+
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string &path, const std::string &contents)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+}
+
+class GameJournalTest : public ::testing::Test
+{
+protected:
+    std::string path = "game_journal_test.txt";
+    std::string journalPath = path + ".journal";
+
+    void SetUp() override
+    {
+        TearDown();
+    }
+
+    void TearDown() override
+    {
+        std::remove(path.c_str());
+        std::remove(journalPath.c_str());
+    }
+};
+
+// 操作の記録は変換して戻すと同じになり、1バイトでも壊れていれば読まない
+TEST_F(GameJournalTest, EncodeAndDecode)
+{
+    uint8_t record[GameJournal::RECORD_SIZE];
+    GameJournal::encode(JournalOperation::PLAY, 14, 3, record);
+
+    JournalOperation operation;
+    int first = 0;
+    int second = 0;
+    ASSERT_TRUE(GameJournal::decode(record, operation, first, second));
+    EXPECT_EQ(operation, JournalOperation::PLAY);
+    EXPECT_EQ(first, 14);
+    EXPECT_EQ(second, 3);
+
+    for (size_t i = 0; i < sizeof(record); i++)
+    {
+        uint8_t corrupted[GameJournal::RECORD_SIZE];
+        std::copy(record, record + sizeof(record), corrupted);
+        corrupted[i] ^= 0x10;
+        EXPECT_FALSE(GameJournal::decode(corrupted, operation, first, second)) << "byte " << i;
+    }
+}
+
+// 全ての種類の操作を記録から再生すると、変化の木も含めて同じ対局に戻る
+TEST_F(GameJournalTest, ReplaysEveryOperation)
+{
+    GameJournalOptions options;
+    options.compactionRecords = 0;
+    std::string expected;
+    {
+        GameJournal journal(path, options);
+        Game game = journal.open(Game(15));
+        game.setJournal(&journal);
+
+        game.reset(9);
+        game.playTurn(4, 4);
+        game.reset(15);
+        game.playTurn(7, 7);
+        game.playTurn(7, 8);
+        game.playTurn(8, 8);
+        game.playTurn(8, 9);
+        game.undoMove();
+        game.undoMove();
+        game.playTurn(6, 6); // 新しい変化
+        game.undoMove();
+        game.selectVariation(0);
+        game.redoMove();
+        game.jumpTo(1);
+        game.playTurn(0, 0);
+        game.takeBackMove();
+        game.playTurn(1, 1);
+        game.undoMove();
+        game.pruneVariation(1);
+        game.redoMove();
+        EXPECT_EQ(game.playTurn(7, 7), MoveResult::INVALID_MOVE); // 失敗した操作は記録しない
+
+        expected = savedText(game);
+        GameJournalStats stats = journal.getStats();
+        EXPECT_EQ(stats.appended, 20u);
+        EXPECT_EQ(stats.compactions, 0u);
+
+        // コピーした対局の操作は記録しない
+        Game copy(game);
+        EXPECT_EQ(copy.getJournal(), nullptr);
+        copy.playTurn(10, 10);
+        EXPECT_EQ(journal.getStats().appended, 20u);
+        game.setJournal(nullptr);
+    }
+
+    EXPECT_EQ(std::filesystem::file_size(journalPath), GameJournal::HEADER_SIZE + 20 * GameJournal::RECORD_SIZE);
+
+    GameJournal journal(path, options);
+    Game recovered = journal.open(Game(9));
+    EXPECT_EQ(savedText(recovered), expected);
+    EXPECT_EQ(journal.getStats().replayed, 20u);
+    EXPECT_EQ(journal.getStats().discardedBytes, 0u);
+}
+
+// 書きかけの記録は捨てて、その前までの状態に戻る
+TEST_F(GameJournalTest, DiscardsTornRecord)
+{
+    std::string beforeLast;
+    {
+        GameJournal journal(path);
+        Game game = journal.open(Game(15));
+        game.setJournal(&journal);
+        game.playTurn(7, 7);
+        game.playTurn(7, 8);
+        beforeLast = savedText(game);
+        game.playTurn(8, 8);
+        game.setJournal(nullptr);
+    }
+
+    // 最後の記録が途中までしか書けなかった状態
+    std::string contents = readFile(journalPath);
+    writeFile(journalPath, contents.substr(0, contents.size() - 3));
+    {
+        GameJournal journal(path);
+        Game recovered = journal.open(Game(15));
+        EXPECT_EQ(savedText(recovered), beforeLast);
+        EXPECT_EQ(journal.getStats().discardedBytes, GameJournal::RECORD_SIZE - 3);
+        EXPECT_EQ(std::filesystem::file_size(journalPath), GameJournal::HEADER_SIZE + 2 * GameJournal::RECORD_SIZE);
+
+        // 捨てた後ろから続けて記録できる
+        recovered.setJournal(&journal);
+        recovered.playTurn(0, 0);
+        beforeLast = savedText(recovered);
+        recovered.setJournal(nullptr);
+    }
+
+    // 記録のない領域（ゼロで埋まった領域）も書きかけとして扱う
+    writeFile(journalPath, readFile(journalPath) + std::string(GameJournal::RECORD_SIZE, '\0'));
+    GameJournal journal(path);
+    EXPECT_EQ(savedText(journal.open(Game(15))), beforeLast);
+}
+
+// 一定の数の操作ごとに棋譜全体を書き出し、記録を空にする
+TEST_F(GameJournalTest, CompactsIntoSnapshot)
+{
+    GameJournalOptions options;
+    options.compactionRecords = 4;
+    std::string expected;
+    std::string staleJournal;
+    {
+        GameJournal journal(path, options);
+        Game game = journal.open(Game(15));
+        game.setJournal(&journal);
+        for (int i = 0; i < 7; i++)
+        {
+            game.playTurn(i, i % 2 == 0 ? 0 : 14);
+        }
+        staleJournal = readFile(journalPath);
+        for (int i = 7; i < 10; i++)
+        {
+            game.playTurn(i, i % 2 == 0 ? 0 : 14);
+        }
+        expected = savedText(game);
+
+        GameJournalStats stats = journal.getStats();
+        EXPECT_EQ(stats.compactions, 2u);
+        EXPECT_EQ(stats.generation, 2u);
+        EXPECT_EQ(stats.recordsSinceSnapshot, 2u);
+        EXPECT_EQ(std::filesystem::file_size(journalPath), GameJournal::HEADER_SIZE + 2 * GameJournal::RECORD_SIZE);
+        game.setJournal(nullptr);
+    }
+
+    // 書き出した棋譜全体は普通の棋譜としても読める
+    EXPECT_EQ(Game::loadGame(path).getPly(), 8u);
+
+    {
+        GameJournal journal(path, options);
+        EXPECT_EQ(savedText(journal.open(Game(15))), expected);
+        EXPECT_EQ(journal.getStats().replayed, 2u);
+    }
+
+    // 棋譜全体を置き換えた後、記録を空にする前に落ちた場合は、古い世代の記録を再生しない
+    writeFile(journalPath, staleJournal);
+    {
+        GameJournal journal(path, options);
+        Game recovered = journal.open(Game(15));
+        EXPECT_EQ(recovered.getPly(), 8u);
+        EXPECT_EQ(journal.getStats().replayed, 0u);
+        EXPECT_EQ(std::filesystem::file_size(journalPath), GameJournal::HEADER_SIZE);
+    }
+
+    // 棋譜全体より新しい記録は壊れている
+    writeFile(path, "SIZE: 15\nMOVES:\n");
+    GameJournal journal(path, options);
+    EXPECT_THROW(journal.open(Game(15)), std::runtime_error);
+}
+
+// sync はそれまでに追記した操作をディスクに書き込んでから戻る
+TEST_F(GameJournalTest, SyncMakesRecordsDurable)
+{
+    // 普通に保存した棋譜からも記録を始められる
+    Game saved(15);
+    saved.playTurn(7, 7);
+    saved.saveGame(path);
+
+    GameJournalOptions options;
+    options.syncIntervalMs = 60000;
+    GameJournal journal(path, options);
+    Game game = journal.open(Game(9));
+    EXPECT_EQ(game.getBoard().getSize(), 15);
+    EXPECT_EQ(game.getPly(), 1u);
+    EXPECT_THROW(journal.open(Game(9)), std::runtime_error);
+
+    game.setJournal(&journal);
+    game.playTurn(7, 8);
+    game.playTurn(8, 8);
+    EXPECT_EQ(journal.getStats().durable, 0u);
+
+    journal.sync();
+    GameJournalStats stats = journal.getStats();
+    EXPECT_EQ(stats.appended, 2u);
+    EXPECT_EQ(stats.durable, 2u);
+    EXPECT_EQ(stats.syncs, 1u);
+
+    // 新しく追記していなければ同期しない
+    journal.sync();
+    EXPECT_EQ(journal.getStats().syncs, 1u);
+    game.setJournal(nullptr);
+}
+
+// 持ち時間のある対局を復元しても、再生した着手で時計を押さず、呼び出し側の持ち時間と残り時間を引き継ぐ
+TEST_F(GameJournalTest, KeepsCallersClock)
+{
+    TimeControl control;
+    control.initialMs = 300000;
+    control.incrementMs = 5000;
+    std::string expected;
+    {
+        Game initial(15);
+        initial.setTimeControl(control);
+        GameJournal journal(path);
+        Game game = journal.open(initial);
+        game.setJournal(&journal);
+        game.playTurn(7, 7);
+        game.playTurn(7, 8);
+        game.playTurn(8, 8);
+        expected = savedText(game);
+        game.setJournal(nullptr);
+    }
+
+    // 棋譜全体を読み直し、その後ろの記録を再生する
+    Game initial(15);
+    initial.setTimeControl(control);
+    initial.getClock().setRemaining(Stone::BLACK, 120000);
+    initial.getClock().setRemaining(Stone::WHITE, 90000);
+    {
+        GameJournal journal(path);
+        Game recovered = journal.open(initial);
+        EXPECT_EQ(savedText(recovered), expected);
+        EXPECT_EQ(journal.getStats().replayed, 3u);
+        EXPECT_TRUE(recovered.getClock().isTimed());
+        EXPECT_EQ(recovered.getClock().getControl().incrementMs, 5000);
+        EXPECT_FALSE(recovered.getClock().isRunning());
+        EXPECT_EQ(recovered.getClock().getRemaining(Stone::BLACK), 120000);
+        EXPECT_EQ(recovered.getClock().getRemaining(Stone::WHITE), 90000);
+    }
+
+    // 呼び出し側の時計が動いていれば、復元した手番側の時計を動かす
+    initial.startClock();
+    GameJournal journal(path);
+    Game recovered = journal.open(initial);
+    EXPECT_EQ(recovered.getClock().getRunning(), Stone::WHITE);
+    EXPECT_LE(recovered.getClock().getRemaining(Stone::WHITE), 90000);
+    EXPECT_GT(recovered.getClock().getRemaining(Stone::WHITE), 80000);
+    EXPECT_LE(recovered.getClock().getRemaining(Stone::BLACK), 120000);
+    EXPECT_GT(recovered.getClock().getRemaining(Stone::BLACK), 110000);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/GameSnapshot.h"
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace GomokuLib;
+
+// 公開した対局の状態が読めて、公開するたびに版が進む
+TEST(GameSnapshotTest, PublishesGameState)
+{
+    Game game(15);
+    SnapshotPublisher publisher(game);
+    SnapshotReader reader(publisher);
+    {
+        auto snapshot = reader.read();
+        EXPECT_EQ(snapshot->version, 1u);
+        EXPECT_EQ(snapshot->boardSize, 15);
+        EXPECT_TRUE(snapshot->moves.empty());
+        EXPECT_EQ(snapshot->getStone(7, 7), Stone::EMPTY);
+    }
+
+    game.playTurn(7, 7);
+    game.playTurn(7, 8);
+    publisher.publish(game);
+    EXPECT_EQ(publisher.getVersion(), 2u);
+
+    auto snapshot = reader.read();
+    EXPECT_EQ(snapshot->version, 2u);
+    EXPECT_EQ(snapshot->getStone(7, 7), Stone::BLACK);
+    EXPECT_EQ(snapshot->getStone(7, 8), Stone::WHITE);
+    EXPECT_EQ(snapshot->currentPlayer, Stone::BLACK);
+    EXPECT_EQ(snapshot->winner, Stone::EMPTY);
+    ASSERT_EQ(snapshot->moves.size(), 2u);
+    EXPECT_EQ(snapshot->moves[1], std::make_pair(7, 8));
+}
+
+// 読んでいる間の古い状態は回収されず、読み終わると再利用される
+TEST(GameSnapshotTest, KeepsPinnedSnapshotUntilReleased)
+{
+    Game game(15);
+    SnapshotPublisher publisher(game);
+    SnapshotReader reader(publisher);
+
+    game.playTurn(7, 7);
+    publisher.publish(game);
+    {
+        auto pinned = reader.read();
+        EXPECT_EQ(pinned->version, 2u);
+
+        for (int i = 0; i < 5; i++)
+        {
+            game.playTurn(0, i);
+            publisher.publish(game);
+        }
+
+        // 読んでいる版も、その後に差し替えた版もまだ残っている
+        EXPECT_EQ(pinned->version, 2u);
+        EXPECT_EQ(pinned->moves.size(), 1u);
+        EXPECT_EQ(pinned->getStone(0, 0), Stone::EMPTY);
+        EXPECT_EQ(publisher.getRetiredCount(), 5u);
+    }
+
+    // 読み終わった後に公開すると、古い版はまとめて回収される
+    game.playTurn(1, 0);
+    publisher.publish(game);
+    EXPECT_EQ(publisher.getRetiredCount(), 0u);
+    EXPECT_EQ(reader.read()->version, 8u);
+}
+
+// 観戦者の枠が足りなければ読み取り口を作れず、破棄すると枠が空く
+TEST(GameSnapshotTest, LimitsReaders)
+{
+    Game game(15);
+    SnapshotPublisher publisher(game, 2);
+    EXPECT_EQ(publisher.getMaxReaders(), 2u);
+
+    auto first = std::make_unique<SnapshotReader>(publisher);
+    SnapshotReader second(publisher);
+    EXPECT_THROW(SnapshotReader third(publisher), std::runtime_error);
+
+    first.reset();
+    SnapshotReader third(publisher);
+    EXPECT_EQ(third.read()->version, 1u);
+}
+
+// 公開し続けている間に多くのスレッドから読んでも、読んだ状態は常に一貫していて版は戻らない（getVersion も同じ）
+TEST(GameSnapshotTest, ConcurrentReadersSeeConsistentSnapshots)
+{
+    Game game(15);
+    SnapshotPublisher publisher(game);
+    std::atomic<bool> done{false};
+    std::atomic<int> failures{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; r++)
+    {
+        readers.emplace_back([&]()
+                             {
+            SnapshotReader reader(publisher);
+            uint64_t lastVersion = 0;
+            while (!done.load())
+            {
+                auto snapshot = reader.read();
+                size_t stones = 0;
+                for (Stone stone : snapshot->cells)
+                {
+                    stones += stone != Stone::EMPTY;
+                }
+                if (stones != snapshot->moves.size() || snapshot->version < lastVersion)
+                {
+                    failures++;
+                }
+                lastVersion = snapshot->version;
+                std::this_thread::yield();
+            } });
+    }
+
+    // 枠を持たずに版の番号だけを読むスレッド
+    readers.emplace_back([&]()
+                         {
+        uint64_t lastVersion = 0;
+        while (!done.load())
+        {
+            uint64_t version = publisher.getVersion();
+            if (version < lastVersion || version > 1601)
+            {
+                failures++;
+            }
+            lastVersion = version;
+        } });
+
+    for (int round = 0; round < 20; round++)
+    {
+        for (int i = 0; i < 40; i++)
+        {
+            game.playTurn(i / 15, i % 15);
+            publisher.publish(game);
+        }
+        for (int i = 0; i < 40; i++)
+        {
+            game.undoMove();
+            publisher.publish(game);
+        }
+    }
+    done = true;
+    for (auto &thread : readers)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(failures.load(), 0);
+    EXPECT_EQ(publisher.getVersion(), 1601u);
+}
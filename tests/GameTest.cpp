@@ -1,10 +1,40 @@
 #include <gtest/gtest.h>
 #include "GomokuLib/Game.h"
+#include <algorithm>
 #include <fstream>
+#include <memory_resource>
+#include <sstream>
 #include <cstdio> // for remove()
 
 using namespace GomokuLib;
 
+namespace
+{
+    // 確保の回数を数える領域
+    class CountingResource : public std::pmr::memory_resource
+    {
+    public:
+        size_t allocations = 0;
+
+    private:
+        void *do_allocate(size_t bytes, size_t alignment) override
+        {
+            allocations++;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *pointer, size_t bytes, size_t alignment) override
+        {
+            std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+    };
+}
+
 // Gameクラスのテスト
 class GameTest : public ::testing::Test
 {
@@ -94,6 +124,30 @@ TEST_F(GameTest, MovesRecord)
     EXPECT_EQ(moves[2], std::make_pair(8, 7));
 }
 
+// 棋譜のビューのテスト
+TEST_F(GameTest, MoveView)
+{
+    EXPECT_TRUE(game->getMoveView().empty());
+
+    game->playTurn(7, 7);
+    game->playTurn(7, 8);
+    game->playTurn(8, 7);
+
+    // ビューはコピーした棋譜と同じ内容を指す
+    MoveSpan view = game->getMoveView();
+    std::vector<std::pair<int, int>> moves = game->getMoves();
+    ASSERT_EQ(view.size(), 3);
+    EXPECT_TRUE(std::equal(view.begin(), view.end(), moves.begin(), moves.end()));
+    EXPECT_EQ(view.front(), std::make_pair(7, 7));
+    EXPECT_EQ(view.back(), std::make_pair(8, 7));
+
+    // 一手戻した後は取り直したビューに反映される
+    game->undoMove();
+    view = game->getMoveView();
+    EXPECT_EQ(view.size(), 2);
+    EXPECT_EQ(view.back(), std::make_pair(7, 8));
+}
+
 // 手を戻すテスト
 TEST_F(GameTest, UndoMove)
 {
@@ -184,9 +238,307 @@ TEST_F(GameTest, SaveAndLoadGame)
     remove(testFilePath.c_str());
 }
 
+// 任意の手数への移動のテスト
+TEST_F(GameTest, JumpTo)
+{
+    // 勝負が付かないように2行ずつずらして並べる（保存点を何度もまたぐ長さ）
+    std::vector<std::pair<int, int>> line;
+    for (int row = 0; row < 15 && line.size() < 100; row++)
+    {
+        for (int col = 0; col < 15 && line.size() < 100; col += 2)
+        {
+            line.emplace_back(row, (col + (row / 2) * 3) % 15);
+        }
+    }
+    for (const auto &move : line)
+    {
+        ASSERT_EQ(game->playTurn(move.first, move.second), MoveResult::SUCCESS);
+    }
+
+    // 各手数の局面を、最初から打ち直した局面と比べる
+    const size_t targets[] = {0, 37, 5, 99, 16, 15, 17, 64, 100, 1, 50};
+    for (size_t target : targets)
+    {
+        ASSERT_TRUE(game->jumpTo(target));
+        EXPECT_EQ(game->getPly(), target);
+        EXPECT_EQ(game->getLineView().size(), line.size());
+
+        Game expected(15);
+        for (size_t i = 0; i < target; i++)
+        {
+            expected.playTurn(line[i].first, line[i].second);
+        }
+        EXPECT_EQ(game->getBoard().saveSnapshot(), expected.getBoard().saveSnapshot());
+        EXPECT_EQ(game->getCurrentPlayer(), expected.getCurrentPlayer());
+        EXPECT_EQ(game->getMoves(), expected.getMoves());
+    }
+
+    // 棋譜の長さを超える移動はできない
+    EXPECT_FALSE(game->jumpTo(line.size() + 1));
+}
+
+// 途中の局面で打つと、それ以降の棋譜が破棄されるテスト
+TEST_F(GameTest, PlayAfterJumpTruncatesLine)
+{
+    game->playTurn(7, 7);
+    game->playTurn(7, 8);
+    game->playTurn(8, 7);
+
+    // 一手戻した手は棋譜に残る
+    EXPECT_TRUE(game->undoMove());
+    EXPECT_EQ(game->getMoves().size(), 2);
+    EXPECT_EQ(game->getLineView().size(), 3);
+    EXPECT_TRUE(game->jumpTo(3));
+    EXPECT_EQ(game->getBoard().getStone(8, 7), Stone::BLACK);
+
+    // 1手目の後に別の手を打つ
+    EXPECT_TRUE(game->jumpTo(1));
+    EXPECT_EQ(game->playTurn(0, 0), MoveResult::SUCCESS);
+    EXPECT_EQ(game->getLineView().size(), 2);
+    EXPECT_EQ(game->getBoard().getStone(0, 0), Stone::WHITE);
+    EXPECT_EQ(game->getBoard().getStone(7, 8), Stone::EMPTY);
+    EXPECT_FALSE(game->jumpTo(3));
+}
+
+// 終局の局面への移動で勝者が戻るテスト
+TEST_F(GameTest, JumpToRestoresWinner)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        smallGame->playTurn(0, i);
+        smallGame->playTurn(1, i);
+    }
+    smallGame->playTurn(0, 4);
+    EXPECT_EQ(smallGame->getWinner(), Stone::BLACK);
+
+    EXPECT_TRUE(smallGame->jumpTo(4));
+    EXPECT_FALSE(smallGame->isGameOver());
+    EXPECT_EQ(smallGame->getCurrentPlayer(), Stone::BLACK);
+
+    EXPECT_TRUE(smallGame->jumpTo(9));
+    EXPECT_TRUE(smallGame->isGameOver());
+    EXPECT_EQ(smallGame->getWinner(), Stone::BLACK);
+    EXPECT_EQ(smallGame->playTurn(4, 4), MoveResult::GAME_OVER);
+}
+
+// 一手戻した手を進め直すテスト
+TEST_F(GameTest, RedoMove)
+{
+    EXPECT_FALSE(game->redoMove());
+
+    game->playTurn(7, 7);
+    game->playTurn(7, 8);
+    EXPECT_TRUE(game->undoMove());
+    EXPECT_TRUE(game->undoMove());
+    EXPECT_EQ(game->getBoard().getStone(7, 7), Stone::EMPTY);
+
+    EXPECT_TRUE(game->redoMove());
+    EXPECT_EQ(game->getBoard().getStone(7, 7), Stone::BLACK);
+    EXPECT_EQ(game->getCurrentPlayer(), Stone::WHITE);
+    EXPECT_TRUE(game->redoMove());
+    EXPECT_EQ(game->getBoard().getStone(7, 8), Stone::WHITE);
+    EXPECT_FALSE(game->redoMove());
+}
+
+// 変化の作成・切り替え・削除のテスト
+TEST_F(GameTest, Variations)
+{
+    game->playTurn(7, 7);
+    game->playTurn(7, 8);
+    game->playTurn(8, 8);
+
+    // 2手目に戻って別の手を打つと、元の手順は変化として残る
+    ASSERT_TRUE(game->jumpTo(1));
+    EXPECT_EQ(game->playTurn(6, 6), MoveResult::SUCCESS);
+    game->playTurn(5, 5);
+    EXPECT_EQ(game->getVariationNodeCount(), 5);
+
+    ASSERT_TRUE(game->jumpTo(1));
+    auto variations = game->getVariations();
+    ASSERT_EQ(variations.size(), 2);
+    EXPECT_EQ(variations[0], std::make_pair(7, 8));
+    EXPECT_EQ(variations[1], std::make_pair(6, 6));
+    EXPECT_EQ(game->getLineView().size(), 3);
+    EXPECT_EQ(game->getLineView()[2], std::make_pair(5, 5));
+
+    // 元の変化に切り替えても盤面は変わらず、その先の手順だけが入れ替わる
+    EXPECT_TRUE(game->selectVariation(0));
+    EXPECT_EQ(game->getPly(), 1);
+    EXPECT_EQ(game->getBoard().getStone(6, 6), Stone::EMPTY);
+    EXPECT_EQ(game->getLineView()[1], std::make_pair(7, 8));
+    EXPECT_TRUE(game->jumpTo(3));
+    EXPECT_EQ(game->getBoard().getStone(8, 8), Stone::BLACK);
+    EXPECT_FALSE(game->selectVariation(0));
+
+    // 同じ手を打ち直した場合は既存の変化をたどり、その先の手順も残る
+    ASSERT_TRUE(game->jumpTo(1));
+    EXPECT_TRUE(game->selectVariation(1));
+    EXPECT_EQ(game->playTurn(7, 8), MoveResult::SUCCESS);
+    EXPECT_EQ(game->getVariationNodeCount(), 5);
+    EXPECT_EQ(game->getLineView().size(), 3);
+    EXPECT_EQ(game->getLineView()[2], std::make_pair(8, 8));
+
+    // 現在の棋譜の変化を削除すると、残った変化に切り替わる
+    ASSERT_TRUE(game->jumpTo(1));
+    EXPECT_TRUE(game->pruneVariation(0));
+    EXPECT_FALSE(game->pruneVariation(1));
+    EXPECT_EQ(game->getVariationNodeCount(), 3);
+    ASSERT_EQ(game->getVariations().size(), 1);
+    EXPECT_EQ(game->getLineView().size(), 3);
+    EXPECT_EQ(game->getLineView()[1], std::make_pair(6, 6));
+
+    // 削除した節点は再利用される
+    EXPECT_EQ(game->playTurn(0, 0), MoveResult::SUCCESS);
+    EXPECT_EQ(game->getVariationNodeCount(), 4);
+    EXPECT_EQ(game->getLineView().size(), 2);
+}
+
+// 変化を含む棋譜の保存と読み込みのテスト
+TEST_F(GameTest, SaveAndLoadVariations)
+{
+    std::string testFilePath = "test_variations.gomoku";
+
+    game->playTurn(7, 7);
+    game->playTurn(7, 8);
+    game->playTurn(8, 8);
+    game->jumpTo(1);
+    game->playTurn(6, 6);
+    game->playTurn(5, 5);
+    game->jumpTo(1);
+    game->selectVariation(0);
+    game->redoMove();
+    game->saveGame(testFilePath);
+
+    Game loadedGame = Game::loadGame(testFilePath);
+    EXPECT_EQ(loadedGame.getMoves(), game->getMoves());
+    EXPECT_EQ(loadedGame.getPly(), 2);
+    EXPECT_EQ(loadedGame.getVariationNodeCount(), 5);
+    ASSERT_EQ(loadedGame.getLineView().size(), 3);
+    EXPECT_EQ(loadedGame.getLineView()[2], std::make_pair(8, 8));
+    EXPECT_EQ(loadedGame.getCurrentPlayer(), Stone::BLACK);
+
+    // 変化の並び順も保存される
+    ASSERT_TRUE(loadedGame.jumpTo(1));
+    auto variations = loadedGame.getVariations();
+    ASSERT_EQ(variations.size(), 2);
+    EXPECT_EQ(variations[0], std::make_pair(7, 8));
+    EXPECT_EQ(variations[1], std::make_pair(6, 6));
+
+    remove(testFilePath.c_str());
+}
+
 // エラーケースのテスト
 TEST_F(GameTest, ErrorCases)
 {
     // 不正なファイルパスからの読み込み
     EXPECT_THROW(Game::loadGame("non_existent_file.gomoku"), std::runtime_error);
+
+    // 黒と白が交互でない棋譜（読み込み直後と goto で盤面が変わってしまう）
+    std::istringstream outOfTurn("SIZE: 15\nMOVES:\n7,7,B\n7,8,B\n");
+    EXPECT_THROW(Game::loadGame(outOfTurn), std::runtime_error);
+    std::istringstream whiteFirst("SIZE: 15\nMOVES:\n7,7,W\n");
+    EXPECT_THROW(Game::loadGame(whiteFirst), std::runtime_error);
+}
+
+// 一手戻して棋譜からも消す
+TEST_F(GameTest, TakeBackMove)
+{
+    EXPECT_FALSE(game->takeBackMove());
+
+    game->playTurn(7, 7);
+    game->playTurn(7, 8);
+    game->playTurn(8, 8);
+    game->undoMove();
+
+    // 戻した手の先にあった手も含めて消える
+    EXPECT_TRUE(game->takeBackMove());
+    EXPECT_EQ(game->getPly(), 1u);
+    EXPECT_EQ(game->getLineView().size(), 1u);
+    EXPECT_EQ(game->getVariationNodeCount(), 1u);
+    EXPECT_EQ(game->getBoard().getStone(7, 8), Stone::EMPTY);
+    EXPECT_EQ(game->getCurrentPlayer(), Stone::WHITE);
+    EXPECT_FALSE(game->redoMove());
+
+    // 残っている別の変化があれば、その手順に切り替わる
+    game->playTurn(0, 0);
+    game->undoMove();
+    game->playTurn(1, 1);
+    EXPECT_TRUE(game->takeBackMove());
+    auto variations = game->getVariations();
+    ASSERT_EQ(variations.size(), 1u);
+    EXPECT_EQ(variations[0], std::make_pair(0, 0));
+    EXPECT_EQ(game->getLineView().size(), 2u);
+}
+
+// reset は初期局面に戻し、同じ手順をもう一度打っても新しく確保しない
+TEST_F(GameTest, ResetReusesStorage)
+{
+    CountingResource counting;
+    Game pooled(15, &counting);
+    auto playLine = [&pooled]()
+    {
+        for (int i = 0; i < 40; i++)
+        {
+            pooled.playTurn(i / 15, i % 15);
+        }
+        pooled.jumpTo(10);
+        pooled.playTurn(14, 14); // 変化を作る
+    };
+    playLine();
+    std::string expected;
+    {
+        std::ostringstream out;
+        pooled.saveGame(out);
+        expected = out.str();
+    }
+
+    size_t allocations = counting.allocations;
+    pooled.reset();
+    EXPECT_EQ(pooled.getPly(), 0u);
+    EXPECT_EQ(pooled.getVariationNodeCount(), 0u);
+    EXPECT_EQ(pooled.getCurrentPlayer(), Stone::BLACK);
+    EXPECT_EQ(pooled.getBoard().getStone(0, 0), Stone::EMPTY);
+    playLine();
+    EXPECT_EQ(counting.allocations, allocations);
+
+    std::ostringstream out;
+    pooled.saveGame(out);
+    EXPECT_EQ(out.str(), expected);
+
+    // サイズを変えて使い直せる
+    pooled.reset(9);
+    EXPECT_EQ(pooled.getBoard().getSize(), 9);
+    EXPECT_EQ(pooled.playTurn(8, 8), MoveResult::SUCCESS);
+    EXPECT_EQ(pooled.playTurn(9, 9), MoveResult::INVALID_MOVE);
+}
+
+// スレッドの領域のようなプールへのコピーは、一度確保した後は上流から確保しない
+TEST_F(GameTest, CopyIntoPoolIsAllocationFree)
+{
+    for (int i = 0; i < 40; i++)
+    {
+        game->playTurn(i / 15, i % 15);
+    }
+    game->jumpTo(20);
+
+    CountingResource counting;
+    std::pmr::unsynchronized_pool_resource pool(&counting);
+    {
+        Game copy(*game, &pool);
+        EXPECT_EQ(copy.getAllocator().resource(), &pool);
+    }
+    size_t allocations = counting.allocations;
+    for (int i = 0; i < 10; i++)
+    {
+        Game copy(*game, &pool);
+        EXPECT_EQ(copy.getPly(), 20u);
+        EXPECT_TRUE(copy.jumpTo(40));
+        EXPECT_EQ(copy.getBoard().getStone(2, 9), Stone::WHITE);
+    }
+    EXPECT_EQ(counting.allocations, allocations);
+
+    // ムーブは中身を移し、元の対局には触れない
+    Game moved(std::move(*game));
+    EXPECT_EQ(moved.getPly(), 20u);
+    EXPECT_EQ(moved.getLineView().size(), 40u);
 }
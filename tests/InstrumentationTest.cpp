@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/Instrumentation.h"
+#include "GomokuLib/Game.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace GomokuLib;
+
+namespace
+{
+    uint64_t counterValue(const InstrumentationSnapshot &snapshot, Counter counter)
+    {
+        return snapshot.counters[static_cast<size_t>(counter)];
+    }
+
+    const InstrumentationSnapshot::TimerStats *findTimer(const InstrumentationSnapshot &snapshot, const std::string &name)
+    {
+        auto it = std::find_if(snapshot.timers.begin(), snapshot.timers.end(),
+                               [&](const InstrumentationSnapshot::TimerStats &timer)
+                               { return timer.name == name; });
+        return (it != snapshot.timers.end()) ? &*it : nullptr;
+    }
+}
+
+// 着手と勝敗判定が数えられる
+TEST(InstrumentationTest, CountsMovesAndWinChecks)
+{
+    if (!Instrumentation::ENABLED)
+        GTEST_SKIP() << "instrumentation is disabled in this build";
+
+    Instrumentation::reset();
+    Game game(15);
+    game.playTurn(7, 7);
+    game.playTurn(8, 8);
+    game.playTurn(0, 0); // 端の石も数える
+    EXPECT_EQ(game.playTurn(7, 7), MoveResult::INVALID_MOVE);
+
+    auto snapshot = Instrumentation::snapshot();
+    EXPECT_EQ(counterValue(snapshot, Counter::MOVES_APPLIED), 3);
+    EXPECT_EQ(counterValue(snapshot, Counter::WIN_CHECKS), 3);
+    // 4方向とも自分の石だけを数えるので、孤立した石は1方向につき1マス
+    EXPECT_EQ(counterValue(snapshot, Counter::CELLS_SCANNED), 12);
+}
+
+// 終了したスレッドの値も合計に残り、reset で 0 に戻る
+TEST(InstrumentationTest, AggregatesAcrossThreads)
+{
+    if (!Instrumentation::ENABLED)
+        GTEST_SKIP() << "instrumentation is disabled in this build";
+
+    Instrumentation::reset();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([]
+                             {
+                                 for (int i = 0; i < 1000; i++)
+                                 {
+                                     GOMOKU_COUNT(BYTES_PARSED, 2);
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    GOMOKU_COUNT(BYTES_PARSED, 5);
+
+    EXPECT_EQ(counterValue(Instrumentation::snapshot(), Counter::BYTES_PARSED), 8005);
+
+    Instrumentation::reset();
+    EXPECT_EQ(counterValue(Instrumentation::snapshot(), Counter::BYTES_PARSED), 0);
+    GOMOKU_COUNT(BYTES_PARSED, 1);
+    EXPECT_EQ(counterValue(Instrumentation::snapshot(), Counter::BYTES_PARSED), 1);
+}
+
+// 名前付きタイマーへの記録と、JSON・Prometheus 形式への書き出し
+TEST(InstrumentationTest, TimersAndExport)
+{
+    if (!Instrumentation::ENABLED)
+        GTEST_SKIP() << "instrumentation is disabled in this build";
+
+    Instrumentation::reset();
+    for (int i = 0; i < 3; i++)
+    {
+        GOMOKU_TIMED_SCOPE("test.scope");
+    }
+    Instrumentation::timer("test.manual").record(2000);
+
+    auto snapshot = Instrumentation::snapshot();
+    const auto *scope = findTimer(snapshot, "test.scope");
+    ASSERT_NE(scope, nullptr);
+    EXPECT_EQ(scope->count, 3);
+    const auto *manual = findTimer(snapshot, "test.manual");
+    ASSERT_NE(manual, nullptr);
+    EXPECT_EQ(manual->count, 1);
+    EXPECT_EQ(manual->max, 2000);
+
+    std::string json = Instrumentation::toJson(snapshot);
+    EXPECT_NE(json.find("\"moves_applied\": "), std::string::npos);
+    EXPECT_NE(json.find("\"name\": \"test.manual\", \"count\": 1"), std::string::npos);
+
+    std::string prometheus = Instrumentation::toPrometheus(snapshot);
+    EXPECT_NE(prometheus.find("# TYPE gomoku_win_checks_total counter"), std::string::npos);
+    EXPECT_NE(prometheus.find("gomoku_latency_seconds_count{name=\"test.manual\"} 1"), std::string::npos);
+    EXPECT_NE(prometheus.find("gomoku_latency_seconds{name=\"test.manual\",quantile=\"0.99\"} "), std::string::npos);
+
+    // reset 後は記録のないタイマーは出力しない
+    Instrumentation::reset();
+    EXPECT_EQ(findTimer(Instrumentation::snapshot(), "test.manual"), nullptr);
+}
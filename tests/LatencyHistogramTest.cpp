@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/LatencyHistogram.h"
+
+using namespace GomokuLib;
+
+// 空のヒストグラム
+TEST(LatencyHistogramTest, Empty)
+{
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.getCount(), 0);
+    EXPECT_EQ(histogram.getPercentile(50), 0);
+    EXPECT_EQ(histogram.getMax(), 0);
+}
+
+// パーセンタイルの精度（相対誤差は 1/16 以内）
+TEST(LatencyHistogramTest, Percentiles)
+{
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 10000; ++value)
+    {
+        histogram.record(value * 100);
+    }
+
+    EXPECT_EQ(histogram.getCount(), 10000);
+    EXPECT_EQ(histogram.getMax(), 1000000);
+    EXPECT_NEAR(static_cast<double>(histogram.getPercentile(50)), 500000.0, 500000.0 / 16);
+    EXPECT_NEAR(static_cast<double>(histogram.getPercentile(99)), 990000.0, 990000.0 / 16);
+    EXPECT_EQ(histogram.getPercentile(100), 1000000);
+    EXPECT_NEAR(histogram.getMean(), 500050.0, 1.0);
+
+    // 小さい値は正確に記録される
+    LatencyHistogram small;
+    small.record(3);
+    small.record(7);
+    EXPECT_EQ(small.getPercentile(50), 3);
+    EXPECT_EQ(small.getPercentile(100), 7);
+}
+
+// 集計の結合とリセット
+TEST(LatencyHistogramTest, MergeAndReset)
+{
+    LatencyHistogram a;
+    LatencyHistogram b;
+    a.record(10);
+    b.record(1000);
+    b.record(2000);
+
+    a.merge(b);
+    EXPECT_EQ(a.getCount(), 3);
+    EXPECT_EQ(a.getMax(), 2000);
+
+    a.reset();
+    EXPECT_EQ(a.getCount(), 0);
+    EXPECT_EQ(a.getMax(), 0);
+}
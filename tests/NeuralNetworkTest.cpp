@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/NeuralNetwork.h"
+#include "GomokuLib/Search.h"
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+using namespace GomokuLib;
+
+namespace
+{
+    // 石をランダムに置いた盤面
+    Board randomBoard(int size, int stones, std::mt19937 &rng)
+    {
+        Board board(size);
+        std::uniform_int_distribution<int> cell(0, size - 1);
+        Stone stone = Stone::BLACK;
+        for (int placed = 0; placed < stones;)
+        {
+            if (board.placeStone(cell(rng), cell(rng), stone))
+            {
+                stone = (stone == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
+                placed++;
+            }
+        }
+        return board;
+    }
+}
+
+class NeuralNetworkTest : public ::testing::Test
+{
+protected:
+    std::string weightsPath = "neural_network_test.nnue";
+
+    void TearDown() override
+    {
+        std::remove(weightsPath.c_str());
+    }
+};
+
+// 保存した重みを読み込むと同じ評価になる
+TEST_F(NeuralNetworkTest, SaveAndLoad)
+{
+    NeuralNetwork network = NeuralNetwork::random(15, 42);
+    network.save(weightsPath);
+    NeuralNetwork loaded = NeuralNetwork::load(weightsPath);
+    EXPECT_EQ(loaded.getBoardSize(), 15);
+
+    std::mt19937 rng(1);
+    for (int trial = 0; trial < 20; trial++)
+    {
+        Board board = randomBoard(15, trial * 5, rng);
+        NeuralAccumulator original(network, board);
+        NeuralAccumulator restored(loaded, board);
+        EXPECT_EQ(original.evaluate(Stone::BLACK), restored.evaluate(Stone::BLACK));
+        EXPECT_EQ(original.evaluate(Stone::WHITE), restored.evaluate(Stone::WHITE));
+    }
+}
+
+// 形式の違うファイルは読み込まない
+TEST_F(NeuralNetworkTest, RejectsInvalidFiles)
+{
+    {
+        std::ofstream file(weightsPath, std::ios::binary);
+        file << "NOTNNUE1 and some more bytes";
+    }
+    EXPECT_THROW(NeuralNetwork::load(weightsPath), std::runtime_error);
+
+    // 途中で切れたファイル
+    NeuralNetwork::random(9, 1).save(weightsPath);
+    std::string contents;
+    {
+        std::ifstream file(weightsPath, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream file(weightsPath, std::ios::binary | std::ios::trunc);
+        file.write(contents.data(), static_cast<std::streamsize>(contents.size() - 1));
+    }
+    EXPECT_THROW(NeuralNetwork::load(weightsPath), std::runtime_error);
+
+    EXPECT_THROW(NeuralNetwork::load("no_such_network.nnue"), std::runtime_error);
+    EXPECT_THROW(NeuralNetwork::random(65, 1), std::runtime_error);
+}
+
+// 差分で更新したアキュムレータは、盤面から作り直したものと同じ評価になる
+TEST_F(NeuralNetworkTest, IncrementalUpdateMatchesRefresh)
+{
+    NeuralNetwork network = NeuralNetwork::random(15, 7);
+    std::mt19937 rng(2);
+    Board board(15);
+    NeuralAccumulator accumulator(network, board);
+
+    std::uniform_int_distribution<int> cell(0, 14);
+    Stone stone = Stone::BLACK;
+    for (int step = 0; step < 300; step++)
+    {
+        int row = cell(rng);
+        int col = cell(rng);
+        Stone existing = board.getStone(row, col);
+        if (existing == Stone::EMPTY)
+        {
+            board.placeStone(row, col, stone);
+            accumulator.addStone(row, col, stone);
+            stone = (stone == Stone::BLACK) ? Stone::WHITE : Stone::BLACK;
+        }
+        else
+        {
+            board.placeStone(row, col, Stone::EMPTY);
+            accumulator.removeStone(row, col, existing);
+        }
+
+        NeuralAccumulator fresh(network, board);
+        ASSERT_EQ(accumulator.evaluate(Stone::BLACK), fresh.evaluate(Stone::BLACK));
+        ASSERT_EQ(accumulator.evaluate(Stone::WHITE), fresh.evaluate(Stone::WHITE));
+    }
+}
+
+// AVX2 版は通常の実装と同じ値を返す
+TEST_F(NeuralNetworkTest, SimdMatchesScalar)
+{
+    if (!BoardScan::isSupported(SimdLevel::AVX2))
+        GTEST_SKIP() << "AVX2 is not available";
+
+    NeuralNetwork network = NeuralNetwork::random(15, 11);
+    SimdLevel previous = NeuralNetwork::getLevel();
+    std::mt19937 rng(3);
+    for (int trial = 0; trial < 50; trial++)
+    {
+        Board board = randomBoard(15, trial * 4, rng);
+        NeuralAccumulator accumulator(network, board);
+
+        NeuralNetwork::setLevel(SimdLevel::SCALAR);
+        int scalar = accumulator.evaluate(Stone::BLACK);
+        NeuralNetwork::setLevel(SimdLevel::AVX2);
+        EXPECT_EQ(accumulator.evaluate(Stone::BLACK), scalar);
+    }
+    NeuralNetwork::setLevel(previous);
+
+    EXPECT_THROW(NeuralNetwork::setLevel(SimdLevel::SSE2), std::runtime_error);
+}
+
+// 探索の末端の評価に使える
+TEST_F(NeuralNetworkTest, UsedBySearch)
+{
+    Board board(15);
+    board.placeStone(7, 7, Stone::BLACK);
+    board.placeStone(7, 8, Stone::WHITE);
+
+    SearchLimits limits;
+    limits.maxDepth = 3;
+    limits.network = std::make_shared<NeuralNetwork>(NeuralNetwork::random(15, 5));
+    SearchResult result = Search::run(board, Stone::BLACK, limits);
+    EXPECT_TRUE(result.completed);
+    EXPECT_EQ(result.depth, 3);
+    EXPECT_EQ(board.getStone(result.bestMove.first, result.bestMove.second), Stone::EMPTY);
+
+    // 勝ちの手は評価に関わらず見つける
+    Board winning(15);
+    for (int col = 3; col < 7; col++)
+    {
+        winning.placeStone(7, col, Stone::BLACK);
+        winning.placeStone(0, col * 2, Stone::WHITE);
+    }
+    result = Search::run(winning, Stone::BLACK, limits);
+    EXPECT_TRUE(Search::isWinScore(result.score));
+
+    // 盤面サイズが違うネットワークは使わず、手書きの評価で探索する
+    Board small(9);
+    small.placeStone(4, 4, Stone::BLACK);
+    SearchLimits handwritten = limits;
+    handwritten.network = nullptr;
+    EXPECT_EQ(Search::run(small, Stone::WHITE, limits).score, Search::run(small, Stone::WHITE, handwritten).score);
+
+    // アキュムレータを直接作る場合は例外になる
+    EXPECT_THROW(NeuralAccumulator(*limits.network, small), std::runtime_error);
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/Perft.h"
+#include <numeric>
+
+using namespace GomokuLib;
+
+namespace
+{
+    // 黒白の順に打った対局
+    Game gameWithMoves(int boardSize, const std::vector<std::pair<int, int>> &moves)
+    {
+        Game game(boardSize);
+        for (const auto &move : moves)
+        {
+            EXPECT_EQ(game.playTurn(move.first, move.second), MoveResult::SUCCESS);
+        }
+        return game;
+    }
+
+    // 5x5 で黒が1行目に四を並べ、白が2行目に4つ並べた局面（黒番）
+    Game fiveByFourInARow()
+    {
+        return gameWithMoves(5, {{0, 0}, {1, 0}, {0, 1}, {1, 1}, {0, 2}, {1, 2}, {0, 3}, {1, 3}});
+    }
+
+    // 6x6 で黒が三を持つ局面（黒番、3手目で五連ができる並びがある）
+    Game sixBySixThree()
+    {
+        return gameWithMoves(6, {{2, 1}, {3, 1}, {2, 2}, {3, 2}, {2, 3}, {1, 1}, {3, 3}, {4, 4}});
+    }
+}
+
+// 空の盤面では、終局するまでは空きマスの順列の数になる
+TEST(PerftTest, EmptyBoard)
+{
+    Game game(5);
+    EXPECT_EQ(Perft::count(game, 0).sequences, 1u);
+    EXPECT_EQ(Perft::count(game, 1).sequences, 25u);
+    EXPECT_EQ(Perft::count(game, 2).sequences, 600u);
+    EXPECT_EQ(Perft::count(game, 3).sequences, 13800u);
+
+    PerftResult result = Perft::count(game, 4);
+    EXPECT_EQ(result.sequences, 303600u);
+    EXPECT_EQ(result.nodes, 25u + 600u + 13800u + 303600u);
+    EXPECT_EQ(result.terminals, 0u);
+}
+
+// 既知の数（盤面を直接操作する別の実装で数えた値）
+TEST(PerftTest, KnownCounts)
+{
+    Game nearWin = fiveByFourInARow();
+    const uint64_t nearWinCounts[] = {17, 256, 3615, 47460};
+    for (int depth = 1; depth <= 4; depth++)
+    {
+        EXPECT_EQ(Perft::count(nearWin, depth).sequences, nearWinCounts[depth - 1]) << "depth " << depth;
+    }
+
+    // 黒の (0,4) で即座に終局する
+    PerftResult one = Perft::count(nearWin, 1);
+    EXPECT_EQ(one.terminals, 1u);
+
+    Game three = sixBySixThree();
+    const uint64_t threeCounts[] = {28, 756, 19656, 488800};
+    for (int depth = 1; depth <= 4; depth++)
+    {
+        EXPECT_EQ(Perft::count(three, depth).sequences, threeCounts[depth - 1]) << "depth " << depth;
+    }
+}
+
+// 数えた後は元の局面・棋譜に戻る
+TEST(PerftTest, RestoresGame)
+{
+    Game game = sixBySixThree();
+    auto movesBefore = game.getMoves();
+    size_t nodesBefore = game.getVariationNodeCount();
+
+    Perft::count(game, 3);
+    EXPECT_EQ(game.getMoves(), movesBefore);
+    EXPECT_EQ(game.getLineView().size(), movesBefore.size());
+    EXPECT_EQ(game.getVariationNodeCount(), nodesBefore);
+    EXPECT_EQ(game.getCurrentPlayer(), Stone::BLACK);
+    EXPECT_FALSE(game.isGameOver());
+
+    // 棋譜の途中の局面から数えても、戻した手とその先の変化は残る
+    Game branched = sixBySixThree();
+    branched.undoMove();
+    branched.undoMove();
+    branched.playTurn(5, 0);
+    branched.undoMove();
+    auto lineBefore = branched.getLineView();
+    std::vector<std::pair<int, int>> lineMoves(lineBefore.begin(), lineBefore.end());
+    auto variationsBefore = branched.getVariations();
+    ASSERT_EQ(variationsBefore.size(), 2u);
+    Perft::count(branched, 2);
+    Perft::divide(branched, 2);
+    Perft::countParallel(branched, 2, 2);
+    auto lineAfter = branched.getLineView();
+    std::vector<std::pair<int, int>> lineMovesAfter(lineAfter.begin(), lineAfter.end());
+    EXPECT_EQ(lineMovesAfter, lineMoves);
+    EXPECT_EQ(branched.getVariations(), variationsBefore);
+    EXPECT_EQ(branched.getPly(), movesBefore.size() - 2);
+    EXPECT_TRUE(branched.redoMove());
+
+    // 終局した局面から先には打てない
+    game.playTurn(2, 0);
+    game.playTurn(5, 5);
+    game.playTurn(2, 4);
+    ASSERT_TRUE(game.isGameOver());
+    EXPECT_EQ(Perft::count(game, 0).sequences, 1u);
+    EXPECT_EQ(Perft::count(game, 2).sequences, 0u);
+}
+
+// 初手ごとの分割と並列の結果は、逐次の結果と一致する
+TEST(PerftTest, DivideAndParallel)
+{
+    Game game = fiveByFourInARow();
+    PerftResult serial = Perft::count(game, 3);
+
+    auto divided = Perft::divide(game, 3);
+    EXPECT_EQ(divided.size(), 17u);
+    uint64_t sum = std::accumulate(divided.begin(), divided.end(), uint64_t(0),
+                                   [](uint64_t total, const auto &entry)
+                                   { return total + entry.second; });
+    EXPECT_EQ(sum, serial.sequences);
+
+    PerftResult parallel = Perft::countParallel(game, 3, 4);
+    EXPECT_EQ(parallel.sequences, serial.sequences);
+    EXPECT_EQ(parallel.nodes, serial.nodes);
+    EXPECT_EQ(parallel.terminals, serial.terminals);
+    EXPECT_EQ(Perft::countParallel(game, 1, 4).sequences, 17u);
+}
+
+// 持ち時間のある対局でも時計は変わらず、途中で時間切れにもならない
+TEST(PerftTest, LeavesClockUntouched)
+{
+    TimeControl control;
+    control.initialMs = 60000;
+    control.incrementMs = 1000;
+    Game game = sixBySixThree();
+    game.setTimeControl(control);
+    game.playTurn(0, 0);
+    game.getClock().stop();
+    int64_t black = game.getClock().getRemaining(Stone::BLACK);
+    int64_t white = game.getClock().getRemaining(Stone::WHITE);
+
+    Perft::count(game, 2);
+    Perft::divide(game, 2);
+    Perft::countParallel(game, 2, 2);
+    EXPECT_EQ(game.getClock().getRemaining(Stone::BLACK), black);
+    EXPECT_EQ(game.getClock().getRemaining(Stone::WHITE), white);
+    EXPECT_FALSE(game.getClock().isRunning());
+
+    // 数えている間に持ち時間が尽きても、数は時間制限のない対局と同じ
+    Game hurried = sixBySixThree();
+    control.initialMs = 1;
+    control.incrementMs = 0;
+    hurried.setTimeControl(control);
+    hurried.startClock();
+    EXPECT_EQ(Perft::count(hurried, 3).sequences, 19656u);
+    EXPECT_EQ(Perft::countParallel(hurried, 3, 2).sequences, 19656u);
+    EXPECT_EQ(hurried.getClock().getFlagged(), Stone::EMPTY);
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/RecordValidator.h"
+#include "GomokuLib/Game.h"
+#include <cstdio> // for remove()
+
+using namespace GomokuLib;
+
+// 正しい棋譜の検証
+TEST(RecordValidatorTest, ValidRecord)
+{
+    RecordSummary summary = RecordValidator::validate(
+        "SIZE: 5\nMOVES:\n0,0,B\n1,0,W\n0,1,B\n1,1,W\n0,2,B\n1,2,W\n0,3,B\n1,3,W\n0,4,B\n");
+
+    EXPECT_TRUE(summary.isValid());
+    EXPECT_EQ(summary.boardSize, 5);
+    EXPECT_EQ(summary.moves.size(), 9);
+    EXPECT_EQ(summary.winner, Stone::BLACK);
+}
+
+// 盤面外・既に石がある位置への着手
+TEST(RecordValidatorTest, IllegalMoves)
+{
+    RecordSummary summary = RecordValidator::validate("SIZE: 5\nMOVES:\n0,0,B\n0,0,W\n9,9,W\n");
+
+    ASSERT_EQ(summary.issues.size(), 2);
+    EXPECT_EQ(summary.issues[0].type, RecordIssueType::ILLEGAL_MOVE);
+    EXPECT_EQ(summary.issues[0].line, 4);
+    EXPECT_EQ(summary.issues[0].moveIndex, 2);
+    EXPECT_EQ(summary.issues[1].type, RecordIssueType::ILLEGAL_MOVE);
+    EXPECT_EQ(summary.moves.size(), 1);
+}
+
+// 終局後の着手
+TEST(RecordValidatorTest, MoveAfterGameOver)
+{
+    RecordSummary summary = RecordValidator::validate(
+        "SIZE: 5\n0,0,B\n1,0,W\n0,1,B\n1,1,W\n0,2,B\n1,2,W\n0,3,B\n1,3,W\n0,4,B\n2,2,W\n");
+
+    ASSERT_EQ(summary.issues.size(), 1);
+    EXPECT_EQ(summary.issues[0].type, RecordIssueType::MOVE_AFTER_GAME_OVER);
+    EXPECT_EQ(summary.issues[0].moveIndex, 10);
+    EXPECT_EQ(summary.winner, Stone::BLACK);
+}
+
+// 手番の色の誤り
+TEST(RecordValidatorTest, WrongColorOrder)
+{
+    RecordSummary summary = RecordValidator::validate("SIZE: 15\nMOVES:\n7,7,B\n7,8,B\n");
+
+    ASSERT_EQ(summary.issues.size(), 1);
+    EXPECT_EQ(summary.issues[0].type, RecordIssueType::WRONG_COLOR_ORDER);
+    EXPECT_EQ(summary.moves.size(), 2);
+}
+
+// 書式の誤りと盤面サイズ
+TEST(RecordValidatorTest, ParseErrors)
+{
+    RecordSummary summary = RecordValidator::validate("# comment\r\nSIZE: 3\nMOVES:\n7;7;B\n7,x,B\n7,7,X\n");
+
+    ASSERT_EQ(summary.issues.size(), 4);
+    EXPECT_EQ(summary.issues[0].type, RecordIssueType::INVALID_SIZE);
+    EXPECT_EQ(summary.issues[1].type, RecordIssueType::PARSE_ERROR);
+    EXPECT_EQ(summary.issues[2].type, RecordIssueType::PARSE_ERROR);
+    EXPECT_EQ(summary.issues[3].type, RecordIssueType::PARSE_ERROR);
+    EXPECT_TRUE(summary.moves.empty());
+}
+
+// 変化の木は検証の対象外
+TEST(RecordValidatorTest, IgnoresVariations)
+{
+    RecordSummary summary = RecordValidator::validate(
+        "SIZE: 15\nMOVES:\n7,7,B\nVARIATIONS:\n0 7,7 *\n1 7,8 *\n1 8,8\n");
+
+    EXPECT_TRUE(summary.isValid());
+    EXPECT_EQ(summary.moves.size(), 1);
+}
+
+// saveGame で保存した棋譜は正しいと判定される
+TEST(RecordValidatorTest, ValidateSavedFile)
+{
+    const std::string testFilePath = "test_validator.gomoku";
+
+    Game game(15);
+    game.playTurn(7, 7);
+    game.playTurn(7, 8);
+    game.playTurn(8, 8);
+    game.saveGame(testFilePath);
+
+    RecordSummary summary = RecordValidator::validateFile(testFilePath);
+    EXPECT_TRUE(summary.isValid());
+    EXPECT_EQ(summary.moves, game.getMoves());
+    EXPECT_EQ(summary.winner, Stone::EMPTY);
+
+    remove(testFilePath.c_str());
+
+    EXPECT_THROW(RecordValidator::validateFile("non_existent_file.gomoku"), std::runtime_error);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/Search.h"
+
+using namespace GomokuLib;
+
+// 空の盤面では中央に打つ
+TEST(SearchTest, EmptyBoardPlaysCenter)
+{
+    Board board(15);
+    SearchLimits limits;
+    limits.maxDepth = 2;
+
+    SearchResult result = Search::run(board, Stone::BLACK, limits);
+    EXPECT_EQ(result.bestMove, std::make_pair(7, 7));
+    EXPECT_TRUE(result.completed);
+    EXPECT_EQ(result.depth, 2);
+}
+
+// 五連を作れるなら勝ちと読む
+TEST(SearchTest, FindsImmediateWin)
+{
+    Board board(15);
+    for (int i = 0; i < 4; ++i)
+    {
+        board.placeStone(7, 3 + i, Stone::BLACK);
+        board.placeStone(9, 3 + i, Stone::WHITE);
+    }
+
+    SearchResult result = Search::run(board, Stone::BLACK, SearchLimits());
+    EXPECT_TRUE(result.bestMove == std::make_pair(7, 2) || result.bestMove == std::make_pair(7, 7));
+    EXPECT_EQ(result.score, Search::SCORE_WIN);
+    EXPECT_TRUE(Search::isWinScore(result.score));
+}
+
+// 両端が空いた三を止めないと負ける局面では止める
+TEST(SearchTest, BlocksOpenThree)
+{
+    Board board(15);
+    board.placeStone(7, 6, Stone::WHITE);
+    board.placeStone(7, 7, Stone::WHITE);
+    board.placeStone(7, 8, Stone::WHITE);
+    board.placeStone(0, 0, Stone::BLACK);
+    board.placeStone(14, 14, Stone::BLACK);
+
+    SearchLimits limits;
+    limits.maxDepth = 4;
+    SearchResult result = Search::run(board, Stone::BLACK, limits);
+    EXPECT_TRUE(result.bestMove == std::make_pair(7, 5) || result.bestMove == std::make_pair(7, 9))
+        << result.bestMove.first << "," << result.bestMove.second;
+    EXPECT_FALSE(result.principalVariation.empty());
+    EXPECT_EQ(result.principalVariation.front(), result.bestMove);
+}
+
+// 深さを読み終えるたびに途中経過が通知される
+TEST(SearchTest, ReportsProgressPerDepth)
+{
+    Board board(15);
+    board.placeStone(7, 7, Stone::BLACK);
+
+    SearchLimits limits;
+    limits.maxDepth = 3;
+    std::vector<int> depths;
+    Search::run(board, Stone::WHITE, limits, CancellationToken(),
+                [&](const SearchResult &partial)
+                {
+                    depths.push_back(partial.depth);
+                    EXPECT_GE(partial.bestMove.first, 0);
+                });
+
+    EXPECT_EQ(depths, std::vector<int>({1, 2, 3}));
+}
+
+// キャンセルされると読み終えた深さまでの結果を返す
+TEST(SearchTest, Cancellation)
+{
+    Board board(15);
+    board.placeStone(7, 7, Stone::BLACK);
+
+    CancellationToken token;
+    CancellationToken copy = token;
+    copy.cancel();
+    EXPECT_TRUE(token.isCancelled());
+
+    SearchLimits limits;
+    limits.maxDepth = 20;
+    SearchResult result = Search::run(board, Stone::WHITE, limits, token);
+    EXPECT_FALSE(result.completed);
+    EXPECT_LT(result.depth, 20);
+    EXPECT_GE(result.bestMove.first, 0);
+}
+
+// 置換表を使っても同じ手を選び、盤面サイズが違う表は受け付けない
+TEST(SearchTest, TranspositionTable)
+{
+    Board board(15);
+    board.placeStone(7, 6, Stone::WHITE);
+    board.placeStone(7, 7, Stone::WHITE);
+    board.placeStone(7, 8, Stone::WHITE);
+    board.placeStone(0, 0, Stone::BLACK);
+    board.placeStone(14, 14, Stone::BLACK);
+
+    SearchLimits limits;
+    limits.maxDepth = 4;
+    TranspositionTable table(15, 1 << 16);
+    SearchResult first = Search::run(board, Stone::BLACK, limits, CancellationToken(), nullptr, &table);
+    SearchResult second = Search::run(board, Stone::BLACK, limits, CancellationToken(), nullptr, &table);
+
+    EXPECT_TRUE(first.bestMove == std::make_pair(7, 5) || first.bestMove == std::make_pair(7, 9));
+    EXPECT_EQ(second.bestMove, first.bestMove);
+    EXPECT_EQ(second.score, first.score);
+    // 2回目は置換表の結果で読みを省ける
+    EXPECT_LT(second.nodes, first.nodes);
+
+    TranspositionTable wrongSize(9, 16);
+    EXPECT_THROW(Search::run(board, Stone::BLACK, limits, CancellationToken(), nullptr, &wrongSize), std::runtime_error);
+}
+
+// 局面数の上限で打ち切ると completed が false になる
+TEST(SearchTest, NodeBudget)
+{
+    Board board(15);
+    board.placeStone(7, 7, Stone::BLACK);
+
+    SearchLimits limits;
+    limits.maxDepth = 10;
+    limits.maxNodes = 500;
+    SearchResult result = Search::run(board, Stone::WHITE, limits);
+    EXPECT_FALSE(result.completed);
+    EXPECT_LE(result.nodes, 501u);
+    EXPECT_GE(result.bestMove.first, 0);
+}
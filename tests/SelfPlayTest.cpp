@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/Board.h"
+#include "GomokuLib/SelfPlay.h"
+#include <filesystem>
+
+using namespace GomokuLib;
+
+namespace
+{
+    // テスト用の小さな条件（9路盤、浅い探索）
+    SelfPlayOptions smallOptions(const std::string &directory)
+    {
+        SelfPlayOptions options;
+        options.outputDirectory = directory;
+        options.boardSize = 9;
+        options.games = 6;
+        options.seed = 5;
+        options.shardCount = 2;
+        options.limits.maxDepth = 2;
+        options.limits.maxCandidates = 6;
+        options.limits.maxNodes = 2000;
+        return options;
+    }
+
+    // シャードの全レコード
+    std::vector<TrainingSample> readShard(const std::string &path)
+    {
+        TrainingShardReader reader(path);
+        std::vector<TrainingSample> samples(reader.getRecordCount());
+        for (uint64_t i = 0; i < reader.getRecordCount(); i++)
+        {
+            reader.read(i, samples[i]);
+        }
+        return samples;
+    }
+
+    bool sameSamples(const std::vector<TrainingSample> &a, const std::vector<TrainingSample> &b)
+    {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (a[i].game != b[i].game || a[i].ply != b[i].ply || a[i].symmetry != b[i].symmetry ||
+                a[i].outcome != b[i].outcome || a[i].bestMove != b[i].bestMove || a[i].score != b[i].score ||
+                a[i].cells != b[i].cells)
+                return false;
+        }
+        return true;
+    }
+}
+
+class SelfPlayTest : public ::testing::Test
+{
+protected:
+    std::string directory = "self_play_test";
+    std::string otherDirectory = "self_play_test_other";
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(directory);
+        std::filesystem::remove_all(otherDirectory);
+    }
+};
+
+// 対局の各局面は、最善手が空きマスで、結果が勝った側と一致する
+TEST_F(SelfPlayTest, GameSamplesAreConsistent)
+{
+    SelfPlayOptions options = smallOptions(directory);
+    std::vector<TrainingSample> samples;
+    ASSERT_TRUE(SelfPlay::playGame(options, 0, samples));
+    ASSERT_FALSE(samples.empty());
+
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        const auto &sample = samples[i];
+        EXPECT_EQ(sample.ply, options.openingPlies + static_cast<int>(i));
+        EXPECT_EQ(sample.sideToMove, (sample.ply % 2 == 0) ? Stone::BLACK : Stone::WHITE);
+        EXPECT_EQ(sample.cells[static_cast<size_t>(sample.bestMove.first) * 9 + sample.bestMove.second], Stone::EMPTY);
+        if (i > 0)
+        {
+            // 隣り合う局面は、手番が入れ替わり結果も反対の立場になる
+            EXPECT_EQ(sample.outcome, -samples[i - 1].outcome);
+        }
+    }
+
+    // 同じ種なら同じ対局になる
+    std::vector<TrainingSample> again;
+    ASSERT_TRUE(SelfPlay::playGame(options, 0, again));
+    EXPECT_TRUE(sameSamples(samples, again));
+
+    // キャンセルされた対局は途中で止める
+    CancellationToken token;
+    token.cancel();
+    EXPECT_FALSE(SelfPlay::playGame(options, 0, again, token));
+}
+
+// 各シャードには自分の対局だけを、対称変換した8局面ずつ書く
+TEST_F(SelfPlayTest, WritesShards)
+{
+    SelfPlayOptions options = smallOptions(directory);
+    SelfPlayStats stats = SelfPlay::run(options);
+    EXPECT_EQ(stats.games, 6u);
+    EXPECT_EQ(stats.resumedSamples, 0u);
+
+    uint64_t total = 0;
+    for (size_t shard = 0; shard < 2; shard++)
+    {
+        auto samples = readShard(SelfPlay::shardPath(directory, shard));
+        ASSERT_FALSE(samples.empty());
+        ASSERT_EQ(samples.size() % TrainingData::SYMMETRY_COUNT, 0u);
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            EXPECT_EQ(samples[i].game % 2, shard);
+            EXPECT_EQ(samples[i].symmetry, static_cast<int>(i % TrainingData::SYMMETRY_COUNT));
+        }
+        total += samples.size();
+    }
+    EXPECT_EQ(stats.samples, total);
+}
+
+// 途中で止めて再開しても、一度に作った場合と同じデータになる
+TEST_F(SelfPlayTest, ResumeMatchesUninterruptedRun)
+{
+    SelfPlayOptions options = smallOptions(directory);
+    SelfPlay::run(options);
+
+    SelfPlayOptions interrupted = smallOptions(otherDirectory);
+    interrupted.games = 3;
+    SelfPlay::run(interrupted);
+
+    // 最後の対局のレコードを途中まで書いた状態にする
+    std::string lastShard = SelfPlay::shardPath(otherDirectory, 0);
+    auto size = std::filesystem::file_size(lastShard);
+    std::filesystem::resize_file(lastShard, size - TrainingData::recordSize(9) - 3);
+
+    interrupted.games = 6;
+    interrupted.resume = true;
+    SelfPlayStats stats = SelfPlay::run(interrupted);
+    EXPECT_GT(stats.resumedSamples, 0u);
+
+    for (size_t shard = 0; shard < 2; shard++)
+    {
+        EXPECT_TRUE(sameSamples(readShard(SelfPlay::shardPath(directory, shard)),
+                                readShard(SelfPlay::shardPath(otherDirectory, shard))));
+    }
+}
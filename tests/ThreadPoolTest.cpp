@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/ThreadPool.h"
+#include <atomic>
+
+using namespace GomokuLib;
+
+// 全てのタスクが実行されることを確認
+TEST(ThreadPoolTest, RunsAllTasks)
+{
+    ThreadPool pool(4);
+    std::atomic<int> counter(0);
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        pool.post([&counter]()
+                  { counter++; });
+    }
+    pool.waitIdle();
+
+    EXPECT_EQ(counter.load(), 1000);
+    EXPECT_EQ(pool.getThreadCount(), 4);
+}
+
+// タスクの中から投入したタスクも待機対象になる
+TEST(ThreadPoolTest, NestedTasks)
+{
+    ThreadPool pool(2);
+    std::atomic<int> counter(0);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        pool.post([&pool, &counter]()
+                  {
+                      EXPECT_GE(pool.currentWorkerIndex(), 0);
+                      for (int j = 0; j < 10; ++j)
+                      {
+                          pool.post([&counter]() { counter++; });
+                      } });
+    }
+    pool.waitIdle();
+
+    EXPECT_EQ(counter.load(), 100);
+    EXPECT_EQ(pool.currentWorkerIndex(), -1);
+}
+
+// future で結果を受け取る
+TEST(ThreadPoolTest, SubmitReturnsFuture)
+{
+    ThreadPool pool(2);
+    auto future = pool.submit([]()
+                              { return 6 * 7; });
+    EXPECT_EQ(future.get(), 42);
+}
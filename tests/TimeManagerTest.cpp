@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/Game.h"
+#include "GomokuLib/Search.h"
+#include "GomokuLib/TimeManager.h"
+#include <chrono>
+#include <thread>
+
+using namespace GomokuLib;
+
+namespace
+{
+    TimeControl makeControl(int64_t initialMs, int64_t incrementMs = 0)
+    {
+        TimeControl control;
+        control.initialMs = initialMs;
+        control.incrementMs = incrementMs;
+        return control;
+    }
+
+    GameClock::TimePoint at(GameClock::TimePoint origin, int64_t milliseconds)
+    {
+        return origin + std::chrono::milliseconds(milliseconds);
+    }
+}
+
+// 手番側の時計だけが動き、押すと増分を加えて相手の時計に切り替わる
+TEST(GameClockTest, ChargesOnlyTheSideToMove)
+{
+    GameClock clock(makeControl(10000, 500));
+    auto origin = GameClock::Clock::now();
+    EXPECT_FALSE(clock.isRunning());
+
+    clock.start(Stone::BLACK, origin);
+    EXPECT_EQ(clock.getRemaining(Stone::BLACK, at(origin, 1200)), 8800);
+    EXPECT_EQ(clock.getRemaining(Stone::WHITE, at(origin, 1200)), 10000);
+
+    EXPECT_TRUE(clock.press(Stone::BLACK, at(origin, 1200)));
+    EXPECT_EQ(clock.getRunning(), Stone::WHITE);
+    EXPECT_EQ(clock.getRemaining(Stone::BLACK, at(origin, 5000)), 9300);
+    EXPECT_EQ(clock.getRemaining(Stone::WHITE, at(origin, 5000)), 6200);
+    EXPECT_EQ(clock.getElapsed(at(origin, 5000)), 3800);
+
+    clock.stop(at(origin, 5000));
+    EXPECT_FALSE(clock.isRunning());
+    EXPECT_EQ(clock.getRemaining(Stone::WHITE, at(origin, 9000)), 6200);
+    EXPECT_EQ(clock.getFlagged(), Stone::EMPTY);
+}
+
+// 残り時間か1手の上限を超えると時間切れになる
+TEST(GameClockTest, FlagsWhenTimeRunsOut)
+{
+    auto origin = GameClock::Clock::now();
+    GameClock clock(makeControl(1000));
+    clock.start(Stone::BLACK, origin);
+    EXPECT_EQ(clock.checkFlag(at(origin, 1000)), Stone::EMPTY);
+    EXPECT_EQ(clock.checkFlag(at(origin, 1001)), Stone::BLACK);
+
+    TimeControl perMove = makeControl(60000);
+    perMove.maxMoveMs = 2000;
+    GameClock limited(perMove);
+    limited.start(Stone::BLACK, origin);
+    EXPECT_TRUE(limited.press(Stone::BLACK, at(origin, 1500)));
+    EXPECT_FALSE(limited.press(Stone::WHITE, at(origin, 4000)));
+    EXPECT_EQ(limited.getFlagged(), Stone::WHITE);
+
+    // 時間制限がなければ時計は動かない
+    GameClock untimed;
+    untimed.start(Stone::BLACK, origin);
+    EXPECT_FALSE(untimed.isRunning());
+    EXPECT_TRUE(untimed.press(Stone::BLACK, at(origin, 100000)));
+}
+
+// 対局は着手のたびに時計を押し、時間切れになった側の負けで終局する
+TEST(GameClockTest, GameEndsOnTime)
+{
+    Game game(15);
+    game.setTimeControl(makeControl(60000));
+    EXPECT_EQ(game.playTurn(7, 7), MoveResult::SUCCESS);
+    EXPECT_EQ(game.getClock().getRunning(), Stone::WHITE);
+
+    // 一手戻すと、戻した側の時計に切り替わる
+    EXPECT_TRUE(game.undoMove());
+    EXPECT_EQ(game.getClock().getRunning(), Stone::BLACK);
+
+    game.setTimeControl(makeControl(20));
+    game.startClock();
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_EQ(game.playTurn(7, 7), MoveResult::GAME_OVER);
+    EXPECT_TRUE(game.isGameOver());
+    EXPECT_EQ(game.getWinner(), Stone::WHITE);
+    EXPECT_EQ(game.getBoard().getStone(7, 7), Stone::EMPTY);
+
+    // 持ち時間を設定し直すと時間切れも消える
+    game.reset();
+    EXPECT_FALSE(game.isGameOver());
+    EXPECT_EQ(game.getClock().getRemaining(Stone::BLACK), 20);
+}
+
+// 時間制限がなければ無制限、あれば目安は上限を超えず、上限は残り時間の一部に収まる
+TEST(TimeManagerTest, AllocatesFromRemainingTime)
+{
+    EXPECT_FALSE(TimeManager::allocate(TimeControl(), 0, 15, 0).isLimited());
+
+    TimeBudget middle = TimeManager::allocate(makeControl(60000), 60000, 15, 20);
+    EXPECT_TRUE(middle.isLimited());
+    EXPECT_EQ(middle.softMs, 60000 / 25);
+    EXPECT_LE(middle.softMs, middle.hardMs);
+    EXPECT_LE(middle.hardMs, 60000 / TimeManager::HARD_SHARE);
+
+    // 序盤は控えめに、終盤（空きが少ない）は残り時間を多めに使う
+    EXPECT_LT(TimeManager::allocate(makeControl(60000), 60000, 15, 0).softMs, middle.softMs);
+    EXPECT_GT(TimeManager::allocate(makeControl(60000), 60000, 7, 40).softMs, middle.softMs);
+
+    // 増分があれば、その分を多く使う
+    EXPECT_GT(TimeManager::allocate(makeControl(60000, 1000), 60000, 15, 20).softMs, middle.softMs);
+
+    // 1手の上限と遅れに備える分は上限から除く
+    TimeControl capped = makeControl(60000);
+    capped.maxMoveMs = 1000;
+    capped.overheadMs = 100;
+    TimeBudget cappedBudget = TimeManager::allocate(capped, 60000, 15, 20);
+    EXPECT_EQ(cappedBudget.hardMs, 900);
+    EXPECT_LE(cappedBudget.softMs, 900);
+
+    // 時間が尽きていても最小の時間で指す
+    TimeBudget exhausted = TimeManager::allocate(makeControl(60000), -5, 15, 20);
+    EXPECT_EQ(exhausted.softMs, 1);
+    EXPECT_EQ(exhausted.hardMs, 1);
+}
+
+// 最善手が変わると目安が延び、変わらなければ縮み、強制手ならすぐに止める
+TEST(TimeManagerTest, AdjustsToBestMoveStability)
+{
+    auto origin = TimeManager::Clock::now();
+    TimeBudget budget;
+    budget.softMs = 100;
+    budget.hardMs = 400;
+
+    TimeManager manager(budget, origin);
+    EXPECT_FALSE(manager.isHardExpired(at(origin, 399)));
+    EXPECT_TRUE(manager.isHardExpired(at(origin, 400)));
+
+    EXPECT_TRUE(manager.shouldContinue({7, 7}, false, at(origin, 10)));
+    EXPECT_EQ(manager.getSoftLimit(), 100);
+    EXPECT_TRUE(manager.shouldContinue({7, 8}, false, at(origin, 20)));
+    EXPECT_EQ(manager.getSoftLimit(), 160);
+    EXPECT_TRUE(manager.shouldContinue({7, 8}, false, at(origin, 30)));
+    EXPECT_EQ(manager.getSoftLimit(), 136);
+    EXPECT_FALSE(manager.shouldContinue({7, 8}, false, at(origin, 140)));
+
+    TimeManager forced(budget, origin);
+    EXPECT_FALSE(forced.shouldContinue({7, 7}, true, at(origin, 1)));
+
+    // 次の深さを上限までに読み終えられそうになければ始めない
+    TimeBudget wide;
+    wide.softMs = 1000;
+    wide.hardMs = 1000;
+    TimeManager slow(wide, origin);
+    EXPECT_FALSE(slow.shouldContinue({7, 7}, false, at(origin, 400)));
+
+    // 時間制限がなければ止めない
+    TimeManager unlimited(TimeBudget(), origin);
+    EXPECT_TRUE(unlimited.shouldContinue({7, 7}, true, at(origin, 1000000)));
+    EXPECT_FALSE(unlimited.isHardExpired());
+}
+
+// 他の手が全て負けになる局面では、深く読まずに受けの手を返す
+TEST(TimeManagerTest, SearchStopsOnForcedMove)
+{
+    Board board(15);
+    board.placeStone(7, 2, Stone::WHITE);
+    for (int col = 3; col <= 6; col++)
+    {
+        board.placeStone(7, col, Stone::BLACK);
+    }
+    board.placeStone(0, 0, Stone::WHITE);
+    board.placeStone(14, 14, Stone::WHITE);
+
+    SearchLimits limits;
+    limits.maxDepth = 12;
+    limits.time.softMs = 60000;
+    limits.time.hardMs = 60000;
+    SearchResult result = Search::run(board, Stone::WHITE, limits);
+    EXPECT_EQ(result.bestMove, std::make_pair(7, 7));
+    EXPECT_TRUE(result.forced);
+    EXPECT_TRUE(result.completed);
+    EXPECT_LE(result.depth, 2);
+}
+
+// 上限を過ぎると読んでいる途中でも打ち切り、読み終えた深さの手を返す
+TEST(TimeManagerTest, SearchRespectsHardLimit)
+{
+    Board board(15);
+    board.placeStone(7, 7, Stone::BLACK);
+    board.placeStone(7, 8, Stone::WHITE);
+    board.placeStone(8, 8, Stone::BLACK);
+
+    SearchLimits limits;
+    limits.maxDepth = 64;
+    limits.maxCandidates = 20;
+    limits.time.softMs = 30;
+    limits.time.hardMs = 60;
+    auto start = std::chrono::steady_clock::now();
+    SearchResult result = Search::run(board, Stone::WHITE, limits);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_GE(result.bestMove.first, 0);
+    EXPECT_LT(result.depth, 64);
+    EXPECT_LT(elapsed, 1000);
+}
@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/Tracer.h"
+#include "GomokuLib/Game.h"
+#include "GomokuLib/Search.h"
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace GomokuLib;
+
+namespace
+{
+    std::string readFile(const std::string &path)
+    {
+        std::ifstream file(path);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    size_t countOccurrences(const std::string &text, const std::string &pattern)
+    {
+        size_t count = 0;
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+        {
+            count++;
+        }
+        return count;
+    }
+}
+
+class TracerTest : public ::testing::Test
+{
+protected:
+    std::string tracePath = "tracer_test.json";
+
+    void SetUp() override
+    {
+        if (!Instrumentation::ENABLED)
+            GTEST_SKIP() << "tracing is disabled in this build";
+    }
+
+    void TearDown() override
+    {
+        Tracer::stop();
+        std::remove(tracePath.c_str());
+    }
+};
+
+// 止めている間は何も記録しない
+TEST_F(TracerTest, DisabledByDefault)
+{
+    EXPECT_FALSE(Tracer::isEnabled());
+    Game game(15);
+    game.playTurn(7, 7);
+
+    Tracer::start(tracePath);
+    EXPECT_TRUE(Tracer::isEnabled());
+    Tracer::stop();
+    EXPECT_FALSE(Tracer::isEnabled());
+
+    EXPECT_EQ(Tracer::getWrittenCount(), 0);
+    EXPECT_EQ(readFile(tracePath), "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n]}\n");
+}
+
+// 着手・勝敗判定・保存・探索の区間が Chrome のトレース形式で書き出される
+TEST_F(TracerTest, RecordsSpans)
+{
+    Tracer::start(tracePath);
+    Game game(15);
+    game.playTurn(7, 7);
+    game.playTurn(8, 8);
+    game.saveGame("tracer_test_game.txt");
+    Game::loadGame("tracer_test_game.txt");
+    std::remove("tracer_test_game.txt");
+    SearchLimits limits;
+    limits.maxDepth = 2;
+    Search::run(game.getBoard(), game.getCurrentPlayer(), limits);
+    Tracer::stop();
+
+    std::string trace = readFile(tracePath);
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0);
+    EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"Game::playTurn\""), 4); // loadGame も棋譜を打ち直す
+    EXPECT_GE(countOccurrences(trace, "\"name\":\"Board::checkWinAt\""), 2);
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"Game::saveGame\",\"cat\":\"io\",\"ph\":\"X\""), 1);
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"Game::loadGame\""), 1);
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"Search::run\""), 1);
+    EXPECT_EQ(countOccurrences(trace, "\"args\":{\"depth\":2}"), 1);
+    EXPECT_EQ(countOccurrences(trace, "\"ph\":\"X\""), Tracer::getWrittenCount());
+    EXPECT_EQ(Tracer::getDroppedCount(), 0);
+}
+
+// スレッドごとに別の tid で記録され、終了したスレッドの区間も失われない
+TEST_F(TracerTest, SeparatesThreads)
+{
+    Tracer::start(tracePath);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; t++)
+    {
+        threads.emplace_back([]
+                             {
+                                 for (int i = 0; i < 10; i++)
+                                 {
+                                     GOMOKU_TRACE_SCOPE("test", "worker", "index", i);
+                                 } });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+    Tracer::stop();
+
+    std::string trace = readFile(tracePath);
+    EXPECT_EQ(countOccurrences(trace, "\"name\":\"worker\""), 30);
+
+    std::set<std::string> threadIds;
+    for (size_t pos = trace.find("\"tid\":"); pos != std::string::npos; pos = trace.find("\"tid\":", pos + 1))
+    {
+        threadIds.insert(trace.substr(pos, trace.find_first_of(",}", pos) - pos));
+    }
+    EXPECT_EQ(threadIds.size(), 3);
+}
+
+// バッファが溢れた区間は捨てて数える
+TEST_F(TracerTest, CountsDroppedEvents)
+{
+    Tracer::start(tracePath);
+    std::thread producer([&]
+                         {
+                             // 書き出しが追いつく前に一度に書き込む
+                             for (size_t i = 0; i < Tracer::BUFFER_CAPACITY * 4; i++)
+                             {
+                                 GOMOKU_TRACE_SCOPE("test", "burst");
+                             } });
+    producer.join();
+    Tracer::stop();
+
+    EXPECT_EQ(Tracer::getWrittenCount() + Tracer::getDroppedCount(), Tracer::BUFFER_CAPACITY * 4);
+    EXPECT_GE(Tracer::getWrittenCount(), Tracer::BUFFER_CAPACITY);
+}
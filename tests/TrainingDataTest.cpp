@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/TrainingData.h"
+#include <cstdio>
+#include <set>
+#include <unistd.h>
+
+using namespace GomokuLib;
+
+namespace
+{
+    TrainingSample makeSample(int size, uint32_t game, int ply)
+    {
+        TrainingSample sample;
+        sample.game = game;
+        sample.ply = ply;
+        sample.sideToMove = (ply % 2 == 0) ? Stone::BLACK : Stone::WHITE;
+        sample.outcome = -1;
+        sample.bestMove = {1, size - 2};
+        sample.score = -123456;
+        sample.cells.assign(static_cast<size_t>(size) * size, Stone::EMPTY);
+        sample.cells[0] = Stone::BLACK;
+        sample.cells[static_cast<size_t>(size) + 3] = Stone::WHITE;
+        sample.cells[static_cast<size_t>(size) * size - 1] = Stone::BLACK;
+        return sample;
+    }
+
+    void expectSameSample(const TrainingSample &a, const TrainingSample &b)
+    {
+        EXPECT_EQ(a.game, b.game);
+        EXPECT_EQ(a.ply, b.ply);
+        EXPECT_EQ(a.symmetry, b.symmetry);
+        EXPECT_EQ(a.sideToMove, b.sideToMove);
+        EXPECT_EQ(a.outcome, b.outcome);
+        EXPECT_EQ(a.bestMove, b.bestMove);
+        EXPECT_EQ(a.score, b.score);
+        EXPECT_EQ(a.cells, b.cells);
+    }
+}
+
+class TrainingDataTest : public ::testing::Test
+{
+protected:
+    std::string shardPath = "training_data_test.bin";
+
+    void TearDown() override
+    {
+        std::remove(shardPath.c_str());
+    }
+};
+
+// レコードに変換して戻すと同じ局面になる
+TEST_F(TrainingDataTest, EncodeAndDecode)
+{
+    for (int size : {5, 15, 19})
+    {
+        TrainingSample sample = makeSample(size, 7, 12);
+        std::vector<uint8_t> record(TrainingData::recordSize(size));
+        TrainingData::encode(sample, size, record.data());
+
+        TrainingSample decoded;
+        TrainingData::decode(record.data(), size, decoded);
+        expectSameSample(sample, decoded);
+    }
+}
+
+// 8通りの対称変換は全て異なり、石の数と最善手のマスの中身を保つ
+TEST_F(TrainingDataTest, SymmetriesAreDistinct)
+{
+    const int size = 9;
+    TrainingSample sample = makeSample(size, 0, 0);
+    sample.cells[static_cast<size_t>(sample.bestMove.first) * size + sample.bestMove.second] = Stone::WHITE;
+
+    std::set<std::vector<Stone>> boards;
+    TrainingSample transformed;
+    for (int symmetry = 0; symmetry < TrainingData::SYMMETRY_COUNT; symmetry++)
+    {
+        TrainingData::applySymmetry(sample, size, symmetry, transformed);
+        EXPECT_EQ(transformed.symmetry, symmetry);
+        EXPECT_EQ(transformed.cells[static_cast<size_t>(transformed.bestMove.first) * size + transformed.bestMove.second],
+                  Stone::WHITE);
+        boards.insert(transformed.cells);
+    }
+    EXPECT_EQ(boards.size(), static_cast<size_t>(TrainingData::SYMMETRY_COUNT));
+
+    // 恒等変換は元の局面のまま
+    TrainingData::applySymmetry(sample, size, 0, transformed);
+    expectSameSample(sample, transformed);
+}
+
+// 書き出したレコードを読み込める
+TEST_F(TrainingDataTest, WriteAndRead)
+{
+    TrainingShardInfo info{15, 99, 2, 4};
+    {
+        TrainingShardWriter writer(shardPath, info, false, 256);
+        for (int i = 0; i < 10; i++)
+        {
+            writer.append(makeSample(15, static_cast<uint32_t>(i / 3), i));
+        }
+        EXPECT_EQ(writer.getRecordCount(), 10u);
+        EXPECT_EQ(writer.getLastGame(), 3);
+    }
+
+    TrainingShardReader reader(shardPath);
+    EXPECT_EQ(reader.getInfo().boardSize, 15);
+    EXPECT_EQ(reader.getInfo().seed, 99u);
+    EXPECT_EQ(reader.getInfo().shardIndex, 2u);
+    EXPECT_EQ(reader.getInfo().shardCount, 4u);
+    ASSERT_EQ(reader.getRecordCount(), 10u);
+
+    TrainingSample sample;
+    for (int i = 0; i < 10; i++)
+    {
+        reader.read(static_cast<uint64_t>(i), sample);
+        expectSameSample(makeSample(15, static_cast<uint32_t>(i / 3), i), sample);
+    }
+    EXPECT_THROW(reader.read(10, sample), std::runtime_error);
+}
+
+// 再開すると、書きかけのレコードと最後の対局を取り除いて続きから書く
+TEST_F(TrainingDataTest, ResumeDropsLastGame)
+{
+    TrainingShardInfo info{9, 1, 0, 1};
+    {
+        TrainingShardWriter writer(shardPath, info, false);
+        for (int i = 0; i < 7; i++)
+        {
+            writer.append(makeSample(9, static_cast<uint32_t>(i / 3), i));
+        }
+    }
+
+    // 書き込みの途中で止まった状態（最後のレコードが途中まで）
+    size_t full = TrainingData::HEADER_SIZE + 7 * TrainingData::recordSize(9);
+    ASSERT_EQ(::truncate(shardPath.c_str(), static_cast<off_t>(full - 5)), 0);
+
+    // 最後に残った完全なレコードの対局 1 も、終わりまで書けたか分からないので取り除く
+    {
+        TrainingShardWriter writer(shardPath, info, true);
+        EXPECT_EQ(writer.getRecordCount(), 3u);
+        EXPECT_EQ(writer.getLastGame(), 0);
+        for (int i = 3; i < 7; i++)
+        {
+            writer.append(makeSample(9, static_cast<uint32_t>(i / 3), i));
+        }
+    }
+
+    TrainingShardReader reader(shardPath);
+    ASSERT_EQ(reader.getRecordCount(), 7u);
+    TrainingSample sample;
+    for (int i = 0; i < 7; i++)
+    {
+        reader.read(static_cast<uint64_t>(i), sample);
+        expectSameSample(makeSample(9, static_cast<uint32_t>(i / 3), i), sample);
+    }
+
+    // 条件が違うシャードの続きは書かない
+    TrainingShardInfo other{9, 2, 0, 1};
+    EXPECT_THROW(TrainingShardWriter(shardPath, other, true), std::runtime_error);
+}
+
+// 形式の違うファイルは読み込まない
+TEST_F(TrainingDataTest, RejectsInvalidFiles)
+{
+    FILE *file = std::fopen(shardPath.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    std::fputs("not a training shard at all, just some text to fill the header", file);
+    std::fclose(file);
+    EXPECT_THROW(TrainingShardReader reader(shardPath), std::runtime_error);
+}
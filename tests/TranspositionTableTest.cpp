@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "GomokuLib/TranspositionTable.h"
+
+using namespace GomokuLib;
+
+// 登録した結果をそのまま引ける
+TEST(TranspositionTableTest, StoreAndProbe)
+{
+    TranspositionTable table(15, 1024);
+    EXPECT_EQ(table.getCapacity(), 1024u);
+
+    TableEntry entry;
+    entry.score = -12345;
+    entry.depth = 3;
+    entry.bound = BoundType::LOWER;
+    entry.move = {14, 2};
+    table.store(0x123456789ULL, entry);
+
+    TableEntry found;
+    ASSERT_TRUE(table.probe(0x123456789ULL, found));
+    EXPECT_EQ(found.score, -12345);
+    EXPECT_EQ(found.depth, 3);
+    EXPECT_EQ(found.bound, BoundType::LOWER);
+    EXPECT_EQ(found.move, std::make_pair(14, 2));
+
+    // 同じ位置に入る別の局面とは区別される
+    EXPECT_FALSE(table.probe(0x123456789ULL + 1024, found));
+
+    table.clear();
+    EXPECT_FALSE(table.probe(0x123456789ULL, found));
+}
+
+// 同じ局面はより深い結果を残す
+TEST(TranspositionTableTest, KeepsDeeperResult)
+{
+    TranspositionTable table(15, 16);
+
+    TableEntry deep;
+    deep.score = 10;
+    deep.depth = 5;
+    deep.bound = BoundType::EXACT;
+    table.store(42, deep);
+
+    TableEntry shallow = deep;
+    shallow.score = 20;
+    shallow.depth = 2;
+    table.store(42, shallow);
+
+    TableEntry found;
+    ASSERT_TRUE(table.probe(42, found));
+    EXPECT_EQ(found.score, 10);
+    EXPECT_EQ(found.move, std::make_pair(-1, -1));
+
+    // 別の局面なら置き換える
+    table.store(42 + 16, shallow);
+    EXPECT_FALSE(table.probe(42, found));
+    EXPECT_TRUE(table.probe(42 + 16, found));
+}
+
+// 差分で更新したハッシュは盤面全体から計算したハッシュと一致する
+TEST(TranspositionTableTest, IncrementalHash)
+{
+    TranspositionTable table(9, 64);
+    Board board(9);
+
+    uint64_t key = table.hash(board, Stone::BLACK);
+    board.placeStone(4, 4, Stone::BLACK);
+    key ^= table.stoneKey(4, 4, Stone::BLACK) ^ table.sideToMoveKey();
+    board.placeStone(3, 5, Stone::WHITE);
+    key ^= table.stoneKey(3, 5, Stone::WHITE) ^ table.sideToMoveKey();
+    EXPECT_EQ(key, table.hash(board, Stone::BLACK));
+    EXPECT_NE(key, table.hash(board, Stone::WHITE));
+
+    // 同じ石の並びでも手順によらず同じハッシュになる
+    Board other(9);
+    other.placeStone(3, 5, Stone::WHITE);
+    other.placeStone(4, 4, Stone::BLACK);
+    EXPECT_EQ(table.hash(other, Stone::BLACK), key);
+
+}
@@ -1,7 +1,26 @@
 #include <gtest/gtest.h>
+#include "GomokuLib/CpuDispatch.h"
+#include <cstdlib>
+#include <iostream>
+
+// GOMOKU_SIMD で指定した命令セットがこの CPU で使えない場合に返す終了コード（ctest ではスキップになる）
+constexpr int SKIP_EXIT_CODE = 77;
 
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
+
+    // 命令セットを指定して実行する場合は、その実装を確実に通す
+    const char *forced = std::getenv(GomokuLib::CpuDispatch::ENVIRONMENT_VARIABLE);
+    GomokuLib::SimdLevel level;
+    if (forced && GomokuLib::CpuDispatch::parseLevel(forced, level))
+    {
+        if (!GomokuLib::CpuDispatch::isSupported(level))
+        {
+            std::cout << "SIMD level " << forced << " is not supported on this CPU; skipping" << std::endl;
+            return SKIP_EXIT_CODE;
+        }
+        std::cout << "Kernels: " << GomokuLib::CpuDispatch::levelToString(GomokuLib::CpuDispatch::getLevel()) << std::endl;
+    }
     return RUN_ALL_TESTS();
 }